@@ -0,0 +1,76 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <SpectralEvaluation/Log.h>
+
+// ------------ This file contains the small framework used to define the benchmarks of SpectralEvaluation ------------
+
+namespace novac
+{
+/** The operation to measure in one benchmark, together with the description of how much work it does. */
+struct BenchmarkOperation
+{
+    /** The operation to time. This returns a value calculated from its result,
+        such that the compiler cannot optimize away the work. */
+    std::function<double()> run;
+
+    /** The number of items (spectra, pixels, scans...) processed by one call to 'run', used to calculate the throughput. */
+    double itemsPerRun = 1.0;
+
+    /** The name of the items, e.g. "spectra". */
+    std::string itemName = "runs";
+
+    /** Additional values describing the operation which are reported together with the timing,
+        e.g. the number of bytes copied per spectrum. The key is the name of the value. */
+    std::map<std::string, double> counters;
+};
+
+/** One benchmark in the suite. */
+struct Benchmark
+{
+    /** The unique name of the benchmark, used to track the results between releases. */
+    std::string name;
+
+    /** The kind of benchmark, "micro" for a single function or "macro" for a complete evaluation. */
+    std::string kind;
+
+    /** Reads the test data and prepares everything which should not be timed and returns the operation to time.
+        @throws BenchmarkSkippedException if the test data necessary for the benchmark is not available. */
+    std::function<BenchmarkOperation()> setup;
+};
+
+/** Thrown by the setup of a benchmark which cannot run, e.g. since its test data is missing.
+    The benchmark is then reported as skipped instead of as failed. */
+class BenchmarkSkippedException : public std::runtime_error
+{
+public:
+    BenchmarkSkippedException(const std::string& reason) : std::runtime_error(reason) {}
+};
+
+/** Discards all messages, such that the time taken to write to the console is not measured. */
+class SilentLog : public ILogger
+{
+public:
+    virtual void Debug(const std::string&) override {}
+    virtual void Debug(const LogContext&, const std::string&) override {}
+
+    virtual void Information(const std::string&) override {}
+    virtual void Information(const LogContext&, const std::string&) override {}
+
+    virtual void Error(const std::string&) override {}
+    virtual void Error(const LogContext&, const std::string&) override {}
+};
+
+/** @throws BenchmarkSkippedException if the file with the given name does not exist. */
+void RequireTestDataFile(const std::string& fileName);
+
+/** Adds the benchmarks of single functions to the provided list. */
+void AddMicroBenchmarks(std::vector<Benchmark>& benchmarks);
+
+/** Adds the benchmarks of complete evaluations to the provided list. */
+void AddMacroBenchmarks(std::vector<Benchmark>& benchmarks);
+}
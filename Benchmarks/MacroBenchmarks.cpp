@@ -0,0 +1,210 @@
+#include "Benchmark.h"
+#include "TestData.h"
+#include <SpectralEvaluation/Calibration/Correspondence.h>
+#include <SpectralEvaluation/Calibration/InstrumentLineShape.h>
+#include <SpectralEvaluation/Calibration/WavelengthCalibration.h>
+#include <SpectralEvaluation/Configuration/DarkSettings.h>
+#include <SpectralEvaluation/Evaluation/BasicScanEvaluationResult.h>
+#include <SpectralEvaluation/Evaluation/EvaluationBase.h>
+#include <SpectralEvaluation/Evaluation/RatioEvaluation.h>
+#include <SpectralEvaluation/File/File.h>
+#include <SpectralEvaluation/File/FitWindowFileHandler.h>
+#include <SpectralEvaluation/File/ScanEvaluationLogFileHandler.h>
+#include <SpectralEvaluation/File/ScanFileHandler.h>
+#include <SpectralEvaluation/Flux/PlumeInScanProperty.h>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <memory>
+
+// The benchmarks of complete evaluations, each reading its spectra from one of the .pak files in the test data.
+
+namespace novac
+{
+    static void ReadScanFile(CScanFileHandler& fileHandler, const std::string& fileName)
+    {
+        if (!fileHandler.CheckScanFile(LogContext(), fileName))
+        {
+            throw std::runtime_error("Failed to read the scan file " + fileName);
+        }
+    }
+
+    // Evaluates all the spectra in the 2009175M1 scan, the same setup as in IntegrationTests_EvaluationBase.
+    static BenchmarkOperation SetupEvaluateScan()
+    {
+        const std::string scanFile = TestData::GetMeasuredSpectrumName_2009175M1();
+        RequireTestDataFile(scanFile);
+
+        auto window = std::make_shared<CFitWindow>();
+        window->fitLow = 475;
+        window->fitHigh = 643;
+        window->fitType = FIT_TYPE::FIT_HP_DIV;
+        for (const std::string& reference : TestData::GetReferences_2009175M1())
+        {
+            RequireTestDataFile(reference);
+            CReferenceFile& ref = window->ref[window->nRef++];
+            ref.m_path = reference;
+            ref.m_columnOption = SHIFT_TYPE::SHIFT_FREE;
+            ref.m_shiftOption = SHIFT_TYPE::SHIFT_FIX;
+            ref.m_shiftValue = 0.0;
+            ref.m_squeezeOption = SHIFT_TYPE::SHIFT_FIX;
+            ref.m_squeezeValue = 1.0;
+            if (0 != ref.ReadCrossSectionDataFromFile())
+            {
+                throw std::runtime_error("Failed to read the reference " + reference);
+            }
+        }
+
+        SilentLog log;
+        CScanFileHandler fileHandler(log);
+        ReadScanFile(fileHandler, scanFile);
+        const int numberOfSpectra = fileHandler.GetSpectrumNumInFile();
+
+        BenchmarkOperation operation;
+        operation.run = [scanFile, window]() {
+            SilentLog log;
+            LogContext context;
+            CScanFileHandler fileHandler(log);
+            ReadScanFile(fileHandler, scanFile);
+
+            // The first spectrum is the sky and the second the dark spectrum.
+            CSpectrum skySpectrum;
+            CSpectrum darkSpectrum;
+            if (1 != fileHandler.GetSpectrum(context, skySpectrum, 0) || 1 != fileHandler.GetSpectrum(context, darkSpectrum, 1))
+            {
+                throw std::runtime_error("Failed to read the sky and dark spectra");
+            }
+            skySpectrum.Div(skySpectrum.NumSpectra());
+            darkSpectrum.Div(darkSpectrum.NumSpectra());
+            skySpectrum.Sub(darkSpectrum);
+
+            CEvaluationBase evaluation(log);
+            evaluation.SetFitWindow(*window);
+            evaluation.SetSkySpectrum(skySpectrum);
+
+            double sum = 0.0;
+            CSpectrum spectrum;
+            for (long spectrumIdx = 2; 1 == fileHandler.GetSpectrum(context, spectrum, spectrumIdx); ++spectrumIdx)
+            {
+                spectrum.Div(spectrum.NumSpectra());
+                spectrum.Sub(darkSpectrum);
+                if (0 == evaluation.Evaluate(spectrum))
+                {
+                    sum += evaluation.m_result.m_referenceResult[0].m_column;
+                }
+            }
+            return sum;
+        };
+        operation.itemsPerRun = (double)(numberOfSpectra - 2);
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    // Calculates the BrO/SO2 ratio of the first BrO ratio scan, the same setup as in IntegrationTests_RatioEvaluation.
+    static BenchmarkOperation SetupRatioEvaluation()
+    {
+        const std::string scanFile = TestData::GetBrORatioScanFile1();
+        RequireTestDataFile(scanFile);
+        RequireTestDataFile(TestData::GetBrORatioEvaluationFile1());
+        RequireTestDataFile(TestData::GetBrORatioFitWindowFileSO2());
+        RequireTestDataFile(TestData::GetBrORatioFitWindowFileBrO());
+
+        CScanEvaluationLogFileHandler evaluationFileHandler;
+        if (!evaluationFileHandler.ReadEvaluationLog(TestData::GetBrORatioEvaluationFile1()) || evaluationFileHandler.m_scan.size() != 1)
+        {
+            throw std::runtime_error("Failed to read the evaluation log " + TestData::GetBrORatioEvaluationFile1());
+        }
+        auto scanResult = std::make_shared<BasicScanEvaluationResult>(evaluationFileHandler.m_scan[0]);
+
+        auto plumeInScanProperties = std::make_shared<CPlumeInScanProperty>();
+        CalculatePlumeOffset(*scanResult, 0, *plumeInScanProperties);
+        if (!CalculatePlumeCompleteness(*scanResult, 0, *plumeInScanProperties))
+        {
+            throw std::runtime_error("Failed to calculate the plume completeness");
+        }
+
+        CFitWindowFileHandler fitWindowFileHandler;
+        auto so2FitWindows = fitWindowFileHandler.ReadFitWindowFile(TestData::GetBrORatioFitWindowFileSO2());
+        auto broFitWindows = fitWindowFileHandler.ReadFitWindowFile(TestData::GetBrORatioFitWindowFileBrO());
+        if (so2FitWindows.size() != 1 || broFitWindows.size() != 1)
+        {
+            throw std::runtime_error("Failed to read the fit windows");
+        }
+        auto so2FitWindow = std::make_shared<CFitWindow>(so2FitWindows.front());
+        so2FitWindow->fitLow = 439;
+        so2FitWindow->fitHigh = 592;
+        auto broFitWindow = std::make_shared<CFitWindow>(broFitWindows.front());
+        broFitWindow->fitLow = 641;
+        broFitWindow->fitHigh = 939;
+        if (!ReadReferences(*so2FitWindow) || !ReadReferences(*broFitWindow))
+        {
+            throw std::runtime_error("Failed to read the references of the fit windows");
+        }
+
+        BenchmarkOperation operation;
+        operation.run = [scanFile, scanResult, plumeInScanProperties, so2FitWindow, broFitWindow]() {
+            Configuration::RatioEvaluationSettings settings;
+            Configuration::CDarkSettings darkSettings;
+            SilentLog log;
+            LogContext context;
+            CScanFileHandler fileHandler(log);
+            ReadScanFile(fileHandler, scanFile);
+
+            RatioEvaluation ratioEvaluation{ settings, darkSettings, log };
+            ratioEvaluation.SetupFirstResult(*scanResult, *plumeInScanProperties);
+            ratioEvaluation.SetupFitWindows(*so2FitWindow, std::vector<CFitWindow>{ *broFitWindow });
+
+            const auto ratios = ratioEvaluation.Run(context, fileHandler);
+            if (ratios.size() != 1)
+            {
+                throw std::runtime_error("The ratio evaluation did not produce a ratio");
+            }
+            return ratios.front().ratio;
+        };
+        operation.itemName = "scans";
+        return operation;
+    }
+
+    // Calibrates the sky spectrum of I2J8549 against the high resolution solar atlas.
+    static BenchmarkOperation SetupWavelengthCalibration()
+    {
+        const std::string scanFile = TestData::GetMeasuredSpectrumName_I2J8549();
+        RequireTestDataFile(scanFile);
+        RequireTestDataFile(TestData::GetInitialPixelToWavelengthCalibration_I2J8549());
+        RequireTestDataFile(TestData::GetInitialInstrumentLineShapefile_I2J8549());
+        RequireTestDataFile(TestData::GetSolarAtlasFile());
+
+        auto settings = std::make_shared<WavelengthCalibrationSettings>();
+        settings->highResSolarAtlas = TestData::GetSolarAtlasFile();
+        settings->initialPixelToWavelengthMapping = GetPixelToWavelengthMappingFromFile(TestData::GetInitialPixelToWavelengthCalibration_I2J8549());
+        if (!ReadCrossSectionFile(TestData::GetInitialInstrumentLineShapefile_I2J8549(), settings->initialInstrumentLineShape))
+        {
+            throw std::runtime_error("Failed to read the instrument line shape " + TestData::GetInitialInstrumentLineShapefile_I2J8549());
+        }
+
+        SilentLog log;
+        CScanFileHandler fileHandler(log);
+        ReadScanFile(fileHandler, scanFile);
+        auto measuredSpectrum = std::make_shared<CSpectrum>();
+        CSpectrum darkSpectrum;
+        if (0 != fileHandler.GetSky(*measuredSpectrum) || 0 != fileHandler.GetDark(darkSpectrum))
+        {
+            throw std::runtime_error("Failed to read the sky and dark spectra from " + scanFile);
+        }
+        measuredSpectrum->Sub(darkSpectrum);
+
+        BenchmarkOperation operation;
+        operation.run = [settings, measuredSpectrum]() {
+            WavelengthCalibrationSetup calibration{ *settings };
+            const SpectrometerCalibrationResult result = calibration.DoWavelengthCalibration(*measuredSpectrum);
+            return result.pixelToWavelengthMapping[result.pixelToWavelengthMapping.size() / 2];
+        };
+        operation.itemName = "calibrations";
+        return operation;
+    }
+
+    void AddMacroBenchmarks(std::vector<Benchmark>& benchmarks)
+    {
+        benchmarks.push_back(Benchmark{ "CEvaluationBase/Scan_2009175M1", "macro", SetupEvaluateScan });
+        benchmarks.push_back(Benchmark{ "RatioEvaluation/BrORatioScan1", "macro", SetupRatioEvaluation });
+        benchmarks.push_back(Benchmark{ "WavelengthCalibrationSetup::DoWavelengthCalibration/I2J8549", "macro", SetupWavelengthCalibration });
+    }
+}
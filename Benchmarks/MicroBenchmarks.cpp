@@ -0,0 +1,800 @@
+#include "Benchmark.h"
+#include "TestData.h"
+#include <SpectralEvaluation/Calibration/Correspondence.h>
+#include <SpectralEvaluation/Calibration/ReferenceSpectrumConvolution.h>
+#include <SpectralEvaluation/Calibration/WavelengthCalibration.h>
+#include <SpectralEvaluation/Evaluation/BasicMath.h>
+#include <SpectralEvaluation/Evaluation/CrossSectionData.h>
+#include <SpectralEvaluation/Evaluation/DoasFit.h>
+#include <SpectralEvaluation/Evaluation/DoasFitPreparation.h>
+#include <SpectralEvaluation/File/File.h>
+#include <SpectralEvaluation/File/FitWindowFileHandler.h>
+#include <SpectralEvaluation/File/MKPack.h>
+#include <SpectralEvaluation/File/PakFileIndex.h>
+#include <SpectralEvaluation/File/ScanFileHandler.h>
+#include <SpectralEvaluation/File/SpectrumIO.h>
+#include <SpectralEvaluation/Fit/CubicSplineFunction.h>
+#include <SpectralEvaluation/Fit/DiscreteFunction.h>
+#include <SpectralEvaluation/Fit/LeastSquareFit.h>
+#include <SpectralEvaluation/Fit/Matrix.h>
+#include <SpectralEvaluation/Fit/PolynomialFunction.h>
+#include <SpectralEvaluation/Fit/StandardMetricFunction.h>
+#include <SpectralEvaluation/Math/BinomialFilter.h>
+#include <SpectralEvaluation/Math/PolynomialFit.h>
+#include <SpectralEvaluation/Spectra/Scattering.h>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <SpectralEvaluation/Spectra/SpectrumView.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+
+// The benchmarks of the single functions which dominate the time taken to read and evaluate spectra.
+// All synthetic data is generated with fixed seeds, such that every run measures exactly the same work.
+
+namespace novac
+{
+    // Creates a spectrum-like signal, a smooth and strongly varying background with narrow absorption lines and some noise.
+    static std::vector<double> CreateSpectrum(size_t length, unsigned int seed)
+    {
+        std::mt19937 generator{ seed };
+        std::uniform_real_distribution<double> noise{ -1.0, 1.0 };
+        std::vector<double> data(length);
+        for (size_t ii = 0; ii < length; ++ii)
+        {
+            const double x = (double)ii / (double)length;
+            const double background = 100.0 + 40000.0 * std::exp(-std::pow((x - 0.6) / 0.25, 2.0));
+            const double lines = 1.0 - 0.3 * std::pow(std::sin(0.37 * ii), 8.0);
+            data[ii] = background * lines + 10.0 * noise(generator);
+        }
+        return data;
+    }
+
+    static std::vector<std::string> GetPakFiles()
+    {
+        return { TestData::GetMeasuredSpectrumName_I2J8549(), TestData::GetMeasuredSpectrumName_2009175M1(), TestData::GetBrORatioScanFile1() };
+    }
+
+    struct CompressedSpectrum
+    {
+        std::vector<std::uint8_t> data;
+        long pixels;
+    };
+
+    // Copies the compressed data of all the spectra in the .pak files of the test data.
+    static std::shared_ptr<std::vector<CompressedSpectrum>> ReadCompressedSpectra(long& maximumPixels)
+    {
+        auto spectra = std::make_shared<std::vector<CompressedSpectrum>>();
+        maximumPixels = 0;
+        for (const std::string& fileName : GetPakFiles())
+        {
+            PakFileIndex index;
+            if (!index.Open(fileName))
+            {
+                throw BenchmarkSkippedException("Cannot open " + fileName);
+            }
+            for (size_t ii = 0; ii < index.SpectrumCount(); ++ii)
+            {
+                const MKZYhdr& header = index.GetHeader(ii);
+                CompressedSpectrum spectrum;
+                spectrum.data.assign(index.GetCompressedData(ii), index.GetCompressedData(ii) + header.size);
+                spectrum.pixels = header.pixels;
+                maximumPixels = std::max(maximumPixels, spectrum.pixels);
+                spectra->push_back(spectrum);
+            }
+        }
+        return spectra;
+    }
+
+    template<class T>
+    static BenchmarkOperation SetupUnPack()
+    {
+        long maximumPixels = 0;
+        auto spectra = ReadCompressedSpectra(maximumPixels);
+        auto buffer = std::make_shared<std::vector<T>>(maximumPixels);
+
+        BenchmarkOperation operation;
+        operation.run = [spectra, buffer]() {
+            double sum = 0.0;
+            for (const CompressedSpectrum& spectrum : *spectra)
+            {
+                MKPack::UnPack(spectrum.data.data(), spectrum.data.size(), spectrum.pixels, buffer->data());
+                sum += (double)(*buffer)[spectrum.pixels / 2];
+            }
+            return sum;
+        };
+        operation.itemsPerRun = (double)spectra->size();
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    // The decoder which was used before the word based decoder, kept for comparison.
+    static BenchmarkOperation SetupUnPackOriginal()
+    {
+        long maximumPixels = 0;
+        auto spectra = ReadCompressedSpectra(maximumPixels);
+        auto buffer = std::make_shared<std::vector<long>>(maximumPixels);
+
+        BenchmarkOperation operation;
+        operation.run = [spectra, buffer]() {
+            double sum = 0.0;
+            for (CompressedSpectrum& spectrum : *spectra)
+            {
+                MKPack mkPack;
+                mkPack.UnPack(spectrum.data.data(), spectrum.pixels, buffer->data());
+                sum += (double)(*buffer)[spectrum.pixels / 2];
+            }
+            return sum;
+        };
+        operation.itemsPerRun = (double)spectra->size();
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    static BenchmarkOperation SetupReadNextSpectrum()
+    {
+        const std::string fileName = TestData::GetBrORatioScanFile1();
+        RequireTestDataFile(fileName);
+
+        PakFileIndex index;
+        if (!index.Open(fileName))
+        {
+            throw BenchmarkSkippedException("Cannot open " + fileName);
+        }
+        const size_t numberOfSpectra = index.SpectrumCount();
+
+        BenchmarkOperation operation;
+        operation.run = [fileName]() {
+            CSpectrumIO reader;
+            CSpectrum spectrum;
+            double sum = 0.0;
+            FILE* f = fopen(fileName.c_str(), "rb");
+            if (f == nullptr)
+            {
+                throw std::runtime_error("Cannot open " + fileName);
+            }
+            while (reader.ReadNextSpectrum(f, spectrum))
+            {
+                sum += spectrum.m_data[spectrum.m_length / 2];
+            }
+            fclose(f);
+            return sum;
+        };
+        operation.itemsPerRun = (double)numberOfSpectra;
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    static BenchmarkOperation SetupHighPassBinomial()
+    {
+        auto spectrum = std::make_shared<std::vector<double>>(CreateSpectrum(2048, 1));
+        auto buffer = std::make_shared<std::vector<double>>(spectrum->size());
+        auto math = std::make_shared<CBasicMath>();
+
+        BenchmarkOperation operation;
+        operation.run = [spectrum, buffer, math]() {
+            *buffer = *spectrum;
+            math->HighPassBinomial(buffer->data(), (int)buffer->size(), 500);
+            return (*buffer)[buffer->size() / 2];
+        };
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    // Convolves the high resolution SO2 cross section with the measured instrument line shape of I2J8549.
+    static BenchmarkOperation SetupConvolveReference(ConvolutionMethod method)
+    {
+        RequireTestDataFile(TestData::GetInitialPixelToWavelengthCalibration_I2J8549());
+        RequireTestDataFile(TestData::GetInitialInstrumentLineShapefile_I2J8549());
+        RequireTestDataFile(TestData::GetHighResolutionSO2CrossSectionFile());
+
+        auto pixelToWavelengthMapping = std::make_shared<std::vector<double>>(GetPixelToWavelengthMappingFromFile(TestData::GetInitialPixelToWavelengthCalibration_I2J8549()));
+        auto slf = std::make_shared<CCrossSectionData>();
+        auto highResReference = std::make_shared<CCrossSectionData>();
+        if (!ReadCrossSectionFile(TestData::GetInitialInstrumentLineShapefile_I2J8549(), *slf) ||
+            !ReadCrossSectionFile(TestData::GetHighResolutionSO2CrossSectionFile(), *highResReference))
+        {
+            throw std::runtime_error("Failed to read the instrument line shape or the high resolution cross section");
+        }
+        auto result = std::make_shared<std::vector<double>>();
+
+        BenchmarkOperation operation;
+        operation.run = [pixelToWavelengthMapping, slf, highResReference, result, method]() {
+            ConvolveReference(*pixelToWavelengthMapping, *slf, *highResReference, *result, WavelengthConversion::None, method);
+            return (*result)[result->size() / 2];
+        };
+        operation.itemName = "references";
+        return operation;
+    }
+
+    static BenchmarkOperation SetupEvaluateSplineVector()
+    {
+        // A spline through a high resolution spectrum evaluated at the pixels of a spectrometer, as when resampling references.
+        // EvaluateSplineVector is private and measured through GetValues.
+        const int highResolutionLength = 16384;
+        const int length = 2048;
+        const std::vector<double> highResolutionSpectrum = CreateSpectrum(highResolutionLength, 2);
+        MathFit::CVector highResolutionWavelength(highResolutionLength);
+        MathFit::CVector highResolutionValue(highResolutionLength);
+        for (int ii = 0; ii < highResolutionLength; ++ii)
+        {
+            highResolutionWavelength.SetAt(ii, 280.0 + 150.0 * ii / (double)highResolutionLength);
+            highResolutionValue.SetAt(ii, highResolutionSpectrum[ii]);
+        }
+
+        struct SplineData
+        {
+            MathFit::CCubicSplineFunction spline;
+            MathFit::CVector wavelength;
+            MathFit::CVector result;
+        };
+        auto data = std::make_shared<SplineData>();
+        data->spline.SetData(highResolutionWavelength, highResolutionValue);
+        data->wavelength.SetSize(length);
+        data->result.SetSize(length);
+        for (int ii = 0; ii < length; ++ii)
+        {
+            data->wavelength.SetAt(ii, 290.0 + 0.0625 * ii + 2.0e-6 * ii * ii);
+        }
+
+        BenchmarkOperation operation;
+        operation.run = [data, length]() {
+            data->spline.GetValues(data->wavelength, data->result);
+            return data->result.GetAt(length / 2);
+        };
+        operation.itemsPerRun = (double)length;
+        operation.itemName = "pixels";
+        return operation;
+    }
+
+    static BenchmarkOperation SetupLeastSquareFit()
+    {
+        // A fifth order polynomial fitted to a spectrum, a linear fit of the same size as the polynomial part of a DOAS fit.
+        const int length = 2048;
+        const int polynomialOrder = 5;
+        const std::vector<double> spectrum = CreateSpectrum(length, 3);
+
+        struct FitData
+        {
+            MathFit::CVector x;
+            MathFit::CVector y;
+        };
+        auto data = std::make_shared<FitData>();
+        data->x.SetSize(length);
+        data->y.SetSize(length);
+        for (int ii = 0; ii < length; ++ii)
+        {
+            data->x.SetAt(ii, ii / (double)length);
+            data->y.SetAt(ii, std::log(spectrum[ii]));
+        }
+
+        BenchmarkOperation operation;
+        operation.run = [data, polynomialOrder]() {
+            MathFit::CDiscreteFunction target;
+            target.SetData(data->x, data->y);
+            MathFit::CPolynomialFunction polynomial(polynomialOrder);
+            MathFit::CStandardMetricFunction metric(target, polynomial);
+
+            MathFit::CLeastSquareFit fit(metric);
+            fit.SetFitRange(data->x);
+            fit.PrepareMinimize();
+            fit.Minimize();
+            fit.FinishMinimize();
+
+            return polynomial.GetCoefficient(1);
+        };
+        operation.itemName = "fits";
+        return operation;
+    }
+
+    static BenchmarkOperation SetupCountInliers()
+    {
+        // Keypoints with one correct and two false correspondences each, as in the ransac wavelength calibration.
+        const std::vector<double> actualModelPolynomial{ 300.0, 0.05, -2.0e-6 };
+        const std::vector<double> suggestedModelPolynomial{ 300.02, 0.05, -2.0e-6 };
+        const size_t numberOfKeypoints = 150;
+
+        std::mt19937 rnd{ 1234 };
+        std::uniform_real_distribution<double> falseWavelengthOffset(1.0, 5.0);
+        std::vector<Correspondence> allCorrespondences;
+        for (size_t ii = 0; ii < numberOfKeypoints; ++ii)
+        {
+            Correspondence c;
+            c.measuredIdx = ii;
+            c.measuredValue = 10.0 + 13.5 * ii;
+            c.theoreticalIdx = 3 * ii;
+            c.theoreticalValue = PolynomialValueAt(actualModelPolynomial, c.measuredValue);
+            allCorrespondences.push_back(c);
+
+            for (size_t falseIdx = 1; falseIdx <= 2; ++falseIdx)
+            {
+                Correspondence falseCorrespondence = c;
+                falseCorrespondence.theoreticalIdx = 3 * ii + falseIdx;
+                falseCorrespondence.theoreticalValue += (falseIdx == 1) ? falseWavelengthOffset(rnd) : -falseWavelengthOffset(rnd);
+                allCorrespondences.push_back(falseCorrespondence);
+            }
+        }
+
+        auto correspondences = std::make_shared<CorrespondencesByMeasuredKeypoint>(CreateCorrespondencesByMeasuredKeypoint(ArrangeByMeasuredKeypoint(allCorrespondences)));
+        auto scratch = std::make_shared<CountInliersScratch>();
+        auto inliers = std::make_shared<std::vector<Correspondence>>();
+
+        BenchmarkOperation operation;
+        operation.run = [correspondences, scratch, inliers, suggestedModelPolynomial]() {
+            double meanError = 0.0;
+            bool isMonotonic = false;
+            const size_t numberOfInliers = CountInliers(suggestedModelPolynomial, *correspondences, 0.1, *inliers, meanError, isMonotonic, *scratch);
+            return (double)numberOfInliers + meanError;
+        };
+        operation.itemName = "models";
+        return operation;
+    }
+
+    // The original implementation of CBasicMath::HighPassBinomial, kept for comparison with BinomialFilter.
+    static void HighPassBinomialIterative(double* data, int length, int iterations, std::vector<double>& lowPass, std::vector<double>& buffer)
+    {
+        lowPass.assign(data, data + length);
+        buffer.resize(length);
+        for (int iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (int ii = 0; ii < length; ++ii)
+            {
+                const double left = (ii == 0) ? lowPass[ii] : lowPass[ii - 1];
+                const double right = (ii == length - 1) ? lowPass[ii] : lowPass[ii + 1];
+                buffer[ii] = 0.5 * lowPass[ii] + 0.25 * left + 0.25 * right;
+            }
+            std::swap(lowPass, buffer);
+        }
+        for (int ii = 0; ii < length; ++ii)
+        {
+            data[ii] = (lowPass[ii] != 0.0) ? data[ii] / lowPass[ii] : 0.0;
+        }
+    }
+
+    static BenchmarkOperation SetupHighPassBinomialIterative(int length)
+    {
+        struct FilterData
+        {
+            std::vector<double> spectrum;
+            std::vector<double> buffer;
+            std::vector<double> lowPass;
+            std::vector<double> lowPassBuffer;
+        };
+        auto data = std::make_shared<FilterData>();
+        data->spectrum = CreateSpectrum(length, 1);
+
+        BenchmarkOperation operation;
+        operation.run = [data, length]() {
+            data->buffer = data->spectrum;
+            HighPassBinomialIterative(data->buffer.data(), length, 500, data->lowPass, data->lowPassBuffer);
+            return data->buffer[length / 2];
+        };
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    // Filters 'numberOfSpectra' spectra, one at a time or all of them together in one call.
+    static BenchmarkOperation SetupBinomialFilter(int length, int numberOfSpectra, bool batched)
+    {
+        struct FilterData
+        {
+            FilterData(int length) : filter((size_t)length, 500) {}
+            BinomialFilter filter;
+            std::vector<std::vector<double>> spectra;
+            std::vector<std::vector<double>> buffers;
+            std::vector<double*> spectraToFilter;
+        };
+        auto data = std::make_shared<FilterData>(length);
+        for (int ii = 0; ii < numberOfSpectra; ++ii)
+        {
+            data->spectra.push_back(CreateSpectrum(length, 1 + ii));
+        }
+        data->buffers = data->spectra;
+        for (auto& buffer : data->buffers)
+        {
+            data->spectraToFilter.push_back(buffer.data());
+        }
+
+        BenchmarkOperation operation;
+        operation.run = [data, length, batched]() {
+            for (size_t ii = 0; ii < data->spectra.size(); ++ii)
+            {
+                std::copy(data->spectra[ii].begin(), data->spectra[ii].end(), data->buffers[ii].begin());
+            }
+            if (batched)
+            {
+                data->filter.HighPass(data->spectraToFilter);
+            }
+            else
+            {
+                for (double* spectrum : data->spectraToFilter)
+                {
+                    data->filter.HighPass(spectrum);
+                }
+            }
+            return data->buffers[0][length / 2];
+        };
+        operation.itemsPerRun = (double)numberOfSpectra;
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    struct RingSpectrumData
+    {
+        std::vector<double> wavelength;
+        std::vector<double> intensity;
+        CSpectrum sky;
+    };
+
+    static std::shared_ptr<RingSpectrumData> CreateRingSpectrumData(int length)
+    {
+        auto data = std::make_shared<RingSpectrumData>();
+        data->wavelength.resize(length);
+        data->intensity = CreateSpectrum(length, 4);
+        for (int ii = 0; ii < length; ++ii)
+        {
+            data->wavelength[ii] = 280.0 + 100.0 * ii / length;
+        }
+        data->sky = CSpectrum{ data->wavelength, data->intensity };
+        return data;
+    }
+
+    // The original calculation of the Ring spectrum, scattering each pixel of the spectrum.
+    static BenchmarkOperation SetupCalcRamanSpectrum(int length)
+    {
+        auto data = CreateRingSpectrumData(length);
+
+        BenchmarkOperation operation;
+        operation.run = [data, length]() {
+            MathFit::CVector wavelength(data->sky.m_wavelength.data(), length, 1, false);
+            MathFit::CVector energy(length);
+            for (int ii = 0; ii < length; ++ii)
+            {
+                energy.SetAt(ii, data->intensity[ii] / data->wavelength[ii]);
+            }
+            MathFit::CVector raman = Doasis::Scattering::CalcRamanSpectrum(wavelength, energy, 250.0, 30, 0.8, 90.0);
+            raman.DivSimpleSafe(energy);
+            return raman.GetAt(length / 2);
+        };
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    static BenchmarkOperation SetupRingSpectrumCalculatorConstruction(int length)
+    {
+        auto data = CreateRingSpectrumData(length);
+
+        BenchmarkOperation operation;
+        operation.run = [data, length]() {
+            Doasis::RingSpectrumCalculator calculator{ data->wavelength, 250.0, 30, 0.8 };
+            std::vector<double> ring(length);
+            calculator.CalcRamanSpectrum(data->intensity.data(), ring.data(), 90.0);
+            return ring[length / 2];
+        };
+        operation.itemName = "calculators";
+        return operation;
+    }
+
+    static BenchmarkOperation SetupRingSpectrumCalculator(int length)
+    {
+        auto data = CreateRingSpectrumData(length);
+        auto calculator = std::make_shared<Doasis::RingSpectrumCalculator>(data->wavelength, 250.0, 30, 0.8);
+        auto ring = std::make_shared<std::vector<double>>(length);
+
+        BenchmarkOperation operation;
+        operation.run = [data, calculator, ring, length]() {
+            calculator->CalcRingSpectrum(data->sky.m_data, ring->data(), 90.0);
+            return (*ring)[length / 2];
+        };
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    // Scattering::CalcRingSpectrum, which sets up the RingSpectrumCalculator in the first call and then reuses it.
+    static BenchmarkOperation SetupCalcRingSpectrum(int length)
+    {
+        auto data = CreateRingSpectrumData(length);
+        Doasis::Scattering::CalcRingSpectrum(data->sky);
+
+        BenchmarkOperation operation;
+        operation.run = [data, length]() {
+            const CSpectrum ring = Doasis::Scattering::CalcRingSpectrum(data->sky);
+            return ring.m_data[length / 2];
+        };
+        operation.itemName = "spectra";
+        return operation;
+    }
+
+    // The linear algebra of one iteration of a DOAS fit with ten references, using the kernels of the given instruction set.
+    static BenchmarkOperation SetupFitIteration(int pixels, MathFit::Kernels::EInstructionSet instructionSet)
+    {
+        if (instructionSet > MathFit::Kernels::GetSupportedInstructionSet())
+        {
+            throw BenchmarkSkippedException("The instruction set is not supported by this processor");
+        }
+
+        const int numberOfReferences = 10;
+        struct FitData
+        {
+            FitData(int pixels, int columns)
+                : design(columns, pixels), measured(pixels), normalMatrix(columns, columns), atb(columns), solution(columns), residual(pixels)
+            {
+            }
+            MathFit::CMatrix design;
+            MathFit::CVector measured;
+            MathFit::CMatrix normalMatrix;
+            MathFit::CVector atb;
+            MathFit::CVector solution;
+            MathFit::CVector residual;
+        };
+        auto data = std::make_shared<FitData>(pixels, numberOfReferences);
+        for (int row = 0; row < pixels; ++row)
+        {
+            for (int col = 0; col < numberOfReferences; ++col)
+            {
+                data->design.SetAt(row, col, std::sin(0.01 * row * (col + 1)));
+            }
+            data->measured.SetAt(row, std::cos(0.02 * row));
+        }
+
+        BenchmarkOperation operation;
+        operation.run = [data, numberOfReferences, instructionSet]() {
+            const MathFit::Kernels::EInstructionSet originalInstructionSet = MathFit::Kernels::GetInstructionSet();
+            MathFit::Kernels::SetInstructionSet(instructionSet);
+
+            // AtA and Atb
+            data->normalMatrix.NormalMatrix(data->design);
+            for (int col = 0; col < numberOfReferences; ++col)
+            {
+                data->atb.SetAt(col, data->design.GetCol(col).Mul(data->measured));
+            }
+
+            // the model and the residual
+            data->solution.Copy(data->atb);
+            data->solution.Div(data->normalMatrix.GetAt(0, 0));
+            data->design.Mul(data->solution);
+            data->residual.Copy(data->measured);
+            data->residual.Sub(data->solution);
+            data->residual.Mul(0.5);
+            const double chiSquare = data->residual.Mul(data->residual);
+
+            MathFit::Kernels::SetInstructionSet(originalInstructionSet);
+            return chiSquare;
+        };
+        operation.itemName = "iterations";
+        return operation;
+    }
+
+    // The original reader of two column cross section files, kept for comparison with ReadCrossSectionFile.
+    static bool ReadCrossSectionFileUsingFscanf(const std::string& fileName, CCrossSectionData& result)
+    {
+        FILE* f = fopen(fileName.c_str(), "r");
+        if (nullptr == f)
+        {
+            return false;
+        }
+
+        while (!feof(f))
+        {
+            double col1 = 0.0;
+            double col2 = 0.0;
+            if (2 != fscanf(f, "%lf %lf", &col1, &col2))
+            {
+                break;
+            }
+            result.m_waveLength.push_back(col1);
+            result.m_crossSection.push_back(col2);
+        }
+
+        fclose(f);
+        return true;
+    }
+
+    // The original implementation of CCrossSectionData::ReadCrossSectionFile, kept for comparison.
+    static bool ReadCrossSectionFileUsingSscanf(const std::string& fileName, CCrossSectionData& result)
+    {
+        std::ifstream fileRef(fileName, std::ios_base::in);
+        if (!fileRef.is_open())
+        {
+            return false;
+        }
+
+        const int maxSize = 65536;
+        std::vector<char> tmpBuffer(maxSize);
+        while (!fileRef.eof())
+        {
+            fileRef.getline(tmpBuffer.data(), maxSize);
+            if (strlen(tmpBuffer.data()) == 0 || tmpBuffer[0] == ';' || tmpBuffer[0] == '#')
+            {
+                continue;
+            }
+
+            double fValue1 = 0.0;
+            double fValue2 = 0.0;
+            int nColumns = sscanf(tmpBuffer.data(), "%lf\t%lf", &fValue1, &fValue2);
+            if (nColumns != 2)
+            {
+                break;
+            }
+            result.m_waveLength.push_back(fValue1);
+            result.m_crossSection.push_back(fValue2);
+        }
+
+        return true;
+    }
+
+    // Reads the largest cross section in the test data using the given reader, the throughput is measured in megabytes.
+    static BenchmarkOperation SetupReadCrossSectionFile(std::function<bool(const std::string&, CCrossSectionData&)> read)
+    {
+        const std::string fileName = TestData::GetSolarAtlasFile_330To350nm();
+        RequireTestDataFile(fileName);
+
+        std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+        const double fileSizeInMegabytes = (double)file.tellg() / (1024.0 * 1024.0);
+
+        BenchmarkOperation operation;
+        operation.run = [fileName, read]() {
+            CCrossSectionData result;
+            if (!read(fileName, result) || result.m_crossSection.empty())
+            {
+                throw std::runtime_error("Failed to read " + fileName);
+            }
+            return result.m_crossSection[result.m_crossSection.size() / 2];
+        };
+        operation.itemsPerRun = fileSizeInMegabytes;
+        operation.itemName = "MB";
+        return operation;
+    }
+
+    // Prepares and fits 20 spectra of the first BrO ratio scan for SO2, preparing the spectrum into a new vector
+    //  or preparing it in place and fitting a view of the spectrum.
+    static BenchmarkOperation SetupDoasFit(bool prepareInPlace)
+    {
+        const std::string scanFile = TestData::GetBrORatioScanFile1();
+        RequireTestDataFile(scanFile);
+        RequireTestDataFile(TestData::GetBrORatioFitWindowFileSO2());
+
+        SilentLog log;
+        LogContext context;
+        CScanFileHandler fileHandler(log);
+        if (!fileHandler.CheckScanFile(context, scanFile))
+        {
+            throw std::runtime_error("Failed to read the scan file " + scanFile);
+        }
+
+        CFitWindowFileHandler fitWindowFileHandler;
+        auto allWindows = fitWindowFileHandler.ReadFitWindowFile(TestData::GetBrORatioFitWindowFileSO2());
+        if (allWindows.size() != 1 || !ReadReferences(allWindows.front()))
+        {
+            throw std::runtime_error("Failed to read the fit window " + TestData::GetBrORatioFitWindowFileSO2());
+        }
+        CFitWindow so2FitWindow = allWindows.front();
+
+        struct FitData
+        {
+            DoasFit doas;
+            CSpectrum sky;
+            std::vector<CSpectrum> spectra;
+            CSpectrum workspace;
+            DoasResult result;
+            FIT_TYPE fitType = FIT_TYPE::FIT_HP_DIV;
+        };
+        auto data = std::make_shared<FitData>();
+        data->fitType = so2FitWindow.fitType;
+
+        CSpectrum darkSpectrum;
+        fileHandler.GetDark(darkSpectrum);
+        fileHandler.GetSky(data->sky);
+        data->sky.Sub(darkSpectrum);
+        DoasFitPreparation::RemoveOffset(data->sky);
+        AddAsSky(so2FitWindow, DoasFitPreparation::PrepareSkySpectrum(data->sky, so2FitWindow.fitType), SHIFT_TYPE::SHIFT_FREE);
+        data->doas.Setup(so2FitWindow);
+
+        for (long spectrumIdx = 30; spectrumIdx < 50; ++spectrumIdx)
+        {
+            CSpectrum measuredSpectrum;
+            if (1 != fileHandler.GetSpectrum(context, measuredSpectrum, spectrumIdx))
+            {
+                throw std::runtime_error("Failed to read the spectra of " + scanFile);
+            }
+            measuredSpectrum.Sub(darkSpectrum);
+            data->spectra.push_back(measuredSpectrum);
+        }
+
+        BenchmarkOperation operation;
+        if (prepareInPlace)
+        {
+            // The in-place preparation overwrites the spectrum, hence each spectrum is first copied into the workspace.
+            operation.run = [data]() {
+                const IndexRange offsetRemovalRange{ 50, 200 };
+                double sum = 0.0;
+                for (const CSpectrum& spectrum : data->spectra)
+                {
+                    data->workspace = spectrum;
+                    DoasFitPreparation::PrepareMeasuredSpectrum(data->workspace, data->sky, data->fitType, offsetRemovalRange, data->workspace);
+                    data->doas.Run(data->workspace, data->result);
+                    sum += data->result.chiSquare;
+                }
+                return sum;
+            };
+        }
+        else
+        {
+            operation.run = [data]() {
+                double sum = 0.0;
+                for (const CSpectrum& spectrum : data->spectra)
+                {
+                    const std::vector<double> filteredMeasuredSpectrum = DoasFitPreparation::PrepareMeasuredSpectrum(spectrum, data->sky, data->fitType);
+                    data->doas.Run(filteredMeasuredSpectrum.data(), filteredMeasuredSpectrum.size(), data->result);
+                    sum += data->result.chiSquare;
+                }
+                return sum;
+            };
+        }
+        operation.itemsPerRun = (double)data->spectra.size();
+        operation.itemName = "spectra";
+
+        // The number of copies of the measured spectrum made by the preparation and the fit of each spectrum.
+        //  Preparing into a new vector makes one copy, preparing in place and fitting a view of the spectrum makes none
+        //  (the copy into the workspace above only restores the input and is not counted).
+        //  Before SpectrumView six copies were made, i.e. 98304 bytes for a spectrum with 2048 pixels.
+        const int copiesPerSpectrum = prepareInPlace ? 0 : 1;
+        operation.counters["bytesCopiedPerSpectrum"] = (double)(copiesPerSpectrum * data->spectra.front().m_length * (long)sizeof(double));
+        return operation;
+    }
+
+    void AddMicroBenchmarks(std::vector<Benchmark>& benchmarks)
+    {
+        benchmarks.push_back(Benchmark{ "MKPack::UnPack", "micro", SetupUnPack<double> });
+        benchmarks.push_back(Benchmark{ "MKPack::UnPack/int32", "micro", SetupUnPack<std::int32_t> });
+        benchmarks.push_back(Benchmark{ "MKPack::UnPack/Original", "micro", SetupUnPackOriginal });
+        benchmarks.push_back(Benchmark{ "CSpectrumIO::ReadNextSpectrum", "micro", SetupReadNextSpectrum });
+        benchmarks.push_back(Benchmark{ "CBasicMath::HighPassBinomial/2048px/500it", "micro", SetupHighPassBinomial });
+        benchmarks.push_back(Benchmark{ "ConvolveReference/Direct", "micro", []() { return SetupConvolveReference(ConvolutionMethod::Direct); } });
+        benchmarks.push_back(Benchmark{ "ConvolveReference/Fft", "micro", []() { return SetupConvolveReference(ConvolutionMethod::Fft); } });
+        benchmarks.push_back(Benchmark{ "CCubicSplineFunction::EvaluateSplineVector/2048px", "micro", SetupEvaluateSplineVector });
+        benchmarks.push_back(Benchmark{ "CLeastSquareFit::Minimize/polynomial5/2048px", "micro", SetupLeastSquareFit });
+        benchmarks.push_back(Benchmark{ "CountInliers/150keypoints", "micro", SetupCountInliers });
+
+        for (int length : { 512, 2048, 3648 })
+        {
+            const std::string pixels = std::to_string(length) + "px";
+            benchmarks.push_back(Benchmark{ "HighPassBinomial/Original/" + pixels + "/500it", "micro", [=]() { return SetupHighPassBinomialIterative(length); } });
+            benchmarks.push_back(Benchmark{ "BinomialFilter::HighPass/" + pixels + "/500it", "micro", [=]() { return SetupBinomialFilter(length, 64, false); } });
+            benchmarks.push_back(Benchmark{ "BinomialFilter::HighPass/64x" + pixels + "/500it", "micro", [=]() { return SetupBinomialFilter(length, 64, true); } });
+        }
+
+        for (int length : { 512, 2048, 3648 })
+        {
+            const std::string pixels = std::to_string(length) + "px";
+            benchmarks.push_back(Benchmark{ "Scattering::CalcRamanSpectrum/Original/" + pixels, "micro", [=]() { return SetupCalcRamanSpectrum(length); } });
+            benchmarks.push_back(Benchmark{ "RingSpectrumCalculator/Construction/" + pixels, "micro", [=]() { return SetupRingSpectrumCalculatorConstruction(length); } });
+            benchmarks.push_back(Benchmark{ "RingSpectrumCalculator::CalcRingSpectrum/" + pixels, "micro", [=]() { return SetupRingSpectrumCalculator(length); } });
+            benchmarks.push_back(Benchmark{ "Scattering::CalcRingSpectrum/" + pixels, "micro", [=]() { return SetupCalcRingSpectrum(length); } });
+        }
+
+        const char* instructionSetNames[] = { "Scalar", "SSE2", "AVX2" };
+        for (int pixels : { 150, 300, 500, 800 })
+        {
+            for (int instructionSet = MathFit::Kernels::SCALAR; instructionSet <= MathFit::Kernels::AVX2; ++instructionSet)
+            {
+                const auto set = static_cast<MathFit::Kernels::EInstructionSet>(instructionSet);
+                benchmarks.push_back(Benchmark{ "FitIteration/10references/" + std::to_string(pixels) + "px/" + instructionSetNames[instructionSet], "micro",
+                    [=]() { return SetupFitIteration(pixels, set); } });
+            }
+        }
+
+        benchmarks.push_back(Benchmark{ "ReadCrossSectionFile/SolarAtlas_330To350nm", "micro",
+            []() { return SetupReadCrossSectionFile([](const std::string& file, CCrossSectionData& result) { return ReadCrossSectionFile(file, result); }); } });
+        benchmarks.push_back(Benchmark{ "ReadCrossSectionFile/Fscanf/SolarAtlas_330To350nm", "micro", []() { return SetupReadCrossSectionFile(ReadCrossSectionFileUsingFscanf); } });
+        benchmarks.push_back(Benchmark{ "CCrossSectionData::ReadCrossSectionFile/SolarAtlas_330To350nm", "micro",
+            []() { return SetupReadCrossSectionFile([](const std::string& file, CCrossSectionData& result) { return 0 == result.ReadCrossSectionFile(file); }); } });
+        benchmarks.push_back(Benchmark{ "CCrossSectionData::ReadCrossSectionFile/Sscanf/SolarAtlas_330To350nm", "micro", []() { return SetupReadCrossSectionFile(ReadCrossSectionFileUsingSscanf); } });
+
+        benchmarks.push_back(Benchmark{ "DoasFit::Run/PreparedIntoVector/BrORatioScan1", "micro", []() { return SetupDoasFit(false); } });
+        benchmarks.push_back(Benchmark{ "DoasFit::Run/PreparedInPlace/BrORatioScan1", "micro", []() { return SetupDoasFit(true); } });
+    }
+}
@@ -0,0 +1,423 @@
+#include "Benchmark.h"
+#include <SpectralEvaluation/DateTime.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// ------------ The runner of the SpectralEvaluation benchmarks ------------
+// Runs all the benchmarks (or the ones whose name contains the --filter) and prints the timings.
+// With --json the results are also written as json, for comparing the performance between releases.
+// The benchmarks read the test data of the unit tests and must hence be run from the bin/Release directory.
+
+namespace novac
+{
+    void RequireTestDataFile(const std::string& fileName)
+    {
+        FILE* f = fopen(fileName.c_str(), "rb");
+        if (f == nullptr)
+        {
+            throw BenchmarkSkippedException("Missing test data file " + fileName);
+        }
+        fclose(f);
+    }
+
+    struct BenchmarkOptions
+    {
+        /** Only the benchmarks whose name contain this are run. */
+        std::string filter;
+
+        /** The file to write the results to, no json is written if this is empty. */
+        std::string jsonFileName;
+
+        /** The number of timed repetitions of each benchmark. */
+        int repetitions = 10;
+
+        /** The operation of a benchmark is called as many times as needed for one repetition to take at least this long. */
+        double minimumRepetitionTimeInSeconds = 0.05;
+
+        bool listOnly = false;
+    };
+
+    struct BenchmarkResult
+    {
+        std::string name;
+        std::string kind;
+
+        /** "ok", "skipped" or "failed". */
+        std::string status;
+
+        /** The reason why the benchmark was skipped or failed. */
+        std::string message;
+
+        /** The number of calls to the operation in each repetition. */
+        int iterations = 0;
+
+        /** The time taken by one call to the operation, in each of the repetitions, in nanoseconds. */
+        std::vector<double> timesInNanoseconds;
+
+        double itemsPerRun = 1.0;
+        std::string itemName;
+
+        /** The additional values reported by the operation, see BenchmarkOperation::counters. */
+        std::map<std::string, double> counters;
+
+        /** The value returned by the last call to the operation, this should not change between runs. */
+        double checksum = 0.0;
+    };
+
+    static double Median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        const size_t middle = values.size() / 2;
+        return (values.size() % 2 == 1) ? values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+    }
+
+    static double Mean(const std::vector<double>& values)
+    {
+        double sum = 0.0;
+        for (double value : values)
+        {
+            sum += value;
+        }
+        return sum / values.size();
+    }
+
+    static double StandardDeviation(const std::vector<double>& values)
+    {
+        const double mean = Mean(values);
+        double sum = 0.0;
+        for (double value : values)
+        {
+            sum += (value - mean) * (value - mean);
+        }
+        return (values.size() > 1) ? std::sqrt(sum / (values.size() - 1)) : 0.0;
+    }
+
+    // Calls the operation 'iterations' times and returns the time taken per call, in nanoseconds.
+    static double TimeOperation(const BenchmarkOperation& operation, int iterations, double& checksum)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int iteration = 0; iteration < iterations; ++iteration)
+        {
+            checksum = operation.run();
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+    }
+
+    static BenchmarkResult RunBenchmark(const Benchmark& benchmark, const BenchmarkOptions& options)
+    {
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        result.kind = benchmark.kind;
+
+        try
+        {
+            const BenchmarkOperation operation = benchmark.setup();
+            result.itemsPerRun = operation.itemsPerRun;
+            result.itemName = operation.itemName;
+            result.counters = operation.counters;
+
+            // The first call warms up the caches and decides the number of calls needed in each repetition.
+            const double firstTime = TimeOperation(operation, 1, result.checksum);
+            result.iterations = std::max(1, (int)std::ceil(1e9 * options.minimumRepetitionTimeInSeconds / std::max(firstTime, 1.0)));
+
+            for (int repetition = 0; repetition < options.repetitions; ++repetition)
+            {
+                result.timesInNanoseconds.push_back(TimeOperation(operation, result.iterations, result.checksum));
+            }
+            result.status = "ok";
+        }
+        catch (const BenchmarkSkippedException& e)
+        {
+            result.status = "skipped";
+            result.message = e.what();
+        }
+        catch (const std::exception& e)
+        {
+            result.status = "failed";
+            result.message = e.what();
+        }
+
+        return result;
+    }
+
+    static std::string FormatTime(double nanoseconds)
+    {
+        std::stringstream str;
+        str << std::fixed << std::setprecision(2);
+        if (nanoseconds < 1e3)
+        {
+            str << nanoseconds << " ns";
+        }
+        else if (nanoseconds < 1e6)
+        {
+            str << nanoseconds * 1e-3 << " us";
+        }
+        else if (nanoseconds < 1e9)
+        {
+            str << nanoseconds * 1e-6 << " ms";
+        }
+        else
+        {
+            str << nanoseconds * 1e-9 << " s";
+        }
+        return str.str();
+    }
+
+    static void PrintResult(const BenchmarkResult& result)
+    {
+        std::cout << std::left << std::setw(64) << result.name << std::right;
+        if (result.status != "ok")
+        {
+            std::cout << "  " << result.status << ": " << result.message << std::endl;
+            return;
+        }
+
+        const double median = Median(result.timesInNanoseconds);
+        const double minimum = *std::min_element(result.timesInNanoseconds.begin(), result.timesInNanoseconds.end());
+        std::cout << std::setw(14) << FormatTime(median)
+            << std::setw(14) << FormatTime(minimum)
+            << std::setw(16) << std::fixed << std::setprecision(1) << result.itemsPerRun * 1e9 / median << " " << result.itemName << "/s";
+        for (const auto& counter : result.counters)
+        {
+            std::cout << "  " << counter.first << "=" << counter.second;
+        }
+        std::cout << std::endl;
+    }
+
+    static std::string EscapeJson(const std::string& text)
+    {
+        std::stringstream str;
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"': str << "\\\""; break;
+            case '\\': str << "\\\\"; break;
+            case '\n': str << "\\n"; break;
+            case '\r': str << "\\r"; break;
+            case '\t': str << "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20)
+                {
+                    str << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+                }
+                else
+                {
+                    str << c;
+                }
+            }
+        }
+        return str.str();
+    }
+
+    // Json does not allow nan or infinity.
+    static std::string JsonNumber(double value)
+    {
+        if (!std::isfinite(value))
+        {
+            return "null";
+        }
+        std::stringstream str;
+        str << std::setprecision(10) << value;
+        return str.str();
+    }
+
+    static std::string CurrentUtcTime()
+    {
+        CDateTime now;
+        now.SetToNowUTC();
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02dZ", now.year, now.month, now.day, now.hour, now.minute, now.second);
+        return std::string(buffer);
+    }
+
+    static std::string CompilerVersion()
+    {
+#if defined(_MSC_VER)
+        return "MSVC " + std::to_string(_MSC_VER);
+#elif defined(__clang__)
+        return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        return std::string("gcc ") + __VERSION__;
+#else
+        return "unknown";
+#endif
+    }
+
+    static void WriteJson(std::ostream& out, const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options)
+    {
+#ifdef _OPENMP
+        const int numberOfThreads = omp_get_max_threads();
+#else
+        const int numberOfThreads = 1;
+#endif
+#ifdef NDEBUG
+        const char* buildType = "release";
+#else
+        const char* buildType = "debug";
+#endif
+
+        out << "{" << std::endl;
+        out << "  \"context\": {" << std::endl;
+        out << "    \"date\": \"" << CurrentUtcTime() << "\"," << std::endl;
+        out << "    \"compiler\": \"" << EscapeJson(CompilerVersion()) << "\"," << std::endl;
+        out << "    \"build\": \"" << buildType << "\"," << std::endl;
+        out << "    \"threads\": " << numberOfThreads << "," << std::endl;
+        out << "    \"repetitions\": " << options.repetitions << "," << std::endl;
+        out << "    \"minimumRepetitionTimeSeconds\": " << JsonNumber(options.minimumRepetitionTimeInSeconds) << std::endl;
+        out << "  }," << std::endl;
+        out << "  \"benchmarks\": [";
+
+        for (size_t ii = 0; ii < results.size(); ++ii)
+        {
+            const BenchmarkResult& result = results[ii];
+            out << ((ii == 0) ? "" : ",") << std::endl;
+            out << "    {" << std::endl;
+            out << "      \"name\": \"" << EscapeJson(result.name) << "\"," << std::endl;
+            out << "      \"kind\": \"" << result.kind << "\"," << std::endl;
+            if (result.status != "ok")
+            {
+                out << "      \"status\": \"" << result.status << "\"," << std::endl;
+                out << "      \"message\": \"" << EscapeJson(result.message) << "\"" << std::endl;
+                out << "    }";
+                continue;
+            }
+
+            const double median = Median(result.timesInNanoseconds);
+            out << "      \"status\": \"ok\"," << std::endl;
+            out << "      \"iterations\": " << result.iterations << "," << std::endl;
+            out << "      \"repetitions\": " << result.timesInNanoseconds.size() << "," << std::endl;
+            out << "      \"timeUnit\": \"ns\"," << std::endl;
+            out << "      \"median\": " << JsonNumber(median) << "," << std::endl;
+            out << "      \"mean\": " << JsonNumber(Mean(result.timesInNanoseconds)) << "," << std::endl;
+            out << "      \"min\": " << JsonNumber(*std::min_element(result.timesInNanoseconds.begin(), result.timesInNanoseconds.end())) << "," << std::endl;
+            out << "      \"max\": " << JsonNumber(*std::max_element(result.timesInNanoseconds.begin(), result.timesInNanoseconds.end())) << "," << std::endl;
+            out << "      \"stddev\": " << JsonNumber(StandardDeviation(result.timesInNanoseconds)) << "," << std::endl;
+            out << "      \"itemsPerRun\": " << JsonNumber(result.itemsPerRun) << "," << std::endl;
+            out << "      \"itemName\": \"" << EscapeJson(result.itemName) << "\"," << std::endl;
+            out << "      \"itemsPerSecond\": " << JsonNumber(result.itemsPerRun * 1e9 / median) << "," << std::endl;
+            if (result.counters.size() > 0)
+            {
+                out << "      \"counters\": {";
+                bool firstCounter = true;
+                for (const auto& counter : result.counters)
+                {
+                    out << (firstCounter ? " " : ", ") << "\"" << EscapeJson(counter.first) << "\": " << JsonNumber(counter.second);
+                    firstCounter = false;
+                }
+                out << " }," << std::endl;
+            }
+            out << "      \"checksum\": " << JsonNumber(result.checksum) << std::endl;
+            out << "    }";
+        }
+
+        out << std::endl << "  ]" << std::endl;
+        out << "}" << std::endl;
+    }
+
+    static void PrintUsage()
+    {
+        std::cout << "Usage: SpectralEvaluationBenchmarks [options]" << std::endl;
+        std::cout << "  --filter <text>       Only run the benchmarks whose name contains <text>" << std::endl;
+        std::cout << "  --json <file>         Write the results as json to <file>" << std::endl;
+        std::cout << "  --repetitions <n>     The number of timed repetitions of each benchmark (default 10)" << std::endl;
+        std::cout << "  --min-time <seconds>  The shortest time of one repetition (default 0.05)" << std::endl;
+        std::cout << "  --list                List the benchmarks without running them" << std::endl;
+        std::cout << "The benchmarks read the test data in ../TestData/ and must be run from the bin/Release directory." << std::endl;
+    }
+
+    static bool ParseArguments(int argc, char* argv[], BenchmarkOptions& options)
+    {
+        for (int ii = 1; ii < argc; ++ii)
+        {
+            const std::string argument = argv[ii];
+            const bool hasValue = ii + 1 < argc;
+            if (argument == "--filter" && hasValue)
+            {
+                options.filter = argv[++ii];
+            }
+            else if (argument == "--json" && hasValue)
+            {
+                options.jsonFileName = argv[++ii];
+            }
+            else if (argument == "--repetitions" && hasValue)
+            {
+                options.repetitions = std::max(1, std::atoi(argv[++ii]));
+            }
+            else if (argument == "--min-time" && hasValue)
+            {
+                options.minimumRepetitionTimeInSeconds = std::max(0.0, std::atof(argv[++ii]));
+            }
+            else if (argument == "--list")
+            {
+                options.listOnly = true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace novac;
+
+    BenchmarkOptions options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::vector<Benchmark> benchmarks;
+    AddMicroBenchmarks(benchmarks);
+    AddMacroBenchmarks(benchmarks);
+
+    std::vector<BenchmarkResult> results;
+    bool anyFailed = false;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (benchmark.name.find(options.filter) == std::string::npos)
+        {
+            continue;
+        }
+        if (options.listOnly)
+        {
+            std::cout << benchmark.kind << "\t" << benchmark.name << std::endl;
+            continue;
+        }
+
+        results.push_back(RunBenchmark(benchmark, options));
+        PrintResult(results.back());
+        anyFailed |= (results.back().status == "failed");
+    }
+
+    if (!options.jsonFileName.empty() && !options.listOnly)
+    {
+        std::ofstream jsonFile(options.jsonFileName);
+        if (!jsonFile.is_open())
+        {
+            std::cout << "Failed to open " << options.jsonFileName << " for writing" << std::endl;
+            return 1;
+        }
+        WriteJson(jsonFile, results, options);
+    }
+
+    return anyFailed ? 1 : 0;
+}
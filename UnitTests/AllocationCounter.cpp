@@ -0,0 +1,77 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// The global operator new and delete are replaced for the entire program, hence this is only linked into SpectralEvaluationAllocationTests.
+//  The allocations are only counted while an AllocationCounter exists.
+
+namespace
+{
+std::atomic<bool> countAllocations{ false };
+std::atomic<size_t> numberOfAllocations{ 0 };
+
+void* Allocate(std::size_t size)
+{
+    if (countAllocations.load(std::memory_order_relaxed))
+    {
+        numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+}
+
+void* operator new(std::size_t size)
+{
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return Allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace novac
+{
+AllocationCounter::AllocationCounter()
+{
+    numberOfAllocations = 0;
+    countAllocations = true;
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    countAllocations = false;
+}
+
+size_t AllocationCounter::NumberOfAllocations() const
+{
+    return numberOfAllocations.load();
+}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+// ------------ This file contains a helper for counting the number of heap allocations made by the code under test ------------
+
+namespace novac
+{
+/** Counts the number of calls to the global operator new (and new[]) made while the counter is alive.
+    Only one counter may be alive at a time. */
+class AllocationCounter
+{
+public:
+    AllocationCounter();
+    ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    /** @return the number of allocations made since this counter was created. */
+    size_t NumberOfAllocations() const;
+};
+}
@@ -0,0 +1,170 @@
+#include <SpectralEvaluation/Evaluation/CrossSectionCache.h>
+#include <SpectralEvaluation/Evaluation/CrossSectionData.h>
+#include <SpectralEvaluation/Calibration/FraunhoferSpectrumGeneration.h>
+#include <SpectralEvaluation/Spectra/WavelengthRange.h>
+#include "catch.hpp"
+#include "TestData.h"
+#include <cstring>
+#include <thread>
+#include <stdio.h>
+
+namespace novac
+{
+    static void WriteCrossSectionFile(const std::string& fileName, const char* contents)
+    {
+        FILE* f = fopen(fileName.c_str(), "wb");
+        REQUIRE(f != nullptr);
+        fwrite(contents, 1, strlen(contents), f);
+        fclose(f);
+    }
+
+    TEST_CASE("CrossSectionCache Get", "[CrossSectionCache][IntegrationTest]")
+    {
+        CrossSectionCache sut;
+
+        SECTION("File does not exist, returns nullptr")
+        {
+            const auto result = sut.Get(TestData::GetTestDataDirectory() + "NonExistingCrossSection.xs");
+
+            REQUIRE(result == nullptr);
+            REQUIRE(sut.MemoryUsage() == 0);
+        }
+
+        SECTION("File is not a cross section, returns nullptr")
+        {
+            WriteCrossSectionFile(TestData::GetTemporaryTextFileName(), "not a cross section\n");
+
+            const auto result = sut.Get(TestData::GetTemporaryTextFileName());
+
+            REQUIRE(result == nullptr);
+            REQUIRE(sut.MemoryUsage() == 0);
+        }
+
+        SECTION("Returns same data as ReadCrossSectionFile")
+        {
+            CCrossSectionData expected;
+            REQUIRE(0 == expected.ReadCrossSectionFile(TestData::GetHighResolutionSO2CrossSectionFile()));
+
+            const auto result = sut.Get(TestData::GetHighResolutionSO2CrossSectionFile());
+
+            REQUIRE(result != nullptr);
+            REQUIRE(result->m_waveLength == expected.m_waveLength);
+            REQUIRE(result->m_crossSection == expected.m_crossSection);
+            REQUIRE(sut.MemoryUsage() > 0);
+        }
+
+        SECTION("Same file requested twice, file is only read once")
+        {
+            const auto first = sut.Get(TestData::GetHighResolutionSO2CrossSectionFile());
+            const auto second = sut.Get(TestData::GetHighResolutionSO2CrossSectionFile());
+
+            REQUIRE(first != nullptr);
+            REQUIRE(first == second);
+            REQUIRE(sut.NumberOfFileReads() == 1);
+        }
+
+        SECTION("File changed on disk, file is read again")
+        {
+            WriteCrossSectionFile(TestData::GetTemporaryTextFileName(), "300.0\t1.0\n301.0\t2.0\n");
+            const auto first = sut.Get(TestData::GetTemporaryTextFileName());
+
+            WriteCrossSectionFile(TestData::GetTemporaryTextFileName(), "300.0\t1.0\n301.0\t2.0\n302.0\t3.0\n");
+            const auto second = sut.Get(TestData::GetTemporaryTextFileName());
+
+            REQUIRE(first != nullptr);
+            REQUIRE(first->m_crossSection.size() == 2);
+            REQUIRE(second != nullptr);
+            REQUIRE(second->m_crossSection.size() == 3);
+            REQUIRE(sut.NumberOfFileReads() == 2);
+        }
+
+        SECTION("Same file requested from several threads, file is only read once")
+        {
+            std::vector<std::shared_ptr<const CCrossSectionData>> results(8);
+            std::vector<std::thread> threads;
+            for (size_t ii = 0; ii < results.size(); ++ii)
+            {
+                threads.push_back(std::thread([&, ii]() { results[ii] = sut.Get(TestData::GetSolarAtlasFile_330To350nm()); }));
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            REQUIRE(results[0] != nullptr);
+            for (const auto& result : results)
+            {
+                REQUIRE(result == results[0]);
+            }
+            REQUIRE(sut.NumberOfFileReads() == 1);
+        }
+
+        SECTION("Clear, file is read again")
+        {
+            sut.Get(TestData::GetHighResolutionSO2CrossSectionFile());
+            sut.Clear();
+
+            REQUIRE(sut.MemoryUsage() == 0);
+            REQUIRE(sut.Get(TestData::GetHighResolutionSO2CrossSectionFile()) != nullptr);
+            REQUIRE(sut.NumberOfFileReads() == 1);
+        }
+    }
+
+    TEST_CASE("CrossSectionCache memory budget", "[CrossSectionCache][IntegrationTest]")
+    {
+        CrossSectionCache sut;
+        const auto so2CrossSection = sut.Get(TestData::GetHighResolutionSO2CrossSectionFile());
+        REQUIRE(so2CrossSection != nullptr);
+        const size_t memoryUsageOfOneFile = sut.MemoryUsage();
+
+        SECTION("Budget exceeded, least recently used file is removed")
+        {
+            sut.SetMemoryBudget(memoryUsageOfOneFile + 16);
+
+            const auto solarAtlas = sut.Get(TestData::GetSolarAtlasFile_330To350nm());
+            REQUIRE(solarAtlas != nullptr);
+            REQUIRE(sut.NumberOfFileReads() == 2);
+
+            // The so2 cross section has been removed from the cache, but is still kept alive by the caller.
+            REQUIRE(so2CrossSection->m_crossSection.size() > 0);
+            const auto so2CrossSectionAgain = sut.Get(TestData::GetHighResolutionSO2CrossSectionFile());
+            REQUIRE(so2CrossSectionAgain != so2CrossSection);
+            REQUIRE(so2CrossSectionAgain->m_crossSection == so2CrossSection->m_crossSection);
+            REQUIRE(sut.NumberOfFileReads() == 3);
+        }
+
+        SECTION("Budget reduced, cross sections are removed")
+        {
+            sut.SetMemoryBudget(0);
+
+            REQUIRE(sut.MemoryUsage() == 0);
+            REQUIRE(sut.Get(TestData::GetHighResolutionSO2CrossSectionFile()) != so2CrossSection);
+        }
+
+        SECTION("Budget not exceeded, all files are kept")
+        {
+            sut.Get(TestData::GetSolarAtlasFile_330To350nm());
+            sut.Get(TestData::GetHighResolutionSO2CrossSectionFile());
+            sut.Get(TestData::GetSolarAtlasFile_330To350nm());
+
+            REQUIRE(sut.NumberOfFileReads() == 2);
+        }
+    }
+
+    TEST_CASE("FraunhoferSpectrumGeneration several instances with same solar atlas, solar atlas is only read once", "[CrossSectionCache][FraunhoferSpectrumGeneration][IntegrationTest]")
+    {
+        CrossSectionCache::GetInstance().Clear();
+        const std::vector<std::pair<std::string, double>> noCrossSections;
+        const std::vector<double> wavelengthCalibration{ 320.0, 330.0, 340.0, 350.0, 360.0 };
+
+        FraunhoferSpectrumGeneration first(TestData::GetSolarAtlasFile_330To350nm(), noCrossSections);
+        FraunhoferSpectrumGeneration second(TestData::GetSolarAtlasFile_330To350nm(), noCrossSections);
+
+        const auto firstRange = first.GetFraunhoferRange(wavelengthCalibration);
+        const auto secondRange = second.GetFraunhoferRange(wavelengthCalibration);
+
+        REQUIRE(firstRange.low == secondRange.low);
+        REQUIRE(firstRange.high == secondRange.high);
+        REQUIRE(CrossSectionCache::GetInstance().NumberOfFileReads() == 1);
+    }
+}
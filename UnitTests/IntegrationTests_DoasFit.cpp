@@ -81,7 +81,7 @@ TEST_CASE("DoasFit - IntegrationTest with good scan - scan file 1", "[DoasFit][I
         so2FitWindow.fitType = FIT_TYPE::FIT_HP_DIV;
         for (int refIdx = 0; refIdx < so2FitWindow.nRef; ++refIdx)
         {
-            HighPassFilter(*so2FitWindow.ref[refIdx].m_data, false);
+            HighPassFilter(so2FitWindow.ref[refIdx].MutableData(), false);
         }
 
         // Setup the DOAS Fit
@@ -121,7 +121,7 @@ TEST_CASE("DoasFit - IntegrationTest with good scan - scan file 1", "[DoasFit][I
         so2FitWindow.fitType = FIT_TYPE::FIT_HP_SUB;
         for (int refIdx = 0; refIdx < so2FitWindow.nRef; ++refIdx)
         {
-            HighPassFilter(*so2FitWindow.ref[refIdx].m_data, false);
+            HighPassFilter(so2FitWindow.ref[refIdx].MutableData(), false);
         }
 
         // Setup the DOAS Fit
@@ -160,3 +160,231 @@ TEST_CASE("DoasFit - IntegrationTest with good scan - scan file 1", "[DoasFit][I
         REQUIRE(std::abs(result.referenceResult[2].columnError) < std::numeric_limits<double>::epsilon());
     }
 }
+
+TEST_CASE("DoasFit - RunBatch gives identical result as Run - scan file 1", "[DoasFit][IntegrationTest]")
+{
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    novac::CScanFileHandler fileHandler(log);
+    const bool scanFileIsOk = fileHandler.CheckScanFile(context, TestData::GetBrORatioScanFile1());
+    REQUIRE(scanFileIsOk); // check assumption on the setup
+
+    CFitWindowFileHandler fitWindowFileHandler;
+    auto allWindows = fitWindowFileHandler.ReadFitWindowFile(TestData::GetBrORatioFitWindowFileSO2());
+    REQUIRE(allWindows.size() == 1);
+    auto so2FitWindow = allWindows.front();
+    REQUIRE(true == ReadReferences(so2FitWindow));
+
+    CSpectrum darkSpectrum;
+    fileHandler.GetDark(darkSpectrum);
+    CSpectrum skySpectrum;
+    fileHandler.GetSky(skySpectrum);
+    skySpectrum.Sub(darkSpectrum);
+    DoasFitPreparation::RemoveOffset(skySpectrum);
+
+    auto filteredSkySpectrum = DoasFitPreparation::PrepareSkySpectrum(skySpectrum, so2FitWindow.fitType);
+    AddAsSky(so2FitWindow, filteredSkySpectrum, SHIFT_TYPE::SHIFT_FREE);
+
+    // Prepare a number of the spectra in the scan
+    std::vector<std::vector<double>> filteredMeasuredData;
+    for (int spectrumIdx = 36; spectrumIdx < 48; ++spectrumIdx)
+    {
+        CSpectrum measuredSpectrum;
+        REQUIRE(1 == fileHandler.GetSpectrum(context, measuredSpectrum, static_cast<long>(spectrumIdx)));
+        measuredSpectrum.Sub(darkSpectrum);
+        filteredMeasuredData.push_back(DoasFitPreparation::PrepareMeasuredSpectrum(measuredSpectrum, skySpectrum, so2FitWindow.fitType));
+    }
+    std::vector<const double*> measuredData;
+    for (const auto& spectrum : filteredMeasuredData)
+    {
+        measuredData.push_back(spectrum.data());
+    }
+    const size_t spectrumLength = filteredMeasuredData.front().size();
+
+    DoasFit sut;
+    sut.Setup(so2FitWindow);
+
+    // Act
+    std::vector<DoasResult> batchResult;
+    sut.RunBatch(measuredData, spectrumLength, batchResult);
+
+    // Assert
+    REQUIRE(batchResult.size() == measuredData.size());
+    for (size_t spectrumIdx = 0; spectrumIdx < measuredData.size(); ++spectrumIdx)
+    {
+        DoasFit serialFit;
+        serialFit.Setup(so2FitWindow);
+        DoasResult serialResult;
+        serialFit.Run(measuredData[spectrumIdx], spectrumLength, serialResult);
+
+        const DoasResult& result = batchResult[spectrumIdx];
+        REQUIRE(result.iterations == serialResult.iterations);
+        REQUIRE(result.chiSquare == serialResult.chiSquare);
+        REQUIRE(result.residual == serialResult.residual);
+        REQUIRE(result.polynomialCoefficients == serialResult.polynomialCoefficients);
+        REQUIRE(result.referenceResult.size() == serialResult.referenceResult.size());
+        for (size_t refIdx = 0; refIdx < result.referenceResult.size(); ++refIdx)
+        {
+            REQUIRE(result.referenceResult[refIdx].name == serialResult.referenceResult[refIdx].name);
+            REQUIRE(result.referenceResult[refIdx].column == serialResult.referenceResult[refIdx].column);
+            REQUIRE(result.referenceResult[refIdx].columnError == serialResult.referenceResult[refIdx].columnError);
+            REQUIRE(result.referenceResult[refIdx].shift == serialResult.referenceResult[refIdx].shift);
+            REQUIRE(result.referenceResult[refIdx].squeeze == serialResult.referenceResult[refIdx].squeeze);
+        }
+    }
+
+    // Running the batch a second time must give the same result again.
+    std::vector<DoasResult> secondBatchResult;
+    sut.RunBatch(measuredData, spectrumLength, secondBatchResult);
+    REQUIRE(secondBatchResult.size() == batchResult.size());
+    for (size_t spectrumIdx = 0; spectrumIdx < batchResult.size(); ++spectrumIdx)
+    {
+        REQUIRE(secondBatchResult[spectrumIdx].chiSquare == batchResult[spectrumIdx].chiSquare);
+        REQUIRE(secondBatchResult[spectrumIdx].referenceResult[0].column == batchResult[spectrumIdx].referenceResult[0].column);
+    }
+}
+
+TEST_CASE("DoasFit - Linear fit with fixed shift and squeeze gives same result as iterative fit - scan file 1", "[DoasFit][IntegrationTest]")
+{
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    novac::CScanFileHandler fileHandler(log);
+    const bool scanFileIsOk = fileHandler.CheckScanFile(context, TestData::GetBrORatioScanFile1());
+    REQUIRE(scanFileIsOk); // check assumption on the setup
+
+    CFitWindowFileHandler fitWindowFileHandler;
+    auto allWindows = fitWindowFileHandler.ReadFitWindowFile(TestData::GetBrORatioFitWindowFileSO2());
+    REQUIRE(allWindows.size() == 1);
+    auto linearFitWindow = allWindows.front();
+    REQUIRE(true == ReadReferences(linearFitWindow));
+
+    CSpectrum darkSpectrum;
+    fileHandler.GetDark(darkSpectrum);
+    CSpectrum skySpectrum;
+    fileHandler.GetSky(skySpectrum);
+    skySpectrum.Sub(darkSpectrum);
+    DoasFitPreparation::RemoveOffset(skySpectrum);
+    CSpectrum measuredSpectrum;
+    fileHandler.GetSpectrum(context, 42, measuredSpectrum);
+    measuredSpectrum.Sub(darkSpectrum);
+
+    auto filteredSkySpectrum = DoasFitPreparation::PrepareSkySpectrum(skySpectrum, linearFitWindow.fitType);
+    AddAsSky(linearFitWindow, filteredSkySpectrum, SHIFT_TYPE::SHIFT_FIX);
+    auto filteredMeasuredData = DoasFitPreparation::PrepareMeasuredSpectrum(measuredSpectrum, skySpectrum, linearFitWindow.fitType);
+
+    // Fix the shift and squeeze of all references, this makes the fit linear.
+    for (int refIdx = 0; refIdx < linearFitWindow.nRef; ++refIdx)
+    {
+        linearFitWindow.ref[refIdx].m_shiftOption = SHIFT_TYPE::SHIFT_FIX;
+        linearFitWindow.ref[refIdx].m_shiftValue = 0.1 * refIdx;
+        linearFitWindow.ref[refIdx].m_squeezeOption = SHIFT_TYPE::SHIFT_FIX;
+        linearFitWindow.ref[refIdx].m_squeezeValue = 1.0;
+    }
+
+    // The same fit where the shift and squeeze of the second reference are linked to the first.
+    //  This has no free non-linear parameter either but is evaluated using the iterative fit.
+    CFitWindow iterativeFitWindow = linearFitWindow;
+    linearFitWindow.ref[1].m_shiftValue = 0.0;
+    iterativeFitWindow.ref[1].m_shiftOption = SHIFT_TYPE::SHIFT_LINK;
+    iterativeFitWindow.ref[1].m_shiftValue = 0.0;
+    iterativeFitWindow.ref[1].m_squeezeOption = SHIFT_TYPE::SHIFT_LINK;
+    iterativeFitWindow.ref[1].m_squeezeValue = 0.0;
+
+    DoasFit linearFit;
+    linearFit.Setup(linearFitWindow);
+    DoasFit iterativeFit;
+    iterativeFit.Setup(iterativeFitWindow);
+
+    // Act
+    DoasResult linearResult;
+    linearFit.Run(filteredMeasuredData.data(), filteredMeasuredData.size(), linearResult);
+    DoasResult iterativeResult;
+    iterativeFit.Run(filteredMeasuredData.data(), filteredMeasuredData.size(), iterativeResult);
+
+    // Assert
+    REQUIRE(linearResult.fitLow == iterativeResult.fitLow);
+    REQUIRE(linearResult.fitHigh == iterativeResult.fitHigh);
+    REQUIRE(linearResult.iterations == 0);
+    REQUIRE(std::abs(linearResult.chiSquare - iterativeResult.chiSquare) < 1e-6 * iterativeResult.chiSquare);
+    REQUIRE(std::abs(linearResult.delta - iterativeResult.delta) < 1e-6 * iterativeResult.delta);
+    REQUIRE(linearResult.residual.size() == iterativeResult.residual.size());
+    REQUIRE(linearResult.polynomialValues.size() == iterativeResult.polynomialValues.size());
+    for (size_t ii = 0; ii < linearResult.residual.size(); ++ii)
+    {
+        REQUIRE(std::abs(linearResult.residual[ii] - iterativeResult.residual[ii]) < 1e-6 * iterativeResult.delta);
+        REQUIRE(std::abs(linearResult.polynomialValues[ii] - iterativeResult.polynomialValues[ii]) < 1e-6 * std::abs(iterativeResult.polynomialValues[ii]));
+    }
+
+    REQUIRE(linearResult.referenceResult.size() == iterativeResult.referenceResult.size());
+    for (size_t refIdx = 0; refIdx < linearResult.referenceResult.size(); ++refIdx)
+    {
+        const auto& linear = linearResult.referenceResult[refIdx];
+        const auto& iterative = iterativeResult.referenceResult[refIdx];
+        REQUIRE(linear.name == iterative.name);
+        REQUIRE(std::abs(linear.column - iterative.column) < 1e-6 * std::abs(iterative.column));
+        REQUIRE(std::abs(linear.columnError - iterative.columnError) <= 1e-6 * std::abs(iterative.columnError));
+        REQUIRE(linear.shift == iterative.shift);
+        REQUIRE(linear.squeeze == iterative.squeeze);
+        REQUIRE(linear.scaledValues.size() == iterative.scaledValues.size());
+        for (size_t ii = 0; ii < linear.scaledValues.size(); ++ii)
+        {
+            REQUIRE(std::abs(linear.scaledValues[ii] - iterative.scaledValues[ii]) <= 1e-6 * std::abs(iterative.scaledValues[ii]) + 1e-12);
+        }
+    }
+}
+
+TEST_CASE("DoasFit - Run on spectrum prepared in place gives identical result as Run on prepared copy - scan file 1", "[DoasFit][IntegrationTest]")
+{
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    novac::CScanFileHandler fileHandler(log);
+    const bool scanFileIsOk = fileHandler.CheckScanFile(context, TestData::GetBrORatioScanFile1());
+    REQUIRE(scanFileIsOk); // check assumption on the setup
+
+    CFitWindowFileHandler fitWindowFileHandler;
+    auto allWindows = fitWindowFileHandler.ReadFitWindowFile(TestData::GetBrORatioFitWindowFileSO2());
+    REQUIRE(allWindows.size() == 1);
+    auto so2FitWindow = allWindows.front();
+    REQUIRE(true == ReadReferences(so2FitWindow));
+
+    CSpectrum darkSpectrum;
+    fileHandler.GetDark(darkSpectrum);
+    CSpectrum skySpectrum;
+    fileHandler.GetSky(skySpectrum);
+    skySpectrum.Sub(darkSpectrum);
+    DoasFitPreparation::RemoveOffset(skySpectrum);
+
+    auto filteredSkySpectrum = DoasFitPreparation::PrepareSkySpectrum(skySpectrum, so2FitWindow.fitType);
+    AddAsSky(so2FitWindow, filteredSkySpectrum, SHIFT_TYPE::SHIFT_FREE);
+
+    CSpectrum measuredSpectrum;
+    fileHandler.GetSpectrum(context, 42, measuredSpectrum);
+    measuredSpectrum.Sub(darkSpectrum);
+
+    DoasFit sut;
+    sut.Setup(so2FitWindow);
+
+    DoasResult expectedResult;
+    const std::vector<double> filteredMeasuredData = DoasFitPreparation::PrepareMeasuredSpectrum(measuredSpectrum, skySpectrum, so2FitWindow.fitType);
+    sut.Run(filteredMeasuredData.data(), filteredMeasuredData.size(), expectedResult);
+
+    // Act, prepare the measured spectrum in place and fit the data of the spectrum itself.
+    DoasFitPreparation::PrepareMeasuredSpectrum(measuredSpectrum, skySpectrum, so2FitWindow.fitType, IndexRange{ 50, 200 }, measuredSpectrum);
+    DoasResult result;
+    DoasFit secondFit;
+    secondFit.Setup(so2FitWindow);
+    secondFit.Run(measuredSpectrum, result);
+
+    // Assert
+    REQUIRE(filteredMeasuredData == std::vector<double>(measuredSpectrum.m_data, measuredSpectrum.m_data + measuredSpectrum.m_length));
+    REQUIRE(result.iterations == expectedResult.iterations);
+    REQUIRE(result.chiSquare == expectedResult.chiSquare);
+    REQUIRE(result.residual == expectedResult.residual);
+    REQUIRE(result.measuredSpectrum == expectedResult.measuredSpectrum);
+    REQUIRE(result.referenceResult.size() == expectedResult.referenceResult.size());
+    for (size_t refIdx = 0; refIdx < result.referenceResult.size(); ++refIdx)
+    {
+        REQUIRE(result.referenceResult[refIdx].column == expectedResult.referenceResult[refIdx].column);
+        REQUIRE(result.referenceResult[refIdx].shift == expectedResult.referenceResult[refIdx].shift);
+    }
+}
@@ -0,0 +1,160 @@
+#include <SpectralEvaluation/File/SpectrumIO.h>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <SpectralEvaluation/Evaluation/EvaluationBase.h>
+#include "catch.hpp"
+#include "TestData.h"
+#include "AllocationCounter.h"
+
+// The tests in this file count the heap allocations made by the code under test, by replacing the global operator new.
+//  They are hence built into their own executable, SpectralEvaluationAllocationTests, such that the replacement does not affect the other tests.
+
+namespace novac
+{
+
+//Region Helper methods
+static CFitWindow PrepareFitWindow()
+{
+    const auto references = TestData::GetReferences_2009175M1();
+    REQUIRE(3 == references.size()); // Assumption here
+
+    CFitWindow window;
+    window.fitLow = 475;
+    window.fitHigh = 643;
+    window.fitType = novac::FIT_TYPE::FIT_HP_DIV;
+    window.nRef = (int)references.size();
+    int refIdx = 0;
+    for (auto& reference : references)
+    {
+        window.ref[refIdx].m_path = reference;
+        window.ref[refIdx].m_columnOption = novac::SHIFT_TYPE::SHIFT_FREE;
+        window.ref[refIdx].m_shiftOption = novac::SHIFT_TYPE::SHIFT_FIX;
+        window.ref[refIdx].m_shiftValue = 0.0;
+        window.ref[refIdx].m_squeezeOption = novac::SHIFT_TYPE::SHIFT_FIX;
+        window.ref[refIdx].m_squeezeValue = 1.0;
+
+        int retCode = window.ref[refIdx].ReadCrossSectionDataFromFile();
+        REQUIRE(retCode == 0);
+
+        ++refIdx;
+    }
+
+    return window;
+}
+
+static CSpectrum ReadSpectrumNumber(const std::string& scanFile, int number)
+{
+    CSpectrumIO reader;
+
+    CSpectrum spectrum;
+    bool success = reader.ReadSpectrum(scanFile, number, spectrum);
+    REQUIRE(success);
+    spectrum.Div(spectrum.NumSpectra());
+
+    return spectrum;
+}
+
+static CSpectrum ReadSkySpectrum(const std::string& scanFile)
+{
+    return ReadSpectrumNumber(scanFile, 0);
+}
+
+static CSpectrum ReadDarkSpectrum(const std::string& scanFile)
+{
+    return ReadSpectrumNumber(scanFile, 1);
+}
+
+//endregion
+
+TEST_CASE("Evaluate with linear fit does not allocate memory when evaluating with the same fit window again", "[Evaluate][EvaluationBase][FitWorkspace]")
+{
+    const auto scanFile = TestData::GetMeasuredSpectrumName_2009175M1();
+
+    novac::ConsoleLog log;
+    CFitWindow window = PrepareFitWindow();
+
+    CEvaluationBase sut(log);
+    sut.SetFitWindow(window);
+
+    CSpectrum skySpectrum = ReadSkySpectrum(scanFile);
+    CSpectrum darkSpectrum = ReadDarkSpectrum(scanFile);
+    CSpectrum firstSpectrum = ReadSpectrumNumber(scanFile, 8);
+    CSpectrum secondSpectrum = ReadSpectrumNumber(scanFile, 21);
+    skySpectrum.Sub(darkSpectrum);
+    firstSpectrum.Sub(darkSpectrum);
+    secondSpectrum.Sub(darkSpectrum);
+    sut.SetSkySpectrum(skySpectrum);
+
+    // The first evaluation sets up the workspace.
+    REQUIRE(0 == sut.Evaluate(firstSpectrum));
+    const double firstColumn = sut.m_result.m_referenceResult[0].m_column;
+    REQUIRE(0 == sut.Evaluate(secondSpectrum));
+    const double secondColumn = sut.m_result.m_referenceResult[0].m_column;
+
+    // Act
+    int returnCode = 0;
+    double firstColumnAgain = 0.0;
+    double secondColumnAgain = 0.0;
+    size_t numberOfAllocations = 0;
+    {
+        AllocationCounter counter;
+
+        returnCode += sut.Evaluate(firstSpectrum);
+        firstColumnAgain = sut.m_result.m_referenceResult[0].m_column;
+
+        returnCode += sut.Evaluate(secondSpectrum);
+        secondColumnAgain = sut.m_result.m_referenceResult[0].m_column;
+
+        numberOfAllocations = counter.NumberOfAllocations();
+    }
+
+    // Assert
+    REQUIRE(0 == returnCode);
+    REQUIRE(0 == numberOfAllocations);
+    REQUIRE(firstColumnAgain == Approx(firstColumn).epsilon(1e-9));
+    REQUIRE(secondColumnAgain == Approx(secondColumn).epsilon(1e-9));
+}
+
+TEST_CASE("Evaluate with nonlinear fit does not allocate memory when evaluating with the same fit window again", "[Evaluate][EvaluationBase][FitWorkspace]")
+{
+    const auto scanFile = TestData::GetMeasuredSpectrumName_2009175M1();
+
+    novac::ConsoleLog log;
+    CFitWindow window = PrepareFitWindow();
+    window.ref[0].m_shiftOption = novac::SHIFT_TYPE::SHIFT_FREE;
+
+    CEvaluationBase sut(log);
+    sut.SetFitWindow(window);
+
+    CSpectrum skySpectrum = ReadSkySpectrum(scanFile);
+    CSpectrum darkSpectrum = ReadDarkSpectrum(scanFile);
+    CSpectrum firstSpectrum = ReadSpectrumNumber(scanFile, 8);
+    CSpectrum secondSpectrum = ReadSpectrumNumber(scanFile, 21);
+    skySpectrum.Sub(darkSpectrum);
+    firstSpectrum.Sub(darkSpectrum);
+    secondSpectrum.Sub(darkSpectrum);
+    sut.SetSkySpectrum(skySpectrum);
+
+    // The first evaluation sets up the workspace.
+    // Notice that the fitted shift is used as starting point for the next evaluation,
+    //  hence the results are not compared between the evaluations here.
+    REQUIRE(0 == sut.Evaluate(firstSpectrum));
+    REQUIRE(0 == sut.Evaluate(secondSpectrum));
+
+    // Act
+    int returnCode = 0;
+    size_t numberOfAllocations = 0;
+    {
+        AllocationCounter counter;
+
+        returnCode += sut.Evaluate(firstSpectrum);
+        returnCode += sut.Evaluate(secondSpectrum);
+
+        numberOfAllocations = counter.NumberOfAllocations();
+    }
+
+    // Assert
+    REQUIRE(0 == returnCode);
+    REQUIRE(0 == numberOfAllocations);
+}
+
+}
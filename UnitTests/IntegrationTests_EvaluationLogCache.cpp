@@ -0,0 +1,148 @@
+#include <SpectralEvaluation/File/EvaluationLogCache.h>
+#include <SpectralEvaluation/File/ScanEvaluationLogFileHandler.h>
+#include <SpectralEvaluation/Flux/PlumeInScanProperty.h>
+#include "catch.hpp"
+#include "TestData.h"
+#include <stdio.h>
+
+namespace novac
+{
+TEST_CASE("EvaluationLogCache Open", "[EvaluationLogCache][IntegrationTests]")
+{
+    const std::string evaluationLog = TestData::GetEvaluationLogfile1();
+    const std::string cacheFile = TestData::GetTemporaryEvaluationLogCacheFileName();
+    remove(cacheFile.c_str());
+
+    SECTION("Parses evaluation log and creates cache file on first open")
+    {
+        EvaluationLogCache sut;
+        REQUIRE(sut.Open(evaluationLog, cacheFile));
+        REQUIRE_FALSE(sut.IsReadFromCacheFile());
+
+        FILE* f = fopen(cacheFile.c_str(), "rb");
+        REQUIRE(f != nullptr);
+        fclose(f);
+    }
+
+    SECTION("Reads cache file on second open")
+    {
+        EvaluationLogCache first;
+        REQUIRE(first.Open(evaluationLog, cacheFile));
+
+        EvaluationLogCache sut;
+        REQUIRE(sut.Open(evaluationLog, cacheFile));
+        REQUIRE(sut.IsReadFromCacheFile());
+        REQUIRE(first.ScanCount() == sut.ScanCount());
+        REQUIRE(first.Species() == sut.Species());
+    }
+
+    SECTION("Re-creates cache file of another evaluation log")
+    {
+        EvaluationLogCache first;
+        REQUIRE(first.Open(TestData::GetBrORatioEvaluationFile1(), cacheFile));
+
+        EvaluationLogCache sut;
+        REQUIRE(sut.Open(evaluationLog, cacheFile));
+        REQUIRE_FALSE(sut.IsReadFromCacheFile());
+
+        sut.Close();
+        REQUIRE(sut.Open(evaluationLog, cacheFile));
+        REQUIRE(sut.IsReadFromCacheFile());
+    }
+
+    SECTION("Returns false for file which does not exist")
+    {
+        EvaluationLogCache sut;
+        REQUIRE_FALSE(sut.Open(TestData::GetTestDataDirectory() + "EvaluationLogs/DoesNotExist.txt", cacheFile));
+        REQUIRE(0 == sut.ScanCount());
+    }
+}
+
+TEST_CASE("EvaluationLogCache GetScan returns same values as CScanEvaluationLogFileHandler", "[EvaluationLogCache][IntegrationTests]")
+{
+    const std::string evaluationLog = TestData::GetEvaluationLogfile1();
+    const std::string cacheFile = TestData::GetTemporaryEvaluationLogCacheFileName();
+    remove(cacheFile.c_str());
+
+    CScanEvaluationLogFileHandler fileHandler;
+    REQUIRE(fileHandler.ReadEvaluationLog(evaluationLog));
+
+    // Read the results twice, once when creating and once from the cache file.
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+        EvaluationLogCache sut;
+        REQUIRE(sut.Open(evaluationLog, cacheFile));
+        REQUIRE((iteration == 1) == sut.IsReadFromCacheFile());
+
+        REQUIRE(fileHandler.m_scan.size() == sut.ScanCount());
+        REQUIRE(fileHandler.m_scan[0].m_spec[0].m_referenceResult.size() == sut.Species().size());
+
+        for (size_t scanIdx = 0; scanIdx < sut.ScanCount(); ++scanIdx)
+        {
+            const BasicScanEvaluationResult& expected = fileHandler.m_scan[scanIdx];
+            const CachedScanResult scan = sut.GetScan(scanIdx);
+
+            REQUIRE(expected.m_spec.size() == scan.numberOfSpectra);
+            REQUIRE(expected.m_skySpecInfo.m_startTime == scan.skyStartTime);
+
+            for (size_t spectrumIdx = 0; spectrumIdx < scan.numberOfSpectra; ++spectrumIdx)
+            {
+                const CEvaluationResult& expectedResult = expected.m_spec[spectrumIdx];
+                const CSpectrumInfo& expectedInfo = expected.m_specInfo[spectrumIdx];
+
+                REQUIRE(expectedInfo.m_scanAngle == scan.scanAngle[spectrumIdx]);
+                REQUIRE(expectedInfo.m_scanAngle2 == scan.scanAngle2[spectrumIdx]);
+                REQUIRE(expectedInfo.m_startTime == scan.StartTime(spectrumIdx));
+                REQUIRE(expectedInfo.m_stopTime == scan.StopTime(spectrumIdx));
+                REQUIRE(expectedResult.m_delta == scan.delta[spectrumIdx]);
+                REQUIRE(expectedResult.m_chiSquare == scan.chiSquare[spectrumIdx]);
+                REQUIRE(expectedResult.IsBad() == scan.IsBad(spectrumIdx));
+
+                for (size_t specieIdx = 0; specieIdx < sut.Species().size(); ++specieIdx)
+                {
+                    const CReferenceFitResult& expectedReference = expectedResult.m_referenceResult[specieIdx];
+                    REQUIRE((expectedReference.m_specieName.empty() || expectedReference.m_specieName == sut.Species()[specieIdx]));
+                    REQUIRE(expectedReference.m_column == scan.column[specieIdx][spectrumIdx]);
+                    REQUIRE(expectedReference.m_columnError == scan.columnError[specieIdx][spectrumIdx]);
+                    REQUIRE(expectedReference.m_shift == scan.shift[specieIdx][spectrumIdx]);
+                    REQUIRE(expectedReference.m_shiftError == scan.shiftError[specieIdx][spectrumIdx]);
+                    REQUIRE(expectedReference.m_squeeze == scan.squeeze[specieIdx][spectrumIdx]);
+                    REQUIRE(expectedReference.m_squeezeError == scan.squeezeError[specieIdx][spectrumIdx]);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("EvaluationLogCache FindPlume gives same result as from evaluation log", "[EvaluationLogCache][PlumeProperties][IntegrationTests]")
+{
+    const std::string evaluationLog = TestData::GetBrORatioEvaluationFile1();
+    const std::string cacheFile = TestData::GetTemporaryEvaluationLogCacheFileName();
+    remove(cacheFile.c_str());
+
+    CScanEvaluationLogFileHandler fileHandler;
+    REQUIRE(fileHandler.ReadEvaluationLog(evaluationLog));
+    CPlumeInScanProperty expectedPlume;
+    CalculatePlumeOffset(fileHandler.m_scan[0], 0, expectedPlume);
+    REQUIRE(FindPlume(fileHandler.m_scan[0], 0, expectedPlume.offset, expectedPlume));
+
+    EvaluationLogCache sut;
+    REQUIRE(sut.Open(evaluationLog, cacheFile));
+    REQUIRE(1 == sut.ScanCount());
+    const int so2Index = sut.GetSpecieIndex("SO2");
+    REQUIRE(0 == so2Index);
+
+    const CachedScanResult scan = sut.GetScan(0);
+    REQUIRE(GetColumns(fileHandler.m_scan[0], so2Index) == GetColumns(scan, so2Index));
+
+    CPlumeInScanProperty plume;
+    CalculatePlumeOffset(scan, so2Index, plume);
+    REQUIRE(expectedPlume.offset == plume.offset);
+
+    REQUIRE(FindPlume(scan, so2Index, plume.offset, plume));
+    REQUIRE(Approx(-23.12).margin(0.01) == plume.plumeCenter);
+    REQUIRE(expectedPlume.plumeCenter == plume.plumeCenter);
+    REQUIRE(expectedPlume.plumeEdgeLow == plume.plumeEdgeLow);
+    REQUIRE(expectedPlume.plumeEdgeHigh == plume.plumeEdgeHigh);
+}
+}
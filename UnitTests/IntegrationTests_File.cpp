@@ -20,6 +20,41 @@ namespace novac
     REQUIRE(result.m_crossSection.back() == Approx(2.358910E-22));
 }
 
+TEST_CASE("ReadCrossSectionFile with solar atlas", "[ReadCrossSectionFile][IntegrationTest][File]")
+{
+    CCrossSectionData result;
+    REQUIRE(ReadCrossSectionFile(TestData::GetSolarAtlasFile_330To350nm(), result));
+
+    REQUIRE(result.m_crossSection.size() == 49061);
+    REQUIRE(result.m_waveLength.size() == 49061);
+
+    // The values are parsed exactly as by strtod (and fscanf).
+    REQUIRE(result.m_waveLength.front() == 330.00023);
+    REQUIRE(result.m_waveLength.back() == 349.99997);
+
+    REQUIRE(result.m_crossSection.front() == 97753.0);
+    REQUIRE(result.m_crossSection.back() == 77832.0);
+
+    SECTION("CCrossSectionData::ReadCrossSectionFile reads same values")
+    {
+        CCrossSectionData other;
+        REQUIRE(0 == other.ReadCrossSectionFile(TestData::GetSolarAtlasFile_330To350nm()));
+
+        REQUIRE(result.m_waveLength == other.m_waveLength);
+        REQUIRE(result.m_crossSection == other.m_crossSection);
+    }
+}
+
+TEST_CASE("ReadCrossSectionFile with file starting with comments", "[ReadCrossSectionFile][IntegrationTest][File]")
+{
+    // This is not supported, but should not get stuck reading the file either.
+    CCrossSectionData result;
+    REQUIRE(ReadCrossSectionFile(TestData::GetQDoasConvolvedSO2CrossSectionFile(), result));
+
+    REQUIRE(result.m_crossSection.size() == 0);
+    REQUIRE(result.m_waveLength.size() == 0);
+}
+
 // TODO: Implement reading a text file containing comments as well
 /* TEST_CASE("ReadCrossSectionFile with two column reference file from QDOAS", "[ReadCrossSectionFile][IntegrationTest]")
 {
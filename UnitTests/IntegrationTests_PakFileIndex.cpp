@@ -0,0 +1,194 @@
+#include <SpectralEvaluation/File/MKPack.h>
+#include <SpectralEvaluation/File/PakFileIndex.h>
+#include <SpectralEvaluation/File/ScanFileHandler.h>
+#include <SpectralEvaluation/File/SpectrumIO.h>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include "catch.hpp"
+#include "TestData.h"
+
+namespace novac
+{
+
+static void RequireEqualSpectra(const CSpectrum& expected, const CSpectrum& actual)
+{
+    REQUIRE(actual.m_length == expected.m_length);
+    REQUIRE(actual.m_info.m_name == expected.m_info.m_name);
+    REQUIRE(actual.m_info.m_device == expected.m_info.m_device);
+    REQUIRE(actual.m_info.m_scanIndex == expected.m_info.m_scanIndex);
+    REQUIRE(actual.m_info.m_scanAngle == expected.m_info.m_scanAngle);
+    REQUIRE(actual.m_info.m_numSpec == expected.m_info.m_numSpec);
+    REQUIRE(actual.m_info.m_exposureTime == expected.m_info.m_exposureTime);
+    REQUIRE(actual.m_info.m_startTime == expected.m_info.m_startTime);
+    REQUIRE(actual.m_info.m_stopTime == expected.m_info.m_stopTime);
+    REQUIRE(actual.m_info.m_peakIntensity == expected.m_info.m_peakIntensity);
+
+    for (long ii = 0; ii < expected.m_length; ++ii)
+    {
+        REQUIRE(actual.m_data[ii] == expected.m_data[ii]);
+    }
+}
+
+TEST_CASE("PakFileIndex Open", "[PakFileIndex][IntegrationTests]")
+{
+    PakFileIndex sut;
+
+    SECTION("Finds all spectra in file")
+    {
+        REQUIRE(sut.Open(TestData::GetMeasuredSpectrumName_I2J8549()));
+
+        CSpectrumIO reader;
+        REQUIRE(sut.SpectrumCount() == (size_t)reader.CountSpectra(TestData::GetMeasuredSpectrumName_I2J8549()));
+        REQUIRE(sut.SpectrumCount() == 53);
+    }
+
+    SECTION("Reads headers of spectra")
+    {
+        REQUIRE(sut.Open(TestData::GetMeasuredSpectrumName_I2J8549()));
+
+        REQUIRE(sut.GetHeader(0).hdrsize == 114);
+        REQUIRE(sut.GetHeader(0).pixels == 2048);
+        REQUIRE(sut.GetSpectrumName(0) == "sky");
+        REQUIRE(sut.GetSpectrumName(1) == "dark");
+    }
+
+    SECTION("File does not exist, returns false")
+    {
+        REQUIRE_FALSE(sut.Open(TestData::GetTestDataDirectory() + "NonExistingFile.pak"));
+        REQUIRE(sut.m_lastError == (int)CSpectrumIO::ERROR_COULD_NOT_OPEN_FILE);
+        REQUIRE(sut.SpectrumCount() == 0);
+    }
+}
+
+static void RequireSameSpectraAsSpectrumIO(const std::string& fileName)
+{
+    PakFileIndex sut;
+    REQUIRE(sut.Open(fileName));
+
+    CSpectrumIO reader;
+    REQUIRE(sut.SpectrumCount() == (size_t)reader.CountSpectra(fileName));
+
+    // Read the spectra in reverse order, to make sure that the order of reading does not matter.
+    for (size_t index = sut.SpectrumCount(); index-- > 0;)
+    {
+        CSpectrum expected;
+        REQUIRE(reader.ReadSpectrum(fileName, (int)index, expected));
+
+        CSpectrum actual;
+        REQUIRE(sut.GetSpectrum(index, actual));
+
+        RequireEqualSpectra(expected, actual);
+    }
+}
+
+TEST_CASE("PakFileIndex GetSpectrum returns same spectra as CSpectrumIO", "[PakFileIndex][IntegrationTests]")
+{
+    SECTION("I2J8549")
+    {
+        RequireSameSpectraAsSpectrumIO(TestData::GetMeasuredSpectrumName_I2J8549());
+    }
+
+    SECTION("2009175M1")
+    {
+        RequireSameSpectraAsSpectrumIO(TestData::GetMeasuredSpectrumName_2009175M1());
+    }
+}
+
+static void RequireSameSpectraAsLegacyUnPack(const std::string& fileName)
+{
+    PakFileIndex sut;
+    REQUIRE(sut.Open(fileName));
+    REQUIRE(sut.SpectrumCount() > 0);
+
+    for (size_t index = 0; index < sut.SpectrumCount(); ++index)
+    {
+        const MKZYhdr& header = sut.GetHeader(index);
+        std::vector<std::uint8_t> compressed(sut.GetCompressedData(index), sut.GetCompressedData(index) + header.size);
+
+        std::vector<long> expected(header.pixels);
+        MKPack mkPack;
+        REQUIRE(header.pixels == mkPack.UnPack(compressed.data(), header.pixels, expected.data()));
+
+        std::vector<std::int32_t> intResult(header.pixels);
+        REQUIRE(header.pixels == MKPack::UnPack(compressed.data(), compressed.size(), header.pixels, intResult.data()));
+
+        std::vector<double> doubleResult(header.pixels);
+        REQUIRE(header.pixels == MKPack::UnPack(compressed.data(), compressed.size(), header.pixels, doubleResult.data()));
+
+        for (long ii = 0; ii < header.pixels; ++ii)
+        {
+            REQUIRE(intResult[ii] == expected[ii]);
+            REQUIRE(doubleResult[ii] == (double)expected[ii]);
+        }
+        REQUIRE(header.checksum == MKPack::Checksum(doubleResult.data(), header.pixels));
+    }
+}
+
+TEST_CASE("MKPack UnPack gives same spectra as original implementation", "[MKPack][PakFileIndex][IntegrationTests]")
+{
+    SECTION("I2J8549")
+    {
+        RequireSameSpectraAsLegacyUnPack(TestData::GetMeasuredSpectrumName_I2J8549());
+    }
+
+    SECTION("2009175M1")
+    {
+        RequireSameSpectraAsLegacyUnPack(TestData::GetMeasuredSpectrumName_2009175M1());
+    }
+
+    SECTION("D2J2124")
+    {
+        RequireSameSpectraAsLegacyUnPack(TestData::GetBrORatioScanFile1());
+        RequireSameSpectraAsLegacyUnPack(TestData::GetBrORatioScanFile2());
+        RequireSameSpectraAsLegacyUnPack(TestData::GetBrORatioScanFile3());
+    }
+}
+
+TEST_CASE("PakFileIndex GetSpectrum past the end of the file returns false", "[PakFileIndex][IntegrationTests]")
+{
+    PakFileIndex sut;
+    REQUIRE(sut.Open(TestData::GetMeasuredSpectrumName_I2J8549()));
+
+    CSpectrum spectrum;
+    REQUIRE_FALSE(sut.GetSpectrum(sut.SpectrumCount(), spectrum));
+    REQUIRE(sut.m_lastError == (int)CSpectrumIO::ERROR_SPECTRUM_NOT_FOUND);
+}
+
+TEST_CASE("ScanFileHandler GetSpectrum in file with many spectra", "[ScanFileHandler][PakFileIndex][IntegrationTests]")
+{
+    // Create a .pak file which is too large for the CScanFileHandler to keep in memory, by repeating the spectra in a measured scan.
+    const std::string fileName = TestData::GetTemporaryPakFileName();
+    CSpectrumIO reader;
+    std::vector<CSpectrum> originalSpectra(reader.CountSpectra(TestData::GetMeasuredSpectrumName_I2J8549()));
+    for (size_t index = 0; index < originalSpectra.size(); ++index)
+    {
+        REQUIRE(reader.ReadSpectrum(TestData::GetMeasuredSpectrumName_I2J8549(), (int)index, originalSpectra[index]));
+    }
+
+    const int numberOfSpectra = 250;
+    for (int index = 0; index < numberOfSpectra; ++index)
+    {
+        const bool overwrite = (index == 0);
+        REQUIRE(0 == reader.AddSpectrumToFile(fileName, originalSpectra[index % originalSpectra.size()], nullptr, 0, overwrite));
+    }
+
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    CScanFileHandler sut(log);
+    REQUIRE(sut.CheckScanFile(context, fileName));
+    REQUIRE(sut.GetSpectrumNumInFile() == numberOfSpectra);
+
+    for (int index : { 249, 0, 123, 124, 53, 1 })
+    {
+        CSpectrum spectrum;
+        REQUIRE(1 == sut.GetSpectrum(context, spectrum, index));
+
+        CSpectrum expected;
+        REQUIRE(reader.ReadSpectrum(fileName, index, expected));
+        RequireEqualSpectra(expected, spectrum);
+    }
+
+    CSpectrum spectrum;
+    REQUIRE(0 == sut.GetSpectrum(context, spectrum, numberOfSpectra));
+}
+
+}
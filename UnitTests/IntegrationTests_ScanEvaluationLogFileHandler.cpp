@@ -2,6 +2,9 @@
 #include <SpectralEvaluation/StringUtils.h>
 #include "catch.hpp"
 #include "TestData.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 namespace novac
 {
@@ -139,6 +142,90 @@ TEST_CASE("CScanEvaluationLogFileHandler ReadEvaluationLog with multiple scans i
     }
 }
 
+TEST_CASE("CScanEvaluationLogFileHandler ReadEvaluationLog with callback", "[CScanEvaluationLogFileHandler][IntegrationTests]")
+{
+    const std::string file = TestData::GetEvaluationLogfile1();
+    CScanEvaluationLogFileHandler reference;
+    REQUIRE(reference.ReadEvaluationLog(file));
+
+    CScanEvaluationLogFileHandler sut;
+    std::vector<BasicScanEvaluationResult> scans;
+
+    // Act
+    const bool result = sut.ReadEvaluationLog(file, [&](BasicScanEvaluationResult&& scan) { scans.push_back(std::move(scan)); });
+
+    SECTION("Returns true and does not fill in m_scan")
+    {
+        REQUIRE(result);
+        REQUIRE(sut.m_scan.empty());
+        REQUIRE(sut.m_specie == reference.m_specie);
+    }
+
+    SECTION("Passes on all scans in the file")
+    {
+        REQUIRE(69 == scans.size());
+    }
+
+    SECTION("Scans are identical to the ones read into m_scan")
+    {
+        // The scans are passed on in the order of the file, m_scan is sorted by time.
+        std::stable_sort(begin(scans), end(scans), [](const BasicScanEvaluationResult& first, const BasicScanEvaluationResult& second)
+            {
+                return first.m_skySpecInfo.m_startTime < second.m_skySpecInfo.m_startTime;
+            });
+        REQUIRE(scans.size() == reference.m_scan.size());
+        for (size_t idx = 0; idx < scans.size(); ++idx)
+        {
+            const auto& expected = reference.m_scan[idx];
+            REQUIRE(scans[idx].m_skySpecInfo.m_startTime == expected.m_skySpecInfo.m_startTime);
+            REQUIRE(scans[idx].m_spec.size() == expected.m_spec.size());
+            REQUIRE(scans[idx].m_specInfo.size() == expected.m_specInfo.size());
+            REQUIRE(scans[idx].m_spec.back().m_referenceResult.size() == expected.m_spec.back().m_referenceResult.size());
+        }
+    }
+}
+
+TEST_CASE("CScanEvaluationLogFileHandler ReadEvaluationLog with header line longer than 8192 characters", "[CScanEvaluationLogFileHandler][IntegrationTests]")
+{
+    const std::string file = TestData::GetBrORatioEvaluationFile1();
+    CScanEvaluationLogFileHandler reference;
+    REQUIRE(reference.ReadEvaluationLog(file));
+
+    // Append unknown columns to the header line, these are ignored.
+    std::string contents;
+    {
+        std::ifstream input(file, std::ios::binary);
+        std::stringstream buffer;
+        buffer << input.rdbuf();
+        contents = buffer.str();
+    }
+    const size_t headerStart = contents.find("#scanangle");
+    REQUIRE(headerStart != std::string::npos);
+    const size_t headerEnd = contents.find_first_of("\r\n", headerStart);
+    std::string extraColumns;
+    for (int columnIdx = 0; columnIdx < 1000; ++columnIdx)
+    {
+        extraColumns += "\tunknown" + std::to_string(columnIdx);
+    }
+    contents.insert(headerEnd, extraColumns);
+    REQUIRE(contents.find_first_of("\r\n", headerStart) - headerStart > 8192);
+    {
+        std::ofstream output(TestData::GetTemporaryTextFileName(), std::ios::binary);
+        output << contents;
+    }
+
+    CScanEvaluationLogFileHandler sut;
+
+    // Act
+    REQUIRE(sut.ReadEvaluationLog(TestData::GetTemporaryTextFileName()));
+
+    // Assert
+    REQUIRE(1 == sut.m_scan.size());
+    REQUIRE(sut.m_scan[0].m_spec.size() == reference.m_scan[0].m_spec.size());
+    REQUIRE(sut.m_scan[0].m_spec[0].m_referenceResult.size() == reference.m_scan[0].m_spec[0].m_referenceResult.size());
+    REQUIRE(sut.m_scan[0].m_spec[0].m_referenceResult[0].m_column == reference.m_scan[0].m_spec[0].m_referenceResult[0].m_column);
+}
+
 TEST_CASE("CScanEvaluationLogFileHandler ReadEvaluationLog - ReEvaluationLog from NovacProgram", "[CScanEvaluationLogFileHandler][IntegrationTests]")
 {
     CScanEvaluationLogFileHandler sut;
@@ -1,7 +1,13 @@
 #include <SpectralEvaluation/File/ScanFileHandler.h>
+#include <SpectralEvaluation/File/SpectrumIO.h>
+#include <SpectralEvaluation/Spectra/ScanSpectrumReduction.h>
 #include <SpectralEvaluation/StringUtils.h>
 #include "catch.hpp"
 #include "TestData.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 
 namespace novac
 {
@@ -181,4 +187,229 @@ TEST_CASE("ScanFileHandler GetNextSpectrum", "[ScanFileHandler][IntegrationTests
         REQUIRE(firstCounter == secondCounter);
     }
 }
-}
\ No newline at end of file
+
+TEST_CASE("SumGoodSpectra of scan, returns the same sum as adding the good spectra one by one", "[ScanFileHandler][SumGoodSpectra][IntegrationTests]")
+{
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    CScanFileHandler scan(log);
+    REQUIRE(scan.CheckScanFile(context, TestData::GetMeasuredSpectrumName_I2J8549()));
+
+    GoodSpectrumCriteria criteria;
+    criteria.fromPixel = 320;
+    criteria.toPixel = 460;
+    criteria.maximumIntensityForSingleReadout = 4095.0 - 20.0;
+    criteria.excludeDarkSpectra = true;
+
+    // The expected sum is the sky spectrum and the measured spectra, read one by one.
+    std::vector<CSpectrum> spectraToSum(1);
+    REQUIRE(0 == scan.GetSky(spectraToSum[0]));
+    scan.ResetCounter();
+    CSpectrum measuredSpectrum;
+    while (0 != scan.GetNextSpectrum(context, measuredSpectrum))
+    {
+        spectraToSum.push_back(measuredSpectrum);
+    }
+    scan.ResetCounter();
+
+    CSpectrum expected;
+    int expectedNumberOfSpectra = 0;
+    for (const CSpectrum& spectrum : spectraToSum)
+    {
+        if (IsGoodSpectrum(spectrum, criteria))
+        {
+            if (expectedNumberOfSpectra == 0)
+            {
+                expected = spectrum;
+            }
+            else
+            {
+                expected.Add(spectrum);
+            }
+            ++expectedNumberOfSpectra;
+        }
+    }
+    REQUIRE(expectedNumberOfSpectra > 2); // check assumption on the setup
+
+    CSpectrum result;
+    const int numberOfSpectra = SumGoodSpectra(context, scan, criteria, result);
+
+    REQUIRE(numberOfSpectra == expectedNumberOfSpectra);
+    REQUIRE(result.m_length == expected.m_length);
+    REQUIRE(result.NumSpectra() == expected.NumSpectra());
+    for (long ii = 0; ii < expected.m_length; ++ii)
+    {
+        REQUIRE(result.m_data[ii] == expected.m_data[ii]);
+    }
+}
+
+TEST_CASE("SumGoodSpectra of scan, does not include the dark, offset and dark-current spectra", "[ScanFileHandler][SumGoodSpectra][IntegrationTests]")
+{
+    // Create a scan where the special spectra are copies of measured spectra, such that they are not recognized as dark from their intensity.
+    const std::string fileName = TestData::GetTemporaryPakFileName();
+    CSpectrumIO reader;
+    const std::vector<std::string> names = { "sky", "dark", "offset", "dark_cur", "scan", "scan" };
+    for (size_t index = 0; index < names.size(); ++index)
+    {
+        CSpectrum spectrum;
+        REQUIRE(reader.ReadSpectrum(TestData::GetMeasuredSpectrumName_I2J8549(), (int)index + 2, spectrum));
+        spectrum.m_info.m_name = names[index];
+        spectrum.m_info.m_scanIndex = (short)index;
+        REQUIRE(0 == reader.AddSpectrumToFile(fileName, spectrum, nullptr, 0, index == 0));
+    }
+
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    CScanFileHandler scan(log);
+    REQUIRE(scan.CheckScanFile(context, fileName));
+
+    GoodSpectrumCriteria criteria;
+    criteria.excludeDarkSpectra = true;
+
+    CSpectrum result;
+    const int numberOfSpectra = SumGoodSpectra(context, scan, criteria, result);
+
+    // The sky spectrum and the two measured spectra
+    REQUIRE(3 == numberOfSpectra);
+
+    CSpectrum sky;
+    REQUIRE(0 == scan.GetSky(sky));
+    CSpectrum measured;
+    REQUIRE(1 == scan.GetSpectrum(context, measured, 4));
+    CSpectrum expected = sky;
+    expected.Add(measured);
+    REQUIRE(1 == scan.GetSpectrum(context, measured, 5));
+    expected.Add(measured);
+    REQUIRE(result.m_data[100] == Approx(expected.m_data[100]));
+}
+
+TEST_CASE("ScanFileHandler CheckScanFile finds special spectra from their names", "[ScanFileHandler][IntegrationTests]")
+{
+    // Create a scan where the special spectra are not in the usual order, with names in varying case.
+    const std::string fileName = TestData::GetTemporaryPakFileName();
+    CSpectrumIO reader;
+    const std::vector<std::string> names = { "dark_cur", "Sky", "scan", "OFFSET", "scan", "dark", "scan" };
+    std::vector<CSpectrum> spectra(names.size());
+    for (size_t index = 0; index < names.size(); ++index)
+    {
+        REQUIRE(reader.ReadSpectrum(TestData::GetMeasuredSpectrumName_I2J8549(), (int)index + 2, spectra[index]));
+        spectra[index].m_info.m_name = names[index];
+        REQUIRE(0 == reader.AddSpectrumToFile(fileName, spectra[index], nullptr, 0, index == 0));
+    }
+
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    CScanFileHandler sut(log);
+    REQUIRE(sut.CheckScanFile(context, fileName));
+    REQUIRE(sut.GetSpectrumNumInFile() == (int)names.size());
+
+    CSpectrum spectrum;
+    REQUIRE(0 == sut.GetSky(spectrum));
+    REQUIRE(spectrum.m_info.m_name == "Sky");
+    REQUIRE(spectrum.m_data[100] == spectra[1].m_data[100]);
+
+    REQUIRE(0 == sut.GetDark(spectrum));
+    REQUIRE(spectrum.m_info.m_name == "dark");
+    REQUIRE(spectrum.m_data[100] == spectra[5].m_data[100]);
+
+    REQUIRE(0 == sut.GetOffset(spectrum));
+    REQUIRE(spectrum.m_info.m_name == "OFFSET");
+    REQUIRE(spectrum.m_data[100] == spectra[3].m_data[100]);
+
+    REQUIRE(0 == sut.GetDarkCurrent(spectrum));
+    REQUIRE(spectrum.m_info.m_name == "dark_cur");
+    REQUIRE(spectrum.m_data[100] == spectra[0].m_data[100]);
+
+    // The first spectrum in the file sets the device and start time of the scan
+    REQUIRE(sut.m_device == spectra[0].m_info.m_device);
+    REQUIRE(sut.GetScanStartTime() <= spectra[0].m_info.m_startTime);
+
+    // all spectra can still be read by index
+    for (int index = 0; index < (int)names.size(); ++index)
+    {
+        REQUIRE(1 == sut.GetSpectrum(context, spectrum, index));
+        REQUIRE(spectrum.m_info.m_name == names[index]);
+    }
+    REQUIRE(0 == sut.GetSpectrum(context, spectrum, -1));
+}
+
+TEST_CASE("ScanFileHandler GetSpectrum reports an error for a corrupt spectrum only", "[ScanFileHandler][IntegrationTests]")
+{
+    const std::string fileName = TestData::GetTemporaryPakFileName();
+    CSpectrumIO reader;
+    for (int index = 0; index < 3; ++index)
+    {
+        CSpectrum spectrum;
+        REQUIRE(reader.ReadSpectrum(TestData::GetMeasuredSpectrumName_I2J8549(), index + 2, spectrum));
+        REQUIRE(0 == reader.AddSpectrumToFile(fileName, spectrum, nullptr, 0, index == 0));
+    }
+
+    // Change one byte in the compressed data of the last spectrum.
+    std::string contents;
+    {
+        std::ifstream input(fileName, std::ios::binary);
+        std::stringstream buffer;
+        buffer << input.rdbuf();
+        contents = buffer.str();
+    }
+    const size_t lastHeader = contents.rfind("MKZY");
+    REQUIRE(lastHeader != std::string::npos);
+    std::uint16_t headerSize = 0;
+    memcpy(&headerSize, contents.data() + lastHeader + 4, sizeof(headerSize));
+    contents[lastHeader + headerSize + 16] ^= 0x55;
+    {
+        std::ofstream output(fileName, std::ios::binary);
+        output << contents;
+    }
+
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    CScanFileHandler sut(log);
+    REQUIRE(sut.CheckScanFile(context, fileName));
+
+    CSpectrum spectrum;
+    REQUIRE(0 == sut.GetSpectrum(context, spectrum, 2));
+    REQUIRE(sut.m_lastError != (int)CSpectrumIO::ERROR_NO_ERROR);
+
+    // The error is remembered, without affecting the other spectra in the scan
+    sut.m_lastError = (int)CSpectrumIO::ERROR_NO_ERROR;
+    REQUIRE(0 == sut.GetSpectrum(context, spectrum, 2));
+    REQUIRE(sut.m_lastError != (int)CSpectrumIO::ERROR_NO_ERROR);
+    REQUIRE(1 == sut.GetSpectrum(context, spectrum, 0));
+    REQUIRE(1 == sut.GetSpectrum(context, spectrum, 1));
+}
+
+TEST_CASE("ScanFileHandler keeps the spectra after the file has been removed", "[ScanFileHandler][IntegrationTests]")
+{
+    const std::string fileName = TestData::GetTemporaryPakFileName();
+    CSpectrumIO reader;
+    std::vector<CSpectrum> spectra(3);
+    for (size_t index = 0; index < spectra.size(); ++index)
+    {
+        REQUIRE(reader.ReadSpectrum(TestData::GetMeasuredSpectrumName_I2J8549(), (int)index + 2, spectra[index]));
+        REQUIRE(0 == reader.AddSpectrumToFile(fileName, spectra[index], nullptr, 0, index == 0));
+    }
+
+    novac::ConsoleLog log;
+    novac::LogContext context;
+    CScanFileHandler sut(log);
+    REQUIRE(sut.CheckScanFile(context, fileName));
+
+    // Reading every spectrum once keeps them all in memory and closes the file.
+    CSpectrum spectrum;
+    for (int index = 0; index < (int)spectra.size(); ++index)
+    {
+        REQUIRE(1 == sut.GetSpectrum(context, spectrum, index));
+    }
+
+    // Act
+    REQUIRE(0 == std::remove(fileName.c_str()));
+
+    // Assert
+    for (int index = 0; index < (int)spectra.size(); ++index)
+    {
+        REQUIRE(1 == sut.GetSpectrum(context, spectrum, index));
+        REQUIRE(spectrum.m_data[100] == spectra[index].m_data[100]);
+    }
+}
+}
@@ -90,4 +90,31 @@ namespace novac
         REQUIRE(spectrum.m_info.m_compass == 34.0);
 
     }
-}
\ No newline at end of file
+
+    TEST_CASE("SpectrumIO can write and read spectrum longer than MAX_SPECTRUM_LENGTH", "[SpectrumIO][ReadSpectrum][IntegrationTests]")
+    {
+        const long length = 6000;
+        std::vector<double> data(length);
+        for (long ii = 0; ii < length; ++ii)
+        {
+            data[ii] = (double)(20000 + (ii * 37) % 5000);
+        }
+        CSpectrum original(data);
+        original.m_info.m_name = "sky";
+        original.m_info.m_numSpec = 15;
+        original.m_info.m_exposureTime = 100;
+
+        const std::string fileName = TestData::GetTemporaryPakFileName();
+        CSpectrumIO sut;
+        REQUIRE(0 == sut.AddSpectrumToFile(fileName, original, nullptr, 0, true));
+
+        CSpectrum result;
+        REQUIRE(sut.ReadSpectrum(fileName, 0, result));
+
+        REQUIRE(result.m_length == length);
+        for (long ii = 0; ii < length; ++ii)
+        {
+            REQUIRE(result.m_data[ii] == data[ii]);
+        }
+    }
+}
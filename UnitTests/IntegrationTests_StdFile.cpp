@@ -3,6 +3,7 @@
 #include "catch.hpp"
 #include "TestData.h"
 #include <string.h>
+#include <fstream>
 
 namespace novac
 {
@@ -103,4 +104,21 @@ namespace novac
         }
     }
 
-}
\ No newline at end of file
+    TEST_CASE("Std file with a spectrum longer than MAX_SPECTRUM_LENGTH is rejected", "[StdFile][IntegrationTest]")
+    {
+        const std::string fileName = TestData::GetTemporaryInstrumentCalibrationStdFileName();
+        {
+            std::ofstream output(fileName);
+            output << "GDBGMNUP" << std::endl << "1" << std::endl << (MAX_SPECTRUM_LENGTH + 1) << std::endl;
+            for (long ii = 0; ii <= MAX_SPECTRUM_LENGTH; ++ii)
+            {
+                output << "1000" << std::endl;
+            }
+        }
+
+        CSpectrum spectrum;
+        const bool returnValue = CSTDFile::ReadSpectrum(spectrum, fileName);
+
+        REQUIRE(returnValue == false);
+    }
+}
@@ -128,6 +128,11 @@ public:
         return GetTestDataDirectory() + std::string("SOLARFL_296-440nm.xs");
     }
 
+    static std::string GetSolarAtlasFile_330To350nm()
+    {
+        return GetTestDataDirectory() + std::string("SOLARFL_330-350nm.xs");
+    }
+
     static std::string GetMercurySpectrumWithoutWavelengthCalibration()
     {
         return GetTestDataDirectory() + std::string("MercurySpectra/hglampnov152021.std");
@@ -168,6 +173,21 @@ public:
         return GetTestDataDirectory() + std::string("Temporary_Congfiguration.config");
     }
 
+    static std::string GetTemporaryPakFileName()
+    {
+        return GetTestDataDirectory() + std::string("Temporary_Scan.pak");
+    }
+
+    static std::string GetTemporaryEvaluationLogCacheFileName()
+    {
+        return GetTestDataDirectory() + std::string("Temporary_EvaluationLog.evcache");
+    }
+
+    static std::string GetTemporaryTextFileName()
+    {
+        return GetTestDataDirectory() + std::string("Temporary_TextFile.txt");
+    }
+
     // endregion
 
     // region Evaluation log file formats
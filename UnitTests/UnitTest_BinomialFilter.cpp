@@ -0,0 +1,163 @@
+#include <SpectralEvaluation/Math/BinomialFilter.h>
+#include <SpectralEvaluation/Evaluation/BasicMath.h>
+#include "catch.hpp"
+#include <cmath>
+#include <random>
+
+namespace novac
+{
+    // The iterative binomial low pass filter, as implemented in CBasicMath::LowPassBinomial, used as reference.
+    static std::vector<double> IterativeLowPass(std::vector<double> data, int iterations)
+    {
+        const size_t length = data.size();
+        std::vector<double> buffer(length);
+        for (int iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (size_t ii = 0; ii < length; ++ii)
+            {
+                const double left = (ii == 0) ? data[ii] : data[ii - 1];
+                const double right = (ii == length - 1) ? data[ii] : data[ii + 1];
+                buffer[ii] = 0.5 * data[ii] + 0.25 * left + 0.25 * right;
+            }
+            std::swap(data, buffer);
+        }
+        return data;
+    }
+
+    static std::vector<double> IterativeHighPass(std::vector<double> data, int iterations)
+    {
+        const std::vector<double> lowPass = IterativeLowPass(data, iterations);
+        for (size_t ii = 0; ii < data.size(); ++ii)
+        {
+            data[ii] = (lowPass[ii] != 0.0) ? data[ii] / lowPass[ii] : 0.0;
+        }
+        return data;
+    }
+
+    // Creates a spectrum-like signal, a smooth and strongly varying background with narrow absorption lines and some noise.
+    static std::vector<double> CreateSpectrum(size_t length, unsigned int seed)
+    {
+        std::mt19937 generator{ seed };
+        std::uniform_real_distribution<double> noise{ -1.0, 1.0 };
+        std::vector<double> data(length);
+        for (size_t ii = 0; ii < length; ++ii)
+        {
+            const double x = (double)ii / (double)length;
+            const double background = 100.0 + 40000.0 * std::exp(-std::pow((x - 0.6) / 0.25, 2.0));
+            const double lines = 1.0 - 0.3 * std::pow(std::sin(0.37 * ii), 8.0);
+            data[ii] = background * lines + 10.0 * noise(generator);
+        }
+        return data;
+    }
+
+    static double MaximumRelativeDifference(const std::vector<double>& expected, const double* actual)
+    {
+        double maximumDifference = 0.0;
+        for (size_t ii = 0; ii < expected.size(); ++ii)
+        {
+            const double difference = std::abs(actual[ii] - expected[ii]) / std::max(std::abs(expected[ii]), 1e-300);
+            maximumDifference = std::max(maximumDifference, difference);
+        }
+        return maximumDifference;
+    }
+
+    TEST_CASE("BinomialFilter LowPass gives same result as iterative filter", "[BinomialFilter][Math]")
+    {
+        for (int iterations : { 1, 16, 100, 500 })
+        {
+            for (size_t length : { 2, 7, 50, 401, 2048 })
+            {
+                const std::vector<double> data = CreateSpectrum(length, 1);
+                const std::vector<double> expected = IterativeLowPass(data, iterations);
+
+                BinomialFilter sut{ length, iterations };
+                std::vector<double> result = data;
+                sut.LowPass(result.data());
+
+                INFO("Length: " << length << ", iterations: " << iterations);
+                REQUIRE(MaximumRelativeDifference(expected, result.data()) < 1e-12);
+            }
+        }
+    }
+
+    TEST_CASE("BinomialFilter HighPass gives same result as iterative filter", "[BinomialFilter][Math]")
+    {
+        const size_t length = 2048;
+        const int iterations = 500;
+        BinomialFilter sut{ length, iterations };
+
+        SECTION("Spectrum")
+        {
+            const std::vector<double> data = CreateSpectrum(length, 2);
+            const std::vector<double> expected = IterativeHighPass(data, iterations);
+
+            std::vector<double> result = data;
+            sut.HighPass(result.data());
+
+            REQUIRE(MaximumRelativeDifference(expected, result.data()) < 1e-12);
+        }
+
+        SECTION("Exponential of cross section")
+        {
+            std::vector<double> data(length);
+            for (size_t ii = 0; ii < length; ++ii)
+            {
+                data[ii] = std::exp(-2.5e15 * 1e-18 * (1.0 + std::sin(0.05 * ii)) * (double)ii / (double)length);
+            }
+            const std::vector<double> expected = IterativeHighPass(data, iterations);
+
+            std::vector<double> result = data;
+            sut.HighPass(result.data());
+
+            REQUIRE(MaximumRelativeDifference(expected, result.data()) < 1e-12);
+        }
+
+        SECTION("Zero data gives zero result")
+        {
+            std::vector<double> result(length, 0.0);
+            sut.HighPass(result.data());
+
+            REQUIRE(MaximumRelativeDifference(std::vector<double>(length, 0.0), result.data()) == 0.0);
+        }
+    }
+
+    TEST_CASE("BinomialFilter batched filtering gives same result as filtering one by one", "[BinomialFilter][Math]")
+    {
+        const size_t length = 1024;
+        const int iterations = 500;
+        BinomialFilter sut{ length, iterations };
+
+        std::vector<std::vector<double>> spectra;
+        std::vector<std::vector<double>> expected;
+        std::vector<double*> spectraToFilter;
+        for (unsigned int ii = 0; ii < 20; ++ii)
+        {
+            spectra.push_back(CreateSpectrum(length, 10 + ii));
+            expected.push_back(spectra.back());
+            sut.HighPass(expected.back().data());
+        }
+        for (auto& spectrum : spectra)
+        {
+            spectraToFilter.push_back(spectrum.data());
+        }
+
+        sut.HighPass(spectraToFilter);
+
+        for (size_t ii = 0; ii < spectra.size(); ++ii)
+        {
+            REQUIRE(spectra[ii] == expected[ii]);
+        }
+    }
+
+    TEST_CASE("CBasicMath HighPassBinomial gives same result as iterative filter", "[BinomialFilter][BasicMath]")
+    {
+        const std::vector<double> data = CreateSpectrum(2048, 3);
+        const std::vector<double> expected = IterativeHighPass(data, 500);
+        CBasicMath math;
+
+        std::vector<double> result = data;
+        math.HighPassBinomial(result.data(), (int)result.size(), 500);
+
+        REQUIRE(MaximumRelativeDifference(expected, result.data()) < 1e-12);
+    }
+}
@@ -0,0 +1,270 @@
+#include "catch.hpp"
+#include <SpectralEvaluation/Fit/DiscreteFunction.h>
+#include <SpectralEvaluation/Fit/LeastSquareFit.h>
+#include <SpectralEvaluation/Fit/PolynomialFunction.h>
+#include <SpectralEvaluation/Fit/StandardMetricFunction.h>
+
+namespace
+{
+    // Creates a matrix from the provided values, given row by row.
+    MathFit::CMatrix CreateMatrix(std::vector<double> values, int rows, int columns)
+    {
+        MathFit::CMatrix result;
+        result.Copy(values.data(), rows, columns, true);
+        return result;
+    }
+}
+
+TEST_CASE("CMatrix - Cholesky decomposition", "[Fit][CMatrix]")
+{
+    // A symmetric, positive definite matrix
+    MathFit::CMatrix original = CreateMatrix({ 4.0, 12.0, -16.0, 12.0, 37.0, -43.0, -16.0, -43.0, 98.0 }, 3, 3);
+
+    SECTION("Lower triangle contains expected decomposition")
+    {
+        MathFit::CMatrix sut(original);
+        sut.CholeskyDecomposition();
+
+        REQUIRE(sut.GetAt(0, 0) == Approx(2.0));
+        REQUIRE(sut.GetAt(1, 0) == Approx(6.0));
+        REQUIRE(sut.GetAt(1, 1) == Approx(1.0));
+        REQUIRE(sut.GetAt(2, 0) == Approx(-8.0));
+        REQUIRE(sut.GetAt(2, 1) == Approx(5.0));
+        REQUIRE(sut.GetAt(2, 2) == Approx(3.0));
+    }
+
+    SECTION("Backsubstitution solves linear equation system")
+    {
+        MathFit::CMatrix sut(original);
+        sut.CholeskyDecomposition();
+
+        // b = A * [1, 2, 3]
+        MathFit::CVector vB(3);
+        vB.SetAt(0, -20.0);
+        vB.SetAt(1, -43.0);
+        vB.SetAt(2, 192.0);
+
+        sut.CholeskyBacksubstitution(vB);
+
+        REQUIRE(vB.GetAt(0) == Approx(1.0));
+        REQUIRE(vB.GetAt(1) == Approx(2.0));
+        REQUIRE(vB.GetAt(2) == Approx(3.0));
+    }
+
+    SECTION("Inverse equals inverse from Gauss Jordan elimination")
+    {
+        MathFit::CMatrix expected(original);
+        expected.Inverse();
+
+        MathFit::CMatrix sut(original);
+        sut.CholeskyDecomposition();
+        MathFit::CMatrix result;
+        sut.CholeskyInverse(result);
+
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int col = 0; col < 3; ++col)
+            {
+                REQUIRE(result.GetAt(row, col) == Approx(expected.GetAt(row, col)));
+            }
+        }
+    }
+
+    SECTION("Not positive definite matrix throws exception")
+    {
+        MathFit::CMatrix sut = CreateMatrix({ 1.0, 2.0, 2.0, 1.0 }, 2, 2);
+
+        REQUIRE_THROWS(sut.CholeskyDecomposition());
+    }
+}
+
+TEST_CASE("CMatrix - QR decomposition", "[Fit][CMatrix]")
+{
+    // An overdetermined system, 4 rows and 2 columns (fit of a straight line through four points).
+    MathFit::CMatrix original = CreateMatrix({ 1.0, 0.0, 1.0, 1.0, 1.0, 2.0, 1.0, 3.0 }, 4, 2);
+
+    SECTION("Backsubstitution gives least squares solution")
+    {
+        MathFit::CMatrix sut(original);
+        MathFit::CVector vRDiagonal(2);
+        sut.QRDecomposition(vRDiagonal);
+
+        // points on the line y = 1 + 2x, with some noise which cancels out in the least squares solution
+        MathFit::CVector vB(4);
+        vB.SetAt(0, 1.1);
+        vB.SetAt(1, 2.9);
+        vB.SetAt(2, 4.9);
+        vB.SetAt(3, 7.1);
+
+        sut.QRBacksubstitution(vRDiagonal, vB);
+
+        REQUIRE(vB.GetAt(0) == Approx(1.0));
+        REQUIRE(vB.GetAt(1) == Approx(2.0));
+    }
+
+    SECTION("Inverse normal matrix equals inverse from Gauss Jordan elimination")
+    {
+        MathFit::CMatrix expected;
+        expected.NormalMatrix(original);
+        expected.Inverse();
+
+        MathFit::CMatrix sut(original);
+        MathFit::CVector vRDiagonal(2);
+        sut.QRDecomposition(vRDiagonal);
+        MathFit::CMatrix result;
+        sut.QRInverseNormalMatrix(vRDiagonal, result);
+
+        for (int row = 0; row < 2; ++row)
+        {
+            for (int col = 0; col < 2; ++col)
+            {
+                REQUIRE(result.GetAt(row, col) == Approx(expected.GetAt(row, col)));
+            }
+        }
+    }
+
+    SECTION("Linearly dependent columns throws exception")
+    {
+        MathFit::CMatrix sut = CreateMatrix({ 1.0, 0.0, 2.0, 0.0, 3.0, 0.0 }, 3, 2);
+        MathFit::CVector vRDiagonal(2);
+
+        REQUIRE_THROWS(sut.QRDecomposition(vRDiagonal));
+    }
+}
+
+TEST_CASE("CMatrix - Products with vectorized kernels", "[Fit][CMatrix]")
+{
+    // A design matrix of the size of a typical DOAS fit
+    const int rows = 301;
+    const int columns = 10;
+    MathFit::CMatrix sut(columns, rows);
+    MathFit::CVector vX(columns);
+    for (int col = 0; col < columns; ++col)
+    {
+        for (int row = 0; row < rows; ++row)
+        {
+            sut.SetAt(row, col, std::cos(0.01 * row * (col + 1)));
+        }
+        vX.SetAt(col, 1.0 / (col + 1));
+    }
+
+    SECTION("Matrix times vector")
+    {
+        MathFit::CVector vResult(vX);
+        sut.Mul(vResult);
+
+        REQUIRE(rows == vResult.GetSize());
+        for (int row = 0; row < rows; ++row)
+        {
+            double expected = 0.0;
+            for (int col = 0; col < columns; ++col)
+            {
+                expected += sut.GetAt(row, col) * vX.GetAt(col);
+            }
+            REQUIRE(vResult.GetAt(row) == expected);
+        }
+    }
+
+    SECTION("Normal matrix and pseudo inverse")
+    {
+        MathFit::CMatrix normalMatrix;
+        normalMatrix.NormalMatrix(sut);
+        MathFit::CMatrix pseudoInverse(sut);
+        pseudoInverse.PseudoInverse();
+
+        REQUIRE(columns == normalMatrix.GetNoRows());
+        REQUIRE(columns == normalMatrix.GetNoColumns());
+        for (int row = 0; row < columns; ++row)
+        {
+            for (int col = 0; col < columns; ++col)
+            {
+                double expected = 0.0;
+                for (int k = 0; k < rows; ++k)
+                {
+                    expected += sut.GetAt(k, row) * sut.GetAt(k, col);
+                }
+                REQUIRE(normalMatrix.GetAt(row, col) == Approx(expected).epsilon(1e-12).margin(1e-12));
+                REQUIRE(pseudoInverse.GetAt(row, col) == normalMatrix.GetAt(row, col));
+            }
+        }
+    }
+}
+
+TEST_CASE("CLeastSquareFit - all solve methods give same polynomial fit", "[Fit][CLeastSquareFit]")
+{
+    // A third order polynomial at large x-values, like the polynomial in a DOAS fit
+    const int length = 200;
+    MathFit::CVector vX(length);
+    MathFit::CVector vY(length);
+    for (int ii = 0; ii < length; ++ii)
+    {
+        const double x = 300.0 + ii;
+        vX.SetAt(ii, x);
+        vY.SetAt(ii, 0.5 - 2e-3 * x + 3e-6 * x * x - 1e-9 * x * x * x + 1e-4 * std::sin(x));
+    }
+
+    auto runFit = [&](MathFit::CMatrix::ESolveMethod method, std::vector<double>& coefficients, std::vector<double>& errors)
+    {
+        MathFit::CDiscreteFunction target;
+        target.SetData(vX, vY);
+        MathFit::CPolynomialFunction polynomial(3);
+        MathFit::CStandardMetricFunction metric(target, polynomial);
+
+        MathFit::CLeastSquareFit sut(metric);
+        sut.SetSolveMethod(method);
+        sut.SetFitRange(vX);
+        sut.PrepareMinimize();
+        sut.Minimize();
+        sut.Minimize(); // the second time uses the cached decomposition (when available)
+        sut.FinishMinimize();
+
+        coefficients.resize(4);
+        errors.resize(4);
+        for (int ii = 0; ii < 4; ++ii)
+        {
+            coefficients[ii] = polynomial.GetCoefficient(ii);
+            errors[ii] = polynomial.GetCoefficientError(ii);
+        }
+    };
+
+    std::vector<double> expectedCoefficients, expectedErrors;
+    runFit(MathFit::CMatrix::GAUSSJORDAN, expectedCoefficients, expectedErrors);
+
+    REQUIRE(expectedCoefficients[3] == Approx(-1e-9).epsilon(0.05));
+
+    SECTION("QR")
+    {
+        std::vector<double> coefficients, errors;
+        runFit(MathFit::CMatrix::QR, coefficients, errors);
+
+        for (int ii = 0; ii < 4; ++ii)
+        {
+            REQUIRE(coefficients[ii] == Approx(expectedCoefficients[ii]).epsilon(1e-6));
+            REQUIRE(errors[ii] == Approx(expectedErrors[ii]).epsilon(1e-6));
+        }
+    }
+
+    SECTION("Cholesky")
+    {
+        std::vector<double> coefficients, errors;
+        runFit(MathFit::CMatrix::CHOLESKY, coefficients, errors);
+
+        for (int ii = 0; ii < 4; ++ii)
+        {
+            REQUIRE(coefficients[ii] == Approx(expectedCoefficients[ii]).epsilon(1e-6));
+            REQUIRE(errors[ii] == Approx(expectedErrors[ii]).epsilon(1e-6));
+        }
+    }
+
+    SECTION("LU decomposition")
+    {
+        std::vector<double> coefficients, errors;
+        runFit(MathFit::CMatrix::LUDECOMPOSITION, coefficients, errors);
+
+        for (int ii = 0; ii < 4; ++ii)
+        {
+            REQUIRE(coefficients[ii] == Approx(expectedCoefficients[ii]).epsilon(1e-6));
+            REQUIRE(errors[ii] == Approx(expectedErrors[ii]).epsilon(1e-6));
+        }
+    }
+}
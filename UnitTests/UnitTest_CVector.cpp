@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <SpectralEvaluation/Fit/Vector.h>
+#include <cmath>
 
 TEST_CASE("CVector creation from vector data - Basic Operations", "[Fit][CVector]")
 {
@@ -185,4 +186,77 @@ TEST_CASE("CVector creation from vector data - Polynomial Operations", "[Fit][CV
         REQUIRE(expectedValue == result);
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("CVector - Vectorized operations give same result as scalar operations", "[Fit][CVector]")
+{
+    const bool takeOwnershipOfData = false;
+
+    // Odd length such that the remainder which doesn't fill a full register is also tested.
+    const int length = 803;
+    std::vector<double> first(length);
+    std::vector<double> second(length);
+    for (int ii = 0; ii < length; ++ii)
+    {
+        first[ii] = 1.0 + std::sin(0.01 * ii);
+        second[ii] = 2.0 + std::cos(0.003 * ii);
+    }
+
+    const MathFit::Kernels::EInstructionSet originalInstructionSet = MathFit::Kernels::GetInstructionSet();
+
+    // Runs all the vector operations and returns the resulting vector, appended with the scalar product.
+    auto runOperations = [&](MathFit::Kernels::EInstructionSet instructionSet)
+    {
+        MathFit::Kernels::SetInstructionSet(instructionSet);
+
+        std::vector<double> data = first;
+        std::vector<double> operand = second;
+        MathFit::CVector sut(data.data(), length, 1, takeOwnershipOfData);
+        MathFit::CVector vOperand(operand.data(), length, 1, takeOwnershipOfData);
+
+        sut.Add(vOperand);
+        sut.Sub(vOperand, 0.25);
+        sut.MulSimple(vOperand);
+        sut.Add(vOperand, 3.0);
+        sut.DivSimple(vOperand);
+        sut.Sub(vOperand);
+        sut.Add(0.5);
+        sut.Sub(0.125);
+        sut.Mul(1.5);
+        sut.Div(3.0);
+
+        const double scalarProduct = sut.Mul(vOperand);
+        data.push_back(scalarProduct);
+        return data;
+    };
+
+    const std::vector<double> expected = runOperations(MathFit::Kernels::SCALAR);
+
+    for (int instructionSet = MathFit::Kernels::SSE2; instructionSet <= MathFit::Kernels::GetSupportedInstructionSet(); ++instructionSet)
+    {
+        const std::vector<double> result = runOperations(static_cast<MathFit::Kernels::EInstructionSet>(instructionSet));
+
+        // The element-wise operations must give identical results
+        for (int ii = 0; ii < length; ++ii)
+        {
+            REQUIRE(result[ii] == expected[ii]);
+        }
+
+        // The scalar product is summed in a different order
+        REQUIRE(result[length] == Approx(expected[length]).epsilon(1e-12));
+    }
+
+    SECTION("Strided vectors use the scalar implementation")
+    {
+        std::vector<double> data = first;
+        MathFit::CVector sut(data.data(), length / 2, 2, takeOwnershipOfData);
+
+        sut.Mul(2.0);
+
+        REQUIRE(data[0] == 2.0 * first[0]);
+        REQUIRE(data[1] == first[1]);
+        REQUIRE(data[2] == 2.0 * first[2]);
+    }
+
+    MathFit::Kernels::SetInstructionSet(originalInstructionSet);
+}
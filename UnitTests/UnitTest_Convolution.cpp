@@ -295,3 +295,178 @@ TEST_CASE("ConvolveReference returns expected output - reference lambda_max < sp
     }
 }
 
+
+
+TEST_CASE("ConvolveReferences returns same output as ConvolveReference for each reference", "[ConvolveReferences]")
+{
+    std::vector<double> wavelMapping = CreatePixelToWavelengthMapping(278.0, 423.0, 2048);
+
+    CCrossSectionData slf;
+    const double slfSigma = 0.7;
+    slf.m_waveLength = CreatePixelToWavelengthMapping(-2.0, +2.0, 41); // 0.1 nm resolution
+    slf.m_crossSection = CreateGaussian(slfSigma, slf.m_waveLength);
+
+    SECTION("References on the same wavelength grid")
+    {
+        // Three references with different structures, these are all convolved on the same grid as ConvolveReference uses.
+        std::vector<CCrossSectionData> highResReferences(3);
+        for (CCrossSectionData& reference : highResReferences)
+        {
+            reference.m_waveLength = CreatePixelToWavelengthMapping(270.0, 400.0, 8192);
+        }
+        highResReferences[0].m_crossSection = CreateGaussian(300.0, 0.5, highResReferences[0].m_waveLength);
+        highResReferences[1].m_crossSection = CreateGaussian(350.0, 5.0, highResReferences[1].m_waveLength);
+        highResReferences[2].m_crossSection = CreateGaussian(320.0, 1.5, highResReferences[2].m_waveLength);
+
+        for (ConvolutionMethod method : { ConvolutionMethod::Direct, ConvolutionMethod::Fft })
+        {
+            std::vector<std::vector<double>> results;
+            ConvolveReferences(wavelMapping, slf, highResReferences, results, WavelengthConversion::None, method);
+
+            REQUIRE(results.size() == highResReferences.size());
+            for (size_t referenceIdx = 0; referenceIdx < highResReferences.size(); ++referenceIdx)
+            {
+                std::vector<double> expectedResult;
+                ConvolveReference(wavelMapping, slf, highResReferences[referenceIdx], expectedResult, WavelengthConversion::None, ConvolutionMethod::Direct);
+
+                REQUIRE(results[referenceIdx].size() == wavelMapping.size());
+                REQUIRE(SumOfSquaredDifferences(results[referenceIdx], expectedResult) < 1e-20);
+            }
+        }
+    }
+
+    SECTION("References on different wavelength grids")
+    {
+        std::vector<CCrossSectionData> highResReferences(2);
+        highResReferences[0].m_waveLength = CreatePixelToWavelengthMapping(wavelMapping.front(), wavelMapping.back(), 8192);
+        highResReferences[0].m_crossSection = CreateGaussian(300.0, 1.5, highResReferences[0].m_waveLength);
+        highResReferences[1].m_waveLength = CreatePixelToWavelengthMapping(wavelMapping.front(), 350.0, 6000);
+        highResReferences[1].m_crossSection = CreateGaussian(320.0, 1.5, highResReferences[1].m_waveLength);
+
+        std::vector<std::vector<double>> results;
+        ConvolveReferences(wavelMapping, slf, highResReferences, results, WavelengthConversion::None, ConvolutionMethod::Fft);
+
+        REQUIRE(results.size() == highResReferences.size());
+        for (size_t referenceIdx = 0; referenceIdx < highResReferences.size(); ++referenceIdx)
+        {
+            std::vector<double> expectedResult;
+            ConvolveReference(wavelMapping, slf, highResReferences[referenceIdx], expectedResult, WavelengthConversion::None, ConvolutionMethod::Direct);
+
+            // The grids, and hence the sampling of the slf, differs slightly from ConvolveReference here.
+            REQUIRE(results[referenceIdx].size() == wavelMapping.size());
+            REQUIRE(SumOfSquaredDifferences(results[referenceIdx], expectedResult) < 1e-3);
+        }
+    }
+}
+
+TEST_CASE("ConvolveReferences with no references returns empty result", "[ConvolveReferences]")
+{
+    std::vector<double> wavelMapping = CreatePixelToWavelengthMapping(278.0, 423.0, 2048);
+
+    CCrossSectionData slf;
+    slf.m_waveLength = CreatePixelToWavelengthMapping(-2.0, +2.0, 41);
+    slf.m_crossSection = CreateGaussian(0.7, slf.m_waveLength);
+
+    std::vector<std::vector<double>> results(2);
+    ConvolveReferences(wavelMapping, slf, std::vector<CCrossSectionData>(), results);
+
+    REQUIRE(results.empty());
+}
+
+TEST_CASE("ConvolveReferences with invalid reference throws invalid_argument", "[ConvolveReferences]")
+{
+    std::vector<double> wavelMapping = CreatePixelToWavelengthMapping(278.0, 423.0, 2048);
+
+    CCrossSectionData slf;
+    slf.m_waveLength = CreatePixelToWavelengthMapping(-2.0, +2.0, 41);
+    slf.m_crossSection = CreateGaussian(0.7, slf.m_waveLength);
+
+    std::vector<CCrossSectionData> highResReferences(2);
+    highResReferences[0].m_waveLength = CreatePixelToWavelengthMapping(wavelMapping.front(), wavelMapping.back(), 8192);
+    highResReferences[0].m_crossSection = std::vector<double>(8192, 1.0);
+    highResReferences[1].m_waveLength = CreatePixelToWavelengthMapping(wavelMapping.front(), wavelMapping.back(), 8192);
+    highResReferences[1].m_crossSection = std::vector<double>(100, 1.0);
+
+    std::vector<std::vector<double>> results;
+    REQUIRE_THROWS_AS(ConvolveReferences(wavelMapping, slf, highResReferences, results), std::invalid_argument);
+}
+
+TEST_CASE("ReferenceConvolutionCache returns same output as ConvolveReference", "[ReferenceConvolutionCache]")
+{
+    std::vector<double> wavelMapping = CreatePixelToWavelengthMapping(278.0, 423.0, 2048);
+
+    CCrossSectionData slf;
+    slf.m_waveLength = CreatePixelToWavelengthMapping(-2.0, +2.0, 41); // 0.1 nm resolution
+    slf.m_crossSection = CreateGaussian(0.7, slf.m_waveLength);
+
+    CCrossSectionData highResReference;
+    highResReference.m_waveLength = CreatePixelToWavelengthMapping(270.0, 400.0, 8192);
+    highResReference.m_crossSection = CreateGaussian(300.0, 0.5, highResReference.m_waveLength);
+
+    std::vector<double> expectedResult;
+    ConvolveReference(wavelMapping, slf, highResReference, expectedResult, WavelengthConversion::None, ConvolutionMethod::Direct);
+
+    for (ConvolutionMethod method : { ConvolutionMethod::Direct, ConvolutionMethod::Fft })
+    {
+        ReferenceConvolutionCache sut{ highResReference };
+
+        std::vector<double> result;
+        sut.Convolve(wavelMapping, slf, result, method);
+
+        REQUIRE(result.size() == wavelMapping.size());
+        REQUIRE(SumOfSquaredDifferences(result, expectedResult) < 1e-20);
+
+        // Repeating the convolution reuses the grid and gives the same result
+        sut.Convolve(wavelMapping, slf, result, method);
+        REQUIRE(SumOfSquaredDifferences(result, expectedResult) < 1e-20);
+        REQUIRE(sut.NumberOfPreparedGrids() == 1);
+    }
+}
+
+TEST_CASE("ReferenceConvolutionCache reuses grid for slf of similar width", "[ReferenceConvolutionCache]")
+{
+    std::vector<double> wavelMapping = CreatePixelToWavelengthMapping(278.0, 423.0, 2048);
+
+    CCrossSectionData highResReference;
+    highResReference.m_waveLength = CreatePixelToWavelengthMapping(270.0, 400.0, 8192);
+    highResReference.m_crossSection = CreateGaussian(300.0, 1.5, highResReference.m_waveLength);
+
+    ReferenceConvolutionCache sut{ highResReference };
+
+    CCrossSectionData initialSlf;
+    initialSlf.m_waveLength = CreatePixelToWavelengthMapping(-2.0, +2.0, 41);
+    initialSlf.m_crossSection = CreateGaussian(0.7, initialSlf.m_waveLength);
+    std::vector<double> result;
+    sut.Convolve(wavelMapping, initialSlf, result, ConvolutionMethod::Fft);
+
+    SECTION("Wider slf, within the allowed range of the grid, gives nearly the same result as ConvolveReference")
+    {
+        CCrossSectionData slf;
+        slf.m_waveLength = CreatePixelToWavelengthMapping(-4.0, +4.0, 81);
+        slf.m_crossSection = CreateGaussian(1.2, slf.m_waveLength);
+
+        sut.Convolve(wavelMapping, slf, result, ConvolutionMethod::Fft);
+
+        std::vector<double> expectedResult;
+        ConvolveReference(wavelMapping, slf, highResReference, expectedResult, WavelengthConversion::None, ConvolutionMethod::Direct);
+
+        REQUIRE(sut.NumberOfPreparedGrids() == 1);
+        REQUIRE(result.size() == wavelMapping.size());
+        REQUIRE(SumOfSquaredDifferences(result, expectedResult) < 1e-3);
+    }
+
+    SECTION("Much narrower slf sets up a new grid")
+    {
+        CCrossSectionData slf;
+        slf.m_waveLength = CreatePixelToWavelengthMapping(-1.0, +1.0, 201);
+        slf.m_crossSection = CreateGaussian(0.1, slf.m_waveLength);
+
+        sut.Convolve(wavelMapping, slf, result, ConvolutionMethod::Fft);
+
+        std::vector<double> expectedResult;
+        ConvolveReference(wavelMapping, slf, highResReference, expectedResult, WavelengthConversion::None, ConvolutionMethod::Direct);
+
+        REQUIRE(sut.NumberOfPreparedGrids() == 2);
+        REQUIRE(SumOfSquaredDifferences(result, expectedResult) < 1e-20);
+    }
+}
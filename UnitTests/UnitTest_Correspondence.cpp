@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <SpectralEvaluation/Calibration/Correspondence.h>
+#include <SpectralEvaluation/Calibration/WavelengthCalibrationByRansac.h>
 #include <SpectralEvaluation/Math/PolynomialFit.h>
 
 namespace novac
@@ -616,4 +617,167 @@ namespace novac
             REQUIRE(isMonotonicallyIncreasing);
         }
     }
+
+    // Creates correspondences for 'numberOfKeypoints' measured keypoints, each with one correspondence following the actualModelPolynomial
+    //  and two false correspondences.
+    static std::vector<Correspondence> CreateCorrespondencesWithOutliers(const std::vector<double>& actualModelPolynomial, size_t numberOfKeypoints)
+    {
+        std::mt19937 rnd{ 1234 };
+        std::uniform_real_distribution<double> falseWavelengthOffset(1.0, 5.0);
+
+        std::vector<Correspondence> allCorrespondences;
+        for (size_t ii = 0; ii < numberOfKeypoints; ++ii)
+        {
+            Correspondence c;
+            c.measuredIdx = ii;
+            c.measuredValue = 100.0 + 45.0 * ii;
+            c.theoreticalIdx = 3 * ii;
+            c.theoreticalValue = PolynomialValueAt(actualModelPolynomial, c.measuredValue);
+            allCorrespondences.push_back(c);
+
+            for (size_t falseIdx = 1; falseIdx <= 2; ++falseIdx)
+            {
+                Correspondence falseCorrespondence = c;
+                falseCorrespondence.theoreticalIdx = 3 * ii + falseIdx;
+                falseCorrespondence.theoreticalValue += (falseIdx == 1) ? falseWavelengthOffset(rnd) : -falseWavelengthOffset(rnd);
+                allCorrespondences.push_back(falseCorrespondence);
+            }
+        }
+
+        return allCorrespondences;
+    }
+
+    TEST_CASE("Correspondence - CreateCorrespondencesByMeasuredKeypoint - correct arrangement", "[Calibration][WavelengthCalibration]")
+    {
+        std::vector<std::vector<Correspondence>> correspondencesArrangedByMeasuredKeypoint(4);
+        correspondencesArrangedByMeasuredKeypoint[0].push_back(Correspondence(0, 4, 0.0));
+        correspondencesArrangedByMeasuredKeypoint[0].push_back(Correspondence(0, 7, 0.0));
+        correspondencesArrangedByMeasuredKeypoint[2].push_back(Correspondence(2, 1, 0.0));
+        correspondencesArrangedByMeasuredKeypoint[3].push_back(Correspondence(3, 2, 0.0));
+        correspondencesArrangedByMeasuredKeypoint[3].push_back(Correspondence(3, 3, 0.0));
+        correspondencesArrangedByMeasuredKeypoint[0][0].measuredValue = 30.0;
+        correspondencesArrangedByMeasuredKeypoint[0][1].measuredValue = 30.0;
+        correspondencesArrangedByMeasuredKeypoint[2][0].measuredValue = 10.0;
+        correspondencesArrangedByMeasuredKeypoint[3][0].measuredValue = 20.0;
+        correspondencesArrangedByMeasuredKeypoint[3][1].measuredValue = 20.0;
+        correspondencesArrangedByMeasuredKeypoint[3][1].theoreticalValue = 5.0;
+
+        const auto result = CreateCorrespondencesByMeasuredKeypoint(correspondencesArrangedByMeasuredKeypoint);
+
+        REQUIRE(result.measuredValue == std::vector<double>{ 30.0, 10.0, 20.0 });
+        REQUIRE(result.keypointOffset == std::vector<size_t>{ 0, 2, 3, 5 });
+        REQUIRE(result.correspondence.size() == 5);
+        REQUIRE(result.theoreticalValue.size() == 5);
+        REQUIRE(result.correspondence[3].theoreticalIdx == 2);
+        REQUIRE(result.theoreticalValue[4] == 5.0);
+        REQUIRE(result.keypointsOrderedByMeasuredValue == std::vector<size_t>{ 1, 2, 0 });
+        REQUIRE(result.theoreticalIdxUpperBound == 8);
+        REQUIRE(result.hasKeypointsWithoutCorrespondences);
+    }
+
+    TEST_CASE("Correspondence - CountInliers - re-using scratch gives same result as without", "[Calibration][WavelengthCalibration]")
+    {
+        const std::vector<double> actualModelPolynomial{ 300.0, 0.05, -2.0e-6 };
+        const std::vector<double> suggestedModelPolynomial{ 300.02, 0.05, -2.0e-6 };
+        std::vector<Correspondence> allCorrespondences;
+        for (size_t ii = 0; ii < 40; ++ii)
+        {
+            for (size_t jj = 0; jj < 3; ++jj)
+            {
+                // Every keypoint has three possible correspondences where two share theoreticalIdx with the neighbouring keypoints.
+                Correspondence c;
+                c.measuredIdx = ii;
+                c.measuredValue = 100.0 + 45.0 * ii;
+                c.theoreticalIdx = ii + jj;
+                c.theoreticalValue = PolynomialValueAt(actualModelPolynomial, c.measuredValue) + 0.01 * jj;
+                allCorrespondences.push_back(c);
+            }
+        }
+        const auto correspondencesArrangedByMeasuredKeypoint = ArrangeByMeasuredKeypoint(allCorrespondences);
+        const auto correspondencesByMeasuredKeypoint = CreateCorrespondencesByMeasuredKeypoint(correspondencesArrangedByMeasuredKeypoint);
+
+        std::vector<Correspondence> expectedInliers;
+        double expectedMeanError;
+        bool expectedIsMonotonic;
+        const size_t expectedNumberOfInliers = CountInliers(suggestedModelPolynomial, correspondencesArrangedByMeasuredKeypoint, 0.1, expectedInliers, expectedMeanError, expectedIsMonotonic);
+
+        CountInliersScratch scratch;
+        for (int repetition = 0; repetition < 3; ++repetition)
+        {
+            std::vector<Correspondence> inliers;
+            double meanError;
+            bool isMonotonic;
+            const size_t numberOfInliers = CountInliers(suggestedModelPolynomial, correspondencesByMeasuredKeypoint, 0.1, inliers, meanError, isMonotonic, scratch);
+
+            REQUIRE(numberOfInliers == expectedNumberOfInliers);
+            REQUIRE(meanError == expectedMeanError);
+            REQUIRE(isMonotonic == expectedIsMonotonic);
+            REQUIRE(inliers.size() == expectedInliers.size());
+            for (size_t ii = 0; ii < inliers.size(); ++ii)
+            {
+                REQUIRE(inliers[ii].measuredIdx == expectedInliers[ii].measuredIdx);
+                REQUIRE(inliers[ii].theoreticalIdx == expectedInliers[ii].theoreticalIdx);
+            }
+            REQUIRE(AllTheoreticalPointsAreUnique(inliers));
+        }
+    }
+
+    TEST_CASE("RansacWavelengthCalibrationSetup - DoWavelengthCalibration", "[Calibration][WavelengthCalibration][Ransac]")
+    {
+        const std::vector<double> actualModelPolynomial{ 300.0, 0.05, -2.0e-6 };
+        const std::vector<Correspondence> allCorrespondences = CreateCorrespondencesWithOutliers(actualModelPolynomial, 40);
+
+        RansacWavelengthCalibrationSettings settings;
+        settings.modelPolynomialOrder = 2;
+        settings.numberOfRansacIterations = 20000;
+        settings.inlierLimitInWavelength = 0.1;
+        settings.randomSeed = 42;
+
+        SECTION("Finds the actual model")
+        {
+            RansacWavelengthCalibrationSetup sut{ settings };
+
+            const auto result = sut.DoWavelengthCalibration(allCorrespondences);
+
+            REQUIRE(result.highestNumberOfInliers == 40);
+            REQUIRE(result.bestFittingModelCoefficients.size() == 3);
+            REQUIRE(std::abs(result.bestFittingModelCoefficients[0] - actualModelPolynomial[0]) < 1e-6);
+            REQUIRE(std::abs(result.bestFittingModelCoefficients[1] - actualModelPolynomial[1]) < 1e-8);
+        }
+
+        SECTION("Same seed gives same result regardless of number of threads")
+        {
+            settings.numberOfThreads = 1;
+            const auto singleThreadedResult = RansacWavelengthCalibrationSetup{ settings }.DoWavelengthCalibration(allCorrespondences);
+
+            settings.numberOfThreads = 4;
+            const auto multiThreadedResult = RansacWavelengthCalibrationSetup{ settings }.DoWavelengthCalibration(allCorrespondences);
+
+            REQUIRE(singleThreadedResult.highestNumberOfInliers == multiThreadedResult.highestNumberOfInliers);
+            REQUIRE(singleThreadedResult.numberOfIterations == multiThreadedResult.numberOfIterations);
+            REQUIRE(singleThreadedResult.bestFittingModelCoefficients == multiThreadedResult.bestFittingModelCoefficients);
+            REQUIRE(singleThreadedResult.correspondenceIsInlier == multiThreadedResult.correspondenceIsInlier);
+        }
+
+        SECTION("Terminates early when the inlier ratio is high")
+        {
+            // A third of the correspondences are inliers, hence about 180 iterations are required for a confidence of 0.999.
+            RansacWavelengthCalibrationSetup sut{ settings };
+
+            const auto result = sut.DoWavelengthCalibration(allCorrespondences);
+
+            REQUIRE(result.numberOfIterations < 20000);
+        }
+
+        SECTION("Runs all iterations with termination confidence of one")
+        {
+            settings.terminationConfidence = 1.0;
+            RansacWavelengthCalibrationSetup sut{ settings };
+
+            const auto result = sut.DoWavelengthCalibration(allCorrespondences);
+
+            REQUIRE(result.numberOfIterations == 20000);
+            REQUIRE(result.highestNumberOfInliers == 40);
+        }
+    }
 }
@@ -0,0 +1,137 @@
+#include "catch.hpp"
+#include <SpectralEvaluation/Fit/CubicSplineCache.h>
+#include <SpectralEvaluation/Fit/ReferenceSpectrumFunction.h>
+#include <cmath>
+#include <memory>
+
+namespace
+{
+    void CreateSpectrum(MathFit::CVector& xValues, MathFit::CVector& yValues, double frequency)
+    {
+        const int length = 200;
+        xValues.SetSize(length);
+        yValues.SetSize(length);
+        for (int ii = 0; ii < length; ++ii)
+        {
+            xValues.SetAt(ii, ii);
+            yValues.SetAt(ii, std::sin(frequency * ii) + 0.01 * ii);
+        }
+    }
+
+    std::shared_ptr<const MathFit::CCubicSplineCoefficients> GetSpline(MathFit::CReferenceSpectrumFunction& reference)
+    {
+        return static_cast<MathFit::CCubicSplineFunction&>(reference.GetBasisFunction()).GetCoefficients();
+    }
+}
+
+TEST_CASE("CCubicSplineCache - References with identical data share one spline", "[Fit][CCubicSplineCache]")
+{
+    MathFit::CVector xValues;
+    MathFit::CVector yValues;
+    CreateSpectrum(xValues, yValues, 0.13);
+
+    const int originalSize = MathFit::CCubicSplineCache::GetSize();
+
+    {
+        MathFit::CReferenceSpectrumFunction first;
+        MathFit::CReferenceSpectrumFunction second;
+        REQUIRE(first.SetData(xValues, yValues));
+        REQUIRE(second.SetData(xValues, yValues));
+
+        REQUIRE(GetSpline(first) != nullptr);
+        REQUIRE(GetSpline(first) == GetSpline(second));
+        REQUIRE(originalSize + 1 == MathFit::CCubicSplineCache::GetSize());
+    }
+
+    // the spline is released together with the last reference using it
+    REQUIRE(originalSize == MathFit::CCubicSplineCache::GetSize());
+}
+
+TEST_CASE("CCubicSplineCache - References with different data do not share spline", "[Fit][CCubicSplineCache]")
+{
+    MathFit::CVector xValues;
+    MathFit::CVector firstYValues;
+    MathFit::CVector secondYValues;
+    CreateSpectrum(xValues, firstYValues, 0.13);
+    CreateSpectrum(xValues, secondYValues, 0.13);
+    secondYValues.SetAt(100, secondYValues.GetAt(100) + 1e-9);
+
+    MathFit::CReferenceSpectrumFunction first;
+    MathFit::CReferenceSpectrumFunction second;
+    REQUIRE(first.SetData(xValues, firstYValues));
+    REQUIRE(second.SetData(xValues, secondYValues));
+
+    REQUIRE(GetSpline(first) != GetSpline(second));
+
+    SECTION("Different grid")
+    {
+        MathFit::CVector shiftedXValues(xValues);
+        shiftedXValues.Add(0.5);
+
+        MathFit::CReferenceSpectrumFunction third;
+        REQUIRE(third.SetData(shiftedXValues, firstYValues));
+
+        REQUIRE(GetSpline(first) != GetSpline(third));
+    }
+}
+
+TEST_CASE("CCubicSplineCache - Shared spline gives same values as spline of its own", "[Fit][CCubicSplineCache]")
+{
+    MathFit::CVector xValues;
+    MathFit::CVector yValues;
+    CreateSpectrum(xValues, yValues, 0.27);
+
+    MathFit::CCubicSplineFunction expectedSpline(xValues, yValues);
+
+    MathFit::CReferenceSpectrumFunction first;
+    MathFit::CReferenceSpectrumFunction second;
+    REQUIRE(first.SetData(xValues, yValues));
+    REQUIRE(second.SetData(xValues, yValues));
+    REQUIRE(GetSpline(first) == GetSpline(second));
+
+    MathFit::CVector evaluationPoints(400);
+    for (int ii = 0; ii < evaluationPoints.GetSize(); ++ii)
+    {
+        evaluationPoints.SetAt(ii, 0.4 + 0.49 * ii);
+    }
+
+    MathFit::CVector expectedValues(evaluationPoints.GetSize());
+    MathFit::CVector expectedSlopes(evaluationPoints.GetSize());
+    expectedSpline.GetValues(evaluationPoints, expectedValues);
+    expectedSpline.GetSlopes(evaluationPoints, expectedSlopes);
+
+    MathFit::CVector values(evaluationPoints.GetSize());
+    MathFit::CVector slopes(evaluationPoints.GetSize());
+    second.GetBasisFunction().GetValues(evaluationPoints, values);
+    second.GetBasisFunction().GetSlopes(evaluationPoints, slopes);
+
+    for (int ii = 0; ii < evaluationPoints.GetSize(); ++ii)
+    {
+        REQUIRE(values.GetAt(ii) == expectedValues.GetAt(ii));
+        REQUIRE(slopes.GetAt(ii) == expectedSlopes.GetAt(ii));
+    }
+}
+
+TEST_CASE("CCubicSplineFunction - Changing data of shared spline does not change other users", "[Fit][CCubicSplineCache]")
+{
+    MathFit::CVector xValues;
+    MathFit::CVector yValues;
+    CreateSpectrum(xValues, yValues, 0.13);
+    const auto sharedSpline = MathFit::CCubicSplineCache::GetCoefficients(xValues, yValues);
+
+    MathFit::CVector error(xValues.GetSize());
+    error.Wedge(1, 0);
+    MathFit::CCubicSplineFunction first;
+    MathFit::CCubicSplineFunction second;
+    REQUIRE(first.SetCoefficients(sharedSpline, error));
+    REQUIRE(second.SetCoefficients(sharedSpline, error));
+
+    MathFit::CVector newYValues(yValues);
+    newYValues.Mul(2.0);
+    REQUIRE(second.SetYData(newYValues));
+
+    REQUIRE(first.GetCoefficients() == sharedSpline);
+    REQUIRE(second.GetCoefficients() != sharedSpline);
+    REQUIRE(first.GetValue(50.5) == Approx(0.5 * second.GetValue(50.5)));
+    REQUIRE(sharedSpline->IsCalculatedFrom(xValues, yValues));
+}
@@ -1,6 +1,8 @@
 #include "catch.hpp"
 #include <vector>
 #include <numeric>
+#include <cmath>
+#include <stdexcept>
 #include <SpectralEvaluation/Math/FFT.h>
 #include <SpectralEvaluation/VectorUtils.h>
 
@@ -188,3 +190,60 @@ TEST_CASE("InverseFft restores result of FftReal", "[Math][FFT][Fft_Real]")
         REQUIRE(std::abs(Max(imagOutput)) < std::numeric_limits<float>::epsilon());
     }
 }
+
+TEST_CASE("RealFftPlan Forward returns same result as Fft_Real", "[Math][FFT][RealFftPlan]")
+{
+    const size_t fftLength = 30;
+    std::vector<double> input(fftLength);
+    for (size_t ii = 0; ii < fftLength; ++ii)
+    {
+        input[ii] = std::sin(0.3 * ii) + 0.1 * ii;
+    }
+
+    std::vector<std::complex<double>> expectedOutput;
+    Fft_Real(input, expectedOutput);
+
+    RealFftPlan plan(fftLength);
+    REQUIRE(plan.Length() == fftLength);
+    REQUIRE(plan.SpectrumLength() == fftLength / 2 + 1);
+
+    std::vector<std::complex<double>> output(plan.SpectrumLength());
+    plan.Forward(input.data(), output.data());
+
+    for (size_t ii = 0; ii < plan.SpectrumLength(); ++ii)
+    {
+        REQUIRE(std::abs(output[ii] - expectedOutput[ii]) < 1e-12);
+    }
+}
+
+TEST_CASE("RealFftPlan Inverse restores result of Forward", "[Math][FFT][RealFftPlan]")
+{
+    const size_t fftLength = 28;
+    std::vector<double> input(fftLength);
+    for (size_t ii = 0; ii < fftLength; ++ii)
+    {
+        input[ii] = std::cos(0.7 * ii) - 0.5;
+    }
+
+    RealFftPlan plan(fftLength);
+    std::vector<std::complex<double>> spectrum(plan.SpectrumLength());
+    std::vector<double> output(fftLength, 1.0);
+
+    // The plan can be reused any number of times
+    for (int repetition = 0; repetition < 3; ++repetition)
+    {
+        plan.Forward(input.data(), spectrum.data());
+        plan.Inverse(spectrum.data(), output.data());
+
+        // The result should be equal to the input (but without the normalization factor)
+        for (size_t ii = 0; ii < fftLength; ++ii)
+        {
+            REQUIRE(std::abs(output[ii] - fftLength * input[ii]) < 1e-12);
+        }
+    }
+}
+
+TEST_CASE("RealFftPlan odd length throws invalid_argument", "[Math][FFT][RealFftPlan]")
+{
+    REQUIRE_THROWS_AS(RealFftPlan(27), std::invalid_argument);
+}
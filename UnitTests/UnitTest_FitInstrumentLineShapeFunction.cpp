@@ -49,7 +49,7 @@ TEST_CASE("FitInstrumentLineShape (Symmetric ApproximateGaussian): Simple Approx
     {
         const double sigma = 0.2; // [nm]
         std::vector<double> spec = CreateGaussian(sigma, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         GaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -62,7 +62,7 @@ TEST_CASE("FitInstrumentLineShape (Symmetric ApproximateGaussian): Simple Approx
     {
         const double sigma = 0.8; // [nm]
         std::vector<double> spec = CreateGaussian(sigma, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         GaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -75,7 +75,7 @@ TEST_CASE("FitInstrumentLineShape (Symmetric ApproximateGaussian): Simple Approx
     {
         const double sigma = 1.5; // [nm] this is very wide compared to the width of the wavelength window
         std::vector<double> spec = CreateGaussian(sigma, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         GaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -96,7 +96,7 @@ TEST_CASE("FitInstrumentLineShape (Symmetric ApproximateGaussian): Simple not ce
     {
         const double sigma = 0.2; // [nm]
         std::vector<double> spec = CreateGaussian(gaussianCenter, sigma, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         GaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -109,7 +109,7 @@ TEST_CASE("FitInstrumentLineShape (Symmetric ApproximateGaussian): Simple not ce
     {
         const double sigma = 0.8; // [nm]
         std::vector<double> spec = CreateGaussian(gaussianCenter, sigma, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         GaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -122,7 +122,7 @@ TEST_CASE("FitInstrumentLineShape (Symmetric ApproximateGaussian): Simple not ce
     {
         const double sigma = 1.5; // [nm] this is very wide compared to the width of the wavelength window
         std::vector<double> spec = CreateGaussian(gaussianCenter, sigma, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         GaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -144,7 +144,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
         const double sigmaLeft = 0.2; // [nm]
         const double sigmaRight = 0.2; // [nm]
         std::vector<double> spec = CreateAsymmetricGaussian(sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         AsymmetricGaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -159,7 +159,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
         const double sigmaLeft = 0.2; // [nm]
         const double sigmaRight = 0.5; // [nm]
         std::vector<double> spec = CreateAsymmetricGaussian(sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         AsymmetricGaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -174,7 +174,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
         const double sigmaLeft = 0.5; // [nm]
         const double sigmaRight = 0.2; // [nm]
         std::vector<double> spec = CreateAsymmetricGaussian(sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         AsymmetricGaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -189,7 +189,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
         const double sigmaLeft = 0.5; // [nm]
         const double sigmaRight = 1.5; // [nm] this is very wide compared to the width of the wavelength window
         std::vector<double> spec = CreateAsymmetricGaussian(sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         AsymmetricGaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -204,7 +204,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
         const double sigmaLeft = 1.5; // [nm] this is very wide compared to the width of the wavelength window
         const double sigmaRight = 0.5; // [nm]
         std::vector<double> spec = CreateAsymmetricGaussian(sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         AsymmetricGaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -228,7 +228,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
 //         const double sigmaLeft = 0.2; // [nm]
 //         const double sigmaRight = 0.2; // [nm]
 //         std::vector<double> spec = CreateAsymmetricGaussian(gaussianCenter, sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-//         memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+//         memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 // 
 //         AsymmetricGaussianLineShape result;
 //         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -243,7 +243,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
 //         const double sigmaLeft = 0.2; // [nm]
 //         const double sigmaRight = 0.5; // [nm]
 //         std::vector<double> spec = CreateAsymmetricGaussian(gaussianCenter, sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-//         memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+//         memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 // 
 //         AsymmetricGaussianLineShape result;
 //         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -258,7 +258,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
 //         const double sigmaLeft = 0.5; // [nm]
 //         const double sigmaRight = 0.2; // [nm]
 //         std::vector<double> spec = CreateAsymmetricGaussian(gaussianCenter, sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-//         memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+//         memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 // 
 //         AsymmetricGaussianLineShape result;
 //         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -273,7 +273,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
 //         const double sigmaLeft = 0.5; // [nm]
 //         const double sigmaRight = 1.5; // [nm] this is very wide compared to the width of the wavelength window
 //         std::vector<double> spec = CreateAsymmetricGaussian(gaussianCenter, sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-//         memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+//         memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 // 
 //         AsymmetricGaussianLineShape result;
 //         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -288,7 +288,7 @@ TEST_CASE("FitInstrumentLineShape (Asymmetric ApproximateGaussian): Simple Asyme
 //         const double sigmaLeft = 1.5; // [nm] this is very wide compared to the width of the wavelength window
 //         const double sigmaRight = 0.5; // [nm]
 //         std::vector<double> spec = CreateAsymmetricGaussian(gaussianCenter, sigmaLeft, sigmaRight, idealGaussian.m_wavelength);
-//         memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+//         memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 // 
 //         AsymmetricGaussianLineShape result;
 //         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -312,7 +312,7 @@ TEST_CASE("FitInstrumentLineShape (Symmetric Super ApproximateGaussian): Simple
         const double sigma = 0.2; // [nm]
         const double expectedWidth = sigma * std::sqrt(2.0);
         std::vector<double> spec = CreateGaussian(sigma, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         SuperGaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -335,7 +335,7 @@ TEST_CASE("FitInstrumentLineShape (Symmetric Super ApproximateGaussian): Simple
         const double sigma = 0.2; // [nm]
         const double expectedWidth = sigma * std::sqrt(2.0);
         std::vector<double> spec = CreateGaussian(gaussianCenter, sigma, idealGaussian.m_wavelength);
-        memcpy(&idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
+        memcpy(idealGaussian.m_data, spec.data(), spec.size() * sizeof(double));
 
         SuperGaussianLineShape result;
         auto ret = FitInstrumentLineShape(idealGaussian, result);
@@ -379,7 +379,7 @@ TEST_CASE("FitInstrumentLineShape: Real SLF input returns reasonable fitted func
     CSpectrum measuredSpectrum;
     measuredSpectrum.m_wavelength = xData;
     measuredSpectrum.m_length = (long)xData.size();
-    memcpy(&measuredSpectrum.m_data, yData.data(), yData.size() * sizeof(double));
+    memcpy(measuredSpectrum.m_data, yData.data(), yData.size() * sizeof(double));
 
     SECTION("Asmmetric ApproximateGaussian")
     {
@@ -11,14 +11,14 @@ TEST_CASE("FitWindow - Default constructor", "[CFitWindow]")
 
     SECTION("No references are defined")
     {
-        REQUIRE(sut.ref[0].m_data == nullptr);
+        REQUIRE(sut.ref[0].Data() == nullptr);
         REQUIRE(sut.nRef == 0);
     }
 }
 
-CCrossSectionData* CreateCrossSection(int startValue)
+std::unique_ptr<CCrossSectionData> CreateCrossSection(int startValue)
 {
-    CCrossSectionData* obj = new CCrossSectionData();
+    auto obj = std::make_unique<CCrossSectionData>();
 
     for (int k = 0; k < 100; ++k)
     {
@@ -36,17 +36,17 @@ TEST_CASE("FitWindow - Copy constructor", "[CFitWindow]")
     SECTION("Original has no references, then no references are copied.")
     {
         REQUIRE(original.nRef == 0);
-        REQUIRE(original.ref[0].m_data == nullptr);
+        REQUIRE(original.ref[0].Data() == nullptr);
 
         CReferenceFile ref1;
         ref1.m_specieName = "SO2";
         ref1.m_path = "C:/Novac/So2.txt";
-        ref1.m_data.reset(CreateCrossSection(1));
+        ref1.SetData(CreateCrossSection(1));
 
         CReferenceFile ref2;
         ref2.m_specieName = "O3";
         ref2.m_path = "C:/Novac/O3.txt";
-        ref2.m_data.reset(CreateCrossSection(2));
+        ref2.SetData(CreateCrossSection(2));
 
         original.ref[0] = ref1;
         original.ref[1] = ref2;
@@ -55,10 +55,62 @@ TEST_CASE("FitWindow - Copy constructor", "[CFitWindow]")
         CFitWindow copy{ original };
 
         REQUIRE(copy.nRef == 2);
-        REQUIRE(copy.ref[0].m_data != nullptr);
-        REQUIRE(copy.ref[1].m_data != nullptr);
+        REQUIRE(copy.ref[0].Data() != nullptr);
+        REQUIRE(copy.ref[1].Data() != nullptr);
     }
 
+    SECTION("Reference data is shared between the original and the copy")
+    {
+        original.ref[0].SetData(CreateCrossSection(1));
+        original.fraunhoferRef.SetData(CreateCrossSection(3));
+        original.nRef = 1;
+
+        CFitWindow copy{ original };
+
+        REQUIRE(copy.ref[0].Data() == original.ref[0].Data());
+        REQUIRE(copy.fraunhoferRef.Data() == original.fraunhoferRef.Data());
+    }
+}
+
+TEST_CASE("ReferenceFile - MutableData", "[CReferenceFile][CFitWindow]")
+{
+    CFitWindow original;
+    original.ref[0].SetData(CreateCrossSection(1));
+    original.nRef = 1;
+
+    SECTION("Data not shared, then the data is modified in place")
+    {
+        const CCrossSectionData* originalData = original.ref[0].Data().get();
+
+        original.ref[0].MutableData().m_crossSection[10] = -1.0;
+
+        REQUIRE(original.ref[0].Data().get() == originalData);
+        REQUIRE(original.ref[0].Data()->m_crossSection[10] == -1.0);
+    }
+
+    SECTION("Data shared, then the modified reference gets its own copy of the data")
+    {
+        CFitWindow copy{ original };
+
+        copy.ref[0].MutableData().m_crossSection[10] = -1.0;
+
+        REQUIRE(copy.ref[0].Data() != original.ref[0].Data());
+        REQUIRE(copy.ref[0].Data()->m_crossSection[10] == -1.0);
+        REQUIRE(original.ref[0].Data()->m_crossSection[10] == 10.0);
+        REQUIRE(copy.ref[0].Data()->m_crossSection[11] == original.ref[0].Data()->m_crossSection[11]);
+    }
+
+    SECTION("HighPassFilterReferences does not modify the references of copies of the window")
+    {
+        original.fitType = FIT_TYPE::FIT_HP_DIV;
+        original.ref[0].m_isFiltered = false;
+        CFitWindow copy{ original };
+
+        HighPassFilterReferences(copy);
+
+        REQUIRE(copy.ref[0].Data() != original.ref[0].Data());
+        REQUIRE(original.ref[0].Data()->m_crossSection[10] == 10.0);
+    }
 }
 
 TEST_CASE("FitWindow - AddAsReference", "[CFitWindow]")
@@ -75,8 +127,8 @@ TEST_CASE("FitWindow - AddAsReference", "[CFitWindow]")
     // Assert
     REQUIRE(window.nRef == 1);
     REQUIRE(window.ref[0].m_specieName == referenceName);
-    REQUIRE((size_t)window.ref[0].m_data->GetSize() == referenceData.size());
-    REQUIRE(window.ref[0].m_data->m_crossSection[10] == referenceData[10]);
+    REQUIRE((size_t)window.ref[0].Data()->GetSize() == referenceData.size());
+    REQUIRE(window.ref[0].Data()->m_crossSection[10] == referenceData[10]);
 
     REQUIRE(window.ref[0].m_columnOption == SHIFT_TYPE::SHIFT_FREE);
     REQUIRE(window.ref[0].m_shiftOption == SHIFT_TYPE::SHIFT_FIX);
@@ -98,8 +150,8 @@ TEST_CASE("FitWindow - AddAsSky", "[CFitWindow]")
     // Assert
     REQUIRE(window.nRef == 1);
     REQUIRE(window.ref[0].m_specieName == "sky");
-    REQUIRE((size_t)window.ref[0].m_data->GetSize() == referenceData.size());
-    REQUIRE(window.ref[0].m_data->m_crossSection[10] == referenceData[10]);
+    REQUIRE((size_t)window.ref[0].Data()->GetSize() == referenceData.size());
+    REQUIRE(window.ref[0].Data()->m_crossSection[10] == referenceData[10]);
 
     REQUIRE(window.ref[0].m_columnOption == SHIFT_TYPE::SHIFT_FIX);
     REQUIRE(window.ref[0].m_columnValue == -1.0);
@@ -120,8 +172,8 @@ TEST_CASE("FitWindow - AddAsSky - shift free", "[CFitWindow]")
     // Assert
     REQUIRE(window.nRef == 1);
     REQUIRE(window.ref[0].m_specieName == "sky");
-    REQUIRE((size_t)window.ref[0].m_data->GetSize() == referenceData.size());
-    REQUIRE(window.ref[0].m_data->m_crossSection[10] == referenceData[10]);
+    REQUIRE((size_t)window.ref[0].Data()->GetSize() == referenceData.size());
+    REQUIRE(window.ref[0].Data()->m_crossSection[10] == referenceData[10]);
 
     REQUIRE(window.ref[0].m_columnOption == SHIFT_TYPE::SHIFT_FIX);
     REQUIRE(window.ref[0].m_columnValue == -1.0);
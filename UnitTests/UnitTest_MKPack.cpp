@@ -0,0 +1,151 @@
+#include <SpectralEvaluation/File/MKPack.h>
+#include "catch.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace novac
+{
+    // Compresses the given spectrum using mk_compress, in the same way as CSpectrumIO::AddSpectrumToFile does.
+    static std::vector<std::uint8_t> Compress(const std::vector<long>& spectrum)
+    {
+        // mk_compress reads one value past the end of the input, hence the extra element.
+        std::vector<long> differences(spectrum.size() + 1, 0);
+        differences[0] = spectrum[0];
+        for (size_t ii = 1; ii < spectrum.size(); ++ii)
+        {
+            differences[ii] = spectrum[ii] - spectrum[ii - 1];
+        }
+
+        std::vector<std::uint8_t> compressed(16384, 0);
+        MKPack mkPack;
+        const std::uint16_t size = mkPack.mk_compress(differences.data(), compressed.data(), (std::uint16_t)spectrum.size());
+        compressed.resize(size);
+        return compressed;
+    }
+
+    // Creates a spectrum where the differences between consecutive pixels are (at most) of the given magnitude.
+    static std::vector<long> CreateSpectrum(size_t length, long maximumDifference, unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<long> difference(-maximumDifference, maximumDifference);
+
+        std::vector<long> spectrum(length);
+        spectrum[0] = 40000;
+        for (size_t ii = 1; ii < length; ++ii)
+        {
+            spectrum[ii] = spectrum[ii - 1] + difference(generator);
+        }
+        return spectrum;
+    }
+
+    static void RequireRoundTrip(const std::vector<long>& spectrum)
+    {
+        std::vector<std::uint8_t> compressed = Compress(spectrum);
+        const long pixels = (long)spectrum.size();
+
+        std::vector<std::int32_t> intResult(pixels);
+        REQUIRE(pixels == MKPack::UnPack(compressed.data(), compressed.size(), pixels, intResult.data()));
+
+        std::vector<double> doubleResult(pixels);
+        REQUIRE(pixels == MKPack::UnPack(compressed.data(), compressed.size(), pixels, doubleResult.data()));
+
+        // the original decoder, as reference
+        std::vector<long> legacyResult(pixels);
+        MKPack mkPack;
+        REQUIRE(pixels == mkPack.UnPack(compressed.data(), pixels, legacyResult.data()));
+
+        for (long ii = 0; ii < pixels; ++ii)
+        {
+            REQUIRE(intResult[ii] == spectrum[ii]);
+            REQUIRE(doubleResult[ii] == (double)spectrum[ii]);
+            REQUIRE(legacyResult[ii] == spectrum[ii]);
+        }
+    }
+
+    TEST_CASE("MKPack UnPack restores compressed spectrum", "[MKPack][File]")
+    {
+        SECTION("Constant spectrum")
+        {
+            RequireRoundTrip(std::vector<long>(2048, 1234));
+        }
+
+        SECTION("Small differences")
+        {
+            RequireRoundTrip(CreateSpectrum(2048, 3, 1));
+        }
+
+        SECTION("Medium differences")
+        {
+            RequireRoundTrip(CreateSpectrum(2048, 500, 2));
+        }
+
+        SECTION("Large differences")
+        {
+            RequireRoundTrip(CreateSpectrum(2048, 1 << 20, 3));
+        }
+
+        SECTION("Varying differences")
+        {
+            std::vector<long> spectrum = CreateSpectrum(3648, 40, 4);
+            for (size_t ii = 1000; ii < 1300; ++ii)
+            {
+                spectrum[ii] += (ii % 2) ? 100000 : -3;
+            }
+            for (size_t ii = 2000; ii < 2500; ++ii)
+            {
+                spectrum[ii] = spectrum[1999];
+            }
+            RequireRoundTrip(spectrum);
+        }
+
+        SECTION("Short spectrum")
+        {
+            RequireRoundTrip(CreateSpectrum(7, 1000, 5));
+        }
+    }
+
+    TEST_CASE("MKPack UnPack with invalid input returns -1", "[MKPack][File]")
+    {
+        const std::vector<long> spectrum = CreateSpectrum(2048, 500, 6);
+        std::vector<std::uint8_t> compressed = Compress(spectrum);
+        std::vector<double> result(spectrum.size());
+
+        SECTION("Truncated data")
+        {
+            REQUIRE(-1 == MKPack::UnPack(compressed.data(), compressed.size() / 2, (long)spectrum.size(), result.data()));
+        }
+
+        SECTION("More pixels than in the data")
+        {
+            REQUIRE(-1 == MKPack::UnPack(compressed.data(), compressed.size(), (long)spectrum.size() + 100, result.data()));
+        }
+
+        SECTION("Segment longer than the number of pixels")
+        {
+            REQUIRE(-1 == MKPack::UnPack(compressed.data(), compressed.size(), 10, result.data()));
+        }
+
+        SECTION("No data")
+        {
+            REQUIRE(-1 == MKPack::UnPack(nullptr, 0, (long)spectrum.size(), result.data()));
+        }
+    }
+
+    TEST_CASE("MKPack Checksum", "[MKPack][File]")
+    {
+        const std::vector<long> spectrum = CreateSpectrum(2048, 5000, 7);
+
+        std::uint32_t chk = 0;
+        std::vector<double> values(spectrum.size());
+        for (size_t ii = 0; ii < spectrum.size(); ++ii)
+        {
+            chk += (std::uint32_t)spectrum[ii];
+            values[ii] = (double)spectrum[ii];
+        }
+        const std::uint16_t* p = (std::uint16_t*)&chk;
+        const std::uint16_t expected = p[0] + p[1];
+
+        REQUIRE(expected == MKPack::Checksum(values.data(), (long)values.size()));
+    }
+}
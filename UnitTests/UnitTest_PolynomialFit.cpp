@@ -1,5 +1,7 @@
 #include "catch.hpp"
 #include <SpectralEvaluation/Math/PolynomialFit.h>
+#include <SpectralEvaluation/Fit/VectorKernels.h>
+#include <algorithm>
 
 using namespace novac;
 
@@ -50,6 +52,49 @@ TEST_CASE("PolynomialFit - PolynomialValueAt", "[Math][PolynomialFit]")
 }
 
 
+TEST_CASE("PolynomialFit - PolynomialValuesAt", "[Math][PolynomialFit]")
+{
+    // An odd number of points, such that the kernels also have to handle the remaining elements.
+    std::vector<double> x;
+    for (int ii = 0; ii < 37; ++ii)
+    {
+        x.push_back(-3.0 + 0.173 * ii);
+    }
+
+    const MathFit::Kernels::EInstructionSet originalInstructionSet = MathFit::Kernels::GetInstructionSet();
+
+    SECTION("Empty polynomial gives zeros")
+    {
+        std::vector<double> result{ 1.0, 2.0 };
+        PolynomialValuesAt(std::vector<double>{}, x, result);
+
+        REQUIRE(result.size() == x.size());
+        REQUIRE(std::all_of(result.begin(), result.end(), [](double v) { return v == 0.0; }));
+    }
+
+    SECTION("Same values as PolynomialValueAt with all instruction sets")
+    {
+        const std::vector<double> polynomial{ 302.1, 0.0512, -2.1e-6, 3.3e-10 };
+
+        for (int instructionSet = MathFit::Kernels::SCALAR; instructionSet <= MathFit::Kernels::GetSupportedInstructionSet(); ++instructionSet)
+        {
+            MathFit::Kernels::SetInstructionSet(static_cast<MathFit::Kernels::EInstructionSet>(instructionSet));
+
+            std::vector<double> result;
+            PolynomialValuesAt(polynomial, x, result);
+
+            REQUIRE(result.size() == x.size());
+            for (size_t ii = 0; ii < x.size(); ++ii)
+            {
+                REQUIRE(result[ii] == PolynomialValueAt(polynomial, x[ii]));
+            }
+        }
+    }
+
+    MathFit::Kernels::SetInstructionSet(originalInstructionSet);
+}
+
+
 TEST_CASE("PolynomialFit - FindRoots", "[Math][PolynomialFit]")
 {
     SECTION("Constant")
@@ -0,0 +1,126 @@
+#include <SpectralEvaluation/Spectra/ScanSpectrumReduction.h>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include "catch.hpp"
+
+namespace novac
+{
+    // Creates a spectrum with the provided length, where pixel i has the value 'level + i' (and hence is not dark)
+    static CSpectrum CreateSpectrum(long length, double level, long numberOfReadouts)
+    {
+        std::vector<double> data(length);
+        for (long ii = 0; ii < length; ++ii)
+        {
+            data[ii] = level + (double)ii;
+        }
+        CSpectrum spectrum{ data };
+        spectrum.m_info.m_numSpec = numberOfReadouts;
+        return spectrum;
+    }
+
+    static CSpectrum CreateDarkSpectrum(long length, long numberOfReadouts)
+    {
+        std::vector<double> data(length, 150.0);
+        CSpectrum spectrum{ data };
+        spectrum.m_info.m_numSpec = numberOfReadouts;
+        return spectrum;
+    }
+
+    TEST_CASE("SumGoodSpectra", "[ScanSpectrumReduction][SumGoodSpectra]")
+    {
+        const long length = 2048;
+        GoodSpectrumCriteria criteria;
+        criteria.fromPixel = 300;
+        criteria.toPixel = 500;
+        criteria.maximumIntensityForSingleReadout = 4095.0;
+        criteria.excludeDarkSpectra = true;
+        CSpectrum result;
+
+        SECTION("No spectra, returns zero and clears result")
+        {
+            result = CreateSpectrum(length, 1000.0, 1);
+            std::vector<CSpectrum> spectra;
+
+            REQUIRE(0 == SumGoodSpectra(spectra, criteria, result));
+            REQUIRE(result.m_length == 0);
+        }
+
+        SECTION("All spectra good, returns sum of all spectra")
+        {
+            std::vector<CSpectrum> spectra;
+            CSpectrum expected = CreateSpectrum(length, 1000.0, 10);
+            spectra.push_back(expected);
+            for (int ii = 1; ii < 100; ++ii)
+            {
+                spectra.push_back(CreateSpectrum(length, 1000.0 + ii, 10));
+                expected.Add(spectra.back());
+            }
+
+            REQUIRE(100 == SumGoodSpectra(spectra, criteria, result));
+
+            REQUIRE(result.m_length == length);
+            REQUIRE(result.NumSpectra() == 1000);
+            for (long ii = 0; ii < length; ++ii)
+            {
+                REQUIRE(result.m_data[ii] == expected.m_data[ii]);
+            }
+        }
+
+        SECTION("Saturated and dark spectra are excluded")
+        {
+            std::vector<CSpectrum> spectra;
+            spectra.push_back(CreateSpectrum(length, 4095.0 * 10, 10)); // saturated
+            spectra.push_back(CreateDarkSpectrum(length, 10));
+            spectra.push_back(CreateSpectrum(length, 1000.0, 10));
+            spectra.push_back(CreateSpectrum(length, 2000.0, 10));
+
+            REQUIRE(2 == SumGoodSpectra(spectra, criteria, result));
+
+            REQUIRE(result.NumSpectra() == 20);
+            REQUIRE(result.m_data[0] == 3000.0);
+            REQUIRE(result.m_data[1] == 3002.0);
+        }
+
+        SECTION("Saturation not checked, saturated spectra are included")
+        {
+            criteria.maximumIntensityForSingleReadout = 0.0;
+            std::vector<CSpectrum> spectra;
+            spectra.push_back(CreateSpectrum(length, 4095.0 * 10, 10));
+            spectra.push_back(CreateSpectrum(length, 1000.0, 10));
+
+            REQUIRE(2 == SumGoodSpectra(spectra, criteria, result));
+            REQUIRE(result.m_data[0] == 41950.0);
+        }
+
+        SECTION("Spectra with different length than the first good spectrum are excluded")
+        {
+            std::vector<CSpectrum> spectra;
+            spectra.push_back(CreateSpectrum(length, 1000.0, 10));
+            spectra.push_back(CreateSpectrum(length / 2, 1000.0, 10));
+            spectra.push_back(CreateSpectrum(length, 1000.0, 10));
+
+            REQUIRE(2 == SumGoodSpectra(spectra, criteria, result));
+            REQUIRE(result.m_length == length);
+            REQUIRE(result.m_data[0] == 2000.0);
+        }
+
+        SECTION("Meta data combined as in CSpectrum::Add")
+        {
+            std::vector<CSpectrum> spectra;
+            spectra.push_back(CreateSpectrum(length, 1000.0, 10));
+            spectra.back().m_info.m_name = "first";
+            spectra.back().m_info.m_startTime = CDateTime(2023, 1, 2, 12, 0, 0);
+            spectra.back().m_info.m_stopTime = CDateTime(2023, 1, 2, 12, 0, 10);
+            spectra.push_back(CreateSpectrum(length, 1000.0, 15));
+            spectra.back().m_info.m_name = "second";
+            spectra.back().m_info.m_startTime = CDateTime(2023, 1, 2, 11, 0, 0);
+            spectra.back().m_info.m_stopTime = CDateTime(2023, 1, 2, 13, 0, 0);
+
+            REQUIRE(2 == SumGoodSpectra(spectra, criteria, result));
+
+            REQUIRE(result.m_info.m_name == "first");
+            REQUIRE(result.NumSpectra() == 25);
+            REQUIRE(result.m_info.m_startTime == CDateTime(2023, 1, 2, 11, 0, 0));
+            REQUIRE(result.m_info.m_stopTime == CDateTime(2023, 1, 2, 13, 0, 0));
+        }
+    }
+}
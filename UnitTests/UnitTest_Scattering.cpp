@@ -0,0 +1,119 @@
+#include <SpectralEvaluation/Spectra/Scattering.h>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <SpectralEvaluation/Fit/Vector.h>
+#include "catch.hpp"
+#include <cmath>
+
+namespace novac
+{
+    // Creates a spectrum-like signal on a typical wavelength calibration, with a smooth background and narrow Fraunhofer lines.
+    static CSpectrum CreateSkySpectrum(size_t length)
+    {
+        std::vector<double> wavelength(length);
+        std::vector<double> intensity(length);
+        for (size_t ii = 0; ii < length; ++ii)
+        {
+            const double x = (double)ii;
+            wavelength[ii] = 280.0 + 0.06 * x + 2.0e-6 * x * x;
+            intensity[ii] = (1000.0 + 30000.0 * std::exp(-std::pow((x - 1200.0) / 600.0, 2.0))) * (1.0 - 0.4 * std::pow(std::sin(0.21 * x), 10.0));
+        }
+        return CSpectrum(wavelength, intensity);
+    }
+
+    // The Ring spectrum calculated as Scattering::CalcRingSpectrum originally did, with one spline lookup per scattered line.
+    static std::vector<double> ReferenceRingSpectrum(CSpectrum& spectrum, double temperature, int jMax, double mixing, double sza)
+    {
+        MathFit::CVector wavelength(spectrum.m_wavelength.data(), (int)spectrum.m_length, 1, false);
+        MathFit::CVector energy((int)spectrum.m_length);
+        for (int ii = 0; ii < (int)spectrum.m_length; ++ii)
+        {
+            energy.SetAt(ii, spectrum.m_data[ii] / spectrum.m_wavelength[ii]);
+        }
+        MathFit::CVector raman = Doasis::Scattering::CalcRamanSpectrum(wavelength, energy, temperature, jMax, mixing, sza);
+        raman.DivSimpleSafe(energy);
+
+        std::vector<double> result(spectrum.m_length);
+        for (int ii = 0; ii < (int)spectrum.m_length; ++ii)
+        {
+            result[ii] = raman.GetAt(ii);
+        }
+        return result;
+    }
+
+    static double MaximumRelativeDifference(const std::vector<double>& expected, const double* actual)
+    {
+        double maximumValue = 0.0;
+        double maximumDifference = 0.0;
+        for (size_t ii = 0; ii < expected.size(); ++ii)
+        {
+            maximumValue = std::max(maximumValue, std::abs(expected[ii]));
+            maximumDifference = std::max(maximumDifference, std::abs(actual[ii] - expected[ii]));
+        }
+        return maximumDifference / maximumValue;
+    }
+
+    TEST_CASE("RingSpectrumCalculator gives same result as scattering each pixel", "[Scattering][Ring]")
+    {
+        CSpectrum sky = CreateSkySpectrum(2048);
+        const std::vector<double> expected = ReferenceRingSpectrum(sky, 250.0, 30, 0.8, 90.0);
+
+        SECTION("RingSpectrumCalculator")
+        {
+            Doasis::RingSpectrumCalculator sut{ sky.m_wavelength, 250.0, 30, 0.8 };
+            std::vector<double> result(sky.m_length);
+
+            sut.CalcRingSpectrum(sky.m_data, result.data(), 90.0);
+
+            REQUIRE(MaximumRelativeDifference(expected, result.data()) < 1e-12);
+        }
+
+        SECTION("RingSpectrumCalculator, same calculator for different SZA")
+        {
+            const std::vector<double> expectedAtOtherSza = ReferenceRingSpectrum(sky, 250.0, 30, 0.8, 60.0);
+            Doasis::RingSpectrumCalculator sut{ sky.m_wavelength, 250.0, 30, 0.8 };
+            std::vector<double> result(sky.m_length);
+
+            sut.CalcRingSpectrum(sky.m_data, result.data(), 90.0);
+            sut.CalcRingSpectrum(sky.m_data, result.data(), 60.0);
+
+            REQUIRE(MaximumRelativeDifference(expectedAtOtherSza, result.data()) < 1e-12);
+        }
+
+        SECTION("Scattering::CalcRingSpectrum, repeated calls")
+        {
+            for (int repetition = 0; repetition < 3; ++repetition)
+            {
+                CSpectrum ring = Doasis::Scattering::CalcRingSpectrum(sky);
+
+                REQUIRE(ring.m_length == sky.m_length);
+                REQUIRE(ring.m_wavelength == sky.m_wavelength);
+                REQUIRE(MaximumRelativeDifference(expected, ring.m_data) < 1e-12);
+            }
+        }
+
+        SECTION("Scattering::CalcRingSpectrum, different parameters")
+        {
+            const std::vector<double> expectedAtOtherTemperature = ReferenceRingSpectrum(sky, 220.0, 20, 0.78, 60.0);
+
+            CSpectrum ring = Doasis::Scattering::CalcRingSpectrum(sky, 220.0, 20, 0.78, 60.0);
+
+            REQUIRE(MaximumRelativeDifference(expectedAtOtherTemperature, ring.m_data) < 1e-12);
+        }
+    }
+
+    TEST_CASE("RingSpectrumCalculator IsSetupFor", "[Scattering][Ring]")
+    {
+        CSpectrum sky = CreateSkySpectrum(512);
+        Doasis::RingSpectrumCalculator sut{ sky.m_wavelength, 250.0, 30, 0.8 };
+
+        REQUIRE(sut.Length() == 512);
+        REQUIRE(sut.IsSetupFor(sky.m_wavelength, 250.0, 30, 0.8));
+        REQUIRE_FALSE(sut.IsSetupFor(sky.m_wavelength, 251.0, 30, 0.8));
+        REQUIRE_FALSE(sut.IsSetupFor(sky.m_wavelength, 250.0, 29, 0.8));
+        REQUIRE_FALSE(sut.IsSetupFor(sky.m_wavelength, 250.0, 30, 0.78));
+
+        std::vector<double> shiftedWavelength = sky.m_wavelength;
+        shiftedWavelength[100] += 1e-6;
+        REQUIRE_FALSE(sut.IsSetupFor(shiftedWavelength, 250.0, 30, 0.8));
+    }
+}
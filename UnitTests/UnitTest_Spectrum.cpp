@@ -0,0 +1,226 @@
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <SpectralEvaluation/Spectra/SpectrumDataPool.h>
+#include <SpectralEvaluation/Spectra/SpectrumView.h>
+#include "catch.hpp"
+#include <type_traits>
+#include <utility>
+
+namespace novac
+{
+    static std::vector<double> CreateSpectrumData(size_t length)
+    {
+        std::vector<double> data(length);
+        for (size_t ii = 0; ii < length; ++ii)
+        {
+            data[ii] = 1000.0 + (double)(ii % 97);
+        }
+        return data;
+    }
+
+    TEST_CASE("CSpectrum storage", "[Spectrum]")
+    {
+        SECTION("Default constructed spectrum has room for MAX_SPECTRUM_LENGTH zeros")
+        {
+            CSpectrum sut;
+
+            REQUIRE(sut.m_length == 0);
+            REQUIRE(sut.Capacity() == MAX_SPECTRUM_LENGTH);
+            for (long ii = 0; ii < MAX_SPECTRUM_LENGTH; ++ii)
+            {
+                REQUIRE(sut.m_data[ii] == 0.0);
+            }
+        }
+
+        SECTION("Copy has room for MAX_SPECTRUM_LENGTH values")
+        {
+            const std::vector<double> data = CreateSpectrumData(2048);
+            CSpectrum original(data);
+
+            CSpectrum sut(original);
+
+            REQUIRE(sut.m_length == 2048);
+            REQUIRE(sut.Capacity() == MAX_SPECTRUM_LENGTH);
+            REQUIRE(sut.m_data != original.m_data);
+            for (long ii = 0; ii < sut.m_length; ++ii)
+            {
+                REQUIRE(sut.m_data[ii] == data[ii]);
+            }
+        }
+
+        SECTION("Copy assignment copies the values")
+        {
+            const std::vector<double> data = CreateSpectrumData(3000);
+            CSpectrum original(data);
+            CSpectrum sut(CreateSpectrumData(10));
+
+            sut = original;
+
+            REQUIRE(sut.m_length == 3000);
+            REQUIRE(sut.Capacity() >= 3000);
+            for (long ii = 0; ii < sut.m_length; ++ii)
+            {
+                REQUIRE(sut.m_data[ii] == data[ii]);
+            }
+        }
+
+        SECTION("Move takes over the storage")
+        {
+            CSpectrum original(CreateSpectrumData(2048));
+            const double* originalData = original.m_data;
+
+            CSpectrum sut(std::move(original));
+
+            REQUIRE(sut.m_data == originalData);
+            REQUIRE(sut.m_length == 2048);
+            REQUIRE(original.m_length == 0);
+            REQUIRE(original.Capacity() == MAX_SPECTRUM_LENGTH);
+            REQUIRE(original.m_data != nullptr);
+
+            CSpectrum other;
+            other = std::move(sut);
+            REQUIRE(other.m_data == originalData);
+            REQUIRE(other.m_length == 2048);
+            REQUIRE(sut.m_length == 0);
+            REQUIRE(sut.Capacity() >= MAX_SPECTRUM_LENGTH);
+            REQUIRE(sut.m_data != nullptr);
+        }
+
+        SECTION("Copy of spectrum longer than MAX_SPECTRUM_LENGTH has room for all values")
+        {
+            const std::vector<double> data = CreateSpectrumData(10000);
+            CSpectrum original(data);
+
+            CSpectrum sut(original);
+
+            REQUIRE(sut.m_length == 10000);
+            REQUIRE(sut.Capacity() >= 10000);
+            REQUIRE(sut.m_data[9999] == data[9999]);
+        }
+
+        SECTION("Spectrum longer than MAX_SPECTRUM_LENGTH keeps all values")
+        {
+            const std::vector<double> data = CreateSpectrumData(10000);
+
+            CSpectrum sut(data);
+
+            REQUIRE(sut.m_length == 10000);
+            REQUIRE(sut.Capacity() >= 10000);
+            REQUIRE(sut.m_data[9999] == data[9999]);
+            REQUIRE(sut.MaxValue() == 1096.0);
+        }
+
+        SECTION("Resize keeps values and clears added pixels")
+        {
+            const std::vector<double> data = CreateSpectrumData(2048);
+            CSpectrum sut(data);
+
+            sut.Resize(6000);
+
+            REQUIRE(sut.m_length == 6000);
+            REQUIRE(sut.Capacity() >= 6000);
+            for (long ii = 0; ii < 2048; ++ii)
+            {
+                REQUIRE(sut.m_data[ii] == data[ii]);
+            }
+            for (long ii = 2048; ii < 6000; ++ii)
+            {
+                REQUIRE(sut.m_data[ii] == 0.0);
+            }
+        }
+
+        SECTION("Split spectrum into spectra with less capacity")
+        {
+            CSpectrum sut(CreateSpectrumData(2048));
+            sut.m_info.m_channel = 129;
+            CSpectrum first(CreateSpectrumData(1));
+            CSpectrum second(CreateSpectrumData(1));
+            CSpectrum* result[MAX_CHANNEL_NUM] = { &first, &second };
+
+            REQUIRE(2 == sut.Split(result));
+
+            REQUIRE(first.m_length + second.m_length == 2047);
+            REQUIRE(first.Capacity() >= first.m_length);
+            REQUIRE(second.Capacity() >= second.m_length);
+        }
+    }
+
+    TEST_CASE("SpectrumDataPool reuses released buffers", "[Spectrum][SpectrumDataPool]")
+    {
+        size_t capacity = 0;
+        double* first = SpectrumDataPool::Allocate(2000, capacity);
+        REQUIRE(first != nullptr);
+        REQUIRE(capacity == 2048);
+
+        const size_t cachedBuffers = SpectrumDataPool::CachedBufferCount();
+        SpectrumDataPool::Release(first, capacity);
+        REQUIRE(SpectrumDataPool::CachedBufferCount() == cachedBuffers + 1);
+
+        size_t secondCapacity = 0;
+        double* second = SpectrumDataPool::Allocate(2048, secondCapacity);
+        REQUIRE(second == first);
+        REQUIRE(secondCapacity == 2048);
+        REQUIRE(SpectrumDataPool::CachedBufferCount() == cachedBuffers);
+
+        SpectrumDataPool::Release(second, secondCapacity);
+
+        SECTION("Zero length gives no buffer")
+        {
+            REQUIRE(nullptr == SpectrumDataPool::Allocate(0, capacity));
+            REQUIRE(capacity == 0);
+        }
+    }
+
+    TEST_CASE("SpectrumView refers to the viewed data", "[Spectrum][SpectrumView]")
+    {
+        CSpectrum spectrum(CreateSpectrumData(2048));
+
+        SECTION("View of spectrum")
+        {
+            SpectrumView sut(spectrum);
+
+            REQUIRE(sut.data() == spectrum.m_data);
+            REQUIRE(sut.size() == 2048);
+            REQUIRE(sut[100] == spectrum.m_data[100]);
+        }
+
+        SECTION("Writing through mutable view changes the spectrum")
+        {
+            MutableSpectrumView sut(spectrum);
+
+            sut[10] = -1.0;
+
+            REQUIRE(spectrum.m_data[10] == -1.0);
+        }
+
+        SECTION("Sub view")
+        {
+            const std::vector<double> data = CreateSpectrumData(100);
+            SpectrumView sut = SpectrumView(data).SubView(20, 10);
+
+            REQUIRE(sut.data() == data.data() + 20);
+            REQUIRE(sut.size() == 10);
+            REQUIRE(sut.end() - sut.begin() == 10);
+        }
+
+        SECTION("Mutable view converts to view")
+        {
+            MutableSpectrumView mutableView(spectrum);
+            SpectrumView sut = mutableView;
+
+            REQUIRE(sut.data() == spectrum.m_data);
+            REQUIRE(sut.size() == mutableView.size());
+        }
+
+        SECTION("Only a read-only view can be created of const data")
+        {
+            static_assert(!std::is_constructible<MutableSpectrumView, const CSpectrum&>::value, "MutableSpectrumView of const CSpectrum");
+            static_assert(!std::is_constructible<MutableSpectrumView, const std::vector<double>&>::value, "MutableSpectrumView of const vector");
+            static_assert(std::is_constructible<MutableSpectrumView, CSpectrum&>::value, "MutableSpectrumView of CSpectrum");
+
+            const CSpectrum& constSpectrum = spectrum;
+            SpectrumView sut(constSpectrum);
+
+            REQUIRE(sut.data() == spectrum.m_data);
+        }
+    }
+}
@@ -85,7 +85,7 @@ namespace novac
             const double sigma = 0.2; // [nm]
             const double center = inputSpectrum.m_wavelength[inputSpectrum.m_length / 2];
             std::vector<double> spec = CreateGaussian(center, sigma, inputSpectrum.m_wavelength);
-            memcpy(&inputSpectrum.m_data, spec.data(), spec.size() * sizeof(double));
+            memcpy(inputSpectrum.m_data, spec.data(), spec.size() * sizeof(double));
 
             novac::FindPeaks(inputSpectrum, 0.0, result);
 
@@ -100,7 +100,7 @@ namespace novac
             const double sigma = 0.2; // [nm]
             const double center = inputSpectrum.m_wavelength[0] + 0.42 * (inputSpectrum.m_wavelength[inputSpectrum.m_length - 1] - inputSpectrum.m_wavelength[0]);
             std::vector<double> spec = CreateGaussian(center, sigma, inputSpectrum.m_wavelength);
-            memcpy(&inputSpectrum.m_data, spec.data(), spec.size() * sizeof(double));
+            memcpy(inputSpectrum.m_data, spec.data(), spec.size() * sizeof(double));
 
             novac::FindPeaks(inputSpectrum, 0.0, result);
 
@@ -0,0 +1,196 @@
+#include <SpectralEvaluation/File/TextFileReader.h>
+#include "catch.hpp"
+#include "TestData.h"
+#include <cstring>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace novac
+{
+    static void WriteTextFile(const std::string& fileName, const char* contents)
+    {
+        FILE* f = fopen(fileName.c_str(), "wb");
+        REQUIRE(f != nullptr);
+        fwrite(contents, 1, strlen(contents), f);
+        fclose(f);
+    }
+
+    TEST_CASE("ParseDouble", "[TextFileReader][File]")
+    {
+        double value = 0.0;
+
+        SECTION("Empty range returns false")
+        {
+            const char* text = "1.0";
+            const char* position = text;
+            REQUIRE_FALSE(ParseDouble(position, text, value));
+            REQUIRE(position == text);
+        }
+
+        SECTION("Only whitespace returns false")
+        {
+            const char* text = " \t\r\n";
+            const char* position = text;
+            REQUIRE_FALSE(ParseDouble(position, text + strlen(text), value));
+        }
+
+        SECTION("Not a number returns false")
+        {
+            const char* text = "; comment";
+            const char* position = text;
+            REQUIRE_FALSE(ParseDouble(position, text + strlen(text), value));
+            REQUIRE(position == text);
+        }
+
+        SECTION("Skips leading whitespace and stops after number")
+        {
+            const char* text = " \t 3.754169E-20\t2.5";
+            const char* position = text;
+            REQUIRE(ParseDouble(position, text + strlen(text), value));
+            REQUIRE(value == strtod(" \t 3.754169E-20", nullptr));
+            REQUIRE(position == text + strlen(" \t 3.754169E-20"));
+        }
+
+        SECTION("Does not read beyond end of range")
+        {
+            const char* text = "238.9581";
+            const char* position = text;
+            REQUIRE(ParseDouble(position, text + 5, value));
+            REQUIRE(value == 238.9);
+            REQUIRE(position == text + 5);
+        }
+
+        SECTION("Gives same result as strtod")
+        {
+            std::mt19937 randomGenerator{ 4711 };
+            std::uniform_int_distribution<int> numberOfDigits{ 1, 20 };
+            std::uniform_int_distribution<int> digit{ 0, 9 };
+            std::uniform_int_distribution<int> exponent{ -30, 30 };
+
+            for (int iteration = 0; iteration < 20000; ++iteration)
+            {
+                std::string text = (iteration % 3 == 0) ? "-" : "";
+                const int digits = numberOfDigits(randomGenerator);
+                const int decimalPointPosition = std::uniform_int_distribution<int>{ 0, digits }(randomGenerator);
+                for (int ii = 0; ii < digits; ++ii)
+                {
+                    if (ii == decimalPointPosition)
+                    {
+                        text.push_back('.');
+                    }
+                    text.push_back((char)('0' + digit(randomGenerator)));
+                }
+                if (iteration % 2 == 0)
+                {
+                    text += "e" + std::to_string(exponent(randomGenerator));
+                }
+
+                const double expectedValue = strtod(text.c_str(), nullptr);
+                const char* position = text.c_str();
+                REQUIRE(ParseDouble(position, text.c_str() + text.size(), value));
+                REQUIRE(position == text.c_str() + text.size());
+                REQUIRE(0 == memcmp(&expectedValue, &value, sizeof(double)));
+            }
+        }
+
+        SECTION("Parses special values as strtod")
+        {
+            for (const char* text : { "0x1Ap1", "inf", "-Infinity", "1e400", "1e-400", "12345678901234567890123", "1.5e", "1.5e+", "-0", ".5", "5." })
+            {
+                const double expectedValue = strtod(text, nullptr);
+                const char* position = text;
+                REQUIRE(ParseDouble(position, text + strlen(text), value));
+                REQUIRE(0 == memcmp(&expectedValue, &value, sizeof(double)));
+            }
+        }
+
+        SECTION("Stops at separator")
+        {
+            const char* text = "1.25,2.5";
+            const char* position = text;
+            REQUIRE(ParseDouble(position, text + strlen(text), value));
+            REQUIRE(value == 1.25);
+            REQUIRE(*position == ',');
+        }
+    }
+
+    TEST_CASE("TextFileReader", "[TextFileReader][File]")
+    {
+        const std::string fileName = TestData::GetTemporaryTextFileName();
+        TextFileReader sut;
+
+        SECTION("Open returns false for file which does not exist")
+        {
+            REQUIRE_FALSE(sut.Open(TestData::GetTestDataDirectory() + "DoesNotExist.txt"));
+        }
+
+        SECTION("Empty file contains no lines")
+        {
+            WriteTextFile(fileName, "");
+            REQUIRE(sut.Open(fileName));
+            REQUIRE(sut.IsAtEnd());
+
+            char buffer[16];
+            REQUIRE_FALSE(sut.ReadLine(buffer, sizeof(buffer)));
+            double value = 0.0;
+            REQUIRE_FALSE(sut.ReadDouble(value));
+        }
+
+        SECTION("ReadLine into buffer behaves as fgets")
+        {
+            WriteTextFile(fileName, "first line\r\nsecond\nlast");
+            REQUIRE(sut.Open(fileName));
+
+            char buffer[8];
+            REQUIRE(sut.ReadLine(buffer, sizeof(buffer)));
+            REQUIRE(std::string("first l") == buffer);
+            REQUIRE(sut.ReadLine(buffer, sizeof(buffer)));
+            REQUIRE(std::string("ine\r\n") == buffer);
+            REQUIRE(sut.ReadLine(buffer, sizeof(buffer)));
+            REQUIRE(std::string("second\n") == buffer);
+            REQUIRE(sut.ReadLine(buffer, sizeof(buffer)));
+            REQUIRE(std::string("last") == buffer);
+            REQUIRE_FALSE(sut.ReadLine(buffer, sizeof(buffer)));
+        }
+
+        SECTION("ReadLine without copy excludes newline")
+        {
+            WriteTextFile(fileName, "; comment\n\n1.0\t2.0");
+            REQUIRE(sut.Open(fileName));
+
+            const char* lineBegin = nullptr;
+            const char* lineEnd = nullptr;
+            REQUIRE(sut.ReadLine(lineBegin, lineEnd));
+            REQUIRE(std::string("; comment") == std::string(lineBegin, lineEnd));
+            REQUIRE(sut.ReadLine(lineBegin, lineEnd));
+            REQUIRE(lineBegin == lineEnd);
+            REQUIRE(sut.ReadLine(lineBegin, lineEnd));
+            REQUIRE(std::string("1.0\t2.0") == std::string(lineBegin, lineEnd));
+            REQUIRE_FALSE(sut.ReadLine(lineBegin, lineEnd));
+        }
+
+        SECTION("ReadDouble reads values separated by whitespace and newlines")
+        {
+            WriteTextFile(fileName, "  1.5 -2e3\r\n\n4;5");
+            REQUIRE(sut.Open(fileName));
+
+            double value = 0.0;
+            REQUIRE(sut.ReadDouble(value));
+            REQUIRE(value == 1.5);
+            REQUIRE(sut.ReadDouble(value));
+            REQUIRE(value == -2000.0);
+            REQUIRE(sut.ReadDouble(value));
+            REQUIRE(value == 4.0);
+            REQUIRE_FALSE(sut.ReadDouble(value));
+            REQUIRE(sut.ReadCharacter(';'));
+            REQUIRE(sut.ReadDouble(value));
+            REQUIRE(value == 5.0);
+            REQUIRE(sut.IsAtEnd());
+
+            sut.Rewind();
+            REQUIRE(sut.ReadDouble(value));
+            REQUIRE(value == 1.5);
+        }
+    }
+}
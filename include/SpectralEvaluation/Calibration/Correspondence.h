@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <random>
+#include <utility>
 
 // -----------------------------------------------------------------------------------------------------------------------------
 // - This header contains a helper struct used to perform the wavelength calibration of a spectrometer using a ransac approach -
@@ -108,5 +109,60 @@ size_t CountInliers(
     double& averageError,
     bool& isMonotonic);
 
+/** The possible correspondences arranged by the measured keypoint they belong to, stored as a structure of arrays
+    such that a pixel-to-wavelength model can be evaluated at all the measured keypoints in one pass.
+    Only the measured keypoints which have at least one possible correspondence are included.
+    The correspondences of the included keypoint 'N' are found at the indices [keypointOffset[N], keypointOffset[N + 1]). */
+struct CorrespondencesByMeasuredKeypoint
+{
+    /** The measured value (pixel) of each included measured keypoint, ordered by measuredIdx. */
+    std::vector<double> measuredValue;
+
+    /** The index of the first correspondence of each included measured keypoint, with one extra element at the end. */
+    std::vector<size_t> keypointOffset;
+
+    /** The theoretical value (wavelength) of each correspondence. */
+    std::vector<double> theoreticalValue;
+
+    /** The correspondences themselves, in the same order as theoreticalValue. */
+    std::vector<Correspondence> correspondence;
+
+    /** The indices of the included measured keypoints, ordered by increasing measuredValue. */
+    std::vector<size_t> keypointsOrderedByMeasuredValue;
+
+    /** One larger than the largest theoreticalIdx of any correspondence. */
+    size_t theoreticalIdxUpperBound = 0;
+
+    /** True if there are measured keypoints (with measuredIdx lower than the largest included) without any correspondence. */
+    bool hasKeypointsWithoutCorrespondences = false;
+};
+
+/** Creates the structure of arrays from the correspondences arranged by measured keypoint, i.e. the output from ArrangeByMeasuredKeypoint. */
+CorrespondencesByMeasuredKeypoint CreateCorrespondencesByMeasuredKeypoint(const std::vector<std::vector<Correspondence>>& allCorrespondencesOrderedByMeasuredKeypoint);
+
+/** Buffers used internally by CountInliers. Passing the same instance to repeated calls to CountInliers
+    avoids allocating memory in every call. */
+struct CountInliersScratch
+{
+    std::vector<double> distances;
+
+    /** The model evaluated at each of the measured keypoints. */
+    std::vector<double> predictedWavelengths;
+
+    /** The index in the list of inliers of the correspondence with a given theoreticalIdx, -1 if there is none. */
+    std::vector<int> inlierWithTheoreticalIdx;
+};
+
+/** Counts the number of the provided correspondences which fits the provided pixel-to-wavelength model, see above.
+*   This evaluates the model at all the measured keypoints in one vectorized pass before scoring the correspondences.
+*   @param scratch Buffers used during the calculation, these are re-used between calls. */
+size_t CountInliers(
+    const std::vector<double>& polynomialCoefficientsOfModel,
+    const CorrespondencesByMeasuredKeypoint& allCorrespondences,
+    double toleranceInWavelength,
+    std::vector<Correspondence>& inlier,
+    double& averageError,
+    bool& isMonotonic,
+    CountInliersScratch& scratch);
 
 }
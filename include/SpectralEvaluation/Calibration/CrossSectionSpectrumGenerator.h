@@ -3,6 +3,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <SpectralEvaluation/Calibration/ReferenceSpectrumConvolution.h>
 
 // ---------------------------------------------------------------------------------------------------------------
 // --- This header contains CrossSectionSpectrumGenerator which helps with convolving cross section references ---
@@ -51,6 +52,11 @@ public:
 };
 
 
+/// <summary>
+/// Generates convolved cross sections from one high resolution cross section, which is read in on first use
+/// through the CrossSectionCache (and hence shared with other generators using the same file).
+/// The cross section resampled to the convolution grid, and its Fourier transform, are kept between the calls.
+/// </summary>
 class CrossSectionSpectrumGenerator : public ICrossSectionSpectrumGenerator
 {
 public:
@@ -98,7 +104,10 @@ private:
 
     const std::string m_crossSectionFile;
 
-    std::unique_ptr<novac::CCrossSectionData> m_highResolutionCrossSection;
+    std::shared_ptr<const novac::CCrossSectionData> m_highResolutionCrossSection;
+
+    /// <summary>The m_highResolutionCrossSection prepared for convolution. Created on first use.</summary>
+    std::unique_ptr<ReferenceConvolutionCache> m_crossSectionConvolution;
 
     void ReadCrossSection();
 };
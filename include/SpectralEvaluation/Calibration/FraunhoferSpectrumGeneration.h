@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <mutex>
+#include <SpectralEvaluation/Calibration/ReferenceSpectrumConvolution.h>
 
 // ---------------------------------------------------------------------------------------------------------------
 // ---- This header contains FraunhoferSpectrumGeneration which helps with convolving Fraunhofer references  -----
@@ -15,6 +17,9 @@ namespace novac
     class CCrossSectionData;
     struct WavelengthRange;
 
+    /** Generator of synthetic Fraunhofer spectra.
+        Implementations must allow GetFraunhoferSpectrum and GetDifferentialFraunhoferSpectrum to be called concurrently,
+        the instrument line shape estimation calculates these in parallel. */
     class IFraunhoferSpectrumGenerator
     {
     public:
@@ -58,7 +63,11 @@ namespace novac
     /** This is a helper class for generating a Fraunhofer spectrum from a high resolved
         solar spectrum, a likewise high resolved ozone spectrum and a given instrument setup.
         Notice that this class will read in the high-resolved solar spectrum when needed (calling GetFraunhoferSpectrum)
-        and will keep it in memory to save loading time. If memory is a consern, then make sure that this object gets destructed when no longer needed.  */
+        through the CrossSectionCache, such that the solar atlas and cross sections are shared with all other instances using the same files.
+        The cache releases files which are no longer used when its memory budget is exceeded, but this object will keep its files in memory
+        as long as it lives. If memory is a consern, then make sure that this object gets destructed when no longer needed.
+        The solar spectrum resampled to the convolution grid, and its Fourier transform, are also kept such that
+        repeated calls with similar instrument line shapes (e.g. during the instrument line shape estimation) only need to convolve. */
     class FraunhoferSpectrumGeneration : public IFraunhoferSpectrumGenerator
     {
     public:
@@ -111,28 +120,23 @@ namespace novac
 
             std::string path;
             double totalColumn = 0.0;
-            std::unique_ptr<novac::CCrossSectionData> crossSectionData;
+            std::shared_ptr<const novac::CCrossSectionData> crossSectionData;
         };
 
         /** The path and total column of the high resolved absorption cross section files to include.  */
         std::vector<AbsorbingCrossSection> crossSectionsToInclude;
 
-        /** The read in high resolution solar cross section, saved in order to reduce file-io time. */
-        std::unique_ptr<novac::CCrossSectionData> solarCrossSection;
+        /** The read in high resolution solar cross section, shared through the CrossSectionCache in order to reduce file-io time. */
+        std::shared_ptr<const novac::CCrossSectionData> solarCrossSection;
 
-        /** This creates a Fraunhofer spectrum using the provided Absorbing cross sections instead of using the member */
-        std::unique_ptr<CSpectrum> GetFraunhoferSpectrum(
-            const std::vector<double>& pixelToWavelengthMapping,
-            const novac::CCrossSectionData& measuredInstrumentLineShape,
-            std::vector<AbsorbingCrossSection>& crossSectionsToInclude,
-            double fwhmOfInstrumentLineShape,
-            bool normalize);
+        /** The solar spectrum, including the absorbing cross sections, prepared for convolution. Created on first use. */
+        std::unique_ptr<ReferenceConvolutionCache> solarSpectrumConvolution;
 
-        std::unique_ptr<CSpectrum> GetDifferentialFraunhoferSpectrum(
-            const std::vector<double>& pixelToWavelengthMapping,
-            const novac::CCrossSectionData& measuredInstrumentLineShape,
-            std::vector<AbsorbingCrossSection>& crossSectionsToInclude,
-            double fwhmOfInstrumentLineShape);
+        /** Guards the lazy reading of the solar atlas and the creation of solarSpectrumConvolution. */
+        std::mutex guard;
+
+        /** @return the solar spectrum, including the absorbing cross sections, prepared for convolution. */
+        ReferenceConvolutionCache& GetSolarSpectrumConvolution();
 
         void ReadSolarCrossSection();
     };
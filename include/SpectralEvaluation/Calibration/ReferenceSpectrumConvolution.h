@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <mutex>
 
 // ---------------------------------------------------------------------------------------------------------------
 // -------------- This header contains methods used to prepare reference spectra for the evaluation --------------
@@ -54,6 +56,76 @@ void ConvolveReference(
     double fwhmOfInstrumentLineShape = 0.0,
     bool normalizeSlf = true);
 
+/** Performs a convolution of each of the high resolution reference functions with the given slf (slit function, the convolution core)
+    and resamples the results to the given pixelToWavelengthMapping. The references are convolved in parallel.
+    This is faster than calling ConvolveReference once for each reference since the fwhm, the resampled slf and
+    (with ConvolutionMethod::Fft) the Fourier transform of the slf are only calculated once.
+    All references are convolved on grids with the same resolution, the resolution which ConvolveReference
+    would use for the reference with the highest resolution.
+    This expects the slf to be shifted to have the center in the middle of the vector.
+    @param results Will on successful return be filled with one convolved reference for each of the highResReferences, in the same order.
+    @throws std::invalid_argument if the slf or any of the highResReferences does not have a valid pixel-to-wavelength mapping, or the calculation of the fwhm failed. */
+void ConvolveReferences(
+    const std::vector<double>& pixelToWavelengthMapping,
+    const CCrossSectionData& slf,
+    const std::vector<CCrossSectionData>& highResReferences,
+    std::vector<std::vector<double>>& results,
+    WavelengthConversion conversion = WavelengthConversion::None,
+    ConvolutionMethod method = ConvolutionMethod::Direct,
+    double fwhmOfInstrumentLineShape = 0.0,
+    bool normalizeSlf = true);
+
+/** ReferenceConvolutionCache convolves one high resolution reference with a series of slit functions of similar width,
+    such as the trial line shapes of an iterative instrument line shape estimation.
+    The uniform convolution grid, the reference resampled onto this grid and (with ConvolutionMethod::Fft) the Fourier transform
+    of the resampled reference are calculated on the first call and are then reused for as long as the grid has between
+    50 and 200 points per fwhm of the slf. A new grid is set up, with the same resolution as ConvolveReference would use, otherwise.
+    Convolve may be called concurrently from several threads. */
+class ReferenceConvolutionCache
+{
+public:
+    /** Sets up the cache for the given reference, optionally converting it from vacuum to air.
+        @throws std::invalid_argument if the highResReference does not have a valid pixel-to-wavelength mapping. */
+    ReferenceConvolutionCache(const CCrossSectionData& highResReference, WavelengthConversion conversion = WavelengthConversion::None);
+
+    ~ReferenceConvolutionCache();
+
+    ReferenceConvolutionCache(const ReferenceConvolutionCache&) = delete;
+    ReferenceConvolutionCache& operator=(const ReferenceConvolutionCache&) = delete;
+
+    /** Performs a convolution of the reference with the given slf and resamples the result to the given pixelToWavelengthMapping.
+        The parameters have the same meaning as for ConvolveReference.
+        @throws std::invalid_argument if the slf does not have a valid pixel-to-wavelength mapping, or the calculation of the fwhm failed. */
+    void Convolve(
+        const std::vector<double>& pixelToWavelengthMapping,
+        const CCrossSectionData& slf,
+        std::vector<double>& result,
+        ConvolutionMethod method = ConvolutionMethod::Direct,
+        double fwhmOfInstrumentLineShape = 0.0,
+        bool normalizeSlf = true);
+
+    /** @return the number of times the convolution grid has been set up, for testing purposes. */
+    int NumberOfPreparedGrids() const { return m_numberOfPreparedGrids; }
+
+private:
+    struct PreparedReference;
+
+    /** The reference to convolve, converted to air if requested. */
+    std::unique_ptr<CCrossSectionData> m_reference;
+
+    /** The current grid, reference and transform. This is replaced (never modified) when a new grid is required,
+        such that threads which are still convolving using the previous one can continue to do so. */
+    std::shared_ptr<const PreparedReference> m_prepared;
+
+    /** Guards m_prepared. */
+    std::mutex m_guard;
+
+    int m_numberOfPreparedGrids = 0;
+
+    /** @return the prepared reference to use for convolving an slf with the given fwhm and extent. */
+    std::shared_ptr<const PreparedReference> GetPreparedReference(double fwhmOfInstrumentLineShape, double slfWidth, bool withTransform);
+};
+
 /** Performs a convolution of the high resolution reference function with the given slf (slit function, the convolution core).
     The result will be sampled on the same wavelength grid as the highResReference.
     This expects the slf to be shifted to have the center in the middle of the vector. */
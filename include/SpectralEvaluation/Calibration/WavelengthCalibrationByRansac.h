@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <vector>
 #include <limits>
+#include <random>
 
 // ---------------------------------------------------------------------------------------------------------------------
 // - This header contains methods used to perform the wavelength calibration of a spectrometer using a ransac approach -
@@ -13,6 +14,7 @@ namespace novac
 
     class CSpectrum;
     struct Correspondence;
+    struct CorrespondencesByMeasuredKeypoint;
     struct SpectrumDataPoint;
 
 
@@ -103,9 +105,22 @@ namespace novac
         bool refine = true;
 
         /** The number of threads to divide the work up into.
-            Special value: 0 corresponds to automatic.
+            Special value: 0 corresponds to automatic, i.e. the number of hardware threads.
             Default is 0 */
         size_t numberOfThreads = 0;
+
+        /** The seed of the random number generator. With the same seed and settings, the result is the same
+            regardless of the number of threads used.
+            Special value: 0 corresponds to a randomly selected seed.
+            Default is 0 */
+        unsigned int randomSeed = 0;
+
+        /** The iterations are stopped before numberOfRansacIterations have been made, once the probability of
+            having drawn at least one sample containing only inliers reaches this value. This probability is estimated
+            using the fraction of the possible correspondences which are inliers to the best model found so far.
+            Set to 1.0 to always make numberOfRansacIterations iterations.
+            Default is 0.999 */
+        double terminationConfidence = 0.999;
     };
 
     struct RansacWavelengthCalibrationResult
@@ -138,6 +153,10 @@ namespace novac
 
         /** The total number of possible correlations, the maximum number for 'highestNumberOfInliers' */
         size_t numberOfPossibleCorrelations = 0U;
+
+        /** The number of ransac iterations which were made to find this result.
+            This may be smaller than the requested number of iterations, due to early termination. */
+        size_t numberOfIterations = 0U;
     };
 
     /** RansacWavelengthCalibrationSetup is the setup of a calibration run
@@ -157,17 +176,32 @@ namespace novac
 
         RansacWavelengthCalibrationSettings settings;
 
+        /** The buffers used by one thread while running the ransac calibrations, such that these are not allocated in every iteration. */
+        struct ScratchBuffers;
+
+        /** Measures how good the initial model in the settings is, this is the model which the ransac iterations need to improve upon.
+            @return The initial model and the number of inliers. If there is no initial model, this has no inliers. */
+        RansacWavelengthCalibrationResult EvaluateInitialModel(const std::vector<Correspondence>& possibleCorrespondences, const CorrespondencesByMeasuredKeypoint& possibleCorrespondencesOrderedByMeasuredKeypoint) const;
+
         /** Runs a part of the ransac calibrations. Used for splitting up the total workload on multiple threads, each performing a small part of the operations.
             @param possibleCorrespondences
+            @param initialResult The result to improve upon, typically the output of EvaluateInitialModel.
+            @param randomGenerator The random generator used to select the samples.
             @return The best fitted model and the number of inliers. */
-        RansacWavelengthCalibrationResult RunRansacCalibrations(const std::vector<Correspondence>& possibleCorrespondences, const std::vector<std::vector<Correspondence>>& possibleCorrespondencesOrderedByMeasuredKeypoint, int numberOfIterations) const;
+        RansacWavelengthCalibrationResult RunRansacCalibrations(
+            const std::vector<Correspondence>& possibleCorrespondences,
+            const CorrespondencesByMeasuredKeypoint& possibleCorrespondencesOrderedByMeasuredKeypoint,
+            const RansacWavelengthCalibrationResult& initialResult,
+            std::mt19937& randomGenerator,
+            int numberOfIterations,
+            ScratchBuffers& scratch) const;
 
         /**
             Runs a basic calibration without random sampling, testing every possible combination.
             Only possible to use if the total number of combinations is low.
             @param possibleCorrespondences
             @return The best fitted model and the number of inliers. */
-        RansacWavelengthCalibrationResult RunDeterministicCalibration(const std::vector<Correspondence>& possibleCorrespondences, const std::vector<std::vector<Correspondence>>& possibleCorrespondencesOrderedByMeasuredKeypoint) const;
+        RansacWavelengthCalibrationResult RunDeterministicCalibration(const std::vector<Correspondence>& possibleCorrespondences, const CorrespondencesByMeasuredKeypoint& possibleCorrespondencesOrderedByMeasuredKeypoint) const;
 
     };
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <SpectralEvaluation/Calibration/InstrumentCalibration.h>
 
@@ -41,5 +42,21 @@ public:
     /** Performs the convolution of the reference using the provided calibration.
          This will update m_resultingCrossSection*/
     void ConvolveReference(const novac::InstrumentCalibration& calibration);
+
+    /** Performs the convolution of all the provided high resolved cross section files using the provided calibration
+        and the current settings. This is considerably faster than convolving the references one at a time,
+        since the instrument line shape is only prepared once and the references are convolved in parallel.
+        This does not update m_resultingCrossSection.
+        @return the resulting convolved cross sections, in the same order as highResolutionCrossSections. */
+    std::vector<std::unique_ptr<novac::CCrossSectionData>> ConvolveReferences(
+        const novac::InstrumentCalibration& calibration,
+        const std::vector<std::string>& highResolutionCrossSections) const;
+
+private:
+    /** Creates the final cross section from the result of the convolution, using the current settings. */
+    std::unique_ptr<novac::CCrossSectionData> CreateResultingCrossSection(
+        const std::vector<double>& convolutionResult,
+        const novac::InstrumentCalibration& calibration,
+        const std::vector<double>& highResolutionWavelength) const;
 };
 
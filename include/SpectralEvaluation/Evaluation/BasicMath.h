@@ -10,6 +10,7 @@ namespace MathFit
 class CVector;
 }
 
+#include <vector>
 #include "../Fit/FitException.h"
 
 #if _MSC_VER > 1000
@@ -95,6 +96,10 @@ private:
     void DFourier(double data[], unsigned long nn, int isign);
 
     static bool mDoNotUseMathLimits;
+
+    // Scratch buffers for the high- and low pass filters, kept such that repeated filtering does not allocate memory.
+    std::vector<double> mHighPassBuffer;
+    std::vector<double> mLowPassBuffer;
 };
 
 #endif // !defined(AFX_BASICMATH_H__1DEB20E2_5D81_11D4_866C_00E098701FA6__INCLUDED_)
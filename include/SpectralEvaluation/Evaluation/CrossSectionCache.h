@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace novac
+{
+class CCrossSectionData;
+
+/** CrossSectionCache keeps the high resolution cross sections and solar atlases read from file in memory,
+    such that a file which is used by several objects (e.g. the Fraunhofer spectrum generation of every instrument
+    calibrated in the same process) only needs to be read once.
+    The cross sections are identified by their file name together with the size and modification time of the file,
+    such that a file which has been changed on disk is read in again.
+    The cached cross sections are immutable and can be shared between threads. When the cached cross sections
+    take up more memory than the memory budget, then the least recently used ones are removed from the cache
+    (these are still kept alive by any object which is holding on to them).
+    This class is thread safe, a file requested by several threads at the same time is only read once. */
+class CrossSectionCache
+{
+public:
+    /** The default memory budget of the cache, in bytes. */
+    static const size_t defaultMemoryBudget = 256 * 1024 * 1024;
+
+    /** @return the cache shared by the entire process. */
+    static CrossSectionCache& GetInstance()
+    {
+        static CrossSectionCache singletonInstance;
+        return singletonInstance;
+    }
+
+    CrossSectionCache() = default;
+
+    explicit CrossSectionCache(size_t memoryBudget)
+        : m_memoryBudget(memoryBudget)
+    {
+    }
+
+    CrossSectionCache(const CrossSectionCache&) = delete;
+    CrossSectionCache& operator=(const CrossSectionCache&) = delete;
+
+    /** @return the cross section in the given file, this is read from file unless it is already in the cache.
+        @return nullptr if the file could not be read. */
+    std::shared_ptr<const CCrossSectionData> Get(const std::string& fileName);
+
+    /** Changes the memory budget of the cache, removing the least recently used cross sections if needed. */
+    void SetMemoryBudget(size_t memoryBudget);
+
+    /** @return the memory budget of the cache, in bytes. */
+    size_t MemoryBudget() const;
+
+    /** @return the memory used by the cross sections currently in the cache, in bytes. */
+    size_t MemoryUsage() const;
+
+    /** @return the number of times a file has been read (i.e. not found in the cache) since the cache was created or cleared. */
+    size_t NumberOfFileReads() const;
+
+    /** Removes all the cross sections from the cache. */
+    void Clear();
+
+private:
+    struct Entry
+    {
+        /** Identifies the entry, such that the thread reading the file can find it again. */
+        std::uint64_t id = 0;
+
+        std::uint64_t fileSize = 0;
+        std::int64_t modificationTime = 0;
+
+        /** The cross section, ready when the file has been read. */
+        std::shared_future<std::shared_ptr<const CCrossSectionData>> crossSection;
+
+        /** The memory used by the cross section, zero while the file is being read. */
+        size_t memoryUsage = 0;
+
+        /** The value of m_useCounter when the cross section was last requested. */
+        std::uint64_t lastUse = 0;
+    };
+
+    mutable std::mutex m_guard;
+
+    std::map<std::string, Entry> m_entries;
+
+    size_t m_memoryBudget = defaultMemoryBudget;
+
+    size_t m_memoryUsage = 0;
+
+    size_t m_numberOfFileReads = 0;
+
+    std::uint64_t m_useCounter = 0;
+
+    /** Removes the least recently used cross sections, which have been read, until the memory usage is within the budget.
+        The cross section in the file 'fileToKeep' is never removed. m_guard must be locked when calling this. */
+    void RemoveLeastRecentlyUsed(const std::string& fileToKeep);
+};
+
+}
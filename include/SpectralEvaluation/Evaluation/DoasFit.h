@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <SpectralEvaluation/Spectra/SpectrumView.h>
 
 namespace novac
 {
@@ -149,7 +150,9 @@ public:
     DoasFit(const DoasFit&) = delete;
     DoasFit& operator=(const DoasFit&) = delete;
 
-    /** Sets up the parameters required to do a Doas fit */
+    /** Sets up the parameters required to do a Doas fit.
+    *   If the shift and squeeze of all references are fixed (and no column is linked) then the fit only contains linear parameters
+    *   and its solution is precomputed here, which makes each call to Run a single matrix-vector multiplication. */
     void Setup(const CFitWindow& setup);
 
     /** Runs the actual Doas fit.
@@ -159,6 +162,20 @@ public:
     *   @throws DoasFitException if the fit itself failed for some reason. */
     void Run(const double* measuredData, size_t measuredLength, DoasResult& result);
 
+    /** Runs the actual Doas fit, see above.
+    *   The measured data is not copied, the fit refers directly to the viewed data. */
+    void Run(SpectrumView measuredData, DoasResult& result);
+
+    /** Runs the Doas fit on a number of spectra, e.g. all spectra of one scan, in parallel.
+    *   Each spectrum is evaluated starting from the parameters set in Setup, hence the result for each spectrum
+    *   is identical to calling Run on a newly setup DoasFit. The results are independent of the number of threads used.
+    *   The reference spectra are shared between the threads, each thread gets its own fit parameters.
+    *   @param measuredData The spectra to evaluate, each with the length measuredLength and already in OpticalDepth.
+    *   @param results Will on successful return be filled with one result for each of the measured spectra.
+    *   @throws std::invalid_argument if Setup hasn't been called or if any of the input spectra are invalid.
+    *   @throws DoasFitException if the fit failed for any of the spectra. The exception of the first failing spectrum is thrown. */
+    void RunBatch(const std::vector<const double*>& measuredData, size_t measuredLength, std::vector<DoasResult>& results);
+
 private:
 
     /// <summary>
@@ -196,6 +213,12 @@ private:
     /// Clears the memory used by m_referenceSetup.
     /// </summary>
     void DeallocateReferenceSetup();
+
+    /// <summary>
+    /// Performs the DOAS fit of one spectrum using the provided set of references.
+    /// The references must be a DoasReferenceSetup with the same number of references as m_referenceSetup.
+    /// </summary>
+    void RunWithReferences(void* referenceSetup, SpectrumView measuredData, DoasResult& result) const;
 };
 
 }
\ No newline at end of file
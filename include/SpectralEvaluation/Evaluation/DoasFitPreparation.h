@@ -3,6 +3,7 @@
 #include <vector>
 #include <SpectralEvaluation/Evaluation/DoasFitEnumDeclarations.h>
 #include <SpectralEvaluation/Math/IndexRange.h>
+#include <SpectralEvaluation/Spectra/SpectrumView.h>
 
 namespace novac
 {
@@ -25,6 +26,11 @@ public:
     static std::vector<double> PrepareMeasuredSpectrum(const CSpectrum& measuredSpectrum, const CSpectrum& skySpectrum, FIT_TYPE doasFitType);
     static std::vector<double> PrepareMeasuredSpectrum(const CSpectrum& measuredSpectrum, const CSpectrum& skySpectrum, FIT_TYPE doasFitType, const IndexRange& offsetRemovalRange);
 
+    /** Prepares the measured spectrum for inclusion into the DOAS fit, writing the result into the provided buffer.
+        This does not allocate any memory and the measured spectrum is prepared in place if result views the same data.
+        @throws std::invalid_argument if the measured spectrum, the sky spectrum and the result do not all have the same length. */
+    static void PrepareMeasuredSpectrum(SpectrumView measuredSpectrum, SpectrumView skySpectrum, FIT_TYPE doasFitType, const IndexRange& offsetRemovalRange, MutableSpectrumView result);
+
     /** Calculates a ring spectrum from the provided sky spectrum (which must have a wavelength calibration)
         and prepares it for a DOAS fit of the given type */
     static std::vector<double> PrepareRingSpectrum(const CSpectrum& skySpectrum, FIT_TYPE doasFitType);
@@ -37,6 +43,7 @@ public:
         in the pixel interval [startIndex, endIndex[ and then subtracting that value from all data points in the spectrum. */
     static void RemoveOffset(CSpectrum& spectrum, int startIndex = 50, int endIndex = 200);
     static void RemoveOffset(std::vector<double>& spectrum, int startIndex = 50, int endIndex = 200);
+    static void RemoveOffset(MutableSpectrumView spectrum, int startIndex = 50, int endIndex = 200);
 
 };
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <SpectralEvaluation/Log.h>
 #include <SpectralEvaluation/Fit/ReferenceSpectrumFunction.h>
 #include <SpectralEvaluation/Evaluation/BasicMath.h>
@@ -15,6 +16,7 @@ class CStandardFit;
 namespace novac
 {
 class CSpectrum;
+class FitWorkspace;
 
 struct ShiftEvaluationResult
 {
@@ -62,7 +64,8 @@ public:
             // TODO: Implement saving this
     CCrossSectionData m_fitResult[MAX_N_REFERENCES + 2];
 
-    /** The measured spectrum, after all processing is done, right before the fit is performed. */
+    /** The measured spectrum, after all processing is done, right before the fit is performed.
+        This is also the data which the fit is performed on, the fit refers to it without copying. */
     std::vector<double> m_measuredData;
 
     /** The last error from calling 'Evaluate' or 'EvaluateShift'.
@@ -155,6 +158,14 @@ protected:
     /** Simple vector for holding the channel number information (element #i in this vector contains the value (i+1) */
     CVector vXData;
 
+    /** The buffers and fit objects used by 'Evaluate'. These are kept between the calls such that
+        repeated evaluations using the same fit window and references does not allocate any memory.
+        Created by the first call to 'Evaluate' and re-created when the fit window or the references changes. */
+    std::unique_ptr<FitWorkspace> m_workspace;
+
+    /** @return the workspace to use for evaluating with the current fit window and references. */
+    FitWorkspace& GetWorkspace();
+
     /** Initializes the elements of the CReferenceSpectrumFunction-array 'ref' using the information in m_window
         This must be called once prior to calling 'Evaluate', after the FitWindow has been set and the references read in from disk. */
     int CreateReferenceSpectra();
@@ -194,6 +205,6 @@ protected:
     void CreateReferenceForRingSpectrumLambda4(const CSpectrum& ring);
 
     // @return the name of the reference with the given index into m_ref
-    std::string GetReferenceName(size_t referenceIndex) const;
+    const std::string& GetReferenceName(size_t referenceIndex) const;
 };
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <SpectralEvaluation/Fit/ReferenceSpectrumFunction.h>
+#include <SpectralEvaluation/Fit/DiscreteFunction.h>
+#include <SpectralEvaluation/Fit/PolynomialFunction.h>
+#include <SpectralEvaluation/Fit/SimpleDOASFunction.h>
+#include <SpectralEvaluation/Fit/StandardMetricFunction.h>
+#include <SpectralEvaluation/Fit/StandardFit.h>
+#include <SpectralEvaluation/Spectra/SpectrumView.h>
+
+namespace novac
+{
+class CFitWindow;
+
+/** The FitWorkspace holds all the buffers and fit objects used by CEvaluationBase::Evaluate.
+    The workspace is sized once from the fit window and the references to include in the fit,
+    such that repeated evaluations with the same setup does not allocate any memory.
+    If the fit window or the references changes then a new workspace must be created. */
+class FitWorkspace
+{
+public:
+    FitWorkspace(const CFitWindow& window, const std::vector<MathFit::CReferenceSpectrumFunction*>& references);
+
+    // The fit objects refer to each other and can therefore not be copied.
+    FitWorkspace(const FitWorkspace&) = delete;
+    FitWorkspace& operator=(const FitWorkspace&) = delete;
+
+    /** @return true if this workspace was created for the given fit window and references. */
+    bool IsValidFor(const CFitWindow& window, const std::vector<MathFit::CReferenceSpectrumFunction*>& references) const;
+
+    /** Sets up the fit for the next evaluation of the prepared measured spectrum.
+        The measured spectrum is not copied, the fit refers directly to the viewed data which must
+        therefore be kept alive and unchanged until the fit is done.
+        @param measuredData The measured spectrum, prepared for the evaluation.
+        @param xData The pixel values, must have a length of at least measuredStartChannel + measuredLength.
+        @param measuredStartChannel The first channel of the measured spectrum.
+        @param fitLow The first pixel in the fit, relative to the start of the measured spectrum.
+        @param fitHigh One past the last pixel in the fit, relative to the start of the measured spectrum.
+        @param numSteps The maximum number of steps in the nonlinear fit. */
+    void PrepareFit(SpectrumView measuredData, MathFit::CVector& xData, int measuredStartChannel, int fitLow, int fitHigh, int numSteps);
+
+    /** The measured spectrum, as used in the fit. This refers to the data passed to PrepareFit. */
+    MathFit::CVector measured;
+
+    /** The (unit) errors of the measured spectrum. */
+    MathFit::CVector measuredError;
+
+    /** The pixels included in the fit. */
+    MathFit::CVector fitRange;
+
+    /** Buffer for the fitted values of the polynomial or one reference, in the fit range. */
+    MathFit::CVector fittedValues;
+
+    /** The function representing the measured spectrum. */
+    MathFit::CDiscreteFunction target;
+
+    /** The DOAS model, the sum of all references and the polynomial. */
+    MathFit::CSimpleDOASFunction model;
+
+    /** The polynomial of the DOAS model. */
+    MathFit::CPolynomialFunction polynomial;
+
+    /** The difference between the measured spectrum and the model. */
+    MathFit::CStandardMetricFunction metric;
+
+    /** The fit object, combining the linear and the nonlinear fit. */
+    MathFit::CStandardFit fit;
+
+private:
+    std::vector<MathFit::CReferenceSpectrumFunction*> m_references;
+
+    int m_specLength = 0;
+
+    int m_polyOrder = 0;
+};
+
+}
@@ -140,11 +140,6 @@ public:
         This can be used to selectively include/exclude references. */
     bool m_include = true;
 
-    /** The actual data of this reference - file. This is equal to
-            nullptr if the reference data has not been read in yet, otherwise
-            this will contain the data from the reference file. */
-    std::unique_ptr<CCrossSectionData> m_data = nullptr;
-
     // ------------------------ METHODS ---------------------------
 
     /** Setting the column.
@@ -167,12 +162,12 @@ public:
 
     /** Reads the data of this reference file from disk.
         The file is taken from the member variable 'm_path' (which of course must be initialized first)
-        and the result is written to 'm_data'. If this fails then m_data will be NULL.
+        and the result is set as the data of this reference. If this fails then Data() will be nullptr.
         @return 0 on success. */
     int ReadCrossSectionDataFromFile();
 
     /** Performs a convolution using the files m_crossSectionFile, m_slitFunctionFile and m_wavelengthCalibrationFile
-        and saves the result in m_data.
+        and sets the result as the data of this reference.
         @return 0 on success.*/
     int ConvolveReference();
 
@@ -181,5 +176,29 @@ public:
     void VerifyReferenceValues(int fromIndex, int toIndex) const;
 
     std::string Name() const;
+
+    /** @return the actual data of this reference - file. This is equal to
+            nullptr if the reference data has not been read in yet, otherwise
+            this will contain the data from the reference file.
+        The data is shared between copies of this reference file, such that copying a reference
+            (or a fit window) does not copy the cross section. Use MutableData() to modify the data. */
+    std::shared_ptr<const CCrossSectionData> Data() const { return m_data; }
+
+    /** Sets the data of this reference file to a copy of the provided cross section. */
+    void SetData(const CCrossSectionData& data);
+
+    /** Sets the data of this reference file, taking over the ownership of the provided cross section. */
+    void SetData(std::unique_ptr<CCrossSectionData> data);
+
+    /** @return a modifiable reference to the data of this reference file. If the data is shared with
+        any other reference file then the data is first replaced with a copy of it, such that the
+        modification does not affect the other references (copy on write).
+        Data() must not be nullptr. */
+    CCrossSectionData& MutableData();
+
+private:
+    /** The data of this reference file, see Data(). This is only handed out as const,
+        such that it is only modified through MutableData(). */
+    std::shared_ptr<CCrossSectionData> m_data;
 };
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SpectralEvaluation/DateTime.h>
+#include <SpectralEvaluation/File/MemoryMappedFile.h>
+
+namespace novac
+{
+
+/** The results of evaluating one scan, as read from an EvaluationLogCache.
+    The values refer directly to the columns of the cache and are valid until the cache is closed or re-opened. */
+struct CachedScanResult
+{
+    /** The number of evaluated spectra in the scan (sky and dark excluded). */
+    size_t numberOfSpectra = 0;
+
+    /** The start time of the sky spectrum of the scan. */
+    CDateTime skyStartTime;
+
+    /** The scan angles and second scan angles (Heidelberg instruments only) of the spectra. */
+    const double* scanAngle = nullptr;
+    const double* scanAngle2 = nullptr;
+
+    /** The delta and chi-square of the fit of each spectrum. */
+    const double* delta = nullptr;
+    const double* chiSquare = nullptr;
+
+    /** The evaluation status, i.e. the MARK_BAD_EVALUATION and MARK_DELETED flags, of each spectrum. */
+    const std::int64_t* evaluationStatus = nullptr;
+
+    /** The start and stop times of the spectra, stored as yyyymmddhhmmss. Use StartTime() and StopTime() to get these as CDateTime. */
+    const std::int64_t* startTime = nullptr;
+    const std::int64_t* stopTime = nullptr;
+
+    /** The fit results for each specie, indexed as column[specieIndex][spectrumIndex]. */
+    std::vector<const double*> column;
+    std::vector<const double*> columnError;
+    std::vector<const double*> shift;
+    std::vector<const double*> shiftError;
+    std::vector<const double*> squeeze;
+    std::vector<const double*> squeezeError;
+
+    /** @return true if the spectrum with the given index is judged as being a bad evaluation. */
+    bool IsBad(size_t spectrumIndex) const;
+
+    CDateTime StartTime(size_t spectrumIndex) const;
+
+    CDateTime StopTime(size_t spectrumIndex) const;
+};
+
+/** EvaluationLogCache keeps the per spectrum results of an evaluation log file in a binary file next to the evaluation log.
+    The results are stored column by column, i.e. all scan angles followed by all columns of the first specie etc.,
+    and the cache file is memory mapped when read. This makes it possible to re-read the results of an evaluation log
+    without parsing the text file again.
+    The cache file is written the first time an evaluation log is opened and is re-written if the size or the
+    modification time of the evaluation log no longer matches the ones stored in the cache.
+    The cache is stored in the byte order of the machine and is not intended to be moved between platforms. */
+class EvaluationLogCache
+{
+public:
+    EvaluationLogCache() = default;
+
+    EvaluationLogCache(const EvaluationLogCache&) = delete;
+    EvaluationLogCache& operator=(const EvaluationLogCache&) = delete;
+
+    /** Opens the results of the given evaluation log, using the cache file GetCacheFileName(evaluationLogFile).
+        If the cache file is missing or out of date then the evaluation log is parsed and the cache file is written.
+        The results are available also if the cache file cannot be written.
+        All the scans in the evaluation log must have been evaluated for the same species, in the same order.
+        @return true if the results could be read. */
+    bool Open(const std::string& evaluationLogFile);
+
+    /** Opens the results of the given evaluation log, as above, using the provided cache file. */
+    bool Open(const std::string& evaluationLogFile, const std::string& cacheFile);
+
+    /** Closes the cache, after this no results can be read. */
+    void Close();
+
+    /** @return the name of the cache file used for the given evaluation log, this is the name of the evaluation log with '.evcache' appended. */
+    static std::string GetCacheFileName(const std::string& evaluationLogFile);
+
+    /** @return true if the results were read from an existing cache file and false if the evaluation log had to be parsed. */
+    bool IsReadFromCacheFile() const { return m_isReadFromCacheFile; }
+
+    /** @return the number of scans in the evaluation log. */
+    size_t ScanCount() const { return m_numberOfScans; }
+
+    /** @return the names of the evaluated species, in the order of the columns in the evaluation log. */
+    const std::vector<std::string>& Species() const { return m_species; }
+
+    /** @return the index of the specie with the given name, ignoring case, or -1 if the specie could not be found. */
+    int GetSpecieIndex(const std::string& specieName) const;
+
+    /** @return the results of the scan with the given index. The scans are ordered by the start time of the sky spectrum,
+        as in CScanEvaluationLogFileHandler::m_scan. Index must be smaller than ScanCount(). */
+    CachedScanResult GetScan(size_t scanIndex) const;
+
+private:
+    /** The contents of the cache file, either pointing into m_file or into m_contents. */
+    const std::uint8_t* m_data = nullptr;
+
+    size_t m_size = 0;
+
+    MemoryMappedFile m_file;
+
+    /** The contents of the cache when these were created by parsing the evaluation log. */
+    std::vector<std::uint64_t> m_contents;
+
+    bool m_isReadFromCacheFile = false;
+
+    size_t m_numberOfScans = 0;
+
+    size_t m_numberOfSpectra = 0;
+
+    std::vector<std::string> m_species;
+
+    /** Sets up the member variables from the contents in m_data.
+        @return false if the contents are not a valid cache of an evaluation log with the given size and modification time. */
+    bool ReadContents(std::uint64_t sourceFileSize, std::int64_t sourceModificationTime);
+
+    const std::uint64_t* ScanOffsets() const;
+
+    const std::uint8_t* Column(size_t columnIndex) const;
+};
+
+/** @return all the evaluated columns for the specie with the provided index.
+    @return an empty vector if the scan is empty or specieIndex is invalid. */
+std::vector<double> GetColumns(const CachedScanResult& result, int specieIndex);
+
+}
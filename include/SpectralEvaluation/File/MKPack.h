@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace novac
@@ -69,6 +70,21 @@ namespace novac
                 @return -  the number of data-points in the uncompressed spectrum ???? */
         long UnPack(std::uint8_t* inpek, long kvar, long* ut);
 
+        /** Uncompress the given compressed spectrum.
+            This gives the same result as the UnPack above but decodes the data 64 bits at a time,
+            validates that the compressed data is not read past its end and writes the result directly to the output.
+                @param compressed - the compressed spectral data.
+                @param compressedSize - the length of the compressed data, in bytes.
+                @param pixels - the number of data-points in the uncompressed spectrum.
+                @param result - will on successful return contain the uncompressed spectrum, must have room for 'pixels' values.
+                @return - the number of data-points in the uncompressed spectrum (equals 'pixels').
+                @return - -1 if the compressed data is not valid. */
+        static long UnPack(const std::uint8_t* compressed, size_t compressedSize, long pixels, std::int32_t* result);
+        static long UnPack(const std::uint8_t* compressed, size_t compressedSize, long pixels, double* result);
+
+        /** Calculates the checksum of an uncompressed spectrum, as saved in MKZYhdr::checksum */
+        static std::uint16_t Checksum(const double* values, long length);
+
     private:
         void SetBit(std::uint8_t* pek, long bit);
         void ClearBit(std::uint8_t* pek, long bit);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace novac
+{
+
+/** MemoryMappedFile maps the contents of a file into (read-only) memory,
+    such that the file can be read without first copying its contents into a buffer.
+    The mapping is released when the object is destroyed or Close() is called. */
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile() = default;
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /** Maps the given file into memory, any previously mapped file is first closed.
+        @return true if the file could be opened and mapped. */
+    bool Open(const std::string& fileName);
+
+    /** Releases the mapping of the file, if any. */
+    void Close();
+
+    /** @return true if a file is currently mapped. */
+    bool IsOpen() const { return m_isOpen; }
+
+    /** @return the first byte of the mapped file. This is null if the file is empty or no file is mapped. */
+    const std::uint8_t* Data() const { return m_data; }
+
+    /** @return the size of the mapped file, in bytes. */
+    size_t Size() const { return m_size; }
+
+private:
+    const std::uint8_t* m_data = nullptr;
+
+    size_t m_size = 0;
+
+    bool m_isOpen = false;
+
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif // _WIN32
+};
+
+}
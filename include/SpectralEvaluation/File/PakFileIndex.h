@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SpectralEvaluation/File/MKPack.h>
+#include <SpectralEvaluation/File/MemoryMappedFile.h>
+
+namespace novac
+{
+class CSpectrum;
+
+/** PakFileIndex provides random access to the spectra in a .pak file.
+    The file is memory mapped and the location of all MKZY headers is found in one pass through the file
+    when opening it, such that any spectrum can then be decompressed directly from the mapped file
+    without searching through the file or copying the compressed data.
+    The spectra are numbered in the same way as in CSpectrumIO::ReadSpectrum. */
+class PakFileIndex
+{
+public:
+    PakFileIndex();
+
+    PakFileIndex(const PakFileIndex&) = delete;
+    PakFileIndex& operator=(const PakFileIndex&) = delete;
+
+    /** Memory maps the given .pak file and locates all the spectra in it.
+        Any previously opened file is first closed.
+        @return true if the file could be opened. m_lastError is set to one of
+            the error codes in CSpectrumIO if the file could not be opened. */
+    bool Open(const std::string& fileName);
+
+    /** Closes the file, after this no spectra can be read. */
+    void Close();
+
+    /** @return the name of the currently opened file. */
+    const std::string& FileName() const { return m_fileName; }
+
+    /** @return the number of spectra in the opened file. */
+    size_t SpectrumCount() const { return m_spectra.size(); }
+
+    /** @return the MKZY header of the spectrum with the given (zero based) index.
+        If the header in the file is shorter than MKZYhdr (older file versions) then the remaining
+        values are zero, except measureidx which is -1. Index must be smaller than SpectrumCount(). */
+    const MKZYhdr& GetHeader(size_t index) const { return m_spectra[index].header; }
+
+    /** @return the compressed data of the spectrum with the given (zero based) index, this points into the mapped file.
+        The length of the compressed data is GetHeader(index).size. Index must be smaller than SpectrumCount(). */
+    const std::uint8_t* GetCompressedData(size_t index) const;
+
+    /** @return the name of the spectrum with the given (zero based) index, e.g. 'sky' or 'dark'.
+        Index must be smaller than SpectrumCount(). */
+    std::string GetSpectrumName(size_t index) const;
+
+    /** Reads and decompresses the spectrum with the given (zero based) index.
+        @param spec Will on successful return contain the desired spectrum.
+        @return true if all is ok. m_lastError is set to one of the error codes in CSpectrumIO if the spectrum could not be read. */
+    bool GetSpectrum(size_t index, CSpectrum& spec);
+
+    /** Reads and decompresses the spectrum with the given (zero based) index, in the same way as GetSpectrum.
+        This does not change the state of the index and can hence be called from several threads at the same time.
+        @param spec Will on successful return contain the desired spectrum.
+        @return CSpectrumIO::ERROR_NO_ERROR if all is ok, otherwise one of the other error codes in CSpectrumIO. */
+    int ReadSpectrum(size_t index, CSpectrum& spec) const;
+
+    /** If any error occurs in the reading of the file, this int is set to
+        any of the errors defined in CSpectrumIO. */
+    int m_lastError;
+
+private:
+    struct SpectrumLocation
+    {
+        /** The header of the spectrum, as read from the file. */
+        MKZYhdr header;
+
+        /** The offset in the file of the first byte of compressed data. */
+        size_t dataOffset;
+    };
+
+    std::string m_fileName;
+
+    MemoryMappedFile m_file;
+
+    std::vector<SpectrumLocation> m_spectra;
+};
+
+}
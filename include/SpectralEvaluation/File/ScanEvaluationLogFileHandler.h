@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <SpectralEvaluation/Evaluation/BasicScanEvaluationResult.h>
 
@@ -26,6 +27,14 @@ public:
         @return true if the file could be parsed successfully, otherwise false. */
     bool ReadEvaluationLog(const std::string& evaluationLogFile);
 
+    /** Parses the contents of the provided evaluation log file and calls 'onScan' with the result of each scan,
+        in the order in which the scans are found in the file. The scans are not stored in m_scan, hence this
+        can be used to process large files without keeping all the results in memory.
+        The file is parsed in the same way as in ReadEvaluationLog and m_evaluationLog, m_specie and m_specInfo are updated.
+        @return true if the file could be parsed successfully, otherwise false. Notice that 'onScan' may have been called
+            also if this returns false. */
+    bool ReadEvaluationLog(const std::string& evaluationLogFile, const std::function<void(BasicScanEvaluationResult&&)>& onScan);
+
     /** Writes the contents of the array 'm_scan' to a new evaluation-log file */
     bool WriteEvaluationLog(const std::string fileName);
 
@@ -101,11 +110,21 @@ private:
     novac::CEvaluationResult m_evResult;
 
     /** Reads the header line for the scan information and retrieves which
-        column represents which value. */
-    void ParseScanHeader(const char szLine[8192]);
+        column represents which value.
+        @param szLine The header line, which does not need to be null terminated.
+        @param length The number of characters in the line. */
+    void ParseScanHeader(const char* szLine, size_t length);
+
+    /** Parses the value in column 'curCol' of a line of spectral data.
+        @return false if the column is the start or stop time and the time could not be parsed. */
+    bool ParseColumn(const char* szToken, int curCol);
+
+    /** Splits the contents of the evaluation log file into lines. */
+    class LogFileLines;
 
-    /** Reads and parses the XML-shaped 'scanInfo' header before the scan */
-    void ParseScanInformation(novac::CSpectrumInfo& scanInfo, double& flux, FILE* f);
+    /** Reads and parses the XML-shaped 'scanInfo' header before the scan.
+        @return true if both the date and the start time of the scan were found. */
+    bool ParseScanInformation(novac::CSpectrumInfo& scanInfo, double& flux, LogFileLines& lines);
 
     /** Reads and parses the XML-shaped 'fluxInfo' header before the scan */
     // void ParseFluxInformation(CWindField& windField, double& flux, FILE* f);
@@ -120,17 +139,10 @@ private:
         to count the number of scans in it */
     long CountScansInFile();
 
-    /** Makes a quick scan through the evaluation-log
-        to get the start-times of each scan. */
-    void GetScanStartTimes(std::vector<novac::CDateTime>& startTimes);
-
-    /** Sorts the scans in order of collection */
+    /** Sorts the scans in order of collection. Scans with the same start time are kept in the order of the file. */
     void SortScans();
 
     /** Returns true if the scans are already ordered */
     bool IsSorted();
-
-    /** Sorts the CDateTime-objects in the given array. */
-    static void SortScanStartTimes(std::vector<CDateTime>& timestamps, std::vector<unsigned int>& sortOrder);
 };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <memory>
 #include <vector>
 #include <SpectralEvaluation/DateTime.h>
+#include <SpectralEvaluation/File/PakFileIndex.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/Spectra/IScanSpectrumSource.h>
 
@@ -12,8 +13,10 @@ namespace novac
 /** ScanFileHandler is a class to read in information from the scan-files
     (all the spectra from one scan are supposed to be packed together in one file in Manne's 'pak'-format.
     Each instance of 'CScanFileHandler' is capable of reading data from one .pak-file.
-    Each instance of this class should be initialized by first calling 'CheckScanFile' which will read in
-    the data on the file and then create*/
+    Each instance of this class should be initialized by first calling 'CheckScanFile' which will locate
+    the spectra in the file and read in the sky, dark, offset and dark-current spectra.
+    The spectra are decompressed when they are first requested and are then kept in memory.
+    The file is kept open until every spectrum in it has been read once. */
 class CScanFileHandler : public IScanSpectrumSource
 {
 public:
@@ -171,15 +174,28 @@ private:
     /** The total number of spectra in the current .pak-file */
     std::uint32_t m_specNum = 0;
 
-    /** An array containing the spectra in the current spectrum file.
-        These are read in when 'CheckScanFile' is called and retrieved
-        by GetSpectrum(...)
-        The buffer is introduced to save some read/writes from hard-disk */
-    std::vector<CSpectrum> m_spectrumBuffer;
+    /** The location of all the spectra in the current spectrum file.
+        This is closed once all the spectra have been read into m_spectrumBuffer. */
+    PakFileIndex m_pakFileIndex;
 
-    /** The number of spectra read in to the m_spectrumBuffer
-        This might not be the same as 'm_specNum' */
-    unsigned int m_spectrumBufferNum = 0;
+    /** The spectra in the current spectrum file, one element for each spectrum in the file.
+        An element is null until the spectrum has been read, or if it could not be read. */
+    std::vector<std::unique_ptr<CSpectrum>> m_spectrumBuffer;
+
+    /** The error (one of the errors in CSpectrumIO) from reading each of the spectra in the file,
+        or -1 if the spectrum has not yet been read. */
+    std::vector<int> m_spectrumError;
+
+    /** The number of spectra in the file which have not yet been read. */
+    std::uint32_t m_spectraNotYetRead = 0;
+
+    /** Returns the spectrum with the given index, reading it from the file if this is the first time it is requested.
+        @return the spectrum, or nullptr (with m_lastError set) if it could not be read. */
+    const CSpectrum* GetBufferedSpectrum(int index);
+
+    /** Creates a copy of the spectrum with the given index, see GetBufferedSpectrum.
+        @return the spectrum, or nullptr (with m_lastError set) if it could not be read. */
+    std::unique_ptr<CSpectrum> ReadSpectrum(int index);
 
     /** Updates the m_startTime and m_stopTime to include the timestamp of the provided spectrum */
     void UpdateStartAndStopTimeOfScan(novac::CSpectrum& spec);
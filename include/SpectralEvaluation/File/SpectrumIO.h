@@ -37,6 +37,9 @@ public:
     /** Returns the contents of m_lastError as a string. */
     std::string FormatLastError() const;
 
+    /** Returns the given error code (one of the errors defined above) as a string. */
+    static std::string FormatError(int errorCode);
+
     /** Reads the next spectrum in the provided spectrum file.
             The spectrum file (which must be in the .pak format) must be opened for reading
             in binary mode. File will not be closed by this routine.
@@ -98,6 +101,10 @@ public:
         @return - The number of spectra in the spectrum file */
     std::uint32_t ScanSpectrumFile(const std::string& fileName, const std::string* specNamesToLookFor, int numSpecNames, int* indices);
 
+    /** Clears the given spectrum and fills in its length and the spectrum information
+        (m_info) from the provided MKZY header. This does not read the spectral data. */
+    static void ParseSpectrumHeader(const MKZYhdr& header, CSpectrum& spec);
+
     /** If any error occurs in the reading of the file, this int is set to
         any of the errors defined above. */
     int m_lastError;
@@ -106,9 +113,6 @@ private:
     /** A buffer for reading data */
     std::vector<unsigned char> m_buffer;
 
-    /** A buffer for temporary output */
-    std::vector<long> m_outbuf;
-
     /** Reads a spectrum header from the supplied file.
         @param MKZYHeader Will on successful return contain the read in result.
         @param spec If not null then the header information will also be saved in the spectrum (not the spectral data).
@@ -122,13 +126,13 @@ private:
     int ReadNextSpectrumHeader(FILE* f, struct MKZYhdr& MKZYHeader, int& headerSize, CSpectrum* spec = nullptr, char* headerBuffer = nullptr, int headerBufferSize = 0);
 
     /** Converts a time from std::uint32_t to CDateTime */
-    void ParseTime(const std::uint32_t t, CDateTime& time) const;
+    static void ParseTime(const std::uint32_t t, CDateTime& time);
 
     /** Converts a time from CDateTime to std::uint32_t */
     void WriteTime(std::uint32_t& t, const CDateTime& time) const;
 
     /** Converts a date from std::uint32_t to CDateTime */
-    void ParseDate(const std::uint32_t d, CDateTime& day) const;
+    static void ParseDate(const std::uint32_t d, CDateTime& day);
 
     /** Converts a date from CDateTime to std::uint32_t */
     void WriteDate(std::uint32_t& d, const CDateTime& day) const;
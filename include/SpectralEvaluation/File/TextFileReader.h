@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <SpectralEvaluation/File/MemoryMappedFile.h>
+
+namespace novac
+{
+
+/** TextFileReader reads the contents of a text file, such as a cross section or a spectrum,
+    from a memory mapped buffer. This replaces reading the file line by line using fgets and
+    parsing the values using (f)scanf, giving the same results but without copying the file
+    into intermediate buffers and without parsing a format string for every value. */
+class TextFileReader
+{
+public:
+    TextFileReader() = default;
+
+    TextFileReader(const TextFileReader&) = delete;
+    TextFileReader& operator=(const TextFileReader&) = delete;
+
+    /** Opens the given file and positions the reader at the start of it. Any previously opened file is first closed.
+        @return true if the file could be opened. Empty files can be opened but contain no lines. */
+    bool Open(const std::string& fileName);
+
+    /** Closes the file. */
+    void Close();
+
+    /** Moves the reader back to the start of the file. */
+    void Rewind();
+
+    /** @return true if the entire file has been read. */
+    bool IsAtEnd() const { return m_position == m_end; }
+
+    /** Reads the next line of the file in the same way as fgets, i.e. reads at most bufferSize - 1 characters,
+        stopping after the first newline character (which is included in the buffer) and null terminates the buffer.
+        @return false if there are no more characters in the file. */
+    bool ReadLine(char* buffer, int bufferSize);
+
+    /** Reads the next line of the file, without copying it. On successful return lineBegin points to the first
+        character of the line and lineEnd to the newline character ending the line (or the end of the file).
+        @return false if there are no more lines in the file. */
+    bool ReadLine(const char*& lineBegin, const char*& lineEnd);
+
+    /** Reads the next value in the file in the same way as fscanf(file, "%lf"), i.e. skipping all whitespace (including newlines).
+        @return false if the next non-whitespace characters in the file are not a number, the reader is then positioned after the whitespace. */
+    bool ReadDouble(double& value);
+
+    /** Moves past the provided character if this is the next character in the file,
+        this is equivalent to a literal character in the format string of fscanf.
+        @return true if the character was found. */
+    bool ReadCharacter(char character);
+
+    /** Moves past all whitespace characters (including newlines) at the current position. */
+    void SkipWhitespace();
+
+private:
+    MemoryMappedFile m_file;
+
+    const char* m_position = nullptr;
+
+    const char* m_end = nullptr;
+};
+
+/** Parses a number from the characters in the range [position, end) in the same way as strtod,
+    i.e. skipping leading whitespace. This never reads any character at or beyond 'end'.
+    @param position Will on successful return point to the first character after the number.
+    @return true if a number could be parsed. */
+bool ParseDouble(const char*& position, const char* end, double& value);
+
+}
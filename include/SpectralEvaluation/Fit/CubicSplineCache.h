@@ -0,0 +1,42 @@
+/**
+ * CubicSplineCache.h
+ *
+ * Contains a process wide cache of cubic splines, such that reference spectra with identical data
+ * (e.g. the same cross section used in several fit windows or by several evaluators) share one spline.
+ */
+#if !defined(CUBICSPLINECACHE_H_200101)
+#define CUBICSPLINECACHE_H_200101
+
+#include <memory>
+#include <SpectralEvaluation/Fit/CubicSplineFunction.h>
+
+namespace MathFit
+{
+	/**
+	* Keeps track of all splines created through it which are still in use. The cache does not keep
+	* the splines alive, a spline is removed when the last object using it releases it.
+	* The splines are identified by the contents of their data points, the X values (the grid) and the Y values.
+	* All methods are thread safe.
+	*/
+	class CCubicSplineCache
+	{
+	public:
+		/**
+		* Returns the spline through the given data points. If a spline through exactly the same data points
+		* is already in use then that spline is returned, otherwise a new spline is calculated.
+		*
+		* @param vXValues			The vector containing the X values.
+		* @param vYValues			The vector containing the Y values in regard to the X values.
+		*
+		* @return	The spline, or an empty pointer if there are too few data points to calculate a spline.
+		*/
+		static std::shared_ptr<const CCubicSplineCoefficients> GetCoefficients(CVector& vXValues, CVector& vYValues);
+
+		/**
+		* @return	The number of splines in the cache which are still in use.
+		*/
+		static int GetSize();
+	};
+}
+
+#endif
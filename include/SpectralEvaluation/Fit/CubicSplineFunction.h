@@ -1,125 +1,34 @@
 #if !defined(CUBICSPLINEFUNCTION_H_020817)
 #define CUBICSPLINEFUNCTION_H_020817
 
+#include <memory>
 #include <SpectralEvaluation/Fit/Function.h>
 
 namespace MathFit
 {
-	class CCubicSplineFunction : public IFunction
+	/**
+	* Contains the data points and the precalculated coefficients of a natural cubic spline.
+	* The coefficients are not changed after they have been calculated, therefore one object can be
+	* shared by several \Ref{CCubicSplineFunction} objects, see also \Ref{CCubicSplineCache}.
+	*/
+	class CCubicSplineCoefficients
 	{
 	public:
 		/**
-		* Create an empty object.
-		*/
-		CCubicSplineFunction()
-		{
-		}
-
-		/**
-		* Create a cubic spline object using the given data.
+		* Calculates the spline through the given data points.
 		*
 		* @param vXValues			The vector containing the X values.
 		* @param vYValues			The vector containing the Y values in regard to the X values.
-		*/
-		CCubicSplineFunction(CVector& vXValues, CVector& vYValues)
-		{
-			CCubicSplineFunction::SetData(vXValues, vYValues);
-		}
-
-		/**
-		* Create a cubic spline object using the given data.
 		*
-		* @param vXValues			The vector containing the X values.
-		* @param vYValues			The vector containing the Y values in regard to the X values.
-		* @param vError				The vector containing the errors of the Y values. This vector will not be interpolated!
+		* @return	TRUE if successful, FALSE if there are too few data points.
 		*/
-		CCubicSplineFunction(CVector& vXValues, CVector& vYValues, CVector& vError)
+		bool Initialize(CVector& vXValues, CVector& vYValues)
 		{
-			CCubicSplineFunction::SetData(vXValues, vYValues, vError);
-		}
-
-		/**
-		* @param vXValues			The vector containing the X values.
-		* @param vYValues			The vector containing the Y values in regard to the X values.
-		*
-		* @return	TRUE if successful, FALSE otherwise
-		*/
-		virtual bool SetData(CVector& vXValues, CVector& vYValues, CVector& vError)
-		{
-			if(!IFunction::SetData(vXValues, vYValues, vError))
-				return false;
+			MATHFIT_ASSERT(vXValues.GetSize() == vYValues.GetSize());
 
-			return InitializeSpline();
-		}
+			mXData.Copy(vXValues);
+			mYData.Copy(vYValues);
 
-		/**
-		* @param vXValues			The vector containing the X values.
-		* @param vYValues			The vector containing the Y values in regard to the X values.
-		* @param vError			The vector containing the errors of the Y values. This vector will not be interpolated!
-		*
-		* @return	TRUE if successful, FALSE otherwise
-		*/
-		virtual bool SetData(CVector& vXValues, CVector& vYValues)
-		{
-			if(!IFunction::SetData(vXValues, vYValues))
-				return false;
-
-			return InitializeSpline();
-		}
-
-		/**
-		* Returns the value of the cubic spline at the given X value.
-		*
-		* @param fXValue	The X value at which to evaluate the spline
-		*
-		* @return	The evaluated spline value.
-		*/
-		virtual TFitData GetValue(TFitData fXValue)
-		{
-			return EvaluateSpline(fXValue);
-		}
-
-		/**
-		* Calculates the function values at a set of given data points.
-		*
-		* @param vXValues			A vector object containing the X values at which the function has to be evaluated.
-		* @param vYTargetVector	A vector object which receives the resulting function values.
-		*
-		* @return	A reference to the Y vector object
-		*/
-		virtual CVector& GetValues(CVector& vXValues, CVector& vYTargetVector)
-		{
-			return EvaluateSplineVector(vXValues, vYTargetVector);
-		}
-
-		/**
-		* Returns the first derivative of the spline at the given data point.
-		*
-		* @param fXValue	The X value at which the slope is needed.
-		*
-		* @return	The slope of the B-Spline at the given data point.
-		*/
-		virtual TFitData GetSlope(TFitData fXValue)
-		{
-			return SlopeSpline(fXValue);
-		}
-
-		/**
-		* Calculates the first derivative of the function at a set of given data points.
-		*
-		* @param vXValues		A vector object containing the X values at which the function has to be evaluated.
-		* @param vSlopeVector	A vector object which receives the resulting function values.
-		*
-		* @return	A reference to the slope vector object.
-		*/
-		virtual CVector& GetSlopes(CVector& vXValues, CVector& vSlopeVector)
-		{
-			return SlopeSplineVector(vXValues, vSlopeVector);
-		}
-
-	private:
-		bool InitializeSpline()
-		{
 			// we need at least 3 nodes
 			MATHFIT_ASSERT(mXData.GetSize() >= 3);
 
@@ -223,6 +132,257 @@ namespace MathFit
 			return true;
 		}
 
+		/**
+		* Checks if the spline was calculated from exactly the given data points.
+		*
+		* @param vXValues			The vector containing the X values.
+		* @param vYValues			The vector containing the Y values in regard to the X values.
+		*
+		* @return	TRUE if the data points are identical to the ones of this spline.
+		*/
+		bool IsCalculatedFrom(const CVector& vXValues, const CVector& vYValues) const
+		{
+			const int iSize = mXData.GetSize();
+			if(vXValues.GetSize() != iSize || vYValues.GetSize() != iSize)
+				return false;
+
+			int i;
+			for(i = 0; i < iSize; i++)
+			{
+				if(vXValues.GetAt(i) != mXData.GetAt(i) || vYValues.GetAt(i) != mYData.GetAt(i))
+					return false;
+			}
+
+			return true;
+		}
+
+		CVector mXData;
+		CVector mYData;
+		CVector mY2ndDerivates;
+
+		CVector mH;
+		CVector mSlopeInvariant;
+		CVector mDeltaHSquareLow;
+		CVector mDeltaHSquareHigh;
+		CVector mSlopeDeltaHSquareLow;
+		CVector mSlopeDeltaHSquareHigh;
+	};
+
+	class CCubicSplineFunction : public IFunction
+	{
+	public:
+		/**
+		* Create an empty object.
+		*/
+		CCubicSplineFunction()
+		{
+		}
+
+		/**
+		* Create a cubic spline object using the given data.
+		*
+		* @param vXValues			The vector containing the X values.
+		* @param vYValues			The vector containing the Y values in regard to the X values.
+		*/
+		CCubicSplineFunction(CVector& vXValues, CVector& vYValues)
+		{
+			CCubicSplineFunction::SetData(vXValues, vYValues);
+		}
+
+		/**
+		* Create a cubic spline object using the given data.
+		*
+		* @param vXValues			The vector containing the X values.
+		* @param vYValues			The vector containing the Y values in regard to the X values.
+		* @param vError				The vector containing the errors of the Y values. This vector will not be interpolated!
+		*/
+		CCubicSplineFunction(CVector& vXValues, CVector& vYValues, CVector& vError)
+		{
+			CCubicSplineFunction::SetData(vXValues, vYValues, vError);
+		}
+
+		/**
+		* Creates a copy of the given spline. The copy shares the spline coefficients with the original.
+		*
+		* @param csfSource			The spline to copy.
+		*/
+		CCubicSplineFunction(const CCubicSplineFunction& csfSource) : IFunction()
+		{
+			*this = csfSource;
+		}
+
+		/**
+		* Copies the given spline. The spline coefficients are shared with the original.
+		*
+		* @param csfSource			The spline to copy.
+		*
+		* @return	A reference to the current object.
+		*/
+		CCubicSplineFunction& operator=(const CCubicSplineFunction& csfSource)
+		{
+			if(this == &csfSource)
+				return *this;
+
+			if(csfSource.mCoefficients)
+				AttachCoefficients(csfSource.mCoefficients);
+			else
+			{
+				ReleaseCoefficients();
+				mXData.Copy(csfSource.mXData);
+				mYData.Copy(csfSource.mYData);
+			}
+			mError.Copy(csfSource.mError);
+
+			return *this;
+		}
+
+		/**
+		* @param vXValues			The vector containing the X values.
+		* @param vYValues			The vector containing the Y values in regard to the X values.
+		*
+		* @return	TRUE if successful, FALSE otherwise
+		*/
+		virtual bool SetData(CVector& vXValues, CVector& vYValues, CVector& vError)
+		{
+			ReleaseCoefficients();
+
+			if(!IFunction::SetData(vXValues, vYValues, vError))
+				return false;
+
+			return InitializeSpline();
+		}
+
+		/**
+		* @param vXValues			The vector containing the X values.
+		* @param vYValues			The vector containing the Y values in regard to the X values.
+		* @param vError			The vector containing the errors of the Y values. This vector will not be interpolated!
+		*
+		* @return	TRUE if successful, FALSE otherwise
+		*/
+		virtual bool SetData(CVector& vXValues, CVector& vYValues)
+		{
+			ReleaseCoefficients();
+
+			if(!IFunction::SetData(vXValues, vYValues))
+				return false;
+
+			return InitializeSpline();
+		}
+
+		/**
+		* Uses an already calculated spline, which may be shared with other objects.
+		*
+		* @param pCoefficients	The spline to use.
+		* @param vError			The vector containing the errors of the Y values. This vector will not be interpolated!
+		*
+		* @return	TRUE if successful, FALSE if no spline is given.
+		*/
+		bool SetCoefficients(const std::shared_ptr<const CCubicSplineCoefficients>& pCoefficients, CVector& vError)
+		{
+			if(!pCoefficients)
+				return false;
+
+			MATHFIT_ASSERT(pCoefficients->mXData.GetSize() == vError.GetSize());
+
+			AttachCoefficients(pCoefficients);
+			mError.Copy(vError);
+
+			return true;
+		}
+
+		/**
+		* Returns the spline currently used by this object.
+		*
+		* @return	The spline, or an empty pointer if no data has been set.
+		*/
+		std::shared_ptr<const CCubicSplineCoefficients> GetCoefficients() const
+		{
+			return mCoefficients;
+		}
+
+		/**
+		* Sets new X values and recalculates the spline.
+		*
+		* @param vXValues		A vector object containing the X values of the data set.
+		*
+		* @return TRUE is successful, FALSE otherwise.
+		*/
+		virtual bool SetXData(CVector& vXValues)
+		{
+			// the current data may be shared, therefore it is copied before it is replaced
+			CVector vYValues(mYData);
+			CVector vError(mError);
+
+			return SetData(vXValues, vYValues, vError);
+		}
+
+		/**
+		* Sets new Y values and recalculates the spline.
+		*
+		* @param vYValues		A vector object containing the Y values of the data set.
+		*
+		* @return TRUE is successful, FALSE otherwise.
+		*/
+		virtual bool SetYData(CVector& vYValues)
+		{
+			// the current data may be shared, therefore it is copied before it is replaced
+			CVector vXValues(mXData);
+			CVector vError(mError);
+
+			return SetData(vXValues, vYValues, vError);
+		}
+
+		/**
+		* Returns the value of the cubic spline at the given X value.
+		*
+		* @param fXValue	The X value at which to evaluate the spline
+		*
+		* @return	The evaluated spline value.
+		*/
+		virtual TFitData GetValue(TFitData fXValue)
+		{
+			return EvaluateSpline(fXValue);
+		}
+
+		/**
+		* Calculates the function values at a set of given data points.
+		*
+		* @param vXValues			A vector object containing the X values at which the function has to be evaluated.
+		* @param vYTargetVector	A vector object which receives the resulting function values.
+		*
+		* @return	A reference to the Y vector object
+		*/
+		virtual CVector& GetValues(CVector& vXValues, CVector& vYTargetVector)
+		{
+			return EvaluateSplineVector(vXValues, vYTargetVector);
+		}
+
+		/**
+		* Returns the first derivative of the spline at the given data point.
+		*
+		* @param fXValue	The X value at which the slope is needed.
+		*
+		* @return	The slope of the B-Spline at the given data point.
+		*/
+		virtual TFitData GetSlope(TFitData fXValue)
+		{
+			return SlopeSpline(fXValue);
+		}
+
+		/**
+		* Calculates the first derivative of the function at a set of given data points.
+		*
+		* @param vXValues		A vector object containing the X values at which the function has to be evaluated.
+		* @param vSlopeVector	A vector object which receives the resulting function values.
+		*
+		* @return	A reference to the slope vector object.
+		*/
+		virtual CVector& GetSlopes(CVector& vXValues, CVector& vSlopeVector)
+		{
+			return SlopeSplineVector(vXValues, vSlopeVector);
+		}
+
+	private:
 		TFitData EvaluateSpline(TFitData fXValue)
 		{
 			// check wheter we have a valid spline
@@ -431,6 +591,70 @@ namespace MathFit
 			return vYData;
 		}
 
+		/**
+		* Calculates the spline through the current data points.
+		*
+		* @return	TRUE if successful, FALSE if there are too few data points.
+		*/
+		bool InitializeSpline()
+		{
+			std::shared_ptr<CCubicSplineCoefficients> pCoefficients = std::make_shared<CCubicSplineCoefficients>();
+			if(!pCoefficients->Initialize(mXData, mYData))
+				return false;
+
+			AttachCoefficients(pCoefficients);
+
+			return true;
+		}
+
+		/**
+		* Lets the data and coefficient vectors of this object refer to the given coefficients.
+		*/
+		void AttachCoefficients(const std::shared_ptr<const CCubicSplineCoefficients>& pCoefficients)
+		{
+			ReleaseCoefficients();
+
+			const int iSize = pCoefficients->mXData.GetSize();
+			mXData.Attach(pCoefficients->mXData.GetSafePtr(), iSize, 1, false);
+			mYData.Attach(pCoefficients->mYData.GetSafePtr(), iSize, 1, false);
+			mY2ndDerivates.Attach(pCoefficients->mY2ndDerivates.GetSafePtr(), iSize, 1, false);
+			mH.Attach(pCoefficients->mH.GetSafePtr(), iSize, 1, false);
+			mSlopeInvariant.Attach(pCoefficients->mSlopeInvariant.GetSafePtr(), iSize, 1, false);
+			mDeltaHSquareLow.Attach(pCoefficients->mDeltaHSquareLow.GetSafePtr(), iSize, 1, false);
+			mDeltaHSquareHigh.Attach(pCoefficients->mDeltaHSquareHigh.GetSafePtr(), iSize, 1, false);
+			mSlopeDeltaHSquareLow.Attach(pCoefficients->mSlopeDeltaHSquareLow.GetSafePtr(), iSize, 1, false);
+			mSlopeDeltaHSquareHigh.Attach(pCoefficients->mSlopeDeltaHSquareHigh.GetSafePtr(), iSize, 1, false);
+
+			mCoefficients = pCoefficients;
+		}
+
+		/**
+		* Detaches the data and coefficient vectors from the current coefficients, if any.
+		* The data vectors are left empty, such that new data can be copied into them.
+		*/
+		void ReleaseCoefficients()
+		{
+			if(!mCoefficients)
+				return;
+
+			mXData.Detach();
+			mYData.Detach();
+			mY2ndDerivates.Detach();
+			mH.Detach();
+			mSlopeInvariant.Detach();
+			mDeltaHSquareLow.Detach();
+			mDeltaHSquareHigh.Detach();
+			mSlopeDeltaHSquareLow.Detach();
+			mSlopeDeltaHSquareHigh.Detach();
+
+			mCoefficients.reset();
+		}
+
+		/**
+		* The coefficients which mXData, mYData and the vectors below refer to.
+		*/
+		std::shared_ptr<const CCubicSplineCoefficients> mCoefficients;
+
 		CVector mY2ndDerivates;
 
 		CVector mH;
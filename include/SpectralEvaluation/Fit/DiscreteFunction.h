@@ -104,6 +104,9 @@ namespace MathFit
 		*/
 		virtual bool SetData(CVector& vXValues, CVector& vYValues, CVector& vError)
 		{
+			// never copy into the buffers of previously attached data
+			DetachData();
+
 			// first copy data into internal buffers
 			if(!IParamFunction::SetData(vXValues, vYValues, vError))
 				return false;
@@ -113,6 +116,32 @@ namespace MathFit
 			return true;
 		}
 
+		/**
+		* Sets the new function values without copying them.
+		* The object refers to the data of the given vectors, which must therefore be kept alive
+		* and unchanged for as long as the object is used or until new data is set.
+		*
+		* @param vXValues		A vector object containing the X values of the data set.
+		* @param vYValues		A vector object containing the Y values of the data set.
+		* @param vError			A vector object containing the <B>sigma</B> error values of the data set.
+		*
+		* @return TRUE is successful, false if the vector sizes do not match.
+		*/
+		bool AttachData(CVector& vXValues, CVector& vYValues, CVector& vError)
+		{
+			if(vXValues.GetSize() != vYValues.GetSize() || vXValues.GetSize() != vError.GetSize())
+				return false;
+
+			DetachData();
+
+			mXData.Attach(vXValues, false);
+			mYData.Attach(vYValues, false);
+			mError.Attach(vError, false);
+			mDataAttached = true;
+
+			return MakeDiscreteSlopes();
+		}
+
 		/**
 		* Returns the value of the function at the given X value.
 		*
@@ -260,7 +289,24 @@ namespace MathFit
 			return true;
 		}
 
+		/**
+		* Releases the references to the data set with AttachData, leaving the data vectors empty.
+		*/
+		void DetachData()
+		{
+			if(!mDataAttached)
+				return;
+
+			mXData.Detach();
+			mYData.Detach();
+			mError.Detach();
+			mDataAttached = false;
+		}
+
 		CVector mDiscreteSlopes;
+
+		// TRUE if the data vectors refer to the data of other vectors, see AttachData
+		bool mDataAttached = false;
 	};
 }
 
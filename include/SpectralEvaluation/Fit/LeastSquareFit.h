@@ -39,6 +39,37 @@ namespace MathFit
 		*/
 		CLeastSquareFit(IParamFunction& ipfModel) : IMinimizer(ipfModel)
 		{
+#if defined(MATHFIT_USELUDECOMPOSITION)
+			mSolveMethod = CMatrix::LUDECOMPOSITION;
+#else
+			mSolveMethod = CMatrix::QR;
+#endif
+			mFactorized = false;
+		}
+
+		/**
+		* Selects the method used to solve the least squares problem.
+		* The default is to use a Householder QR decomposition of the design matrix, which is numerically
+		* more stable than solving the normal equations.
+		* The decompositions made with CMatrix::QR and CMatrix::CHOLESKY are reused as long as the design matrix
+		* does not change between two calls to \Ref{Minimize}, e.g. when the nonlinear parameters of the model are unchanged.
+		*
+		* @param eMethod	The solve method to use.
+		*/
+		void SetSolveMethod(CMatrix::ESolveMethod eMethod)
+		{
+			mSolveMethod = eMethod;
+			mFactorized = false;
+		}
+
+		/**
+		* Returns the method used to solve the least squares problem.
+		*
+		* @return The current solve method.
+		*/
+		CMatrix::ESolveMethod GetSolveMethod() const
+		{
+			return mSolveMethod;
 		}
 
 		/**
@@ -56,101 +87,50 @@ namespace MathFit
 
 		/**
 		* Get the solution for the minimization problem.
-		* The leat square method with the pseudo inverse is used for minimization
+		* The solution is calculated using the method selected with \Ref{SetSolveMethod}.
+		* No memory is allocated here as long as the number of parameters and the fit range are unchanged.
 		*
 		* @return FALSE when finished successfully.
 		*/
 		virtual bool Minimize()
 		{
-			if(mModel.GetLinearParameter().GetSize() <= 0)
+			const int iParams = mModel.GetLinearParameter().GetSize();
+			if(iParams <= 0)
 				return false;
 
-			// bring the matrix and vector to their appropriate sizes
-			mA.SetSize(mModel.GetLinearParameter().GetSize(), mFitRange.GetSize());
-			mB.SetSize(mFitRange.GetSize());
+			// bring the matrix and vectors to their appropriate sizes
+			const int iPoints = mFitRange.GetSize();
+			mDesign.SetSize(iParams, iPoints);
+			mB.SetSize(iPoints);
+			mError.SetSize(iPoints);
 
 			// get the A matrix and a modified B vector according to the model function
-			mModel.GetLinearAMatrix(mFitRange, mA, mB);
+			mModel.GetLinearAMatrix(mFitRange, mDesign, mB);
 
 			// add data errors to model matrix
-			CVector vError(mFitRange.GetSize());
-			mModel.GetFunctionErrors(mFitRange, vError);
-			const int iBSize = mB.GetSize();
+			mModel.GetFunctionErrors(mFitRange, mError);
 			int i;
-			for(i = 0; i < iBSize; i++)
+			for(i = 0; i < iPoints; i++)
 			{
-				mA.GetRow(i).Div(vError.GetAt(i));
-				mB.SetAt(i, mB.GetAt(i) / vError.GetAt(i));
+				mDesign.GetRow(i).Div(mError.GetAt(i));
+				mB.SetAt(i, mB.GetAt(i) / mError.GetAt(i));
 			}
 
-			// build transposed A matrix
-			// At
-			mTranspose.Copy(mA);
-			mTranspose.Transpose();
-
-			// build the new result vector
-			// At * b
-			mTranspose.Mul(mB);
-
-			// build inverse pseudo
-			// (At*A)
-			mA.PseudoInverse();
-
-#if defined(MATHFIT_IMPROVEEQSSOLVE)
-			// to apply the iterative solution improvement, we need backups of the original
-			// result vector and EQS matrix
-			CVector vBackupB(mB);
-			CMatrix mBackupA(mA);
-#endif
-
-			// Solve linear equations
-#if defined(MATHFIT_USELUDECOMPOSITION)
-			mA.LUDecomposition();
-			mA.LUBacksubstitution(mB);
-
-#if defined(MATHFIT_IMPROVEEQSSOLVE)
-			// we want to correct the numerical errors by applying
-			// the 'iterative solution improvement' as described in Numerical Recipes.
-
-			// Use the solution to calculate once again the result vector of the EQS
-			CVector vSolutionError(mB);
-			mBackupA.Mul(vSolutionError);
-
-			// subtract the old result vector from the one calculated using the EQS result
-			// (the result should be nearly zero at all)
-			vSolutionError.Sub(vBackupB);
-
-			// solve the EQS once again but use the solution error as result vector
-			mA.LUBacksubstitution(vSolutionError);
-
-			// subtract the solution error from the original solution
-			mB.Sub(vSolutionError);
-#endif
-#else
-			mA.GaussJordanSolve(mB);
-
-#if defined(MATHFIT_IMPROVEEQSSOLVE)
-			// we want to correct the numerical errors by applying
-			// the 'iterative solution improvement' as described in Numerical Recipes.
-
-			// Use the solution to calculate once again the result vector of the EQS
-			CVector vSolutionError(mB);
-			mBackupA.Mul(vSolutionError);
-
-			// subtract the old result vector from the one calculated using the EQS result
-			// (the result should be nearly zero at all)
-			vSolutionError.Sub(vBackupB);
-
-			// solve the EQS once again but use the solution error as result vector
-			mBackupA.GaussJordanSolve(vSolutionError);
-
-			// subtract the solution error from the original solution
-			mB.Sub(vSolutionError);
-#endif
-#endif
+			switch(mSolveMethod)
+			{
+			case CMatrix::QR:
+				SolveQR();
+				break;
+			case CMatrix::CHOLESKY:
+				SolveCholesky();
+				break;
+			default:
+				SolveNormalEquations();
+				break;
+			}
 
 			// and set the result
-			mModel.SetLinearParameter(mB);			
+			mModel.SetLinearParameter(mSolution);
 
 			return false;
 		}
@@ -170,35 +150,53 @@ namespace MathFit
 			mModel.GetValues(mFitRange, mDiff);
 
 			// now calculate the chi square and variance values
-			CVector vErr(mFitRange.GetSize());
-			mModel.GetFunctionErrors(mFitRange, vErr);
+			mError.SetSize(mFitRange.GetSize());
+			mModel.GetFunctionErrors(mFitRange, mError);
 
 			// get the sum of squares weighted by the sigma error vector
-			mChiSquare = mDiff.SquareSumErrorWeighted(vErr);
+			mChiSquare = mDiff.SquareSumErrorWeighted(mError);
 			mChiSquare += mModel.GetLinearPenalty(mChiSquare);
 
 			// calculate the normalization factor for all statistical parameters
 			TFitData fNorm = (TFitData)sqrt(mChiSquare / (mDiff.GetSize() - iParams));
 
-			// set the covariance matrix, which is the inverse of A after the Gauss Jordan elimination
-#if defined(MATHFIT_USELUDECOMPOSITION)
-			mA.LUInverse();
-#endif
-			CMatrix mCovar(mA);
+			// set the covariance matrix, which is the inverse of the normal matrix
+			CMatrix& mCovar = mCovarBuffer;
+			int i, j;
+			switch(mSolveMethod)
+			{
+			case CMatrix::QR:
+				mA.QRInverseNormalMatrix(mRDiagonal, mCovar);
+				UnscaleCovariance(mCovar);
+				break;
+			case CMatrix::CHOLESKY:
+				mNormal.CholeskyInverse(mCovar);
+				UnscaleCovariance(mCovar);
+				break;
+			case CMatrix::LUDECOMPOSITION:
+				mA.LUInverse();
+				mCovar.Copy(mA);
+				mFactorized = false;
+				break;
+			default:
+				// this is the inverse of A after the Gauss Jordan elimination
+				mCovar.Copy(mA);
+				break;
+			}
 
 			// set the covariance matrix
 			mModel.SetLinearCovarMatrix(mCovar);
 
 			// calculate the parameter errors
-			CVector vError(iParams);
-			int i;
+			CVector& vError = mParamError;
+			vError.SetSize(iParams);
 			for(i = 0; i < iParams; i++)
 				vError.SetAt(i, (TFitData)sqrt(mCovar.GetAt(i, i)));
 
 			// calculate the correlation matrix
-			CMatrix mCorrel(iParams, iParams);
+			CMatrix& mCorrel = mCorrelBuffer;
+			mCorrel.SetSize(iParams, iParams);
 
-			int j;
 			for(i = 0; i < iParams; i++)
 				for(j = 0; j < iParams; j++)
 					mCorrel.SetAt(i, j, mCovar.GetAt(i, j) / (vError.GetAt(i) * vError.GetAt(j)));
@@ -213,25 +211,243 @@ namespace MathFit
 
 	private:
 		/**
-		* This matrix contains the pseudo inverse.
+		* Copies the design matrix into mA and scales each of its columns to unit length.
+		* This equilibration improves the condition of the problem, e.g. for polynomials with large X values.
+		*/
+		void ScaleDesignMatrix()
+		{
+			const int iParams = mDesign.GetNoColumns();
+
+			mA.Copy(mDesign);
+			mColumnScale.SetSize(iParams);
+
+			int j;
+			for(j = 0; j < iParams; j++)
+			{
+				const TFitData fNorm = (TFitData)sqrt(mA.GetCol(j).Mul(mA.GetCol(j)));
+				if(fNorm == 0)
+					throw(EXCEPTION(CMatrixSingularException));
+
+				mColumnScale.SetAt(j, 1 / fNorm);
+				mA.GetCol(j).Mul(1 / fNorm);
+			}
+		}
+
+		/**
+		* Converts the covariance matrix of the column scaled problem into the covariance of the original problem.
+		*
+		* @param mCovar	The covariance matrix to convert.
 		*/
-		CMatrix mPseudoInverse;
+		void UnscaleCovariance(CMatrix& mCovar)
+		{
+			const int iParams = mCovar.GetNoColumns();
+
+			int i, j;
+			for(i = 0; i < iParams; i++)
+				for(j = 0; j < iParams; j++)
+					mCovar.SetAt(i, j, mCovar.GetAt(i, j) * mColumnScale.GetAt(i) * mColumnScale.GetAt(j));
+		}
+
 		/**
-		* Contains the A matrix.
+		* Solves the least squares problem using a QR decomposition of the (scaled) design matrix.
+		* The decomposition is only recalculated if the design matrix has changed since the last call.
+		*/
+		void SolveQR()
+		{
+			const int iParams = mDesign.GetNoColumns();
+
+			if(!mFactorized || !mDesign.IsEqual(mFactorizedDesign))
+			{
+				mFactorized = false;
+				mFactorizedDesign.Copy(mDesign);
+
+				ScaleDesignMatrix();
+				mRDiagonal.SetSize(iParams);
+				mA.QRDecomposition(mRDiagonal);
+
+				mFactorized = true;
+			}
+
+			mWork.Copy(mB);
+			mA.QRBacksubstitution(mRDiagonal, mWork);
+
+			mSolution.SetSize(iParams);
+			int j;
+			for(j = 0; j < iParams; j++)
+				mSolution.SetAt(j, mWork.GetAt(j) * mColumnScale.GetAt(j));
+		}
+
+		/**
+		* Solves the normal equations of the least squares problem using a Cholesky decomposition.
+		* The decomposition is only recalculated if the design matrix has changed since the last call.
+		*/
+		void SolveCholesky()
+		{
+			const int iParams = mDesign.GetNoColumns();
+
+			if(!mFactorized || !mDesign.IsEqual(mFactorizedDesign))
+			{
+				mFactorized = false;
+				mFactorizedDesign.Copy(mDesign);
+
+				ScaleDesignMatrix();
+				mNormal.NormalMatrix(mA);
+				mNormal.CholeskyDecomposition();
+
+				mFactorized = true;
+			}
+
+			// At * b
+			mSolution.SetSize(iParams);
+			int j;
+			for(j = 0; j < iParams; j++)
+				mSolution.SetAt(j, mA.GetCol(j).Mul(mB));
+
+			mNormal.CholeskyBacksubstitution(mSolution);
+
+			for(j = 0; j < iParams; j++)
+				mSolution.SetAt(j, mSolution.GetAt(j) * mColumnScale.GetAt(j));
+		}
+
+		/**
+		* Solves the normal equations of the least squares problem using Gauss-Jordan elimination or LU decomposition.
+		* After this mA contains the inverse of the normal matrix (Gauss-Jordan) or its LU decomposition.
+		*/
+		void SolveNormalEquations()
+		{
+			mFactorized = false;
+			mA.Copy(mDesign);
+
+			// build transposed A matrix
+			// At
+			mTranspose.Copy(mA);
+			mTranspose.Transpose();
+
+			// build the new result vector
+			// At * b
+			mTranspose.Mul(mB);
+
+			// build inverse pseudo
+			// (At*A)
+			mA.PseudoInverse();
+
+#if defined(MATHFIT_IMPROVEEQSSOLVE)
+			// to apply the iterative solution improvement, we need backups of the original
+			// result vector and EQS matrix
+			CVector vBackupB(mB);
+			CMatrix mBackupA(mA);
+#endif
+
+			// Solve linear equations
+			if(mSolveMethod == CMatrix::LUDECOMPOSITION)
+			{
+				mA.LUDecomposition();
+				mA.LUBacksubstitution(mB);
+
+#if defined(MATHFIT_IMPROVEEQSSOLVE)
+				// we want to correct the numerical errors by applying
+				// the 'iterative solution improvement' as described in Numerical Recipes.
+
+				// Use the solution to calculate once again the result vector of the EQS
+				CVector vSolutionError(mB);
+				mBackupA.Mul(vSolutionError);
+
+				// subtract the old result vector from the one calculated using the EQS result
+				// (the result should be nearly zero at all)
+				vSolutionError.Sub(vBackupB);
+
+				// solve the EQS once again but use the solution error as result vector
+				mA.LUBacksubstitution(vSolutionError);
+
+				// subtract the solution error from the original solution
+				mB.Sub(vSolutionError);
+#endif
+			}
+			else
+			{
+				mA.GaussJordanSolve(mB);
+
+#if defined(MATHFIT_IMPROVEEQSSOLVE)
+				// we want to correct the numerical errors by applying
+				// the 'iterative solution improvement' as described in Numerical Recipes.
+
+				// Use the solution to calculate once again the result vector of the EQS
+				CVector vSolutionError(mB);
+				mBackupA.Mul(vSolutionError);
+
+				// subtract the old result vector from the one calculated using the EQS result
+				// (the result should be nearly zero at all)
+				vSolutionError.Sub(vBackupB);
+
+				// solve the EQS once again but use the solution error as result vector
+				mBackupA.GaussJordanSolve(vSolutionError);
+
+				// subtract the solution error from the original solution
+				mB.Sub(vSolutionError);
+#endif
+			}
+
+			mSolution.Copy(mB);
+		}
+
+		/**
+		* The method used to solve the least squares problem.
+		*/
+		CMatrix::ESolveMethod mSolveMethod;
+		/**
+		* Contains the design matrix (A), weighted by the errors.
+		*/
+		CMatrix mDesign;
+		/**
+		* Contains the design matrix from which the current decomposition was calculated.
+		*/
+		CMatrix mFactorizedDesign;
+		/**
+		* TRUE if mA (QR) or mNormal (Cholesky) contains a valid decomposition of mFactorizedDesign.
+		*/
+		bool mFactorized;
+		/**
+		* Contains the A matrix, column scaled and QR decomposed, or the normal matrix when solving the normal equations.
 		*/
 		CMatrix mA;
 		/**
-		* Contains the column index of the A matrix after LU decomposition
+		* Contains the Cholesky decomposed normal matrix.
+		*/
+		CMatrix mNormal;
+		/**
+		* Contains the diagonal of R after the QR decomposition.
 		*/
-		CVector mAIndex;
+		CVector mRDiagonal;
+		/**
+		* Contains the scale factor of each column of the design matrix.
+		*/
+		CVector mColumnScale;
 		/**
 		* Contains the B vector
 		*/
 		CVector mB;
 		/**
+		* Contains the errors of the data points.
+		*/
+		CVector mError;
+		/**
+		* Workspace for the QR back substitution.
+		*/
+		CVector mWork;
+		/**
+		* Contains the solution of the last call to Minimize.
+		*/
+		CVector mSolution;
+		/**
 		* Contains the transposed A matrix
 		*/
 		CMatrix mTranspose;
+		/**
+		* Buffers for the covariance matrix, the parameter errors and the correlation matrix calculated in FinishMinimize.
+		*/
+		CMatrix mCovarBuffer;
+		CVector mParamError;
+		CMatrix mCorrelBuffer;
 	};
 }
 
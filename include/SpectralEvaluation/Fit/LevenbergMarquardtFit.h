@@ -215,7 +215,8 @@ namespace MathFit
 			mModel.GetValues(mFitRange, mDiff);
 
 			// now calculate the chi square and variance values
-			CVector vErr(mFitRange.GetSize());
+			CVector& vErr = mErrorBuffer;
+			vErr.SetSize(mFitRange.GetSize());
 			mModel.GetFunctionErrors(mFitRange, vErr);
 
 			// get the sum of squares weighted by the error vector
@@ -235,18 +236,20 @@ namespace MathFit
 #endif
 
 			// set the covariance matrix
-			CMatrix mCovar(iParams, iParams);
+			CMatrix& mCovar = mCovarBuffer;
 			mCovar.Copy(mAlpha);
 			mModel.SetNonlinearCovarMatrix(mCovar);
 
 			// calculate the parameter errors
-			CVector vError(iParams);
+			CVector& vError = mParamError;
+			vError.SetSize(iParams);
 			int i;
 			for(i = 0; i < iParams; i++)
 				vError.SetAt(i, (TFitData)sqrt(mCovar.GetAt(i, i)));
 
 			// calculate the correlation matrix
-			CMatrix mCorrel(iParams, iParams);
+			CMatrix& mCorrel = mCorrelBuffer;
+			mCorrel.SetSize(iParams, iParams);
 
 			int j;
 			for(i = 0; i < iParams; i++)
@@ -286,7 +289,8 @@ namespace MathFit
 
 			mDiff.SetSize(mFitRange.GetSize());
 			mModel.GetValues(mFitRange, mDiff);
-			CVector vError(mFitRange.GetSize());
+			CVector& vError = mErrorBuffer;
+			vError.SetSize(mFitRange.GetSize());
 			mModel.GetFunctionErrors(mFitRange, vError);
 
 			// 1. LOOP
@@ -360,6 +364,12 @@ namespace MathFit
 		*/
 		CMatrix mDyDa;
 		/**
+		* Buffers for the covariance matrix, the parameter errors and the correlation matrix calculated in FinishMinimize.
+		*/
+		CMatrix mCovarBuffer;
+		CVector mParamError;
+		CMatrix mCorrelBuffer;
+		/**
 		* The current lambda value.
 		*/
 		TFitData mLambda;
@@ -115,6 +115,31 @@ namespace MathFit
 	class CMatrix
 	{
 	public:
+		/**
+		* The available methods for solving linear least squares problems.
+		*
+		* @see CLeastSquareFit::SetSolveMethod
+		*/
+		enum ESolveMethod
+		{
+			/**
+			* Gauss-Jordan elimination of the normal equations, see \Ref{GaussJordanSolve}.
+			*/
+			GAUSSJORDAN = 0,
+			/**
+			* LU decomposition of the normal equations, see \Ref{LUDecomposition}.
+			*/
+			LUDECOMPOSITION = 1,
+			/**
+			* Cholesky decomposition of the normal equations, see \Ref{CholeskyDecomposition}.
+			*/
+			CHOLESKY = 2,
+			/**
+			* Householder QR decomposition of the design matrix, see \Ref{QRDecomposition}.
+			*/
+			QR = 3,
+		};
+
 		/**
 		* Creates an empty matrix object.
 		*/
@@ -849,6 +874,7 @@ namespace MathFit
 
 			CVector vTemp(mSizeY);
 
+#if defined(ROWMATRIX)
 			int i, j;
 			for(i = 0; i < mSizeY; i++)
 			{
@@ -857,6 +883,14 @@ namespace MathFit
 					fSum += GetAt(i, j) * mOperant.GetAt(j);
 				vTemp.SetAt(i, fSum);
 			}
+#else
+			// the columns are stored contiguously, accumulate the result column by column.
+			// This adds the terms in the same order as the row by row loop, hence gives the same result.
+			vTemp.Zero();
+			int j;
+			for(j = 0; j < mSizeX; j++)
+				Kernels::AddScaled(vTemp.GetSafePtr(), &GetSafePtr()[j * mLineOffset], mOperant.GetAt(j), mSizeY);
+#endif
 
 			mOperant.Attach(vTemp);
 			vTemp.Detach();
@@ -1152,111 +1186,10 @@ namespace MathFit
 		*/
 		CMatrix& GaussJordanSolve(CMatrix& mBeta)
 		{
-			const int iCols = GetNoColumns();
-			const int iRows = GetNoRows();
-
-			if(iCols != iRows)
-				throw(EXCEPTION(CMatrixNotSquareException));
-
-			if(iRows != mBeta.GetNoRows())
+			if(GetNoRows() != mBeta.GetNoRows())
 				throw(EXCEPTION(CVectorSizeMismatchException));
 
-			int* iIndexCol = new int[iCols];
-			memset(iIndexCol, 0, sizeof(int) * iCols);
-			int* iIndexRow = new int[iRows];
-			memset(iIndexRow, 0, sizeof(int) * iRows);
-			int* iPivotDone = new int[iCols];
-			memset(iPivotDone, 0, sizeof(int) * iCols);
-			int iR, iC;
-
-			for(int i = 0; i < iCols; i++)
-			{
-				// find pivot
-				iR = iC = i;
-				TFitData fMag = 0;
-				for(int j = 0; j < iRows; j++)
-				{
-					if(iPivotDone[j] != 1)
-					{
-						int k;
-						for(k = 0; k < iRows; k++)
-						{
-							if(iPivotDone[k] == 0)
-							{
-								if(fabs(GetAt(j, k)) >= fMag)
-								{
-									fMag = (TFitData)fabs(GetAt(j, k));
-									iR = j;
-									iC = k;
-								}
-							}
-							else if(iPivotDone[k] > 1)
-							{
-								// this pivot was selected more than once. Shit!!
-								delete[] iPivotDone;
-								delete[] iIndexRow;
-								delete[] iIndexCol;
-
-								throw(EXCEPTION(CMatrixSolveFailedException));
-							}
-						}
-					}
-				}
-				iPivotDone[iC]++;
-
-				// move pivot row into position
-				if(iR != iC)
-				{
-					ExchangeRows(iR, iC);
-					mBeta.ExchangeRows(iR, iC);
-				}	
-
-				// store indices
-				iIndexRow[i] = iR;
-				iIndexCol[i] = iC;
-
-				// get scaling of pivot row
-				fMag = GetAt(iC, iC);
-
-				// no pivot: error
-				if(fMag == 0)
-				{
-					// zero pivot => not a singular matrix
-					delete[] iPivotDone;
-					delete[] iIndexRow;
-					delete[] iIndexCol;
-
-					throw(EXCEPTION(CMatrixSolveFailedException));
-				}
-
-				SetAt(iC, iC, 1);
-				GetRow(iC).Div(fMag);
-				mBeta.GetRow(iC).Div(fMag);
-
-				// eliminate pivot row component from other rows
-				for(int i2 = 0; i2 < iRows; i2++)
-				{
-					if(i2 == iC)
-						continue;
-
-					// get factor to eliminate pivot column
-					TFitData fMag2 = GetAt(i2, iC);
-					SetAt(i2, iC, 0);
-					GetRow(i2).Sub(GetRow(iC), fMag2);
-					mBeta.GetRow(i2).Sub(mBeta.GetRow(iC), fMag2);
-				}
-			}
-
-			// reorder matrix
-			for (int l = iRows - 1; l >= 0; l--) {
-				if (iIndexRow[l] != iIndexCol[l]) {
-					ExchangeCols(iIndexRow[l], iIndexCol[l]);
-				}
-			}
-
-			delete[] iPivotDone;
-			delete[] iIndexRow;
-			delete[] iIndexCol;
+			GaussJordanEliminate(&mBeta, nullptr);
 
 			return mBeta;
 		}
@@ -1277,14 +1210,10 @@ namespace MathFit
 		*/
 		CVector& GaussJordanSolve(CVector& vBeta)
 		{
-			MATHFIT_ASSERT(vBeta.GetStepSize() == 1);
-
-			// attach the vector to a matrix object with just a single column
-			CMatrix mBeta; 
-			mBeta.Attach(vBeta.GetSafePtr(), vBeta.GetSize(), 1, false);
+			if(GetNoRows() != vBeta.GetSize())
+				throw(EXCEPTION(CVectorSizeMismatchException));
 
-			// die geschichte lsen lassen
-			GaussJordanSolve(mBeta);
+			GaussJordanEliminate(nullptr, &vBeta);
 
 			return vBeta;
 		}
@@ -1298,13 +1227,8 @@ namespace MathFit
 		{
 			MATHFIT_ASSERT(mSizeX == mSizeY);
 
-			CMatrix mResult;
-
-			// create idendity matrix
-			mResult.SetSize(1, mSizeY);
-
-			// solve the LES
-			GaussJordanSolve(mResult);
+			// the elimination inverts the matrix, there is no right hand side to solve for
+			GaussJordanEliminate(nullptr, nullptr);
 
 			return *this;
 		}
@@ -1384,11 +1308,15 @@ namespace MathFit
             {
                 for(int iCol = iRow; iCol < mSizeX; iCol++)
 				{
+#if defined(ROWMATRIX)
 					TFitData fSum = 0;
 					for(int k = 0; k < mSizeY; k++)
 					{
                         fSum += GetAt(k, iRow) * GetAt(k, iCol);
                     }
+#else
+					const TFitData fSum = Kernels::Dot(&GetSafePtr()[iRow * mLineOffset], &GetSafePtr()[iCol * mLineOffset], mSizeY);
+#endif
 					mNew.SetAt(iRow, iCol, fSum);
 				}
             }
@@ -1572,6 +1500,303 @@ namespace MathFit
 			return *this;
 		}
 
+		/**
+		* Calculates the normal matrix (At * A) of the given matrix and stores it in the current object.
+		* In contrast to \Ref{PseudoInverse} no memory is allocated if the current matrix already has the correct size.
+		*
+		* @param mOperand	The matrix (A) whose normal matrix is to be calculated.
+		*
+		* @return A reference to the current object.
+		*/
+		CMatrix& NormalMatrix(const CMatrix& mOperand)
+		{
+			const int iN = mOperand.GetNoColumns();
+			const int iM = mOperand.GetNoRows();
+
+			SetSize(iN, iN);
+
+			for(int iRow = 0; iRow < iN; iRow++)
+			{
+				for(int iCol = iRow; iCol < iN; iCol++)
+				{
+#if defined(ROWMATRIX)
+					TFitData fSum = 0;
+					for(int k = 0; k < iM; k++)
+						fSum += mOperand.GetAt(k, iRow) * mOperand.GetAt(k, iCol);
+#else
+					// the columns are stored contiguously, hence each element is the scalar product of two columns
+					const TFitData fSum = Kernels::Dot(&mOperand.GetSafePtr()[iRow * mOperand.mLineOffset], &mOperand.GetSafePtr()[iCol * mOperand.mLineOffset], iM);
+#endif
+					SetAt(iRow, iCol, fSum);
+					SetAt(iCol, iRow, fSum);
+				}
+			}
+
+			return *this;
+		}
+
+		/**
+		* Decomposes the symmetric and positive definite matrix into L * Lt, where L is a lower triangular matrix.
+		* The algorithm is the Cholesky decomposition from Numerical Recipes in C, p. 97.
+		* After the decomposition the lower triangle of the matrix (including the diagonal) contains L,
+		* the upper triangle is left unchanged.
+		*
+		* @return A reference to the current object.
+		*
+		* @exception CMatrixNotSquare
+		* @exception CMatrixSingular	If the matrix is not positive definite.
+		*/
+		CMatrix& CholeskyDecomposition()
+		{
+			if(GetNoColumns() != GetNoRows())
+				throw(EXCEPTION(CMatrixNotSquareException));
+
+			const int iN = GetNoColumns();
+			for(int j = 0; j < iN; j++)
+			{
+				TFitData fSum = GetAt(j, j);
+				for(int k = 0; k < j; k++)
+					fSum -= GetAt(j, k) * GetAt(j, k);
+
+				if(fSum <= 0)
+					throw(EXCEPTION(CMatrixSingularException));
+
+				const TFitData fDiag = (TFitData)sqrt(fSum);
+				SetAt(j, j, fDiag);
+
+				for(int i = j + 1; i < iN; i++)
+				{
+					fSum = GetAt(i, j);
+					for(int k = 0; k < j; k++)
+						fSum -= GetAt(i, k) * GetAt(j, k);
+					SetAt(i, j, fSum / fDiag);
+				}
+			}
+
+			return *this;
+		}
+
+		/**
+		* Solves the linear equation system using the matrix decomposed by \Ref{CholeskyDecomposition}.
+		*
+		* @param vResult	The right hand side vector, which will receive the solution.
+		*
+		* @return A reference to the solution vector.
+		*/
+		CVector& CholeskyBacksubstitution(CVector& vResult)
+		{
+			const int iN = GetNoColumns();
+			MATHFIT_ASSERT(vResult.GetSize() == iN);
+
+			// solve L * y = b
+			for(int i = 0; i < iN; i++)
+			{
+				TFitData fSum = vResult.GetAt(i);
+				for(int k = 0; k < i; k++)
+					fSum -= GetAt(i, k) * vResult.GetAt(k);
+				vResult.SetAt(i, fSum / GetAt(i, i));
+			}
+
+			// solve Lt * x = y
+			for(int i = iN - 1; i >= 0; i--)
+			{
+				TFitData fSum = vResult.GetAt(i);
+				for(int k = i + 1; k < iN; k++)
+					fSum -= GetAt(k, i) * vResult.GetAt(k);
+				vResult.SetAt(i, fSum / GetAt(i, i));
+			}
+
+			return vResult;
+		}
+
+		/**
+		* Calculates the inverse of the matrix decomposed by \Ref{CholeskyDecomposition}.
+		* The decomposed matrix is left unchanged.
+		*
+		* @param mInverse	The matrix which will receive the inverse.
+		*
+		* @return A reference to the inverse matrix.
+		*/
+		CMatrix& CholeskyInverse(CMatrix& mInverse)
+		{
+			const int iN = GetNoColumns();
+
+			mInverse.SetSize(iN, iN);
+			mInverse.Zero();
+
+			for(int j = 0; j < iN; j++)
+			{
+				mInverse.SetAt(j, j, 1);
+				CholeskyBacksubstitution(mInverse.GetCol(j));
+			}
+
+			return mInverse;
+		}
+
+		/**
+		* Decomposes the matrix into Q * R, where Q is orthogonal and R is an upper triangular matrix,
+		* using Householder reflections. The matrix must have at least as many rows as columns.
+		* After the decomposition the upper triangle of the matrix (excluding the diagonal) contains R
+		* and the lower triangle (including the diagonal) contains the Householder vectors which make up Q.
+		*
+		* Since the decomposition is done directly on the matrix, and not on the normal matrix (At * A),
+		* this is numerically more stable than solving the normal equations when used for least squares problems.
+		*
+		* @param vRDiagonal	Will receive the diagonal of R. Must have the same size as the number of columns.
+		*
+		* @return A reference to the current object.
+		*
+		* @exception CMatrixSingular	If the columns of the matrix are linearly dependent.
+		*/
+		CMatrix& QRDecomposition(CVector& vRDiagonal)
+		{
+			const int iN = GetNoColumns();
+			const int iM = GetNoRows();
+
+			if(iM < iN)
+				throw(EXCEPTION(CMatrixSizeMismatchException));
+
+			MATHFIT_ASSERT(vRDiagonal.GetSize() == iN);
+
+			for(int k = 0; k < iN; k++)
+			{
+				// the norm of the k:th column, below the diagonal
+				TFitData fNorm = 0;
+				for(int i = k; i < iM; i++)
+					fNorm = (TFitData)hypot(fNorm, GetAt(i, k));
+
+				if(fNorm == 0)
+					throw(EXCEPTION(CMatrixSingularException));
+
+				// form the k:th Householder vector
+				if(GetAt(k, k) < 0)
+					fNorm = -fNorm;
+				for(int i = k; i < iM; i++)
+					SetAt(i, k, GetAt(i, k) / fNorm);
+				SetAt(k, k, GetAt(k, k) + 1);
+
+				// apply the transformation to the remaining columns
+				for(int j = k + 1; j < iN; j++)
+				{
+					TFitData fSum = 0;
+					for(int i = k; i < iM; i++)
+						fSum += GetAt(i, k) * GetAt(i, j);
+					fSum = -fSum / GetAt(k, k);
+					for(int i = k; i < iM; i++)
+						SetAt(i, j, GetAt(i, j) + fSum * GetAt(i, k));
+				}
+
+				vRDiagonal.SetAt(k, -fNorm);
+			}
+
+			return *this;
+		}
+
+		/**
+		* Solves the linear least squares problem min|A * x - b| using the matrix decomposed by \Ref{QRDecomposition}.
+		*
+		* @param vRDiagonal	The diagonal of R, as returned by \Ref{QRDecomposition}.
+		* @param vResult	The right hand side vector (b), with the same size as the number of rows.
+		*	On return the first elements (as many as there are columns) will contain the solution.
+		*
+		* @return A reference to the result vector.
+		*/
+		CVector& QRBacksubstitution(const CVector& vRDiagonal, CVector& vResult)
+		{
+			const int iN = GetNoColumns();
+			const int iM = GetNoRows();
+			MATHFIT_ASSERT(vResult.GetSize() == iM);
+
+			// calculate Qt * b
+			for(int k = 0; k < iN; k++)
+			{
+				TFitData fSum = 0;
+				for(int i = k; i < iM; i++)
+					fSum += GetAt(i, k) * vResult.GetAt(i);
+				fSum = -fSum / GetAt(k, k);
+				for(int i = k; i < iM; i++)
+					vResult.SetAt(i, vResult.GetAt(i) + fSum * GetAt(i, k));
+			}
+
+			// solve R * x = Qt * b
+			for(int k = iN - 1; k >= 0; k--)
+			{
+				vResult.SetAt(k, vResult.GetAt(k) / vRDiagonal.GetAt(k));
+				for(int i = 0; i < k; i++)
+					vResult.SetAt(i, vResult.GetAt(i) - vResult.GetAt(k) * GetAt(i, k));
+			}
+
+			return vResult;
+		}
+
+		/**
+		* Calculates the inverse of the normal matrix, inv(At * A) = inv(R) * inv(R)t, using the matrix decomposed by \Ref{QRDecomposition}.
+		* This is the covariance matrix of the least squares problem. The decomposed matrix is left unchanged.
+		*
+		* @param vRDiagonal	The diagonal of R, as returned by \Ref{QRDecomposition}.
+		* @param mInverse	The matrix which will receive the inverse.
+		*
+		* @return A reference to the inverse matrix.
+		*/
+		CMatrix& QRInverseNormalMatrix(const CVector& vRDiagonal, CMatrix& mInverse)
+		{
+			const int iN = GetNoColumns();
+
+			mInverse.SetSize(iN, iN);
+			mInverse.Zero();
+
+			// first calculate inv(R), which is upper triangular, and store it in the upper triangle of mInverse
+			for(int j = 0; j < iN; j++)
+			{
+				mInverse.SetAt(j, j, 1 / vRDiagonal.GetAt(j));
+				for(int i = j - 1; i >= 0; i--)
+				{
+					TFitData fSum = 0;
+					for(int k = i + 1; k <= j; k++)
+						fSum += GetAt(i, k) * mInverse.GetAt(k, j);
+					mInverse.SetAt(i, j, -fSum / vRDiagonal.GetAt(i));
+				}
+			}
+
+			// then inv(R) * inv(R)t. Element (i, j) only depends on rows i and j of inv(R) from column max(i, j)
+			//	and can hence be calculated in place if done in order of increasing row and column.
+			for(int i = 0; i < iN; i++)
+			{
+				for(int j = i; j < iN; j++)
+				{
+					TFitData fSum = 0;
+					for(int k = j; k < iN; k++)
+						fSum += mInverse.GetAt(i, k) * mInverse.GetAt(j, k);
+					mInverse.SetAt(i, j, fSum);
+				}
+			}
+			for(int i = 0; i < iN; i++)
+				for(int j = 0; j < i; j++)
+					mInverse.SetAt(i, j, mInverse.GetAt(j, i));
+
+			return mInverse;
+		}
+
+		/**
+		* Checks wheter the current matrix has the same size and content as the given matrix.
+		*
+		* @param mOperand	The matrix to compare with.
+		*
+		* @return	TRUE if the matrices are equal, FALSE otherwise.
+		*/
+		bool IsEqual(const CMatrix& mOperand) const
+		{
+			if(mSizeX != mOperand.mSizeX || mSizeY != mOperand.mSizeY)
+				return false;
+
+			for(int i = 0; i < mSizeY; i++)
+				for(int j = 0; j < mSizeX; j++)
+					if(GetAt(i, j) != mOperand.GetAt(i, j))
+						return false;
+
+			return true;
+		}
+
 		float* GetFloatPtr()
 		{
 			ReleaseFloatPtr();
@@ -1664,6 +1889,138 @@ namespace MathFit
 		}
 
 	private:
+		/**
+		* The largest system for which the Gauss-Jordan elimination keeps its index buffers on the stack.
+		*/
+		enum { STACKPIVOTSIZE = 32 };
+
+		/**
+		* Performs the Gauss-Jordan elimination, see \Ref{GaussJordanSolve}.
+		* The current matrix is inverted and the right hand side, if any, receives the solution.
+		*
+		* @param pBeta			The right hand side as a matrix, or nullptr.
+		* @param pBetaVector	The right hand side as a vector, or nullptr.
+		*
+		* @exception CMatrixSolveFailed
+		* @exception CMatrixNotSquare
+		*/
+		void GaussJordanEliminate(CMatrix* pBeta, CVector* pBetaVector)
+		{
+			const int iCols = GetNoColumns();
+			const int iRows = GetNoRows();
+
+			if(iCols != iRows)
+				throw(EXCEPTION(CMatrixNotSquareException));
+
+			// small systems, such as the nonlinear parameters of a DOAS fit, use index buffers on the stack
+			int iStackBuffer[3 * STACKPIVOTSIZE];
+			int* iBuffer = (iCols <= STACKPIVOTSIZE) ? iStackBuffer : new int[3 * iCols];
+			memset(iBuffer, 0, sizeof(int) * 3 * iCols);
+			int* iIndexCol = iBuffer;
+			int* iIndexRow = iBuffer + iCols;
+			int* iPivotDone = iBuffer + 2 * iCols;
+			int iR, iC;
+
+			for(int i = 0; i < iCols; i++)
+			{
+				// find pivot
+				iR = iC = i;
+				TFitData fMag = 0;
+				for(int j = 0; j < iRows; j++)
+				{
+					if(iPivotDone[j] != 1)
+					{
+						int k;
+						for(k = 0; k < iRows; k++)
+						{
+							if(iPivotDone[k] == 0)
+							{
+								if(fabs(GetAt(j, k)) >= fMag)
+								{
+									fMag = (TFitData)fabs(GetAt(j, k));
+									iR = j;
+									iC = k;
+								}
+							}
+							else if(iPivotDone[k] > 1)
+							{
+								// this pivot was selected more than once. Shit!!
+								if(iBuffer != iStackBuffer)
+									delete[] iBuffer;
+
+								throw(EXCEPTION(CMatrixSolveFailedException));
+							}
+						}
+					}
+				}
+				iPivotDone[iC]++;
+
+				// move pivot row into position
+				if(iR != iC)
+				{
+					ExchangeRows(iR, iC);
+					if(pBeta)
+						pBeta->ExchangeRows(iR, iC);
+					else if(pBetaVector)
+					{
+						TFitData fTemp = pBetaVector->GetAt(iR);
+						pBetaVector->SetAt(iR, pBetaVector->GetAt(iC));
+						pBetaVector->SetAt(iC, fTemp);
+					}
+				}	
+
+				// store indices
+				iIndexRow[i] = iR;
+				iIndexCol[i] = iC;
+
+				// get scaling of pivot row
+				fMag = GetAt(iC, iC);
+
+				// no pivot: error
+				if(fMag == 0)
+				{
+					// zero pivot => not a singular matrix
+					if(iBuffer != iStackBuffer)
+						delete[] iBuffer;
+
+					throw(EXCEPTION(CMatrixSolveFailedException));
+				}
+
+				SetAt(iC, iC, 1);
+				GetRow(iC).Div(fMag);
+				if(pBeta)
+					pBeta->GetRow(iC).Div(fMag);
+				else if(pBetaVector)
+					pBetaVector->SetAt(iC, pBetaVector->GetAt(iC) / fMag);
+
+				// eliminate pivot row component from other rows
+				for(int i2 = 0; i2 < iRows; i2++)
+				{
+					if(i2 == iC)
+						continue;
+
+					// get factor to eliminate pivot column
+					TFitData fMag2 = GetAt(i2, iC);
+					SetAt(i2, iC, 0);
+					GetRow(i2).Sub(GetRow(iC), fMag2);
+					if(pBeta)
+						pBeta->GetRow(i2).Sub(pBeta->GetRow(iC), fMag2);
+					else if(pBetaVector)
+						pBetaVector->SetAt(i2, pBetaVector->GetAt(i2) - pBetaVector->GetAt(iC) * fMag2);
+				}
+			}
+
+			// reorder matrix
+			for (int l = iRows - 1; l >= 0; l--) {
+				if (iIndexRow[l] != iIndexCol[l]) {
+					ExchangeCols(iIndexRow[l], iIndexCol[l]);
+				}
+			}
+
+			if(iBuffer != iStackBuffer)
+				delete[] iBuffer;
+		}
+
 		/**
 		* The number of columns in the matrix.
 		*/
@@ -87,7 +87,8 @@ namespace MathFit
 			mModel.GetValues(mFitRange, mDiff);
 
 			// now calculate the chi square and variance values
-			CVector vErr(mFitRange.GetSize());
+			CVector& vErr = mErrorBuffer;
+			vErr.SetSize(mFitRange.GetSize());
 			mModel.GetFunctionErrors(mFitRange, vErr);
 
 			mChiSquare = mDiff.SquareSumErrorWeighted(vErr);
@@ -214,6 +215,10 @@ namespace MathFit
 		* Contains the fit range's support values.
 		*/
 		CVector mFitRange;
+		/**
+		* Buffer for the function errors in the fit range, kept to avoid reallocations in repeated fits.
+		*/
+		CVector mErrorBuffer;
 	};
 }
 #endif // !defined(AFX_FIT_H__F0C94500_BA3A_42EA_9B39_3BAF247BD44E__INCLUDED_)
@@ -9,6 +9,7 @@
 
 #include "ParamFunction.h"
 #include "CubicSplineFunction.h"
+#include "CubicSplineCache.h"
 
 #if _MSC_VER > 1000
 #pragma once
@@ -106,6 +107,10 @@ public:
 		if (mNormalize)
 			mAmplitudeScale = mYData.Normalize();
 
+		// the default spline only depends on the spectral data, it is therefore shared with all other references with the same data
+		if (mBasisFunction == &mBSpline)
+			return mBSpline.SetCoefficients(CCubicSplineCache::GetCoefficients(mXData, mYData), vError);
+
 		if (!mBasisFunction->SetData(mXData, mYData, vError))
 			return false;
 		return true;
@@ -168,7 +173,8 @@ public:
 		const int iXSize = vXValues.GetSize();
 
 		// it makes more sens to first modify the X values and then call the B-Spline
-		CVector vBuffer(iXSize);
+		CVector& vBuffer = mXBuffer;
+		vBuffer.SetSize(iXSize);
 
 		int i;
 		for (i = 0; i < iXSize; i++)
@@ -226,7 +232,8 @@ public:
 		const int iXSize = vXValues.GetSize();
 
 		// it makes more sens to first modify the X values and then call the B-Spline
-		CVector vBuffer(iXSize);
+		CVector& vBuffer = mXBuffer;
+		vBuffer.SetSize(iXSize);
 
 		int i;
 		for (i = 0; i < iXSize; i++)
@@ -302,7 +309,8 @@ public:
 		case 0:
 		{
 			// we want the slope for the shift parameter
-			CVector vXTemp(vXValues);
+			CVector& vXTemp = mXBuffer;
+			vXTemp.Copy(vXValues);
 
 			vXTemp.Sub(mFitRangeLow);
 			int i;
@@ -316,7 +324,8 @@ public:
 		case 1:
 		{
 			// and now for the squeeze parameters
-			CVector vXTemp(vXValues);
+			CVector& vXTemp = mXBuffer;
+			vXTemp.Copy(vXValues);
 
 			vXTemp.Sub(mFitRangeLow);
 			int i;
@@ -388,7 +397,8 @@ public:
 
 		// we only have one linear parameter: the concentration
 		// therefore we can only fill the vector with the appropriate B-Spline coefficients
-		CVector vBuffer(iXSize);
+		CVector& vBuffer = mXBuffer;
+		vBuffer.SetSize(iXSize);
 
 		// process shift and squeeze
 		int i;
@@ -413,7 +423,8 @@ public:
 		// if we have a fixed concentraction value, we only have to subtract the current function from the target vB
 		if (mLinearParams.IsParamFixed(0))
 		{
-			CVector vBuffer(iXSize);
+			CVector& vBuffer = mValueBuffer;
+			vBuffer.SetSize(iXSize);
 
 			// get the current function
 			GetValues(vXValues, vBuffer);
@@ -612,6 +623,24 @@ public:
 		return *mBasisFunction;
 	}
 
+	/**
+	 * Lets this object evaluate the spectral data of the given reference.
+	 *
+	 * The basis function and the amplitude scale of the source object are shared, not copied.
+	 * Since evaluating the basis function does not modify it, several reference objects with
+	 * their own fit parameters may use the same spectral data concurrently. The source object
+	 * must outlive this object and must not get new data while it is shared.
+	 *
+	 * @param rsfSource	The reference spectrum function whose spectral data should be used.
+	 */
+	void ShareBasisFunction(CReferenceSpectrumFunction& rsfSource)
+	{
+		SetBasisFunction(*rsfSource.mBasisFunction);
+
+		mNormalize = rsfSource.mNormalize;
+		mAmplitudeScale = rsfSource.mAmplitudeScale;
+	}
+
 private:
 	/**
 	 * Initializes the internal data structures.
@@ -653,6 +682,14 @@ private:
 	*/
 	TFitData mAmplitudeScale;
 	TFitData mFitRangeLow;
+	/**
+	* Buffer for the shifted and squeezed X values, kept to avoid reallocations in repeated fits.
+	*/
+	CVector mXBuffer;
+	/**
+	* Buffer for the function values, used when the concentration is fixed.
+	*/
+	CVector mValueBuffer;
 };
 }
 
@@ -69,7 +69,8 @@ namespace MathFit
 		{
 			mTarget.GetValues(vXValues, vYTargetVector);
 
-			CVector vTemp(vXValues.GetSize());
+			CVector& vTemp = mModelBuffer;
+			vTemp.SetSize(vXValues.GetSize());
 			mModel.GetValues(vXValues, vTemp);
 
 			vYTargetVector.Sub(vTemp);
@@ -479,6 +480,10 @@ namespace MathFit
 		* The target function.
 		*/
 		IFunction& mTarget;
+		/**
+		* Buffer for the model function values, kept to avoid reallocations in repeated fits.
+		*/
+		CVector mModelBuffer;
 	};
 }
 
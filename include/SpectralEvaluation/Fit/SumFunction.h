@@ -7,6 +7,7 @@
 #if !defined(SUMFUNCTION_H_011206)
 #define SUMFUNCTION_H_011206
 
+#include <vector>
 #include "ParamFunction.h"
 
 #if _MSC_VER > 1000
@@ -194,7 +195,8 @@ namespace MathFit
 			vYTargetVector.SetSize(iXSize);
 			vYTargetVector.Zero();
 
-			CVector vBuffer(iXSize);
+			CVector& vBuffer = mBuffer;
+			vBuffer.SetSize(iXSize);
 
 			int i;
 			for(i = 0; i < mOperandsCount; i++)
@@ -244,7 +246,8 @@ namespace MathFit
 		virtual CVector& GetSlopes(CVector& vXValues, CVector& vSlopeVector)
 		{
 			vSlopeVector.Zero();
-			CVector vBuffer(vXValues.GetSize());
+			CVector& vBuffer = mBuffer;
+			vBuffer.SetSize(vXValues.GetSize());
 
 			int i;
 			for(i = 0; i < mOperandsCount; i++)
@@ -329,7 +332,8 @@ namespace MathFit
 
 			vSlopes.Zero();
 
-			CVector vBuffer(vXValues.GetSize());
+			CVector& vBuffer = mBuffer;
+			vBuffer.SetSize(vXValues.GetSize());
 
 			int i;
 			for(i = 0; i < mOperandsCount; i++)
@@ -459,7 +463,8 @@ namespace MathFit
 
 			vBasisFunctions.Zero();
 
-			CVector vBasis(vXValues.GetSize());
+			CVector& vBasis = mBasisBuffer;
+			vBasis.SetSize(vXValues.GetSize());
 			vBasis.Zero();
 
 			// the basis function if the sum of all coefficients of the reference spectra in regard
@@ -517,8 +522,9 @@ namespace MathFit
 		{
 			const int iXSize = vXValues.GetSize();
 
-			// create buffer
-			CVector vBuffer(iXSize);
+			// get the buffer
+			CVector& vBuffer = mBuffer;
+			vBuffer.SetSize(iXSize);
 
 			// process every reference given
 			int iParamID = 0;
@@ -620,7 +626,7 @@ namespace MathFit
 				const int iSize = mOperands[i]->GetNonlinearParameter().GetSize();
 				if(iSize > 0)
 				{
-					auto temp = mCovar.SubMatrix(iOffset, iOffset, iSize, iSize);
+					CMatrix& temp = GetDiagonalBlock(mNonlinearBlocks, i, mCovar, iOffset, iSize);
 					mOperands[i]->SetNonlinearCovarMatrix(temp);
 				}
 				iOffset += iSize;
@@ -644,7 +650,7 @@ namespace MathFit
 				const int iSize = mOperands[i]->GetNonlinearParameter().GetSize();
 				if(iSize > 0)
 				{
-					auto temp = mCorrel.SubMatrix(iOffset, iOffset, iSize, iSize);
+					CMatrix& temp = GetDiagonalBlock(mNonlinearBlocks, i, mCorrel, iOffset, iSize);
 					mOperands[i]->SetNonlinearCorrelMatrix(temp);
 				}
 				iOffset += iSize;
@@ -692,7 +698,7 @@ namespace MathFit
 				const int iSize = mOperands[i]->GetLinearParameter().GetSize();
 				if(iSize > 0)
 				{
-					auto temp = mCovar.SubMatrix(iOffset, iOffset, iSize, iSize);
+					CMatrix& temp = GetDiagonalBlock(mLinearBlocks, i, mCovar, iOffset, iSize);
 					mOperands[i]->SetLinearCovarMatrix(temp);
 				}
 				iOffset += iSize;
@@ -716,7 +722,7 @@ namespace MathFit
 				const int iSize = mOperands[i]->GetLinearParameter().GetSize();
 				if(iSize > 0)
 				{
-					auto temp = mCorrel.SubMatrix(iOffset, iOffset, iSize, iSize);
+					CMatrix& temp = GetDiagonalBlock(mLinearBlocks, i, mCorrel, iOffset, iSize);
 					mOperands[i]->SetLinearCorrelMatrix(temp);
 				}
 				iOffset += iSize;
@@ -799,6 +805,37 @@ namespace MathFit
 		}
 
 	private:
+		/**
+		* Copies a diagonal block of the given matrix into the buffer of the given operand.
+		* The buffers are kept between the calls, such that repeated fits do not need to allocate any memory.
+		*
+		* @param vBuffers	The buffers, one per operand.
+		* @param iOperand	The index of the operand.
+		* @param mSource	The matrix to copy the block from.
+		* @param iOffset	The first row and column of the block.
+		* @param iSize		The number of rows and columns in the block.
+		*
+		* @return	A reference to the buffer holding the block.
+		*/
+		CMatrix& GetDiagonalBlock(std::vector<CMatrix>& vBuffers, int iOperand, CMatrix& mSource, int iOffset, int iSize)
+		{
+			if((int)vBuffers.size() < mOperandsCount)
+				vBuffers.resize(mOperandsCount);
+
+			CMatrix& mBlock = vBuffers[iOperand];
+			mBlock.SetSize(iSize, iSize);
+
+			int i;
+			for(i = 0; i < iSize; i++)
+			{
+				int j;
+				for(j = 0; j < iSize; j++)
+					mBlock.SetAt(i, j, mSource.GetAt(iOffset + i, iOffset + j));
+			}
+
+			return mBlock;
+		}
+
 		/**
 		* Creates the linear parameter vector as sum of all linear parameters of all operands.
 		*/
@@ -852,6 +889,22 @@ namespace MathFit
 		* Maximum number of operands.
 		*/
 		int mMaxOperands;
+		/**
+		* Buffer for the function values of one operand.
+		*/
+		CVector mBuffer;
+		/**
+		* Buffer for the linked basis functions.
+		*/
+		CVector mBasisBuffer;
+		/**
+		* Buffers for the blocks of the linear covariance and correlation matrices, one per operand.
+		*/
+		std::vector<CMatrix> mLinearBlocks;
+		/**
+		* Buffers for the blocks of the nonlinear covariance and correlation matrices, one per operand.
+		*/
+		std::vector<CMatrix> mNonlinearBlocks;
 	};
 }
 
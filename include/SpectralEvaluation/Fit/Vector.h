@@ -20,6 +20,7 @@
 #include <math.h>
 #include <SpectralEvaluation/Fit/FitBasic.h>
 #include <SpectralEvaluation/Fit/FitException.h>
+#include <SpectralEvaluation/Fit/VectorKernels.h>
 
 #ifdef _MSC_VER
 #pragma warning (push, 3)
@@ -209,7 +210,7 @@ namespace MathFit
 		*
 		* @return A reference to the current object.
 		*/
-		CVector& Copy(TFitData* fData, int iSize, int iStepSize = 1)
+		CVector& Copy(const TFitData* fData, int iSize, int iStepSize = 1)
 		{
 			SetSize(iSize);
 
@@ -691,6 +692,12 @@ namespace MathFit
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				Kernels::Add(mData, vOperant.mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) + vOperant.GetAt(i));
@@ -710,6 +717,12 @@ namespace MathFit
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				Kernels::AddScaled(mData, vOperant.mData, fFactor, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) + fFactor * vOperant.GetAt(i));
@@ -727,6 +740,12 @@ namespace MathFit
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				Kernels::Sub(mData, vOperant.mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) - vOperant.GetAt(i));
@@ -746,6 +765,12 @@ namespace MathFit
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				Kernels::AddScaled(mData, vOperant.mData, -fFactor, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) - fFactor * vOperant.GetAt(i));
@@ -763,6 +788,9 @@ namespace MathFit
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+				return Kernels::Dot(mData, vOperant.mData, mLength);
+
 			TFitData fResult = 0;
 
 			int i;
@@ -783,6 +811,12 @@ namespace MathFit
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				Kernels::Mul(mData, vOperant.mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) * vOperant.GetAt(i));
@@ -800,6 +834,12 @@ namespace MathFit
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				Kernels::Div(mData, vOperant.mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) / vOperant.GetAt(i));
@@ -839,6 +879,12 @@ namespace MathFit
 		*/
 		CVector& Add(TFitData fScalar)
 		{
+			if(mStepSize == 1)
+			{
+				Kernels::AddScalar(mData, fScalar, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) + fScalar);
@@ -855,6 +901,12 @@ namespace MathFit
 		*/
 		CVector& Sub(TFitData fScalar)
 		{
+			if(mStepSize == 1)
+			{
+				Kernels::AddScalar(mData, -fScalar, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) - fScalar);
@@ -871,6 +923,12 @@ namespace MathFit
 		*/
 		CVector& Mul(TFitData fScalar)
 		{
+			if(mStepSize == 1)
+			{
+				Kernels::MulScalar(mData, fScalar, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) * fScalar);
@@ -887,6 +945,12 @@ namespace MathFit
 		*/
 		CVector& Div(TFitData fScalar)
 		{
+			if(mStepSize == 1)
+			{
+				Kernels::DivScalar(mData, fScalar, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) / fScalar);
@@ -0,0 +1,96 @@
+/**
+ * VectorKernels.h
+ *
+ * Contains the low level kernels used by CVector and CMatrix for data stored contiguously in memory.
+ * The double precision kernels are implemented using SSE2 or AVX2 instructions, the instruction set
+ * is selected once at runtime depending on what the current processor supports.
+ */
+#if !defined(VECTORKERNELS_H_200101)
+#define VECTORKERNELS_H_200101
+
+namespace MathFit
+{
+	namespace Kernels
+	{
+		/**
+		* The instruction sets which the kernels can be implemented with.
+		*/
+		enum EInstructionSet
+		{
+			SCALAR = 0,
+			SSE2 = 1,
+			AVX2 = 2
+		};
+
+		/**
+		* @return The best instruction set supported by the current processor.
+		*/
+		EInstructionSet GetSupportedInstructionSet();
+
+		/**
+		* @return The instruction set currently used by the kernels.
+		*/
+		EInstructionSet GetInstructionSet();
+
+		/**
+		* Selects the instruction set used by the kernels. Instruction sets not supported by the processor are
+		* replaced by the best supported one. This is intended for testing and benchmarking and must not be called
+		* while other threads are using the kernels.
+		*
+		* @param eInstructionSet	The instruction set to use.
+		*
+		* @return The instruction set which is actually used.
+		*/
+		EInstructionSet SetInstructionSet(EInstructionSet eInstructionSet);
+
+		/** fData[i] += fOperand[i] */
+		void Add(double* fData, const double* fOperand, int iLength);
+
+		/** fData[i] -= fOperand[i] */
+		void Sub(double* fData, const double* fOperand, int iLength);
+
+		/** fData[i] += fFactor * fOperand[i] */
+		void AddScaled(double* fData, const double* fOperand, double fFactor, int iLength);
+
+		/** fData[i] *= fOperand[i] */
+		void Mul(double* fData, const double* fOperand, int iLength);
+
+		/** fData[i] /= fOperand[i] */
+		void Div(double* fData, const double* fOperand, int iLength);
+
+		/** fData[i] += fScalar */
+		void AddScalar(double* fData, double fScalar, int iLength);
+
+		/** fData[i] *= fScalar */
+		void MulScalar(double* fData, double fScalar, int iLength);
+
+		/** fData[i] /= fScalar */
+		void DivScalar(double* fData, double fScalar, int iLength);
+
+		/**
+		* Calculates the scalar product of the two arrays.
+		* Notice that the summation order differs from a plain loop, the result may therefore differ in the last digits.
+		*/
+		double Dot(const double* fFirst, const double* fSecond, int iLength);
+
+		/**
+		* Evaluates a polynomial at each of the given points using Horner's scheme:
+		* fResult[i] = fCoefficients[0] + fCoefficients[1] * fX[i] + ... + fCoefficients[iNumberOfCoefficients - 1] * fX[i]^(iNumberOfCoefficients - 1)
+		* The operations are made in the same order for all instruction sets, hence the result is exactly the same as a scalar evaluation.
+		*/
+		void PolynomialValues(double* fResult, const double* fX, int iLength, const double* fCoefficients, int iNumberOfCoefficients);
+
+		// Single precision versions, used if MATHFIT_FITDATAFLOAT is defined. These are not vectorized.
+		inline void Add(float* fData, const float* fOperand, int iLength) { for(int i = 0; i < iLength; i++) fData[i] += fOperand[i]; }
+		inline void Sub(float* fData, const float* fOperand, int iLength) { for(int i = 0; i < iLength; i++) fData[i] -= fOperand[i]; }
+		inline void AddScaled(float* fData, const float* fOperand, float fFactor, int iLength) { for(int i = 0; i < iLength; i++) fData[i] += fFactor * fOperand[i]; }
+		inline void Mul(float* fData, const float* fOperand, int iLength) { for(int i = 0; i < iLength; i++) fData[i] *= fOperand[i]; }
+		inline void Div(float* fData, const float* fOperand, int iLength) { for(int i = 0; i < iLength; i++) fData[i] /= fOperand[i]; }
+		inline void AddScalar(float* fData, float fScalar, int iLength) { for(int i = 0; i < iLength; i++) fData[i] += fScalar; }
+		inline void MulScalar(float* fData, float fScalar, int iLength) { for(int i = 0; i < iLength; i++) fData[i] *= fScalar; }
+		inline void DivScalar(float* fData, float fScalar, int iLength) { for(int i = 0; i < iLength; i++) fData[i] /= fScalar; }
+		inline float Dot(const float* fFirst, const float* fSecond, int iLength) { float fSum = 0; for(int i = 0; i < iLength; i++) fSum += fFirst[i] * fSecond[i]; return fSum; }
+	}
+}
+
+#endif
@@ -7,6 +7,7 @@
 namespace novac
 {
 class BasicScanEvaluationResult;
+struct CachedScanResult;
 
 /** The class CPlumeInScanProperty is used to describe
     how a plume is seen by a scan. This incorporates properties
@@ -80,6 +81,9 @@ bool FindPlume(const std::vector<double>& scanAngles, const std::vector<double>&
     @param message - Will be filled with the reason the plume wasn't found, if it wasn't.. */
 bool FindPlume(const BasicScanEvaluationResult& evaluatedScan, int specieIdx, double plumeOffset, CPlumeInScanProperty& plumeProperties, std::string* message = nullptr);
 
+/** Finds the plume in the supplied scan, as read from an EvaluationLogCache. See FindPlume above. */
+bool FindPlume(const CachedScanResult& evaluatedScan, int specieIdx, double plumeOffset, CPlumeInScanProperty& plumeProperties, std::string* message = nullptr);
+
 /** Tries to calculate the completeness of the given scan.
     This will internally call FindPlume to verify the location of the plume and sets the associated fields in plume
     The completeness is 1.0 if the entire plume can be seen and 0.0 if the plume cannot be seen at all.
@@ -127,4 +131,7 @@ double CalculatePlumeOffset(const std::vector<double>& columns, const std::vecto
     This value is filled into the provided CPlumeInScanProperty and returned. */
 double CalculatePlumeOffset(const BasicScanEvaluationResult& evaluatedScan, int specieIdx, CPlumeInScanProperty& plumeProperties);
 
+/** Calculates the 'offset' of the scan, as read from an EvaluationLogCache, and fills it into the provided CPlumeInScanProperty. */
+double CalculatePlumeOffset(const CachedScanResult& evaluatedScan, int specieIdx, CPlumeInScanProperty& plumeProperties);
+
 }
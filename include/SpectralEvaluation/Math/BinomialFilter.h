@@ -0,0 +1,86 @@
+#pragma once
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace novac
+{
+class RealFftPlan;
+
+/** BinomialFilter performs the same binomial low- and high-pass filtering as CBasicMath::LowPassBinomial
+    and CBasicMath::HighPassBinomial, i.e. 'iterations' passes of the three point smoothing [1/4, 1/2, 1/4]
+    where the first and last values are repeated outside of the data, but in one single step.
+    Repeating the three point smoothing N times is the same as convolving the data, mirrored around its
+    edges, with the binomial kernel C(2N, N + k) / 4^N. This convolution is made using FFT, hence the time
+    taken hardly depends on the number of iterations. The kernel is truncated where its values are
+    negligible (below 1e-20 of the central value).
+    The filter is set up for one length and one number of iterations, create it once and reuse it
+    when filtering many spectra. A BinomialFilter can be used by one thread at a time, except for the
+    batched methods which filter the spectra in parallel. */
+class BinomialFilter
+{
+public:
+    /** Sets up the filter for data of the given length, smoothed with the given number of iterations. */
+    BinomialFilter(size_t length, int iterations);
+    ~BinomialFilter();
+
+    BinomialFilter(const BinomialFilter&) = delete;
+    BinomialFilter& operator=(const BinomialFilter&) = delete;
+
+    /** @return the length of the data this filter was set up for. */
+    size_t Length() const { return m_length; }
+
+    /** @return the number of iterations of the three point smoothing this filter corresponds to. */
+    int Iterations() const { return m_iterations; }
+
+    /** Low pass filters the data in place. Equivalent to CBasicMath::LowPassBinomial(data, Length(), Iterations()).
+        @param data The data to filter, must have Length() values. */
+    void LowPass(double* data);
+
+    /** High pass filters the data in place by dividing it with its low pass filtered version, where the
+        low pass filtered data is zero the result is zero. Equivalent to CBasicMath::HighPassBinomial(data, Length(), Iterations()).
+        @param data The data to filter, must have Length() values. */
+    void HighPass(double* data);
+
+    /** Low pass filters all the provided spectra in place, in parallel. Each spectrum must have Length() values. */
+    void LowPass(const std::vector<double*>& spectra);
+
+    /** High pass filters all the provided spectra in place, in parallel. Each spectrum must have Length() values. */
+    void HighPass(const std::vector<double*>& spectra);
+
+private:
+    /** The fft plan and buffers needed to filter one spectrum. */
+    struct Workspace
+    {
+        std::unique_ptr<RealFftPlan> plan;
+        std::vector<double> extendedData;
+        std::vector<std::complex<double>> spectrum;
+    };
+
+    const size_t m_length;
+
+    const int m_iterations;
+
+    /** The number of values of the kernel on each side of the central value, the kernel has 2 * m_radius + 1 values. */
+    size_t m_radius = 0;
+
+    /** The length of the fft, a power of two which fits the data extended by m_radius values on each side. */
+    size_t m_fftLength = 0;
+
+    /** The Fourier transform of the kernel, scaled such that Inverse(Forward(data) * m_kernelSpectrum) is the convolution. */
+    std::vector<double> m_kernelSpectrum;
+
+    /** The workspace used by LowPass and HighPass of a single spectrum. */
+    std::unique_ptr<Workspace> m_workspace;
+
+    void SetupWorkspace(Workspace& workspace) const;
+
+    /** Calculates the low pass filtered version of 'data' in the workspace.
+        @return a pointer to the Length() filtered values, these are kept in the workspace. */
+    const double* CalculateLowPass(Workspace& workspace, const double* data) const;
+
+    void HighPass(Workspace& workspace, double* data) const;
+};
+
+}
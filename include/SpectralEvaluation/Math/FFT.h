@@ -42,5 +42,46 @@ void Fft(const std::vector<std::complex<double>>& input, std::vector<std::comple
     The length of the input MUST be an even number. */
 void Fft_Real(const std::vector<double>& input, std::vector<std::complex<double>>& result, bool forward = true, bool outputAllValues = true);
 
+/** RealFftPlan is a reusable setup for calculating the Fourier transform of real valued sequences of one fixed length.
+    Setting up the transform (the twiddle factors and the factorization of the length) is costly compared to the
+    transform itself, hence create the plan once and reuse it when many sequences of the same length are to be transformed.
+    The transforms read from and write to buffers owned by the caller and does not allocate any memory.
+    A plan can be used by one thread at a time. */
+class RealFftPlan
+{
+public:
+    /** Creates a plan for sequences of the given length. The length MUST be an even number. */
+    explicit RealFftPlan(size_t length);
+    ~RealFftPlan();
+
+    RealFftPlan(const RealFftPlan&) = delete;
+    RealFftPlan& operator=(const RealFftPlan&) = delete;
+
+    /** @return The length of the real valued sequences this plan was created for. */
+    size_t Length() const { return m_length; }
+
+    /** @return The number of complex values in the half spectrum of a real valued sequence, Length() / 2 + 1. */
+    size_t SpectrumLength() const { return m_length / 2 + 1; }
+
+    /** Calculates the forward Fourier transform of the real valued sequence 'input'.
+        @param input The real valued sequence, must have Length() values.
+        @param spectrum Will be filled with the first half of the spectrum, must have room for SpectrumLength() values.
+            The second half of the spectrum is the complex conjugate of the first half and is not calculated. */
+    void Forward(const double* input, std::complex<double>* spectrum) const;
+
+    /** Calculates the inverse Fourier transform of a half spectrum, as produced by Forward.
+        @param spectrum The first half of the spectrum, must have SpectrumLength() values.
+        @param output Will be filled with the real valued sequence, must have room for Length() values.
+        As with Fft, the result is not normalized and hence Inverse(Forward(x)) equals x * Length(). */
+    void Inverse(const std::complex<double>* spectrum, double* output) const;
+
+private:
+    size_t m_length = 0;
+
+    // The kiss fft configurations, kept opaque to not expose kiss fft to the users of this header.
+    void* m_forwardConfiguration = nullptr;
+    void* m_inverseConfiguration = nullptr;
+};
+
 
 }
\ No newline at end of file
@@ -47,6 +47,10 @@ namespace novac
     /** Calculates the value of the provided polynomial at the given point. */
     double PolynomialValueAt(const std::vector<double>& coefficients, double x);
 
+    /** Calculates the value of the provided polynomial at each of the given points, i.e. result[ii] = PolynomialValueAt(coefficients, x[ii]).
+        All the points are evaluated in one vectorized pass, giving exactly the same values as PolynomialValueAt. */
+    void PolynomialValuesAt(const std::vector<double>& coefficients, const std::vector<double>& x, std::vector<double>& result);
+
     /** Finds the roots (zero crossings) of the provided polynomial. The result is returned in the second parameter.
     *   The number of roots equals the order of the polynomial minus one.
     *   This calculation only supports polynomials of order 0, 1, 2 or 3.
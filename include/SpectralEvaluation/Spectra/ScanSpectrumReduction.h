@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <SpectralEvaluation/Log.h>
+
+// This file contains functions for combining (summing) many spectra from one scan into one spectrum.
+namespace novac
+{
+class CSpectrum;
+class IScanSpectrumSource;
+
+/** Selects which spectra in a scan should be included when summing the spectra using SumGoodSpectra. */
+struct GoodSpectrumCriteria
+{
+    /** The pixel range in which the spectra are checked for saturation.
+        This uses the same convention as CSpectrum::MaxValue(fromPixel, toPixel). */
+    long fromPixel = 0;
+    long toPixel = 0;
+
+    /** The maximum intensity of one single readout of the spectrometer. A spectrum whose maximum intensity in the pixel range
+        [fromPixel, toPixel] is equal to, or larger than, this value times the number of co-added readouts is saturated.
+        Set this to zero or negative to include saturated spectra as well. */
+    double maximumIntensityForSingleReadout = 0.0;
+
+    /** Set to true to exclude the dark spectra (as determined by CSpectrum::IsDark). */
+    bool excludeDarkSpectra = true;
+};
+
+/** @return true if the provided spectrum fulfills the provided criteria. */
+bool IsGoodSpectrum(const CSpectrum& spectrum, const GoodSpectrumCriteria& criteria);
+
+/** Sums all the spectra which fulfills the provided criteria, in one pass over the spectra.
+    The spectra are checked and summed in parallel, each thread adds its share of the spectra into its
+    own buffer which are finally added together (the order of the additions hence differs from adding the spectra one by one).
+    Spectra with a different length than the first good spectrum are ignored.
+    @param result Will on return be set to the sum of the good spectra. The meta data of the result is taken from the first good spectrum,
+        with the number of spectra, start and stop time combined in the same way as CSpectrum::Add.
+        The result is cleared if there are no good spectra.
+    @return the number of spectra which were included in the sum. */
+int SumGoodSpectra(const std::vector<CSpectrum>& spectra, const GoodSpectrumCriteria& criteria, CSpectrum& result);
+
+/** Sums the sky spectrum and the measured spectra of the provided scan which fulfills the provided criteria.
+    The sky, dark, offset and dark-current spectra at the beginning of the scan are not counted as measured spectra,
+    these are skipped in the same way as by CScanFileHandler::ResetCounter.
+    The spectra are read from the scan one by one and then checked and summed in parallel using SumGoodSpectra.
+    @return the number of spectra which were included in the sum. */
+int SumGoodSpectra(novac::LogContext context, IScanSpectrumSource& scan, const GoodSpectrumCriteria& criteria, CSpectrum& result);
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <vector>
 
 #ifndef M_PI
 #define M_PI 3.141592
@@ -285,4 +286,66 @@ namespace Doasis
         static novac::CSpectrum CalcRamanSpectrum(const novac::CSpectrum& specOrig, double fTemp, int iJMax, double fMixing, double fSZA);
 
     };
+
+    /// <summary>
+    /// Calculates Raman and Ring spectra for many spectra sharing the same wavelength calibration.
+    /// </summary>
+    /// <remarks>
+    /// The Raman spectrum calculated by Scattering::CalcRamanSpectrum is linear in the intensity of the spectrum,
+    /// the scattered wavelengths, the pixels they fall on and the scattering cross sections only depend on the
+    /// wavelength calibration, temperature, JMax and mixing ratio. These are calculated once here and stored
+    /// as a banded matrix, where each pixel of the Raman spectrum is the scalar product of one row of the matrix
+    /// with the neighbouring pixels of the spectrum. The SZA only scales the whole Raman spectrum and is hence
+    /// applied when the spectrum is calculated. The results equals Scattering::CalcRamanSpectrum and
+    /// Scattering::CalcRingSpectrum except for differences in the last digits due to the order of the summation.
+    /// </remarks>
+    class RingSpectrumCalculator
+    {
+    public:
+        /// <param name="vWavelength">The wavelength grid, must be strictly increasing.</param>
+        /// <param name="fTemp">The temperature</param>
+        /// <param name="iJMax">The JMAX parameter</param>
+        /// <param name="fMixing">The mixing ratio</param>
+        RingSpectrumCalculator(const std::vector<double>& vWavelength, double fTemp, int iJMax, double fMixing);
+
+        /// <returns>True if this calculator was set up with exactly the given wavelength grid and parameters.</returns>
+        bool IsSetupFor(const std::vector<double>& vWavelength, double fTemp, int iJMax, double fMixing) const;
+
+        /// <returns>The number of pixels of the spectra this calculator handles.</returns>
+        size_t Length() const { return m_wavelength.size(); }
+
+        /// <summary>
+        /// Calculates the Raman spectrum of the given spectrum, both arrays must have Length() values.
+        /// </summary>
+        /// <param name="fSZA">The SZA</param>
+        void CalcRamanSpectrum(const double* fOrigSpec, double* fRamanSpec, double fSZA) const;
+
+        /// <summary>
+        /// Calculates the Ring spectrum of the given spectrum, both arrays must have Length() values.
+        /// This is the Raman spectrum of the wavelength normalized spectrum divided by the wavelength normalized spectrum.
+        /// This uses an internal buffer and can hence only be called by one thread at a time.
+        /// </summary>
+        /// <param name="fSZA">The SZA</param>
+        void CalcRingSpectrum(const double* fOrigSpec, double* fRingSpec, double fSZA);
+
+    private:
+        std::vector<double> m_wavelength;
+        double m_temperature;
+        int m_jMax;
+        double m_mixing;
+
+        /// <summary>
+        /// Row 'i' of the matrix holds the weights of the pixels m_firstColumn[i], m_firstColumn[i] + 1, ...
+        /// of the spectrum and is stored in m_weights starting at m_rowStart[i] and ending at m_rowStart[i + 1].
+        /// The weights do not include the SZA dependent ratio of the phase functions.
+        /// </summary>
+        std::vector<int> m_firstColumn;
+        std::vector<size_t> m_rowStart;
+        std::vector<double> m_weights;
+
+        /// <summary>
+        /// Buffer for the wavelength normalized spectrum used by CalcRingSpectrum.
+        /// </summary>
+        std::vector<double> m_energy;
+    };
 }
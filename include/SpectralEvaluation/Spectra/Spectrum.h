@@ -1,12 +1,14 @@
 #pragma once
 
-// the maximum length of any single spectrum
+// the length of the storage of a default constructed spectrum.
+// Longer spectra are supported but must be sized using CSpectrum::Resize.
 #define MAX_SPECTRUM_LENGTH 4096L
 
 // the maximum number of channels that the program can handle
 #define MAX_CHANNEL_NUM 8
 
 #include <SpectralEvaluation/Spectra/SpectrumInfo.h>
+#include <climits>
 #include <vector>
 
 namespace novac
@@ -18,12 +20,17 @@ class CCrossSectionData;
 <b>CSpectrum</b> is an implementation of a spectrum.
   The class contains the spectral data and a CSpectrumInfo object that contains
   all auxilliary data about the spectrum.
+  The spectral data is stored in a buffer from the SpectrumDataPool which is sized after the
+  length of the spectrum, copies only allocate room for the m_length values of the copied spectrum
+  and moving a spectrum moves the buffer.
 */
 class CSpectrum
 {
 public:
     CSpectrum();
 
+    ~CSpectrum();
+
     /** Copies the contents of the spectral data into this new spectrum.
         This will leave the m_info at default values and m_wavelength empty */
     CSpectrum(const std::vector<double>& spectralData);
@@ -48,7 +55,7 @@ public:
     CSpectrum(const CSpectrum& other);
     CSpectrum& operator=(const CSpectrum& other);
 
-    // Move operators
+    // Move operators. This leaves 'other' as an empty spectrum, which still has room for MAX_SPECTRUM_LENGTH values.
     CSpectrum(CSpectrum&& other);
     CSpectrum& operator=(CSpectrum&& other);
 
@@ -56,9 +63,9 @@ public:
     // ------------------------ PUBLIC DATA ---------------------------------
     // ----------------------------------------------------------------------
 
-    /** The spectral data */
-    // TODO: Make this a std::vector
-    double  m_data[MAX_SPECTRUM_LENGTH];
+    /** The spectral data. This always has room for at least MAX_SPECTRUM_LENGTH values, and for
+        m_length values if the spectrum is longer than that. Use Resize to change the length of the spectrum. */
+    double* m_data = nullptr;
 
     /** The length of the spectrum */
     long    m_length;
@@ -75,22 +82,33 @@ public:
 
     bool IsWavelengthValid() const { return m_wavelength.size() == (size_t)m_length; }
 
+    /** @return the number of values which fits in m_data without reallocating. */
+    long Capacity() const { return (long)m_capacity; }
+
     // ----------------------------------------------------------------------
     // ----------------------- PUBLIC METHODS -------------------------------
     // ----------------------------------------------------------------------
 
     /** Returns the maximum value in the range [fromPixel, toPixel], inclusive. */
-    double MaxValue(long fromPixel = 0, long toPixel = MAX_SPECTRUM_LENGTH - 1) const;
+    double MaxValue(long fromPixel = 0, long toPixel = LONG_MAX) const;
 
     /** Returns the minimum value in the range [fromPixel, toPixel], inclusive. */
-    double MinValue(long fromPixel = 0, long toPixel = MAX_SPECTRUM_LENGTH - 1) const;
+    double MinValue(long fromPixel = 0, long toPixel = LONG_MAX) const;
 
     /** Returns the average value in the range [fromPixel, toPixel], inclusive */
-    double AverageValue(long fromPixel = 0, long toPixel = MAX_SPECTRUM_LENGTH - 1) const;
+    double AverageValue(long fromPixel = 0, long toPixel = LONG_MAX) const;
 
     /** Clears the supplied spectrum. This erases all data in the spectrum */
     void  Clear();
 
+    /** Changes the length of the spectrum to 'length' pixels, growing the storage if necessary.
+        The values of the first min(m_length, length) pixels are kept and any added pixels are set to zero. */
+    void Resize(long length);
+
+    /** Makes sure that m_data has room for at least 'capacity' values.
+        This does not change m_length or any of the values in m_data. */
+    void Reserve(long capacity);
+
     /** Adds the provided spectrum to the current. This spectrum will afterwards
         contain the sum of the two spectra. Both spectra must have the same length.
         @return 1 if the spectra have different length. */
@@ -211,6 +229,9 @@ public:
     bool IsDark() const;
 
 private:
+    /** The number of values which fits in m_data */
+    size_t m_capacity = 0;
+
     /** Asserts that the range [fromPixel, toPixel] (inclusive) is a valid range for this spectrum. */
     int AssertRange(long& fromPixel, long& toPixel) const;
 
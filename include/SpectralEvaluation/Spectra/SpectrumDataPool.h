@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace novac
+{
+/** SpectrumDataPool holds the buffers for the data of the spectra (CSpectrum::m_data).
+    The buffers are grouped into size classes of powers of two and each thread keeps its own
+    list of released buffers for each size class. A released buffer is handed out again on the
+    next request for the same size class on the same thread, such that creating, copying and
+    destroying spectra in a loop does not go through the general purpose heap.
+    A buffer may be released on another thread than the one which allocated it. */
+class SpectrumDataPool
+{
+public:
+    /** Retrieves a buffer with room for at least 'length' values. The contents of the buffer is undefined.
+        @param length The number of values which must fit in the buffer.
+        @param capacity Will on return be set to the number of values which fits in the returned buffer.
+        @return The buffer, or nullptr if length is zero. */
+    static double* Allocate(size_t length, size_t& capacity);
+
+    /** Returns a buffer retrieved from Allocate to the pool of the calling thread.
+        @param buffer The buffer to release, may be nullptr.
+        @param capacity The capacity of the buffer, as returned from Allocate. */
+    static void Release(double* buffer, size_t capacity);
+
+    /** @return the number of released buffers currently kept by the calling thread. */
+    static size_t CachedBufferCount();
+};
+
+}
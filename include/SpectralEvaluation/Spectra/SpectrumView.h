@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+
+namespace novac
+{
+
+/** BasicSpectrumView is a non-owning view of a contiguous range of spectral values,
+    such as the data of a CSpectrum or of a std::vector<double>.
+    The view does not copy the values, hence the viewed data must outlive the view.
+    Use SpectrumView for read-only access and MutableSpectrumView when the values are written to. */
+template<class T>
+class BasicSpectrumView
+{
+public:
+    typedef typename std::remove_const<T>::type value_type;
+
+    BasicSpectrumView() = default;
+
+    BasicSpectrumView(T* data, size_t length)
+        : m_data(data), m_length(length)
+    {
+    }
+
+    BasicSpectrumView(std::vector<value_type>& values)
+        : m_data(values.data()), m_length(values.size())
+    {
+    }
+
+    /** Only a read-only view can be created of a const vector. */
+    template<class U = T, class = typename std::enable_if<std::is_const<U>::value>::type>
+    BasicSpectrumView(const std::vector<value_type>& values)
+        : m_data(values.data()), m_length(values.size())
+    {
+    }
+
+    BasicSpectrumView(CSpectrum& spectrum)
+        : m_data(spectrum.m_data), m_length(static_cast<size_t>(spectrum.m_length))
+    {
+    }
+
+    /** Only a read-only view can be created of a const spectrum. */
+    template<class U = T, class = typename std::enable_if<std::is_const<U>::value>::type>
+    BasicSpectrumView(const CSpectrum& spectrum)
+        : m_data(spectrum.m_data), m_length(static_cast<size_t>(spectrum.m_length))
+    {
+    }
+
+    /** A MutableSpectrumView can be used wherever a SpectrumView is expected. */
+    template<class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    BasicSpectrumView(const BasicSpectrumView<U>& other)
+        : m_data(other.data()), m_length(other.size())
+    {
+    }
+
+    T* data() const { return m_data; }
+
+    size_t size() const { return m_length; }
+
+    bool empty() const { return m_length == 0; }
+
+    T* begin() const { return m_data; }
+
+    T* end() const { return m_data + m_length; }
+
+    T& operator[](size_t index) const { return m_data[index]; }
+
+    /** @return a view of the 'length' values starting at 'offset'. */
+    BasicSpectrumView SubView(size_t offset, size_t length) const
+    {
+        return BasicSpectrumView(m_data + offset, length);
+    }
+
+private:
+    T* m_data = nullptr;
+
+    size_t m_length = 0;
+};
+
+typedef BasicSpectrumView<const double> SpectrumView;
+typedef BasicSpectrumView<double> MutableSpectrumView;
+
+}
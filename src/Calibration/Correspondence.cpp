@@ -3,6 +3,8 @@
 #include <SpectralEvaluation/VectorUtils.h>
 
 #include <algorithm>
+#include <limits>
+#include <numeric>
     
 namespace novac
 {
@@ -211,6 +213,39 @@ std::vector<bool> ListInliers(const std::vector<Correspondence>& selectedValues,
     return result;
 }
 
+CorrespondencesByMeasuredKeypoint CreateCorrespondencesByMeasuredKeypoint(const std::vector<std::vector<Correspondence>>& allCorrespondencesOrderedByMeasuredKeypoint)
+{
+    CorrespondencesByMeasuredKeypoint result;
+    result.keypointOffset.push_back(0);
+
+    for (const std::vector<Correspondence>& correspondencesOfKeypoint : allCorrespondencesOrderedByMeasuredKeypoint)
+    {
+        if (correspondencesOfKeypoint.size() == 0)
+        {
+            result.hasKeypointsWithoutCorrespondences = true;
+            continue;
+        }
+
+        // These correspondeces all have the same measured value.
+        result.measuredValue.push_back(correspondencesOfKeypoint[0].measuredValue);
+
+        for (const Correspondence& corr : correspondencesOfKeypoint)
+        {
+            result.theoreticalValue.push_back(corr.theoreticalValue);
+            result.correspondence.push_back(corr);
+            result.theoreticalIdxUpperBound = std::max(result.theoreticalIdxUpperBound, corr.theoreticalIdx + 1);
+        }
+        result.keypointOffset.push_back(result.correspondence.size());
+    }
+
+    result.keypointsOrderedByMeasuredValue.resize(result.measuredValue.size());
+    std::iota(begin(result.keypointsOrderedByMeasuredValue), end(result.keypointsOrderedByMeasuredValue), size_t(0));
+    std::stable_sort(begin(result.keypointsOrderedByMeasuredValue), end(result.keypointsOrderedByMeasuredValue),
+        [&](size_t a, size_t b) { return result.measuredValue[a] < result.measuredValue[b]; });
+
+    return result;
+}
+
 size_t CountInliers(
     const std::vector<double>& polynomialCoefficients,
     const std::vector<std::vector<Correspondence>>& possibleCorrespondences,
@@ -219,54 +254,68 @@ size_t CountInliers(
     double& averageError,
     bool& isMonotonic)
 {
-    // Order the correspondences by the measured keypoint they belong to and only select one correspondence per keypoint
+    CountInliersScratch scratch;
+    return CountInliers(polynomialCoefficients, CreateCorrespondencesByMeasuredKeypoint(possibleCorrespondences), toleranceInWavelength, inlier, averageError, isMonotonic, scratch);
+}
+
+size_t CountInliers(
+    const std::vector<double>& polynomialCoefficients,
+    const CorrespondencesByMeasuredKeypoint& possibleCorrespondences,
+    double toleranceInWavelength,
+    std::vector<Correspondence>& inlier,
+    double& averageError,
+    bool& isMonotonic,
+    CountInliersScratch& scratch)
+{
+    // Only select one correspondence per measured keypoint
     averageError = 0.0;
     inlier.clear();
     inlier.reserve(100); // guess for the upper bound
-    std::vector<double> distances;
+    std::vector<double>& distances = scratch.distances;
+    distances.clear();
     distances.reserve(100); // guess for the upper bound.
-    std::vector<std::pair<double, double>> pixelToWavelengthMappings; // the mapping evaluated at the measured keypoints
-    pixelToWavelengthMappings.resize(possibleCorrespondences.size());
-
-    for (size_t measuredKeypointIdx = 0; measuredKeypointIdx < possibleCorrespondences.size(); ++measuredKeypointIdx)
+    if (scratch.inlierWithTheoreticalIdx.size() < possibleCorrespondences.theoreticalIdxUpperBound)
     {
-        if (possibleCorrespondences[measuredKeypointIdx].size() == 0)
-        {
-            continue;
-        }
+        scratch.inlierWithTheoreticalIdx.resize(possibleCorrespondences.theoreticalIdxUpperBound, -1);
+    }
 
-        // These correspondeces all have the same measured value, use that to only calculate the wavelength value once
-        const double pixelValue = possibleCorrespondences[measuredKeypointIdx][0].measuredValue;
-        const double predictedWavelength = PolynomialValueAt(polynomialCoefficients, pixelValue);
-        pixelToWavelengthMappings[measuredKeypointIdx].first = pixelValue;
-        pixelToWavelengthMappings[measuredKeypointIdx].second = predictedWavelength;
+    // Evaluate the model at all the measured keypoints at once.
+    std::vector<double>& predictedWavelengths = scratch.predictedWavelengths;
+    PolynomialValuesAt(polynomialCoefficients, possibleCorrespondences.measuredValue, predictedWavelengths);
+
+    const double* theoreticalValue = possibleCorrespondences.theoreticalValue.data();
+    for (size_t keypointIdx = 0; keypointIdx < predictedWavelengths.size(); ++keypointIdx)
+    {
+        const double predictedWavelength = predictedWavelengths[keypointIdx];
 
         // Find the best possible correspondence for this measured keypoint.
-        Correspondence bestcorrespondence;
+        size_t bestCorrespondenceIdx = 0;
         double smallestDistance = std::numeric_limits<double>::max();
-        for (const Correspondence& corr : possibleCorrespondences[measuredKeypointIdx])
+        for (size_t corrIdx = possibleCorrespondences.keypointOffset[keypointIdx]; corrIdx < possibleCorrespondences.keypointOffset[keypointIdx + 1]; ++corrIdx)
         {
             // Calculate the distance, in nm air, between the wavelength of this keypoint in the fraunhofer spectrum and the predicted wavelength of the measured keypoint
-            const double wavelength = corr.theoreticalValue;
-            const double distance = std::abs(predictedWavelength - wavelength); // in nm air
+            const double distance = std::abs(predictedWavelength - theoreticalValue[corrIdx]); // in nm air
 
             if (distance < toleranceInWavelength && distance < smallestDistance)
             {
-                bestcorrespondence = corr;
+                bestCorrespondenceIdx = corrIdx;
                 smallestDistance = distance;
             }
         }
 
         if (smallestDistance < toleranceInWavelength)
         {
+            const Correspondence& bestcorrespondence = possibleCorrespondences.correspondence[bestCorrespondenceIdx];
+
             // There are correspondences with the same theoreticalIdx in the incoming list
             //  but the selected inliers must be unique wrt both the measuredIdx and theoreticalIdx.
             //  Hence, check if we have already inserted a correspondence with this same theoreticalIdx in the result list.
-            const int idxOfDuplicateEntry = FindCorrespondenceWithTheoreticalIdx(inlier, bestcorrespondence.theoreticalIdx);
+            const int idxOfDuplicateEntry = scratch.inlierWithTheoreticalIdx[bestcorrespondence.theoreticalIdx];
 
             if (idxOfDuplicateEntry < 0)
             {
                 // unique
+                scratch.inlierWithTheoreticalIdx[bestcorrespondence.theoreticalIdx] = static_cast<int>(inlier.size());
                 inlier.push_back(bestcorrespondence);
                 distances.push_back(smallestDistance);
                 averageError += smallestDistance;
@@ -285,18 +334,26 @@ size_t CountInliers(
         }
     }
 
+    // Reset the lookup for the next call
+    for (const Correspondence& corr : inlier)
+    {
+        scratch.inlierWithTheoreticalIdx[corr.theoreticalIdx] = -1;
+    }
+
     averageError /= (double)inlier.size();
 
-    // Determine if the mapping is monotonically increasing
-    std::sort(begin(pixelToWavelengthMappings), end(pixelToWavelengthMappings), [](const std::pair<double, double>& a, const std::pair<double, double>& b) { return a.first < b.first; });
+    // Determine if the mapping is monotonically increasing.
+    //  Measured keypoints without correspondences are taken to map pixel zero to wavelength zero.
     isMonotonic = true;
-    for (size_t ii = 1; ii < pixelToWavelengthMappings.size(); ++ii)
+    double previousWavelength = possibleCorrespondences.hasKeypointsWithoutCorrespondences ? 0.0 : std::numeric_limits<double>::lowest();
+    for (size_t keypointIdx : possibleCorrespondences.keypointsOrderedByMeasuredValue)
     {
-        if (pixelToWavelengthMappings[ii].second < pixelToWavelengthMappings[ii - 1].second)
+        if (predictedWavelengths[keypointIdx] < previousWavelength)
         {
             isMonotonic = false;
             break;
         }
+        previousWavelength = predictedWavelengths[keypointIdx];
     }
 
     return inlier.size();
@@ -1,5 +1,6 @@
 #include <SpectralEvaluation/Calibration/CrossSectionSpectrumGenerator.h>
 #include <SpectralEvaluation/Calibration/ReferenceSpectrumConvolution.h>
+#include <SpectralEvaluation/Evaluation/CrossSectionCache.h>
 #include <SpectralEvaluation/Evaluation/CrossSectionData.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/Spectra/WavelengthRange.h>
@@ -34,14 +35,17 @@ std::unique_ptr<CSpectrum> CrossSectionSpectrumGenerator::GetCrossSection(
 {
     ReadCrossSection();
 
+    if (m_crossSectionConvolution == nullptr)
+    {
+        m_crossSectionConvolution = std::make_unique<ReferenceConvolutionCache>(*m_highResolutionCrossSection);
+    }
+
     // Generate a theoretical solar spectrum by convolving the high-res solar atlas with the measured slf
     std::vector<double> convolvedReferenceSpectrumData;
-    ConvolveReference(
+    m_crossSectionConvolution->Convolve(
         pixelToWavelengthMapping,
         measuredInstrumentLineShape,
-        *m_highResolutionCrossSection,
         convolvedReferenceSpectrumData,
-        WavelengthConversion::None,
         ConvolutionMethod::Fft,
         fwhmOfInstrumentLineShape,
         normalize);
@@ -64,10 +68,9 @@ void CrossSectionSpectrumGenerator::ReadCrossSection()
             throw std::invalid_argument("Missing input: a solar atlas file needs to be passed to Fraunhofer spectrum generation.");
         }
 
-        m_highResolutionCrossSection = std::make_unique<CCrossSectionData>();
-        m_highResolutionCrossSection->ReadCrossSectionFile(m_crossSectionFile);
+        m_highResolutionCrossSection = CrossSectionCache::GetInstance().Get(m_crossSectionFile);
 
-        if (m_highResolutionCrossSection->m_crossSection.size() == 0)
+        if (m_highResolutionCrossSection == nullptr)
         {
             throw std::invalid_argument("Invalid solar atlas file passed to Fraunhofer spectrum generation, file could not be read.");
         }
@@ -1,5 +1,6 @@
 #include <SpectralEvaluation/Calibration/FraunhoferSpectrumGeneration.h>
 #include <SpectralEvaluation/Calibration/ReferenceSpectrumConvolution.h>
+#include <SpectralEvaluation/Evaluation/CrossSectionCache.h>
 #include <SpectralEvaluation/Evaluation/CrossSectionData.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/Spectra/WavelengthRange.h>
@@ -7,6 +8,7 @@
 #include <chrono>
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 #undef min
 #undef max
@@ -16,6 +18,7 @@ namespace novac
 
     WavelengthRange FraunhoferSpectrumGeneration::GetFraunhoferRange(const std::vector<double>& pixelToWavelengthMapping)
     {
+        std::lock_guard<std::mutex> lock(this->guard);
         ReadSolarCrossSection();
 
         const WavelengthRange resultingRange(
@@ -29,7 +32,7 @@ namespace novac
         const std::vector<double>& pixelToWavelengthMapping,
         const CCrossSectionData& measuredInstrumentLineShape)
     {
-        return GetFraunhoferSpectrum(pixelToWavelengthMapping, measuredInstrumentLineShape, this->crossSectionsToInclude, 0.0, true);
+        return GetFraunhoferSpectrum(pixelToWavelengthMapping, measuredInstrumentLineShape, 0.0, true);
     }
 
     std::unique_ptr<CSpectrum> FraunhoferSpectrumGeneration::GetFraunhoferSpectrum(
@@ -38,62 +41,17 @@ namespace novac
         double fwhmOfInstrumentLineShape,
         bool normalize)
     {
-        return GetFraunhoferSpectrum(pixelToWavelengthMapping, measuredInstrumentLineShape, this->crossSectionsToInclude, fwhmOfInstrumentLineShape, normalize);
-    }
-
-    std::unique_ptr<CSpectrum> FraunhoferSpectrumGeneration::GetDifferentialFraunhoferSpectrum(
-        const std::vector<double>& pixelToWavelengthMapping,
-        const CCrossSectionData& measuredInstrumentLineShape,
-        double fwhmOfInstrumentLineShape)
-    {
-        return GetDifferentialFraunhoferSpectrum(pixelToWavelengthMapping, measuredInstrumentLineShape, this->crossSectionsToInclude, fwhmOfInstrumentLineShape);
-    }
-
-    std::unique_ptr<CSpectrum> FraunhoferSpectrumGeneration::GetFraunhoferSpectrum(
-        const std::vector<double>& pixelToWavelengthMapping,
-        const CCrossSectionData& measuredInstrumentLineShape,
-        std::vector<AbsorbingCrossSection>& localCrossSectionsToInclude,
-        double fwhmOfInstrumentLineShape,
-        bool normalize)
-    {
-        ReadSolarCrossSection();
-
-        // Create a local copy which we can scale as we want.
-        CCrossSectionData localSolarCrossSection{ *this->solarCrossSection };
-
-        for (auto& absorber : localCrossSectionsToInclude)
-        {
-            // Turn the molecular absorption into an absorbance spectrum and multiply with the high res solar
-            if (std::abs(absorber.totalColumn) > std::numeric_limits<double>::epsilon())
-            {
-                // Get the high res cross section
-                if (absorber.crossSectionData == nullptr)
-                {
-                    absorber.crossSectionData = std::make_unique<CCrossSectionData>();
-                    absorber.crossSectionData->ReadCrossSectionFile(absorber.path);
-                }
-
-                // Create a local copy which we can scale as we want.
-                CCrossSectionData crossSectionCopy{ *absorber.crossSectionData };
-                Mult(crossSectionCopy.m_crossSection, -absorber.totalColumn);
-                Exp(crossSectionCopy.m_crossSection);
-                std::vector<double> resampledCrossSection;
-                Resample(crossSectionCopy, localSolarCrossSection.m_waveLength, resampledCrossSection);
-                Mult(resampledCrossSection, localSolarCrossSection.m_crossSection);
-            }
-        }
+        ReferenceConvolutionCache& solarSpectrum = GetSolarSpectrumConvolution();
 
         const bool normalizeInstrumentLineShape = true;
 
         // Generate a theoretical solar spectrum by convolving the high-res solar atlas with the measured slf
         auto startTime = std::chrono::steady_clock::now();
         std::vector<double> theoreticalFraunhoferSpectrumData;
-        ConvolveReference(
+        solarSpectrum.Convolve(
             pixelToWavelengthMapping,
             measuredInstrumentLineShape,
-            localSolarCrossSection,
             theoreticalFraunhoferSpectrumData,
-            WavelengthConversion::None,
             ConvolutionMethod::Fft,
             fwhmOfInstrumentLineShape,
             normalizeInstrumentLineShape);
@@ -116,48 +74,21 @@ namespace novac
     std::unique_ptr<CSpectrum> FraunhoferSpectrumGeneration::GetDifferentialFraunhoferSpectrum(
         const std::vector<double>& pixelToWavelengthMapping,
         const CCrossSectionData& measuredInstrumentLineShape,
-        std::vector<AbsorbingCrossSection>& localCrossSectionsToInclude,
         double fwhmOfInstrumentLineShape)
     {
-        ReadSolarCrossSection();
-
-        // Create a local copy which we can scale as we want.
-        CCrossSectionData localSolarCrossSection{ *this->solarCrossSection };
-
-        for (auto& absorber : localCrossSectionsToInclude)
-        {
-            // Turn the molecular absorption into an absorbance spectrum and multiply with the high res solar
-            if (std::abs(absorber.totalColumn) > std::numeric_limits<double>::epsilon())
-            {
-                // Get the high res cross section
-                if (absorber.crossSectionData == nullptr)
-                {
-                    absorber.crossSectionData = std::make_unique<CCrossSectionData>();
-                    absorber.crossSectionData->ReadCrossSectionFile(absorber.path);
-                }
-
-                // Create a local copy which we can scale as we want.
-                CCrossSectionData crossSectionCopy{ *absorber.crossSectionData };
-                Mult(crossSectionCopy.m_crossSection, -absorber.totalColumn);
-                Exp(crossSectionCopy.m_crossSection);
-                std::vector<double> resampledCrossSection;
-                Resample(crossSectionCopy, localSolarCrossSection.m_waveLength, resampledCrossSection);
-                Mult(resampledCrossSection, localSolarCrossSection.m_crossSection);
-            }
-        }
+        ReferenceConvolutionCache& solarSpectrum = GetSolarSpectrumConvolution();
 
         const bool normalizeInstrumentLineShape = false;
 
-        // Generate a theoretical solar spectrum by convolving the high-res solar atlas with the measured slf
+        // Generate a theoretical solar spectrum by convolving the high-res solar atlas with the measured slf.
+        //  This uses the fft, since the transform of the solar spectrum is shared with GetFraunhoferSpectrum.
         auto startTime = std::chrono::steady_clock::now();
         std::vector<double> theoreticalFraunhoferSpectrumData;
-        ConvolveReference(
+        solarSpectrum.Convolve(
             pixelToWavelengthMapping,
             measuredInstrumentLineShape,
-            localSolarCrossSection,
             theoreticalFraunhoferSpectrumData,
-            WavelengthConversion::None,
-            ConvolutionMethod::Direct,
+            ConvolutionMethod::Fft,
             fwhmOfInstrumentLineShape,
             normalizeInstrumentLineShape);
 
@@ -180,6 +111,48 @@ namespace novac
         return theoreticalFraunhoferSpectrum;
     }
 
+    ReferenceConvolutionCache& FraunhoferSpectrumGeneration::GetSolarSpectrumConvolution()
+    {
+        std::lock_guard<std::mutex> lock(this->guard);
+
+        if (this->solarSpectrumConvolution == nullptr)
+        {
+            ReadSolarCrossSection();
+
+            // Create a local copy which we can scale as we want.
+            CCrossSectionData localSolarCrossSection{ *this->solarCrossSection };
+
+            for (auto& absorber : this->crossSectionsToInclude)
+            {
+                // Turn the molecular absorption into an absorbance spectrum and multiply with the high res solar
+                if (std::abs(absorber.totalColumn) > std::numeric_limits<double>::epsilon())
+                {
+                    // Get the high res cross section
+                    if (absorber.crossSectionData == nullptr)
+                    {
+                        absorber.crossSectionData = CrossSectionCache::GetInstance().Get(absorber.path);
+                        if (absorber.crossSectionData == nullptr)
+                        {
+                            throw std::invalid_argument("Invalid cross section file passed to Fraunhofer spectrum generation, file could not be read: " + absorber.path);
+                        }
+                    }
+
+                    // Create a local copy which we can scale as we want.
+                    CCrossSectionData crossSectionCopy{ *absorber.crossSectionData };
+                    Mult(crossSectionCopy.m_crossSection, -absorber.totalColumn);
+                    Exp(crossSectionCopy.m_crossSection);
+                    std::vector<double> resampledCrossSection;
+                    Resample(crossSectionCopy, localSolarCrossSection.m_waveLength, resampledCrossSection);
+                    Mult(resampledCrossSection, localSolarCrossSection.m_crossSection);
+                }
+            }
+
+            this->solarSpectrumConvolution = std::make_unique<ReferenceConvolutionCache>(localSolarCrossSection);
+        }
+
+        return *this->solarSpectrumConvolution;
+    }
+
     void FraunhoferSpectrumGeneration::ReadSolarCrossSection()
     {
         if (this->solarCrossSection == nullptr)
@@ -189,10 +162,9 @@ namespace novac
                 throw std::invalid_argument("Missing input: a solar atlas file needs to be passed to Fraunhofer spectrum generation.");
             }
 
-            this->solarCrossSection = std::make_unique<CCrossSectionData>();
-            this->solarCrossSection->ReadCrossSectionFile(this->solarAtlasFile);
+            this->solarCrossSection = CrossSectionCache::GetInstance().Get(this->solarAtlasFile);
 
-            if (this->solarCrossSection->m_crossSection.size() == 0)
+            if (this->solarCrossSection == nullptr)
             {
                 throw std::invalid_argument("Invalid solar atlas file passed to Fraunhofer spectrum generation, file could not be read.");
             }
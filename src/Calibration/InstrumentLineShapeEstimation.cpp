@@ -22,6 +22,7 @@
 #include <cmath>
 #include <sstream>
 #include <limits>
+#include <exception>
 
 namespace novac
 {
@@ -626,7 +627,59 @@ namespace novac
 
         const std::vector<double> selectedPixelToWavelengthMapping(begin(pixelToWavelengthMapping) + indexRangeToUse.from, begin(pixelToWavelengthMapping) + indexRangeToUse.to);
 
-        auto currentFraunhoferSpectrum = fraunhoferSpectrumGen.GetFraunhoferSpectrum(selectedPixelToWavelengthMapping, sampledLineShape, fwhm, false);
+        // The derivatives of the instrument line shape, used to create the pseudo-absorbers below.
+        const int numberOfParameters = 2;
+        std::vector<novac::CCrossSectionData> diffSampledLineShapes(numberOfParameters);
+        for (int parameterIdx = 0; parameterIdx < numberOfParameters; ++parameterIdx)
+        {
+            diffSampledLineShapes[parameterIdx].m_waveLength = sampledLineShape.m_waveLength;
+            diffSampledLineShapes[parameterIdx].m_crossSection = PartialDerivative(currentLineShape, sampledLineShape.m_waveLength, parameterIdx);
+        }
+
+        // The Fraunhofer spectrum, the ozone spectrum and the differential Fraunhofer spectra are independent of each other, convolve them in parallel.
+        //  Exceptions cannot propagate out of the parallel region, these are collected and the first one re-thrown afterwards.
+        std::unique_ptr<CSpectrum> currentFraunhoferSpectrum;
+        std::unique_ptr<CSpectrum> currentOzoneSpectrum;
+        std::vector<std::unique_ptr<CSpectrum>> diffFraunhoferSpectra(numberOfParameters);
+        const int numberOfConvolutions = 2 + numberOfParameters;
+        std::vector<std::exception_ptr> errors(numberOfConvolutions);
+
+#pragma omp parallel for schedule(dynamic)
+        for (int convolutionIdx = 0; convolutionIdx < numberOfConvolutions; ++convolutionIdx)
+        {
+            try
+            {
+                if (convolutionIdx == 0)
+                {
+                    currentFraunhoferSpectrum = fraunhoferSpectrumGen.GetFraunhoferSpectrum(selectedPixelToWavelengthMapping, sampledLineShape, fwhm, false);
+                }
+                else if (convolutionIdx == 1)
+                {
+                    if (ozoneSpectrumGen != nullptr)
+                    {
+                        currentOzoneSpectrum = ozoneSpectrumGen->GetCrossSection(selectedPixelToWavelengthMapping, sampledLineShape, fwhm, false);
+                    }
+                }
+                else
+                {
+                    const int parameterIdx = convolutionIdx - 2;
+                    diffFraunhoferSpectra[parameterIdx] = fraunhoferSpectrumGen.GetDifferentialFraunhoferSpectrum(selectedPixelToWavelengthMapping, diffSampledLineShapes[parameterIdx], fwhm);
+                }
+            }
+            catch (...)
+            {
+                errors[convolutionIdx] = std::current_exception();
+            }
+        }
+
+        for (const std::exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
         if (currentFraunhoferSpectrum == nullptr || currentFraunhoferSpectrum->m_length == 0)
         {
             std::stringstream message;
@@ -642,7 +695,7 @@ namespace novac
 
         // 1. Include the Fraunhofer reference as the first reference
         doasFitSetup.nRef = 1;
-        doasFitSetup.ref[0].m_data = std::make_unique<novac::CCrossSectionData>(filteredFraunhoferSpectrum);
+        doasFitSetup.ref[0].SetData(filteredFraunhoferSpectrum);
         doasFitSetup.ref[0].m_columnOption = novac::SHIFT_TYPE::SHIFT_FIX;
         doasFitSetup.ref[0].m_columnValue = -1.0;
         doasFitSetup.ref[0].m_squeezeOption = novac::SHIFT_TYPE::SHIFT_FIX;
@@ -654,7 +707,7 @@ namespace novac
         auto ringSpectrum = std::make_unique<novac::CSpectrum>(Doasis::Scattering::CalcRingSpectrum(*currentFraunhoferSpectrum));
         std::vector<double> filteredRingSpectrum{ ringSpectrum->m_data, ringSpectrum->m_data + ringSpectrum->m_length };
         math.Log(filteredRingSpectrum.data(), ringSpectrum->m_length);
-        doasFitSetup.ref[doasFitSetup.nRef].m_data = std::make_unique<novac::CCrossSectionData>(filteredRingSpectrum);
+        doasFitSetup.ref[doasFitSetup.nRef].SetData(filteredRingSpectrum);
         doasFitSetup.ref[doasFitSetup.nRef].m_columnOption = novac::SHIFT_TYPE::SHIFT_FREE;
         doasFitSetup.ref[doasFitSetup.nRef].m_squeezeOption = novac::SHIFT_TYPE::SHIFT_FIX;
         doasFitSetup.ref[doasFitSetup.nRef].m_squeezeValue = 1.0;
@@ -663,10 +716,9 @@ namespace novac
         doasFitSetup.nRef += 1;
 
         // 3. Include the Ozone spectrum as the third reference (if required)
-        if (ozoneSpectrumGen != nullptr)
+        if (currentOzoneSpectrum != nullptr)
         {
-            auto currentOzoneSpectrum = ozoneSpectrumGen->GetCrossSection(selectedPixelToWavelengthMapping, sampledLineShape, fwhm, false);
-            doasFitSetup.ref[doasFitSetup.nRef].m_data = std::make_unique<novac::CCrossSectionData>(*currentOzoneSpectrum);
+            doasFitSetup.ref[doasFitSetup.nRef].SetData(*currentOzoneSpectrum);
             doasFitSetup.ref[doasFitSetup.nRef].m_columnOption = novac::SHIFT_TYPE::SHIFT_FREE;
             doasFitSetup.ref[doasFitSetup.nRef].m_squeezeOption = novac::SHIFT_TYPE::SHIFT_FIX;
             doasFitSetup.ref[doasFitSetup.nRef].m_squeezeValue = 1.0;
@@ -677,13 +729,9 @@ namespace novac
 
         // 4. Include the pseudo-absorbers derived from the derivative of the instrument-line-shape function.
         std::vector<int> parameterIndices;
-        for (int parameterIdx = 0; parameterIdx < 2; ++parameterIdx)
+        for (int parameterIdx = 0; parameterIdx < numberOfParameters; ++parameterIdx)
         {
-            auto diffSampledLineShape = std::make_unique<novac::CCrossSectionData>();
-            diffSampledLineShape->m_waveLength = sampledLineShape.m_waveLength;
-            diffSampledLineShape->m_crossSection = PartialDerivative(currentLineShape, sampledLineShape.m_waveLength, parameterIdx);
-
-            auto diffFraunhofer = fraunhoferSpectrumGen.GetDifferentialFraunhoferSpectrum(selectedPixelToWavelengthMapping, *diffSampledLineShape, fwhm);
+            const std::unique_ptr<CSpectrum>& diffFraunhofer = diffFraunhoferSpectra[parameterIdx];
 
             auto pseudoAbsorber = std::make_unique<novac::CCrossSectionData>();
             pseudoAbsorber->m_crossSection.resize(currentFraunhoferSpectrum->m_length);
@@ -695,7 +743,7 @@ namespace novac
 
             parameterIndices.push_back(doasFitSetup.nRef); // remember the index to pick out the results from
 
-            doasFitSetup.ref[doasFitSetup.nRef].m_data = std::move(pseudoAbsorber);
+            doasFitSetup.ref[doasFitSetup.nRef].SetData(std::move(pseudoAbsorber));
             doasFitSetup.ref[doasFitSetup.nRef].m_columnOption = novac::SHIFT_TYPE::SHIFT_FREE;
             doasFitSetup.ref[doasFitSetup.nRef].m_squeezeOption = novac::SHIFT_TYPE::SHIFT_FIX;
             doasFitSetup.ref[doasFitSetup.nRef].m_squeezeValue = 1.0;
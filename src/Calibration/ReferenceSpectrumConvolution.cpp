@@ -8,8 +8,12 @@
 #include <SpectralEvaluation/Air.h>
 #include <SpectralEvaluation/Math/FFT.h>
 #include <iostream>
+#include <memory>
+#include <algorithm>
 #include <assert.h>
 #include <limits>
+#include <exception>
+#include <mutex>
 
 namespace novac
 {
@@ -91,49 +95,60 @@ void ConvolutionCore(const std::vector<double>& input, const std::vector<double>
     }
 }
 
+/* The plan and buffers used by ConvolutionCoreFft. These are kept between the calls, one set per thread,
+    such that convolving many references of the same length does not need to set up the fft or allocate any memory. */
+struct FftConvolutionWorkspace
+{
+    std::unique_ptr<RealFftPlan> plan;
+    std::vector<double> paddedData;
+    std::vector<std::complex<double>> dftOfInput;
+    std::vector<std::complex<double>> dftOfCore;
+
+    void Setup(size_t fftSize)
+    {
+        if (plan == nullptr || plan->Length() != fftSize)
+        {
+            plan.reset(new RealFftPlan(fftSize));
+        }
+        paddedData.resize(fftSize);
+        dftOfInput.resize(plan->SpectrumLength());
+        dftOfCore.resize(plan->SpectrumLength());
+    }
+};
+
 /* Performs a convolution using FFT between the input and core and stores the result in 'result'.
     The result will have length equal to (input.size() + core.size() - 1)
 */
 void ConvolutionCoreFft(const std::vector<double>& input, const std::vector<double>& core, std::vector<double>& result)
 {
     const size_t outputSize = input.size() + core.size() - 1;
-    const size_t fftSize = (outputSize % 2 == 0) ? outputSize : outputSize + 1; // the FFT_real used below only accepts vectors of even length
+    const size_t fftSize = (outputSize % 2 == 0) ? outputSize : outputSize + 1; // the real valued fft used below only accepts vectors of even length
 
     // The convolution is performed by taking the fft of both the input and the core, multiplying their (complex) outputs and taking the inverse fft.
-
-    // Do the fft of the input
-    std::vector<std::complex<double>> dftOfInput(fftSize);
+    // Since both the input and the core are real valued, only the first half of the spectra needs to be calculated.
+    static thread_local FftConvolutionWorkspace workspace;
+    workspace.Setup(fftSize);
+
+    // Do the fft of the input, padded with zeros to the correct length.
+    std::fill(workspace.paddedData.begin() + input.size(), workspace.paddedData.end(), 0.0);
+    std::copy(input.begin(), input.end(), workspace.paddedData.begin());
+    workspace.plan->Forward(workspace.paddedData.data(), workspace.dftOfInput.data());
+
+    // Do the fft of the core, padded with zeros to the correct length.
+    std::fill(workspace.paddedData.begin() + core.size(), workspace.paddedData.end(), 0.0);
+    std::copy(core.begin(), core.end(), workspace.paddedData.begin());
+    workspace.plan->Forward(workspace.paddedData.data(), workspace.dftOfCore.data());
+
+    // Multiply, remember to scale with the length of the fft (since the inverse transform doesn't do that).
+    const double scale = 1.0 / (double)fftSize;
+    for (size_t ii = 0; ii < workspace.dftOfInput.size(); ++ii)
     {
-        // Create a padded input, where the original input has been padded with zeros to the correct length.
-        std::vector<double> paddedInput(fftSize, 0.0);
-        memcpy(paddedInput.data(), input.data(), input.size() * sizeof(double));
-        novac::Fft_Real(paddedInput, dftOfInput);
+        workspace.dftOfInput[ii] *= workspace.dftOfCore[ii] * scale;
     }
 
-    // Do the fft of the core
-    std::vector<std::complex<double>> dftOfCore(fftSize);
-    {
-        // Create a padded core, where the original core has been padded with zeros to the correct length.
-        std::vector<double> paddedCore(fftSize, 0.0);
-        memcpy(paddedCore.data(), core.data(), core.size() * sizeof(double));
-        novac::Fft_Real(paddedCore, dftOfCore);
-    }
-
-    // Multiply
-    std::vector<std::complex<double>> product(fftSize);
-    for (size_t ii = 0; ii < fftSize; ++ii)
-    {
-        product[ii] = dftOfInput[ii] * dftOfCore[ii];
-    }
-
-    // Inverse transform
-    const bool forwardTransform = false;
-    std::vector<std::complex<double>> complexResult(fftSize);
-    novac::Fft(product, complexResult, forwardTransform);
-
-    // Extract the result and return, remember to scale with the length of the fft (since the Ifft above doesn't do that).
-    result = novac::Abs(complexResult);
-    Mult(result, 1.0 / (double)fftSize);
+    // Inverse transform, directly into the result.
+    result.resize(fftSize);
+    workspace.plan->Inverse(workspace.dftOfInput.data(), result.data());
 
     if (outputSize != fftSize)
     {
@@ -322,6 +337,26 @@ bool Convolve(
     return true;
 }
 
+/* Cuts down the result of the convolution of a reference on the given convolutionGrid with a core of length coreSize,
+    such that it covers the same wavelength range as the reference, and resamples it to the pixelToWavelengthMapping. */
+void ResampleConvolutionResult(
+    const std::vector<double>& intermediate,
+    size_t refSize,
+    size_t coreSize,
+    UniformGrid convolutionGrid,
+    const std::vector<double>& pixelToWavelengthMapping,
+    std::vector<double>& result)
+{
+    // Cut down the result to the same size as the output is supposed to be
+    CCrossSectionData resultSpec;
+    resultSpec.m_crossSection = std::vector<double>(begin(intermediate) + coreSize / 2, begin(intermediate) + refSize + coreSize / 2);
+
+    resultSpec.m_waveLength = std::vector<double>(resultSpec.m_crossSection.size());
+    convolutionGrid.Generate(resultSpec.m_waveLength);
+
+    Resample(resultSpec, pixelToWavelengthMapping, result);
+}
+
 // Small helper method, returns the remainder after as many
 //  factors of 2, 3 and 5 as possible have been removed.
 size_t GetNonReduciblePrime(size_t number)
@@ -341,6 +376,36 @@ size_t GetNonReduciblePrime(size_t number)
     return number;
 }
 
+/* Sets up the slf for convolving references on a uniform grid with the given resolution */
+void PrepareSlfForConvolution(const CCrossSectionData& slf, double resolution, bool normalizeSlf, std::vector<double>& result)
+{
+    // We also need to resample the slit-function to be on the same wavelength-grid as the high-res reference.
+    std::vector<double> resampledSlf;
+    Resample(slf, resolution, resampledSlf);
+
+    // To preserve the energy, we need to normalize the slit-function to the range [0->1]
+    if (normalizeSlf)
+    {
+        NormalizeArea(resampledSlf, result);
+        assert(result.size() == resampledSlf.size());
+    }
+    else
+    {
+        result = resampledSlf;
+    }
+}
+
+/* Returns the smallest even length, not smaller than minimumLength, which only contains the prime factors 2, 3 and 5. */
+size_t GetFftLength(size_t minimumLength)
+{
+    size_t length = (minimumLength % 2 == 0) ? minimumLength : minimumLength + 1;
+    while (GetNonReduciblePrime(length) != 1)
+    {
+        length += 2;
+    }
+    return length;
+}
+
 void ConvolveReference(
     const std::vector<double>& pixelToWavelengthMapping,
     const CCrossSectionData& slf,
@@ -428,45 +493,351 @@ void ConvolveReference(
     Resample(convertedHighResReference, convolutionGrid.Resolution(), uniformHighResReference);
     assert(uniformHighResReference.size() == convolutionGrid.length);
 
-    // We also need to resample the slit-function to be on the same wavelength-grid as the high-res reference.
-    std::vector<double> resampledSlf;
-    Resample(slf, convolutionGrid.Resolution(), resampledSlf);
+    std::vector<double> normalizedSlf;
+    PrepareSlfForConvolution(slf, convolutionGrid.Resolution(), normalizeSlf, normalizedSlf);
+
+    const size_t refSize = uniformHighResReference.size();
+    const size_t coreSize = normalizedSlf.size();
+
+    // Do the actual convolution
+    std::vector<double> intermediate;
+    if (method == ConvolutionMethod::Direct)
+    {
+        ConvolutionCore(uniformHighResReference, normalizedSlf, intermediate);
+    }
+    else if (method == ConvolutionMethod::Fft)
+    {
+        ConvolutionCoreFft(uniformHighResReference, normalizedSlf, intermediate);
+    }
+
+    ResampleConvolutionResult(intermediate, refSize, coreSize, convolutionGrid, pixelToWavelengthMapping, result);
+}
+
+void ConvolveReferences(
+    const std::vector<double>& pixelToWavelengthMapping,
+    const CCrossSectionData& slf,
+    const std::vector<CCrossSectionData>& highResReferences,
+    std::vector<std::vector<double>>& results,
+    WavelengthConversion conversion,
+    ConvolutionMethod method,
+    double fwhmOfInstrumentLineShape,
+    bool normalizeSlf)
+{
+    if (slf.m_waveLength.size() != slf.m_crossSection.size())
+    {
+        throw std::invalid_argument(" Error in call to 'ConvolveReferences', the SLF must have as many values as wavelength values.");
+    }
+    for (const CCrossSectionData& highResReference : highResReferences)
+    {
+        if (highResReference.m_waveLength.size() != highResReference.m_crossSection.size() || highResReference.m_waveLength.size() < 2)
+        {
+            throw std::invalid_argument(" Error in call to 'ConvolveReferences', the references must have as many values as wavelength values.");
+        }
+    }
+
+    if (fwhmOfInstrumentLineShape < std::numeric_limits<float>::epsilon())
+    {
+        fwhmOfInstrumentLineShape = GetFwhm(slf);
+    }
+    if (fwhmOfInstrumentLineShape < std::numeric_limits<float>::epsilon())
+    {
+        throw std::invalid_argument(" Error in call to 'ConvolveReferences', the estimated fwhm of the instrument line shape is zero.");
+    }
+
+    if (highResReferences.empty())
+    {
+        // Nothing to convolve, there is no resolution to set up the slf for either.
+        results.clear();
+        return;
+    }
+
+    // If desired, convert the high-res references from vacuum to air
+    const int numberOfReferences = static_cast<int>(highResReferences.size());
+    std::vector<CCrossSectionData> convertedHighResReferences(numberOfReferences);
+    for (int referenceIdx = 0; referenceIdx < numberOfReferences; ++referenceIdx)
+    {
+        Convert(highResReferences[referenceIdx], conversion, convertedHighResReferences[referenceIdx]);
+    }
+
+    // All references are convolved on uniform grids with (very nearly) one common resolution, such that the slf only needs to be set up once.
+    //  The grids are the same as ConvolveReference uses with ConvolutionMethod::Direct for the reference with the highest resolution.
+    const double minimumAllowedResolution = 0.02 * fwhmOfInstrumentLineShape; // do use at least 50 points per FWHM of the SLF
+    const double maximumAllowedResolution = 0.01 * fwhmOfInstrumentLineShape; // do not use more than 100 points per FWHM of the SLF
+    double highestResolution = std::numeric_limits<double>::max();
+    for (const CCrossSectionData& convertedHighResReference : convertedHighResReferences)
+    {
+        const double resolutionOfReference = Resolution(convertedHighResReference.m_waveLength);
+        highestResolution = std::min(highestResolution, std::max(std::min(resolutionOfReference, maximumAllowedResolution), minimumAllowedResolution));
+    }
+
+    std::vector<UniformGrid> convolutionGrids(numberOfReferences);
+    size_t longestConvolutionGrid = 0;
+    for (int referenceIdx = 0; referenceIdx < numberOfReferences; ++referenceIdx)
+    {
+        UniformGrid& convolutionGrid = convolutionGrids[referenceIdx];
+        convolutionGrid.minValue = convertedHighResReferences[referenceIdx].m_waveLength.front();
+        convolutionGrid.maxValue = convertedHighResReferences[referenceIdx].m_waveLength.back();
+        convolutionGrid.length = 2 * (size_t)((convolutionGrid.maxValue - convolutionGrid.minValue) / highestResolution);
+        longestConvolutionGrid = std::max(longestConvolutionGrid, convolutionGrid.length);
+    }
+    const double convolutionResolution = 0.5 * highestResolution;
 
-    // To preserve the energy, we need to normalize the slit-function to the range [0->1]
     std::vector<double> normalizedSlf;
-    if (normalizeSlf)
+    PrepareSlfForConvolution(slf, convolutionResolution, normalizeSlf, normalizedSlf);
+    const size_t coreSize = normalizedSlf.size();
+
+    // With the fft, all references are padded to one common length such that the transform of the slf is only calculated once.
+    size_t fftSize = 0;
+    std::vector<std::complex<double>> dftOfCore;
+    if (method == ConvolutionMethod::Fft)
+    {
+        fftSize = GetFftLength(longestConvolutionGrid + coreSize - 1);
+
+        RealFftPlan plan(fftSize);
+        std::vector<double> paddedCore(fftSize, 0.0);
+        std::copy(normalizedSlf.begin(), normalizedSlf.end(), paddedCore.begin());
+        dftOfCore.resize(plan.SpectrumLength());
+        plan.Forward(paddedCore.data(), dftOfCore.data());
+
+        // remember to scale with the length of the fft (since the inverse transform doesn't do that).
+        for (std::complex<double>& value : dftOfCore)
+        {
+            value /= (double)fftSize;
+        }
+    }
+
+    std::vector<std::vector<double>> batchResult(numberOfReferences);
+
+    // Exceptions cannot propagate out of the parallel region, these are collected and the first one re-thrown afterwards.
+    std::vector<std::exception_ptr> errors(numberOfReferences);
+
+#pragma omp parallel
+    {
+        // Each thread has its own fft plan and buffers, but all share the (read-only) transform of the slf.
+        std::unique_ptr<RealFftPlan> plan;
+        std::vector<double> paddedInput;
+        std::vector<std::complex<double>> dftOfInput;
+        if (method == ConvolutionMethod::Fft)
+        {
+            plan.reset(new RealFftPlan(fftSize));
+            paddedInput.resize(fftSize);
+            dftOfInput.resize(plan->SpectrumLength());
+        }
+        std::vector<double> uniformHighResReference;
+        std::vector<double> intermediate;
+
+#pragma omp for schedule(dynamic)
+        for (int referenceIdx = 0; referenceIdx < numberOfReferences; ++referenceIdx)
+        {
+            try
+            {
+                const UniformGrid& convolutionGrid = convolutionGrids[referenceIdx];
+                Resample(convertedHighResReferences[referenceIdx], convolutionGrid.Resolution(), uniformHighResReference);
+                const size_t refSize = uniformHighResReference.size();
+
+                if (method == ConvolutionMethod::Direct)
+                {
+                    ConvolutionCore(uniformHighResReference, normalizedSlf, intermediate);
+                }
+                else if (method == ConvolutionMethod::Fft)
+                {
+                    std::fill(paddedInput.begin() + refSize, paddedInput.end(), 0.0);
+                    std::copy(uniformHighResReference.begin(), uniformHighResReference.end(), paddedInput.begin());
+                    plan->Forward(paddedInput.data(), dftOfInput.data());
+
+                    for (size_t ii = 0; ii < dftOfInput.size(); ++ii)
+                    {
+                        dftOfInput[ii] *= dftOfCore[ii];
+                    }
+
+                    intermediate.resize(fftSize);
+                    plan->Inverse(dftOfInput.data(), intermediate.data());
+                    intermediate.resize(refSize + coreSize - 1);
+                }
+
+                ResampleConvolutionResult(intermediate, refSize, coreSize, convolutionGrid, pixelToWavelengthMapping, batchResult[referenceIdx]);
+            }
+            catch (...)
+            {
+                errors[referenceIdx] = std::current_exception();
+            }
+        }
+    }
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    results = std::move(batchResult);
+}
+
+struct ReferenceConvolutionCache::PreparedReference
+{
+    UniformGrid grid;
+
+    /** The reference resampled onto the grid. */
+    std::vector<double> uniformReference;
+
+    /** The length of the fft, zero if the transform has not been calculated. */
+    size_t fftSize = 0;
+
+    /** The transform of the uniformReference padded to fftSize, already scaled with 1/fftSize. */
+    std::vector<std::complex<double>> dftOfReference;
+};
+
+ReferenceConvolutionCache::ReferenceConvolutionCache(const CCrossSectionData& highResReference, WavelengthConversion conversion)
+{
+    if (highResReference.m_waveLength.size() != highResReference.m_crossSection.size() || highResReference.m_waveLength.size() < 2)
+    {
+        throw std::invalid_argument(" Error in call to 'ReferenceConvolutionCache', the reference must have as many values as wavelength values.");
+    }
+
+    m_reference.reset(new CCrossSectionData());
+    Convert(highResReference, conversion, *m_reference);
+}
+
+ReferenceConvolutionCache::~ReferenceConvolutionCache() = default;
+
+std::shared_ptr<const ReferenceConvolutionCache::PreparedReference> ReferenceConvolutionCache::GetPreparedReference(double fwhmOfInstrumentLineShape, double slfWidth, bool withTransform)
+{
+    std::lock_guard<std::mutex> lock(m_guard);
+
+    const double minimumAllowedResolution = 0.02 * fwhmOfInstrumentLineShape; // do use at least 50 points per FWHM of the SLF
+    const double maximumAllowedResolution = 0.01 * fwhmOfInstrumentLineShape; // do not use more than 100 points per FWHM of the SLF
+
+    // The grid set up below has twice the resolution of highestResolution, hence the current grid can be kept as long as it
+    //  has between 50 and 200 points per FWHM of the SLF.
+    const bool gridIsValid = m_prepared != nullptr &&
+        m_prepared->grid.Resolution() <= minimumAllowedResolution &&
+        m_prepared->grid.Resolution() >= 0.5 * maximumAllowedResolution;
+
+    size_t requiredFftSize = 0;
+    if (gridIsValid)
+    {
+        if (!withTransform)
+        {
+            return m_prepared;
+        }
+
+        const size_t coreSize = 1 + (size_t)(std::round(slfWidth / m_prepared->grid.Resolution()));
+        requiredFftSize = m_prepared->uniformReference.size() + coreSize - 1;
+        if (m_prepared->fftSize >= requiredFftSize)
+        {
+            return m_prepared;
+        }
+    }
+
+    std::shared_ptr<PreparedReference> newReference = std::make_shared<PreparedReference>();
+    if (gridIsValid)
     {
-        NormalizeArea(resampledSlf, normalizedSlf);
-        assert(normalizedSlf.size() == resampledSlf.size());
+        newReference->grid = m_prepared->grid;
+        newReference->uniformReference = m_prepared->uniformReference;
     }
     else
     {
-        normalizedSlf = resampledSlf;
+        // Same grid as ConvolveReference uses with ConvolutionMethod::Direct
+        const double resolutionOfReference = Resolution(m_reference->m_waveLength);
+        const double highestResolution = std::max(std::min(resolutionOfReference, maximumAllowedResolution), minimumAllowedResolution);
+
+        newReference->grid.minValue = m_reference->m_waveLength.front();
+        newReference->grid.maxValue = m_reference->m_waveLength.back();
+        newReference->grid.length = 2 * (size_t)((newReference->grid.maxValue - newReference->grid.minValue) / highestResolution);
+
+        Resample(*m_reference, newReference->grid.Resolution(), newReference->uniformReference);
+        assert(newReference->uniformReference.size() == newReference->grid.length);
+
+        ++m_numberOfPreparedGrids;
     }
 
-    const size_t refSize = uniformHighResReference.size();
+    if (withTransform)
+    {
+        // Leave room for a core of twice the length of this slf, such that the transform can be kept also if the slf becomes wider.
+        const size_t coreSize = 1 + (size_t)(std::round(slfWidth / newReference->grid.Resolution()));
+        newReference->fftSize = GetFftLength(newReference->uniformReference.size() + 2 * coreSize);
+
+        RealFftPlan plan(newReference->fftSize);
+        std::vector<double> paddedReference(newReference->fftSize, 0.0);
+        std::copy(newReference->uniformReference.begin(), newReference->uniformReference.end(), paddedReference.begin());
+        newReference->dftOfReference.resize(plan.SpectrumLength());
+        plan.Forward(paddedReference.data(), newReference->dftOfReference.data());
+
+        // remember to scale with the length of the fft (since the inverse transform doesn't do that).
+        for (std::complex<double>& value : newReference->dftOfReference)
+        {
+            value /= (double)newReference->fftSize;
+        }
+    }
+
+    m_prepared = newReference;
+    return m_prepared;
+}
+
+void ReferenceConvolutionCache::Convolve(
+    const std::vector<double>& pixelToWavelengthMapping,
+    const CCrossSectionData& slf,
+    std::vector<double>& result,
+    ConvolutionMethod method,
+    double fwhmOfInstrumentLineShape,
+    bool normalizeSlf)
+{
+    if (slf.m_waveLength.size() != slf.m_crossSection.size() || slf.m_waveLength.size() < 2)
+    {
+        throw std::invalid_argument(" Error in call to 'ReferenceConvolutionCache::Convolve', the SLF must have as many values as wavelength values.");
+    }
+
+    if (fwhmOfInstrumentLineShape < std::numeric_limits<float>::epsilon())
+    {
+        fwhmOfInstrumentLineShape = GetFwhm(slf);
+    }
+    if (fwhmOfInstrumentLineShape < std::numeric_limits<float>::epsilon())
+    {
+        throw std::invalid_argument(" Error in call to 'ReferenceConvolutionCache::Convolve', the estimated fwhm of the instrument line shape is zero.");
+    }
+
+    const std::shared_ptr<const PreparedReference> prepared = GetPreparedReference(
+        fwhmOfInstrumentLineShape,
+        slf.m_waveLength.back() - slf.m_waveLength.front(),
+        method == ConvolutionMethod::Fft);
+
+    std::vector<double> normalizedSlf;
+    PrepareSlfForConvolution(slf, prepared->grid.Resolution(), normalizeSlf, normalizedSlf);
+
+    const size_t refSize = prepared->uniformReference.size();
     const size_t coreSize = normalizedSlf.size();
 
     // Do the actual convolution
     std::vector<double> intermediate;
     if (method == ConvolutionMethod::Direct)
     {
-        ConvolutionCore(uniformHighResReference, normalizedSlf, intermediate);
+        ConvolutionCore(prepared->uniformReference, normalizedSlf, intermediate);
     }
     else if (method == ConvolutionMethod::Fft)
     {
-        ConvolutionCoreFft(uniformHighResReference, normalizedSlf, intermediate);
-    }
+        assert(prepared->fftSize >= refSize + coreSize - 1);
 
-    CCrossSectionData resultSpec;
+        // Only the transform of the slf needs to be calculated here, the transform of the reference is shared.
+        static thread_local FftConvolutionWorkspace workspace;
+        workspace.Setup(prepared->fftSize);
 
-    // Cut down the result to the same size as the output is supposed to be
-    resultSpec.m_crossSection = std::vector<double>(begin(intermediate) + coreSize / 2, begin(intermediate) + refSize + coreSize / 2);
+        std::fill(workspace.paddedData.begin() + coreSize, workspace.paddedData.end(), 0.0);
+        std::copy(normalizedSlf.begin(), normalizedSlf.end(), workspace.paddedData.begin());
+        workspace.plan->Forward(workspace.paddedData.data(), workspace.dftOfCore.data());
 
-    resultSpec.m_waveLength = std::vector<double>(resultSpec.m_crossSection.size());
-    convolutionGrid.Generate(resultSpec.m_waveLength);
+        for (size_t ii = 0; ii < workspace.dftOfInput.size(); ++ii)
+        {
+            workspace.dftOfInput[ii] = prepared->dftOfReference[ii] * workspace.dftOfCore[ii];
+        }
 
-    Resample(resultSpec, pixelToWavelengthMapping, result);
+        intermediate.resize(prepared->fftSize);
+        workspace.plan->Inverse(workspace.dftOfInput.data(), intermediate.data());
+        intermediate.resize(refSize + coreSize - 1);
+    }
+
+    ResampleConvolutionResult(intermediate, refSize, coreSize, prepared->grid, pixelToWavelengthMapping, result);
 }
 
 bool ConvolveReference_Fast(
@@ -1,11 +1,13 @@
 #include <SpectralEvaluation/Calibration/WavelengthCalibrationByRansac.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
-#include <omp.h>
 #include <memory>
 #include <random>
 #include <stdexcept>
+#include <thread>
 #include <SpectralEvaluation/Calibration/Correspondence.h>
 #include <SpectralEvaluation/Math/PolynomialFit.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
@@ -46,7 +48,8 @@ namespace novac
         correspondenceIsInlier(other.correspondenceIsInlier),
         smallestError(other.smallestError),
         largestPixelSpan(other.largestPixelSpan),
-        numberOfPossibleCorrelations(other.numberOfPossibleCorrelations)
+        numberOfPossibleCorrelations(other.numberOfPossibleCorrelations),
+        numberOfIterations(other.numberOfIterations)
     {
     }
 
@@ -59,6 +62,7 @@ namespace novac
         this->smallestError = other.smallestError;
         this->largestPixelSpan = other.largestPixelSpan;
         this->numberOfPossibleCorrelations = other.numberOfPossibleCorrelations;
+        this->numberOfIterations = other.numberOfIterations;
 
         return *this;
     }
@@ -244,21 +248,57 @@ namespace novac
     {
     }
 
-    RansacWavelengthCalibrationResult RansacWavelengthCalibrationSetup::RunRansacCalibrations(
-        const std::vector<Correspondence>& possibleCorrespondences,
-        const std::vector<std::vector<Correspondence>>& possibleCorrespondencesOrderedByMeasuredKeypoint,
-        int numberOfIterations) const
+    struct RansacWavelengthCalibrationSetup::ScratchBuffers
     {
-        std::random_device r;
-        std::mt19937 rnd{ r() };
-        PolynomialFit polyFit{ static_cast<int>(settings.modelPolynomialOrder) };
+        ScratchBuffers(size_t modelPolynomialOrder)
+            : polyFit(static_cast<int>(modelPolynomialOrder))
+        {
+        }
 
+        PolynomialFit polyFit;
+        std::vector<double> suggestionForPolynomial;
+        std::vector<Correspondence> selectedCorrespondences;
+        std::vector<Correspondence> inlierCorrespondences;
+        CountInliersScratch countInliers;
+    };
+
+    /** @return true if a model with the given properties is better than the model in the current result. */
+    static bool IsBetterModel(size_t numberOfInliers, double inlierPixelSpan, double meanErrorOfModel, const RansacWavelengthCalibrationResult& current)
+    {
+        return (numberOfInliers > current.highestNumberOfInliers) ||
+            (numberOfInliers == current.highestNumberOfInliers && inlierPixelSpan > current.largestPixelSpan) ||
+            (numberOfInliers == current.highestNumberOfInliers && std::abs(inlierPixelSpan - current.largestPixelSpan) < 0.1 && meanErrorOfModel < current.smallestError);
+    }
+
+    /** The standard ransac bound on the number of iterations required to, with the given confidence, have drawn at least
+        one sample consisting of only inliers, when the given fraction of the possible correspondences are inliers. */
+    static double RequiredNumberOfIterations(double inlierRatio, size_t sampleSize, double confidence)
+    {
+        if (confidence >= 1.0 || inlierRatio <= 0.0)
+        {
+            return std::numeric_limits<double>::max();
+        }
+
+        const double probabilityOfOnlyInliers = std::pow(std::min(inlierRatio, 1.0), (double)sampleSize);
+        if (probabilityOfOnlyInliers >= 1.0)
+        {
+            return 1.0;
+        }
+
+        return std::log(1.0 - confidence) / std::log1p(-probabilityOfOnlyInliers);
+    }
+
+    RansacWavelengthCalibrationResult RansacWavelengthCalibrationSetup::EvaluateInitialModel(
+        const std::vector<Correspondence>& possibleCorrespondences,
+        const CorrespondencesByMeasuredKeypoint& possibleCorrespondencesOrderedByMeasuredKeypoint) const
+    {
         RansacWavelengthCalibrationResult result(settings.modelPolynomialOrder);
         result.numberOfPossibleCorrelations = possibleCorrespondences.size();
         if (settings.initialModelCoefficients.size() == settings.modelPolynomialOrder + 1)
         {
             // We have an initial guess for the pixel-to-wavelength mapping. Measure how good it is.
             std::vector<Correspondence> inlierCorrespondences;
+            CountInliersScratch countInliersScratch;
             bool isMonotonicallyIncreasing = true;
             result.highestNumberOfInliers = CountInliers(
                                                 settings.initialModelCoefficients,
@@ -266,7 +306,7 @@ namespace novac
                                                 settings.inlierLimitInWavelength,
                                                 inlierCorrespondences,
                                                 result.smallestError,
-                                                isMonotonicallyIncreasing);
+                                                isMonotonicallyIncreasing, countInliersScratch);
 
             if (!isMonotonicallyIncreasing)
             {
@@ -280,19 +320,31 @@ namespace novac
             result.smallestError = std::numeric_limits<double>::max();
         }
 
-        // variables in the loop, such that we don't have to recreate them every time
+        return result;
+    }
+
+    RansacWavelengthCalibrationResult RansacWavelengthCalibrationSetup::RunRansacCalibrations(
+        const std::vector<Correspondence>& possibleCorrespondences,
+        const CorrespondencesByMeasuredKeypoint& possibleCorrespondencesOrderedByMeasuredKeypoint,
+        const RansacWavelengthCalibrationResult& initialResult,
+        std::mt19937& rnd,
+        int numberOfIterations,
+        ScratchBuffers& scratch) const
+    {
+        RansacWavelengthCalibrationResult result = initialResult;
+        result.numberOfIterations = static_cast<size_t>(numberOfIterations);
+
         const size_t ransacSampleSize = (settings.sampleSize > 0) ? settings.sampleSize : (settings.modelPolynomialOrder + 1);
-        std::vector<double> selectedPixelValues(ransacSampleSize);
-        std::vector<double> selectedWavelengths(ransacSampleSize);
-        std::vector<double> suggestionForPolynomial;
-        std::vector<Correspondence> selectedCorrespondences;
+        std::vector<double>& suggestionForPolynomial = scratch.suggestionForPolynomial;
+        std::vector<Correspondence>& selectedCorrespondences = scratch.selectedCorrespondences;
+        std::vector<Correspondence>& inlierCorrespondences = scratch.inlierCorrespondences;
 
         for (int iteration = 0; iteration < numberOfIterations; ++iteration)
         {
             SelectMaybeInliers(ransacSampleSize, possibleCorrespondences, rnd, selectedCorrespondences);
 
             // Create a new (better?) model from these selected correspondences
-            if (!FitPolynomial(polyFit, selectedCorrespondences, suggestionForPolynomial))
+            if (!FitPolynomial(scratch.polyFit, selectedCorrespondences, suggestionForPolynomial))
             {
                 std::cout << "Polynomial fit failed" << std::endl;
                 continue;
@@ -305,30 +357,27 @@ namespace novac
 
             // Evaluate if this suggested polynomial fits better than the guess we already have by counting how many of the 
             //  possible correspondences fits with the provided model.
-            std::vector<Correspondence> inlierCorrespondences;
             double meanErrorOfModel = 0.0;
             bool isMonotonicallyIncreasing = true;
-            size_t numberOfInliers = CountInliers(suggestionForPolynomial, possibleCorrespondencesOrderedByMeasuredKeypoint, settings.inlierLimitInWavelength, inlierCorrespondences, meanErrorOfModel, isMonotonicallyIncreasing);
+            size_t numberOfInliers = CountInliers(suggestionForPolynomial, possibleCorrespondencesOrderedByMeasuredKeypoint, settings.inlierLimitInWavelength, inlierCorrespondences, meanErrorOfModel, isMonotonicallyIncreasing, scratch.countInliers);
             const double inlierPixelSpan = GetMeasuredValueSpan(inlierCorrespondences);
 
-            if ((numberOfInliers > result.highestNumberOfInliers && isMonotonicallyIncreasing) ||
-                (numberOfInliers == result.highestNumberOfInliers && isMonotonicallyIncreasing && inlierPixelSpan > result.largestPixelSpan) ||
-                (numberOfInliers == result.highestNumberOfInliers && isMonotonicallyIncreasing && std::abs(inlierPixelSpan - result.largestPixelSpan) < 0.1 && meanErrorOfModel < result.smallestError))
+            if (isMonotonicallyIncreasing && IsBetterModel(numberOfInliers, inlierPixelSpan, meanErrorOfModel, result))
             {
                 if (settings.refine && numberOfInliers > settings.modelPolynomialOrder + 1)
                 {
-                    if (!FitPolynomial(polyFit, inlierCorrespondences, suggestionForPolynomial))
+                    if (!FitPolynomial(scratch.polyFit, inlierCorrespondences, suggestionForPolynomial))
                     {
                         std::cout << "Polynomial fit failed" << std::endl;
                         continue;
                     }
 
                     // recount the inliers
-                    numberOfInliers = CountInliers(suggestionForPolynomial, possibleCorrespondencesOrderedByMeasuredKeypoint, settings.inlierLimitInWavelength, inlierCorrespondences, meanErrorOfModel, isMonotonicallyIncreasing);
+                    numberOfInliers = CountInliers(suggestionForPolynomial, possibleCorrespondencesOrderedByMeasuredKeypoint, settings.inlierLimitInWavelength, inlierCorrespondences, meanErrorOfModel, isMonotonicallyIncreasing, scratch.countInliers);
                     result.largestPixelSpan = GetMeasuredValueSpan(inlierCorrespondences);
                 }
 
-                result.bestFittingModelCoefficients = std::move(suggestionForPolynomial);
+                result.bestFittingModelCoefficients = suggestionForPolynomial;
                 result.highestNumberOfInliers = numberOfInliers;
                 result.correspondenceIsInlier = ListInliers(inlierCorrespondences, possibleCorrespondences);
                 result.smallestError = meanErrorOfModel;
@@ -341,7 +390,7 @@ namespace novac
 
     RansacWavelengthCalibrationResult RansacWavelengthCalibrationSetup::RunDeterministicCalibration(
         const std::vector<Correspondence>& possibleCorrespondences,
-        const std::vector<std::vector<Correspondence>>& possibleCorrespondencesOrderedByMeasuredKeypoint) const
+        const CorrespondencesByMeasuredKeypoint& possibleCorrespondencesOrderedByMeasuredKeypoint) const
     {
         PolynomialFit polyFit{ static_cast<int>(settings.modelPolynomialOrder) };
 
@@ -354,6 +403,7 @@ namespace novac
         const size_t ransacSampleSize = (settings.sampleSize > 0) ? settings.sampleSize : (settings.modelPolynomialOrder + 1);
         std::vector<double> suggestionForPolynomial;
         std::vector<Correspondence> selectedCorrespondences;
+        CountInliersScratch countInliersScratch;
 
         const auto allCorrespondenceCombinations = ListAllPossibleKeypointCombinations(ransacSampleSize, possibleCorrespondences);
 
@@ -380,7 +430,7 @@ namespace novac
             std::vector<Correspondence> inlierCorrespondences;
             double meanErrorOfModel = 0.0;
             bool isMonotonicallyIncreasing = true;
-            size_t numberOfInliers = CountInliers(suggestionForPolynomial, possibleCorrespondencesOrderedByMeasuredKeypoint, settings.inlierLimitInWavelength, inlierCorrespondences, meanErrorOfModel, isMonotonicallyIncreasing);
+            size_t numberOfInliers = CountInliers(suggestionForPolynomial, possibleCorrespondencesOrderedByMeasuredKeypoint, settings.inlierLimitInWavelength, inlierCorrespondences, meanErrorOfModel, isMonotonicallyIncreasing, countInliersScratch);
             double inlierPixelSpan = GetMeasuredValueSpan(inlierCorrespondences);
 
             if (iteration == 0 ||
@@ -397,7 +447,7 @@ namespace novac
                     }
 
                     // recount the inliers
-                    numberOfInliers = CountInliers(suggestionForPolynomial, possibleCorrespondencesOrderedByMeasuredKeypoint, settings.inlierLimitInWavelength, inlierCorrespondences, meanErrorOfModel, isMonotonicallyIncreasing);
+                    numberOfInliers = CountInliers(suggestionForPolynomial, possibleCorrespondencesOrderedByMeasuredKeypoint, settings.inlierLimitInWavelength, inlierCorrespondences, meanErrorOfModel, isMonotonicallyIncreasing, countInliersScratch);
                     inlierPixelSpan = GetMeasuredValueSpan(inlierCorrespondences);
                 }
 
@@ -409,60 +459,109 @@ namespace novac
             }
         }
 
-        return result;
-    }
-
-    int GetBestResult(const std::vector< RansacWavelengthCalibrationResult>& partialResults)
-    {
-        int bestIdx = 0;
-        for (int ii = 1; ii < (int)partialResults.size(); ++ii)
-        {
-            if (partialResults[ii].highestNumberOfInliers > partialResults[bestIdx].highestNumberOfInliers ||
-                (partialResults[ii].highestNumberOfInliers == partialResults[bestIdx].highestNumberOfInliers && partialResults[ii].smallestError < partialResults[bestIdx].smallestError))
-            {
-                bestIdx = ii;
-            }
-        }
+        result.numberOfIterations = allCorrespondenceCombinations.size();
 
-        return bestIdx;
+        return result;
     }
 
-
-    constexpr int OPENMP_DEFAULT_NUMBER_OF_THREADS = 4;
     constexpr size_t OPENMP_MAX_NUMBER_OF_THREADS = 64LLU;
 
+    // The iterations are divided into blocks of this size. Each block uses its own random generator, seeded from the block index,
+    //  such that the result does not depend on which thread runs which block.
+    constexpr int RANSAC_ITERATIONS_PER_BLOCK = 1000;
+
     RansacWavelengthCalibrationResult RansacWavelengthCalibrationSetup::DoWavelengthCalibration(
         const std::vector<Correspondence>& possibleCorrespondences)
     {
-        const auto possibleCorrespondencesOrderedByMeasuredKeypoint = ArrangeByMeasuredKeypoint(possibleCorrespondences);
+        const CorrespondencesByMeasuredKeypoint possibleCorrespondencesOrderedByMeasuredKeypoint = CreateCorrespondencesByMeasuredKeypoint(ArrangeByMeasuredKeypoint(possibleCorrespondences));
 
         if (possibleCorrespondences.size() < 10 * settings.modelPolynomialOrder)
         {
             // No use in random sampling, simply pick all the possible combinations.
             return RunDeterministicCalibration(possibleCorrespondences, possibleCorrespondencesOrderedByMeasuredKeypoint);
         }
-        else
-        {
-            std::vector< RansacWavelengthCalibrationResult> partialResults;
 
-            const int numberOfThreads = (settings.numberOfThreads > 0) ? static_cast<int>(std::min(settings.numberOfThreads, OPENMP_MAX_NUMBER_OF_THREADS)) : OPENMP_DEFAULT_NUMBER_OF_THREADS;
+        const RansacWavelengthCalibrationResult initialResult = EvaluateInitialModel(possibleCorrespondences, possibleCorrespondencesOrderedByMeasuredKeypoint);
+        const size_t ransacSampleSize = (settings.sampleSize > 0) ? settings.sampleSize : (settings.modelPolynomialOrder + 1);
+        const unsigned int seed = (settings.randomSeed != 0) ? settings.randomSeed : std::random_device{}();
+
+        const size_t hardwareThreads = std::max(1U, std::thread::hardware_concurrency());
+        const int numberOfThreads = static_cast<int>(std::min((settings.numberOfThreads > 0) ? settings.numberOfThreads : hardwareThreads, OPENMP_MAX_NUMBER_OF_THREADS));
+
+        // The threads take blocks of iterations, in order, until enough blocks have been run.
+        //  The number of blocks to run is lowered as soon as the blocks completed so far (counted from the first block) give a model
+        //  with enough inliers for the ransac bound to be reached. Blocks beyond this which were started by other threads in the meantime
+        //  are disregarded, such that the result only depends on the seed and not on the timing of the threads.
+        const int numberOfBlocks = std::max(0, (settings.numberOfRansacIterations + RANSAC_ITERATIONS_PER_BLOCK - 1) / RANSAC_ITERATIONS_PER_BLOCK);
+        std::vector<RansacWavelengthCalibrationResult> blockResults(numberOfBlocks);
+        std::vector<std::atomic<long long>> inliersInBlock(numberOfBlocks); // -1 until the block is completed
+        for (std::atomic<long long>& value : inliersInBlock)
+        {
+            value.store(-1);
+        }
+        std::atomic<int> nextBlock{ 0 };
+        std::atomic<int> numberOfBlocksToRun{ numberOfBlocks };
 
-            partialResults.resize(numberOfThreads);
-            omp_set_num_threads(numberOfThreads);
+#pragma omp parallel num_threads(numberOfThreads)
+        {
+            ScratchBuffers scratch(settings.modelPolynomialOrder);
 
-#pragma omp parallel for
-            for (int threadIdx = 0; threadIdx < numberOfThreads; ++threadIdx)
+            while (true)
             {
-                const int numberOfIterationsInThisThread = settings.numberOfRansacIterations / numberOfThreads;
-                partialResults[threadIdx] = RunRansacCalibrations(possibleCorrespondences, possibleCorrespondencesOrderedByMeasuredKeypoint, numberOfIterationsInThisThread);
+                const int blockIdx = nextBlock.fetch_add(1);
+                if (blockIdx >= numberOfBlocksToRun.load())
+                {
+                    break;
+                }
+
+                std::seed_seq blockSeed{ seed, static_cast<unsigned int>(blockIdx) };
+                std::mt19937 rnd{ blockSeed };
+                const int numberOfIterationsInBlock = std::min(RANSAC_ITERATIONS_PER_BLOCK, settings.numberOfRansacIterations - blockIdx * RANSAC_ITERATIONS_PER_BLOCK);
+
+                blockResults[blockIdx] = RunRansacCalibrations(possibleCorrespondences, possibleCorrespondencesOrderedByMeasuredKeypoint, initialResult, rnd, numberOfIterationsInBlock, scratch);
+                inliersInBlock[blockIdx].store(static_cast<long long>(blockResults[blockIdx].highestNumberOfInliers));
+
+                // Check if the completed blocks, counted from the first, are enough.
+                size_t highestNumberOfInliers = initialResult.highestNumberOfInliers;
+                for (int completedBlockIdx = 0; completedBlockIdx < numberOfBlocksToRun.load(); ++completedBlockIdx)
+                {
+                    const long long inliers = inliersInBlock[completedBlockIdx].load();
+                    if (inliers < 0)
+                    {
+                        break;
+                    }
+                    highestNumberOfInliers = std::max(highestNumberOfInliers, static_cast<size_t>(inliers));
+
+                    const double inlierRatio = highestNumberOfInliers / (double)possibleCorrespondences.size();
+                    const double completedIterations = (completedBlockIdx + 1) * (double)RANSAC_ITERATIONS_PER_BLOCK;
+                    if (completedIterations >= RequiredNumberOfIterations(inlierRatio, ransacSampleSize, settings.terminationConfidence))
+                    {
+                        int currentValue = numberOfBlocksToRun.load();
+                        while (completedBlockIdx + 1 < currentValue && !numberOfBlocksToRun.compare_exchange_weak(currentValue, completedBlockIdx + 1))
+                        {
+                        }
+                        break;
+                    }
+                }
             }
+        }
 
-            // Combine the results of the threads results into one final result
-            const int bestResultIdx = GetBestResult(partialResults);
-            RansacWavelengthCalibrationResult finalResult = partialResults[bestResultIdx];
+        // Combine the results of the blocks, in order, into one final result
+        RansacWavelengthCalibrationResult finalResult = initialResult;
+        size_t totalNumberOfIterations = 0;
+        for (int blockIdx = 0; blockIdx < numberOfBlocksToRun.load(); ++blockIdx)
+        {
+            const RansacWavelengthCalibrationResult& blockResult = blockResults[blockIdx];
+            totalNumberOfIterations += blockResult.numberOfIterations;
 
-            return finalResult;
+            if (IsBetterModel(blockResult.highestNumberOfInliers, blockResult.largestPixelSpan, blockResult.smallestError, finalResult))
+            {
+                finalResult = blockResult;
+            }
         }
+        finalResult.numberOfIterations = totalNumberOfIterations;
+
+        return finalResult;
     }
 
 }
@@ -312,7 +312,7 @@ void SetupFitWindowReferences(novac::CFitWindow& window, const std::vector<Refer
     // Use the properties of the first (major) reference for the window
     window.name = window.ref[0].m_specieName;
 
-    if (window.ref[0].m_data->m_waveLength.size() == 0)
+    if (window.ref[0].Data()->m_waveLength.size() == 0)
     {
         std::stringstream message;
         message << "failed to set the fit range,the reference " << window.ref[0].m_specieName << " does not have a wavelength calibration";
@@ -320,8 +320,8 @@ void SetupFitWindowReferences(novac::CFitWindow& window, const std::vector<Refer
     }
 
     // Setup the channel range where the fit should be done.
-    const double fractionalFitLow = window.ref[0].m_data->FindWavelength(wavelengthRange.low);
-    const double fractionalFitHigh = window.ref[0].m_data->FindWavelength(wavelengthRange.high);
+    const double fractionalFitLow = window.ref[0].Data()->FindWavelength(wavelengthRange.low);
+    const double fractionalFitHigh = window.ref[0].Data()->FindWavelength(wavelengthRange.high);
     if (fractionalFitLow < -0.5 || fractionalFitHigh < -0.5)
     {
         std::stringstream message;
@@ -417,6 +417,8 @@ novac::BasicScanEvaluationResult RatioCalculationController::DoInitialEvaluation
     // TODO: This could be the basis for a (future) scan evaluation class based on the new DoasFit class...
     scan.ResetCounter();
     novac::CSpectrum measuredSpectrum;
+    std::vector<double> filteredMeasuredSpectrum;
+    const novac::IndexRange offsetRemovalRange{ 50, 200 };
     novac::SpectrometerModel spectrometerModel = GetModelForMeasurement(measuredSkySpectrum.m_info.m_device);
     while (0 == scan.GetNextMeasuredSpectrum(context, measuredSpectrum))
     {
@@ -426,11 +428,12 @@ novac::BasicScanEvaluationResult RatioCalculationController::DoInitialEvaluation
 
         // Dark-correct and prepare the spectrum for the fit
         measuredSpectrum.Sub(measuredDarkSpectrum);
-        const auto filteredMeasuredSpectrum = novac::DoasFitPreparation::PrepareMeasuredSpectrum(measuredSpectrum, measuredSkySpectrum, localCopyOfWindow.fitType);
+        filteredMeasuredSpectrum.resize(measuredSpectrum.m_length);
+        novac::DoasFitPreparation::PrepareMeasuredSpectrum(measuredSpectrum, measuredSkySpectrum, localCopyOfWindow.fitType, offsetRemovalRange, filteredMeasuredSpectrum);
 
         // do the actual DOAS fit.
         novac::DoasResult doasResult;
-        doas.Run(filteredMeasuredSpectrum.data(), filteredMeasuredSpectrum.size(), doasResult);
+        doas.Run(filteredMeasuredSpectrum, doasResult);
 
         // Convert the DoasResult into an CEvaluationResult
         novac::CEvaluationResult evaluationResult = doasResult;
@@ -683,7 +686,7 @@ void RatioCalculationController::SaveSpectraToPakFile(const std::string& outputD
 
     // Since the measurement is already dark-corrected, create an all-zero dark-spectrum to use
     novac::CSpectrum darkSpectrum;
-    darkSpectrum.m_length = resultToSave.debugInfo.inPlumeSpectrum.m_length;
+    darkSpectrum.Resize(resultToSave.debugInfo.inPlumeSpectrum.m_length);
 
     // Write the data to file.
     novac::CSpectrumIO spectrumWriter;
@@ -100,18 +100,10 @@ novac::InstrumentCalibration ReferenceCreationController::ReadCalibration(std::s
     return initialCalibration;
 }
 
-void ReferenceCreationController::ConvolveReference(const novac::InstrumentCalibration& initialCalibration)
+novac::CCrossSectionData ReadHighResolutionReference(const std::string& highResolutionCrossSection)
 {
-    auto wavelengthConversion = (m_convertToAir) ? novac::WavelengthConversion::VacuumToAir : novac::WavelengthConversion::None;
-
-    // Extract the line shape (needed for the convolution below)
-    novac::CCrossSectionData instrumentLineShape;
-    instrumentLineShape.m_waveLength = initialCalibration.instrumentLineShapeGrid;
-    instrumentLineShape.m_crossSection = initialCalibration.instrumentLineShape;
-
-    // Read the reference
     novac::CCrossSectionData highResReference;
-    if (!novac::ReadCrossSectionFile(m_highResolutionCrossSection, highResReference))
+    if (!novac::ReadCrossSectionFile(highResolutionCrossSection, highResReference))
     {
         throw std::invalid_argument("Failed to read the reference file");
     }
@@ -123,6 +115,21 @@ void ReferenceCreationController::ConvolveReference(const novac::InstrumentCalib
         Reverse(highResReference.m_waveLength);
     }
 
+    return highResReference;
+}
+
+void ReferenceCreationController::ConvolveReference(const novac::InstrumentCalibration& initialCalibration)
+{
+    auto wavelengthConversion = (m_convertToAir) ? novac::WavelengthConversion::VacuumToAir : novac::WavelengthConversion::None;
+
+    // Extract the line shape (needed for the convolution below)
+    novac::CCrossSectionData instrumentLineShape;
+    instrumentLineShape.m_waveLength = initialCalibration.instrumentLineShapeGrid;
+    instrumentLineShape.m_crossSection = initialCalibration.instrumentLineShape;
+
+    // Read the reference
+    novac::CCrossSectionData highResReference = ReadHighResolutionReference(m_highResolutionCrossSection);
+
     // Do the convolution
     std::vector<double> convolutionResult;
     novac::ConvolveReference(
@@ -132,32 +139,78 @@ void ReferenceCreationController::ConvolveReference(const novac::InstrumentCalib
         convolutionResult,
         wavelengthConversion);
 
+    m_resultingCrossSection = CreateResultingCrossSection(convolutionResult, initialCalibration, highResReference.m_waveLength);
+}
+
+std::vector<std::unique_ptr<novac::CCrossSectionData>> ReferenceCreationController::ConvolveReferences(
+    const novac::InstrumentCalibration& calibration,
+    const std::vector<std::string>& highResolutionCrossSections) const
+{
+    auto wavelengthConversion = (m_convertToAir) ? novac::WavelengthConversion::VacuumToAir : novac::WavelengthConversion::None;
+
+    // Extract the line shape (needed for the convolution below)
+    novac::CCrossSectionData instrumentLineShape;
+    instrumentLineShape.m_waveLength = calibration.instrumentLineShapeGrid;
+    instrumentLineShape.m_crossSection = calibration.instrumentLineShape;
+
+    // Read the references
+    std::vector<novac::CCrossSectionData> highResReferences;
+    highResReferences.reserve(highResolutionCrossSections.size());
+    for (const std::string& highResolutionCrossSection : highResolutionCrossSections)
+    {
+        highResReferences.push_back(ReadHighResolutionReference(highResolutionCrossSection));
+    }
+
+    // Do the convolutions, all at once
+    std::vector<std::vector<double>> convolutionResults;
+    novac::ConvolveReferences(
+        calibration.pixelToWavelengthMapping,
+        instrumentLineShape,
+        highResReferences,
+        convolutionResults,
+        wavelengthConversion);
+
+    std::vector<std::unique_ptr<novac::CCrossSectionData>> result;
+    result.reserve(highResReferences.size());
+    for (size_t referenceIdx = 0; referenceIdx < highResReferences.size(); ++referenceIdx)
+    {
+        result.push_back(CreateResultingCrossSection(convolutionResults[referenceIdx], calibration, highResReferences[referenceIdx].m_waveLength));
+    }
+
+    return result;
+}
+
+std::unique_ptr<novac::CCrossSectionData> ReferenceCreationController::CreateResultingCrossSection(
+    const std::vector<double>& convolutionResult,
+    const novac::InstrumentCalibration& calibration,
+    const std::vector<double>& highResolutionWavelength) const
+{
     // Combine the results into the final output cross section data 
-    m_resultingCrossSection = std::make_unique<novac::CCrossSectionData>();
-    m_resultingCrossSection->m_crossSection = convolutionResult;
-    m_resultingCrossSection->m_waveLength = initialCalibration.pixelToWavelengthMapping;
+    auto resultingCrossSection = std::make_unique<novac::CCrossSectionData>();
+    resultingCrossSection->m_crossSection = convolutionResult;
+    resultingCrossSection->m_waveLength = calibration.pixelToWavelengthMapping;
 
     if (m_highPassFilter)
     {
-        PrepareConvolvedReferenceForHighPassFiltering(m_resultingCrossSection, highResReference.m_waveLength);
+        PrepareConvolvedReferenceForHighPassFiltering(resultingCrossSection, highResolutionWavelength);
 
-        const int length = (int)m_resultingCrossSection->m_crossSection.size();
+        const int length = (int)resultingCrossSection->m_crossSection.size();
         CBasicMath math;
 
         if (m_isPseudoAbsorber)
         {
-            math.HighPassBinomial(m_resultingCrossSection->m_crossSection.data(), length, 500);
+            math.HighPassBinomial(resultingCrossSection->m_crossSection.data(), length, 500);
         }
         else
         {
-            math.Mul(m_resultingCrossSection->m_crossSection.data(), length, -2.5e15);
-            math.Delog(m_resultingCrossSection->m_crossSection.data(), length);
-            math.HighPassBinomial(m_resultingCrossSection->m_crossSection.data(), length, 500);
-            math.Log(m_resultingCrossSection->m_crossSection.data(), length);
+            math.Mul(resultingCrossSection->m_crossSection.data(), length, -2.5e15);
+            math.Delog(resultingCrossSection->m_crossSection.data(), length);
+            math.HighPassBinomial(resultingCrossSection->m_crossSection.data(), length, 500);
+            math.Log(resultingCrossSection->m_crossSection.data(), length);
 
             if (m_unitSelection == 1)
             {
-                math.Div(m_resultingCrossSection->m_crossSection.data(), length, 2.5e15);
+                math.Div(resultingCrossSection->m_crossSection.data(), length, 2.5e15);
             }
         }
     }
@@ -165,10 +218,10 @@ void ReferenceCreationController::ConvolveReference(const novac::InstrumentCalib
     {
         if (m_unitSelection == 0 && !m_isPseudoAbsorber)
         {
-            const int length = (int)m_resultingCrossSection->m_crossSection.size();
+            const int length = (int)resultingCrossSection->m_crossSection.size();
 
             CBasicMath math;
-            math.Mul(m_resultingCrossSection->m_crossSection.data(), length, 2.5e15);
+            math.Mul(resultingCrossSection->m_crossSection.data(), length, 2.5e15);
         }
         else
         {
@@ -176,4 +229,5 @@ void ReferenceCreationController::ConvolveReference(const novac::InstrumentCalib
         }
     }
 
+    return resultingCrossSection;
 }
\ No newline at end of file
@@ -9,7 +9,9 @@
 #include <SpectralEvaluation/Fit/PolynomialFunction.h>
 #include <SpectralEvaluation/Fit/DiscreteFunction.h>
 #include <SpectralEvaluation/Fit/StandardFit.h>
+#include <SpectralEvaluation/Math/BinomialFilter.h>
 #include <math.h>
+#include <memory>
 #include <vector>
 
 #ifdef _DEBUG
@@ -30,6 +32,32 @@ using namespace MathFit;
 
 bool CBasicMath::mDoNotUseMathLimits = false;
 
+// Below this number of iterations it is faster to run the binomial filter iteratively than to use novac::BinomialFilter.
+static const int minimumIterationsForBinomialFilter = 16;
+
+// Retrieves a binomial filter for the given length and number of iterations. The filters are kept per thread,
+//  such that repeatedly filtering spectra of the same length does not need to set up the filter again.
+static novac::BinomialFilter& GetBinomialFilter(int iSize, int iNIterations)
+{
+    static thread_local std::vector<std::unique_ptr<novac::BinomialFilter>> filters;
+
+    for (auto& filter : filters)
+    {
+        if (filter->Length() == (size_t)iSize && filter->Iterations() == iNIterations)
+        {
+            return *filter;
+        }
+    }
+
+    const size_t maximumNumberOfFilters = 8;
+    if (filters.size() == maximumNumberOfFilters)
+    {
+        filters.erase(filters.begin());
+    }
+    filters.emplace_back(new novac::BinomialFilter((size_t)iSize, iNIterations));
+    return *filters.back();
+}
+
 CBasicMath::CBasicMath()
 {
 }
@@ -40,9 +68,15 @@ CBasicMath::~CBasicMath()
 
 double* CBasicMath::LowPassBinomial(double* fData, int iSize, int iNIterations)
 {
-    std::vector<double> fBuffer(iSize);
+    if (iNIterations >= minimumIterationsForBinomialFilter && iSize > 0)
+    {
+        GetBinomialFilter(iSize, iNIterations).LowPass(fData);
+        return(fData);
+    }
+
+    mLowPassBuffer.resize(iSize);
     double* fOut = fData;
-    double* fIn = fBuffer.data();
+    double* fIn = mLowPassBuffer.data();
     const int iLast = iSize - 1;
     const int iFirst = 0;
 
@@ -81,11 +115,17 @@ double* CBasicMath::LowPassBinomial(double* fData, int iSize, int iNIterations)
 
 double* CBasicMath::HighPassBinomial(double* fData, int iSize, int iNIterations)
 {
-    std::vector<double> fBuffer(iSize);
+    if (iNIterations >= minimumIterationsForBinomialFilter && iSize > 0)
+    {
+        GetBinomialFilter(iSize, iNIterations).HighPass(fData);
+        return(fData);
+    }
+
+    std::vector<double>& fBuffer = mHighPassBuffer;
     int i;
 
     // create copy of original data
-    memcpy(fBuffer.data(), fData, sizeof(double) * iSize);
+    fBuffer.assign(fData, fData + iSize);
 
     // create low pass filtered data
     LowPassBinomial(fBuffer.data(), iSize, iNIterations);
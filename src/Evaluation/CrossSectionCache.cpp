@@ -0,0 +1,178 @@
+#include <SpectralEvaluation/Evaluation/CrossSectionCache.h>
+#include <SpectralEvaluation/Evaluation/CrossSectionData.h>
+#include <sys/stat.h>
+
+namespace novac
+{
+
+const size_t CrossSectionCache::defaultMemoryBudget;
+
+namespace
+{
+    bool GetFileSizeAndModificationTime(const std::string& fileName, std::uint64_t& size, std::int64_t& modificationTime)
+    {
+        struct stat fileStatus;
+        if (stat(fileName.c_str(), &fileStatus) != 0)
+        {
+            return false;
+        }
+        size = static_cast<std::uint64_t>(fileStatus.st_size);
+        modificationTime = static_cast<std::int64_t>(fileStatus.st_mtime);
+        return true;
+    }
+
+    size_t GetMemoryUsage(const CCrossSectionData& crossSection)
+    {
+        return sizeof(CCrossSectionData) + sizeof(double) * (crossSection.m_waveLength.size() + crossSection.m_crossSection.size());
+    }
+}
+
+std::shared_ptr<const CCrossSectionData> CrossSectionCache::Get(const std::string& fileName)
+{
+    std::uint64_t fileSize = 0;
+    std::int64_t modificationTime = 0;
+    if (!GetFileSizeAndModificationTime(fileName, fileSize, modificationTime))
+    {
+        return nullptr;
+    }
+
+    // Find the cross section in the cache, or add an entry which this thread will fill in by reading the file.
+    std::promise<std::shared_ptr<const CCrossSectionData>> promise;
+    std::shared_future<std::shared_ptr<const CCrossSectionData>> crossSection;
+    std::uint64_t createdEntry = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_guard);
+
+        auto entry = m_entries.find(fileName);
+        if (entry != m_entries.end() && entry->second.fileSize == fileSize && entry->second.modificationTime == modificationTime)
+        {
+            entry->second.lastUse = ++m_useCounter;
+            crossSection = entry->second.crossSection;
+        }
+        else
+        {
+            if (entry != m_entries.end())
+            {
+                // The file has changed since it was read.
+                m_memoryUsage -= entry->second.memoryUsage;
+                m_entries.erase(entry);
+            }
+
+            Entry newEntry;
+            newEntry.fileSize = fileSize;
+            newEntry.modificationTime = modificationTime;
+            newEntry.crossSection = promise.get_future().share();
+            newEntry.lastUse = ++m_useCounter;
+            newEntry.id = newEntry.lastUse;
+            createdEntry = newEntry.id;
+            crossSection = newEntry.crossSection;
+            m_entries[fileName] = newEntry;
+            ++m_numberOfFileReads;
+        }
+    }
+
+    if (createdEntry == 0)
+    {
+        // Waits until the file has been read, if this is done by another thread.
+        return crossSection.get();
+    }
+
+    // Read the file without holding the lock, such that other files can be retrieved meanwhile.
+    std::shared_ptr<const CCrossSectionData> result;
+    try
+    {
+        auto data = std::make_shared<CCrossSectionData>();
+        if (0 == data->ReadCrossSectionFile(fileName) && data->m_crossSection.size() > 0)
+        {
+            result = data;
+        }
+        promise.set_value(result);
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_guard);
+
+        // The entry may have been removed, or replaced, by another thread while the file was read.
+        auto entry = m_entries.find(fileName);
+        if (entry != m_entries.end() && entry->second.id == createdEntry)
+        {
+            if (result == nullptr)
+            {
+                // Files which could not be read are not cached.
+                m_entries.erase(entry);
+            }
+            else
+            {
+                entry->second.memoryUsage = GetMemoryUsage(*result);
+                m_memoryUsage += entry->second.memoryUsage;
+                RemoveLeastRecentlyUsed(fileName);
+            }
+        }
+    }
+
+    return crossSection.get();
+}
+
+void CrossSectionCache::SetMemoryBudget(size_t memoryBudget)
+{
+    std::lock_guard<std::mutex> lock(m_guard);
+    m_memoryBudget = memoryBudget;
+    RemoveLeastRecentlyUsed(std::string());
+}
+
+size_t CrossSectionCache::MemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_guard);
+    return m_memoryBudget;
+}
+
+size_t CrossSectionCache::MemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_guard);
+    return m_memoryUsage;
+}
+
+size_t CrossSectionCache::NumberOfFileReads() const
+{
+    std::lock_guard<std::mutex> lock(m_guard);
+    return m_numberOfFileReads;
+}
+
+void CrossSectionCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_guard);
+    m_entries.clear();
+    m_memoryUsage = 0;
+    m_numberOfFileReads = 0;
+}
+
+void CrossSectionCache::RemoveLeastRecentlyUsed(const std::string& fileToKeep)
+{
+    while (m_memoryUsage > m_memoryBudget)
+    {
+        auto leastRecentlyUsed = m_entries.end();
+        for (auto entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+        {
+            const bool isRead = entry->second.memoryUsage > 0;
+            if (isRead && entry->first != fileToKeep &&
+                (leastRecentlyUsed == m_entries.end() || entry->second.lastUse < leastRecentlyUsed->second.lastUse))
+            {
+                leastRecentlyUsed = entry;
+            }
+        }
+
+        if (leastRecentlyUsed == m_entries.end())
+        {
+            return;
+        }
+
+        m_memoryUsage -= leastRecentlyUsed->second.memoryUsage;
+        m_entries.erase(leastRecentlyUsed);
+    }
+}
+
+}
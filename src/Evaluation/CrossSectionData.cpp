@@ -1,20 +1,16 @@
 #include <SpectralEvaluation/Evaluation/CrossSectionData.h>
 #include <SpectralEvaluation/Evaluation/BasicMath.h>
+#include <SpectralEvaluation/File/TextFileReader.h>
 #include <SpectralEvaluation/Fit/Vector.h>
 #include <SpectralEvaluation/Spectra/Grid.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/Interpolation.h>
 #include <fstream>
 #include <numeric>
-#include <map>
-#include <mutex>
 
 namespace novac
 {
 
-static std::mutex s_crossSectionDatabase;
-static std::map<std::string, CCrossSectionData> s_readInCrossSections;
-
 CCrossSectionData::CCrossSectionData()
 {
 }
@@ -171,21 +167,11 @@ double CCrossSectionData::FindWavelength(double wavelength) const
 
 int CCrossSectionData::ReadCrossSectionFile(const std::string& fileName)
 {
-    // if (s_readInCrossSections.find(fileName) != s_readInCrossSections.end())
-    // {
-    //     // Take the data from the database instead...
-    //     std::lock_guard<std::mutex> lock(s_crossSectionDatabase);
-    //     *this = s_readInCrossSections[fileName];
-    //     return 0;
-    // }
-
     this->m_waveLength.clear();
     this->m_crossSection.clear();
 
-    std::ifstream fileRef;
-
-    fileRef.open(fileName, std::ios_base::in);
-    if (!fileRef.is_open())
+    TextFileReader fileRef;
+    if (!fileRef.Open(fileName))
     {
         std::cout << "ERROR: Cannot open reference file: " << fileName << std::endl;
         return 1;
@@ -194,30 +180,28 @@ int CCrossSectionData::ReadCrossSectionFile(const std::string& fileName)
     int valuesReadNum = 0;
 
     // read reference spectrum into the 'fValue's array
-    const int maxSize = 65536;
-    std::vector<char> tmpBuffer(maxSize);
-    while (!fileRef.eof())
+    const char* lineBegin = nullptr;
+    const char* lineEnd = nullptr;
+    while (fileRef.ReadLine(lineBegin, lineEnd))
     {
-        fileRef.getline(tmpBuffer.data(), maxSize);
-
         // Ignore empty-lines and lines starting with a comment character
-        if (strlen(tmpBuffer.data()) == 0 ||
-            tmpBuffer[0] == ';' ||
-            tmpBuffer[0] == '#')
+        if (lineBegin == lineEnd ||
+            *lineBegin == ';' ||
+            *lineBegin == '#')
         {
             continue;
         }
 
         // this construction enables us to read files with both one or two columns
+        //  (the values are separated by any whitespace, as when reading the line using sscanf(line, "%lf\t%lf"))
         double fValue1 = 0.0;
         double fValue2 = 0.0;
-        int nColumns = sscanf(tmpBuffer.data(), "%lf\t%lf", &fValue1, &fValue2);
-
-        // check so that we actually could read the data
-        if (nColumns < 1 || nColumns > 2)
+        const char* position = lineBegin;
+        if (!ParseDouble(position, lineEnd, fValue1))
         {
             break;
         }
+        const int nColumns = ParseDouble(position, lineEnd, fValue2) ? 2 : 1;
 
         ++valuesReadNum;
 
@@ -236,14 +220,6 @@ int CCrossSectionData::ReadCrossSectionFile(const std::string& fileName)
     {
         return 1; // failed to read any lines
     }
-    fileRef.close();
-
-    // Save the data to the database
-    // if (s_readInCrossSections.find(fileName) == s_readInCrossSections.end())
-    // {
-    //     std::lock_guard<std::mutex> lock(s_crossSectionDatabase);
-    //     s_readInCrossSections[fileName] = *this;
-    // }
 
     return 0;
 }
@@ -124,24 +124,32 @@ bool ModelDarkSpectrum(const IScanSpectrumSource& scan, const CSpectrum& spec, c
     if (offset.m_length == darkCurrent.m_length && offset.m_length > 0)
     {
         // 3c-1 Scale the offset spectrum to the measured
-        offset.Mult(spec.NumSpectra() / (double)offset.NumSpectra());
+        const double offsetScale = spec.NumSpectra() / (double)offset.NumSpectra();
         offset.m_info.m_numSpec = spec.NumSpectra();
 
         // 3c-2 Remove offset from the dark-current spectrum
-        if (offsetCorrectDC)
-        {
-            CSpectrum offset_dc = offset;
-            offset_dc.Mult(darkCurrent.NumSpectra() / (double)offset_dc.NumSpectra());
-            darkCurrent.Sub(offset_dc);
-        }
+        const double offsetInDarkCurrentScale = offsetCorrectDC ? darkCurrent.NumSpectra() / (double)offset.NumSpectra() : 0.0;
 
         // 3c-3 Scale the dark-current spectrum to the measured
-        darkCurrent.Mult((spec.NumSpectra() * spec.ExposureTime()) / (double)(darkCurrent.NumSpectra() * darkCurrent.ExposureTime()));
+        const double darkCurrentScale = (spec.NumSpectra() * spec.ExposureTime()) / (double)(darkCurrent.NumSpectra() * darkCurrent.ExposureTime());
         darkCurrent.m_info.m_numSpec = spec.NumSpectra();
 
+        // All three steps are made in one pass over the spectra, with the same operations for each pixel as when
+        //  scaling and subtracting the spectra one after the other.
+        double* offsetData = offset.m_data;
+        double* darkCurrentData = darkCurrent.m_data;
+        const long length = offset.m_length;
+        for (long ii = 0; ii < length; ++ii)
+        {
+            const double scaledOffset = offsetData[ii] * offsetScale;
+            const double offsetCorrectedDarkCurrent = offsetCorrectDC ? darkCurrentData[ii] - scaledOffset * offsetInDarkCurrentScale : darkCurrentData[ii];
+            offsetData[ii] = scaledOffset;
+            darkCurrentData[ii] = offsetCorrectedDarkCurrent * darkCurrentScale;
+        }
+
         // 3d. Make the dark-spectrum
         dark.Clear();
-        dark.m_length = offset.m_length;
+        dark.Resize(offset.m_length);
         dark.m_info.m_interlaceStep = offset.m_info.m_interlaceStep;
         dark.m_info.m_channel = offset.m_info.m_channel;
         dark.Add(offset);
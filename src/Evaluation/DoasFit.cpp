@@ -9,6 +9,10 @@
 #include <SpectralEvaluation/Fit/StandardFit.h>
 #include <SpectralEvaluation/Fit/StandardMetricFunction.h>
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <memory>
 #include <sstream>
 
 namespace novac
@@ -29,12 +33,8 @@ MathFit::CVector Generate(int first, int last)
 
 void SaveResidual(MathFit::CStandardFit& cFirstFit, DoasResult& result)
 {
-    const auto& res = cFirstFit.GetResiduum();
-    result.residual.resize(res.GetSize());
-    for (int ii = 0; ii < res.GetSize(); ++ii)
-    {
-        result.residual[ii] = res.GetAt(ii);
-    }
+    MathFit::CVector& res = cFirstFit.GetResiduum();
+    result.residual.assign(res.GetSafePtr(), res.GetSafePtr() + res.GetSize());
 }
 
 void SavePolynomial(MathFit::CPolynomialFunction& fittedPolynomial, int fitLow, int fitHigh, DoasResult& result)
@@ -61,10 +61,69 @@ MathFit::CReferenceSpectrumFunction* DefaultReferenceSpectrumFunction()
     return newRef;
 }
 
+// The options for how the parameters of one reference are coupled in the fit, copied from the CReferenceFile.
+struct DoasReferenceCoupling
+{
+    SHIFT_TYPE columnOption = SHIFT_TYPE::SHIFT_FREE;
+    double columnValue = 0.0;
+    SHIFT_TYPE shiftOption = SHIFT_TYPE::SHIFT_FREE;
+    double shiftValue = 0.0;
+    double shiftMaxValue = 0.0;
+    SHIFT_TYPE squeezeOption = SHIFT_TYPE::SHIFT_FREE;
+    double squeezeValue = 0.0;
+    double squeezeMaxValue = 0.0;
+};
+
+// Precomputed solution of the DOAS fit for the case when the shift and squeeze of all references are fixed.
+//  The fit is then linear in all its parameters and the least squares solution can be calculated
+//  directly from the measured spectrum by multiplication with the (pseudo-)inverse of the design matrix,
+//  which only has to be calculated once.
+struct DoasLinearFitSetup
+{
+    // The number of pixels in the fit region.
+    int numberOfPixels = 0;
+
+    // The number of parameters in the fit, the references with free columns followed by the polynomial coefficients.
+    int numberOfParameters = 0;
+
+    // The design matrix (A), stored column by column. Size is numberOfPixels * numberOfParameters.
+    std::vector<double> designMatrix;
+
+    // The matrix inv(At*A)*At, stored row by row. Size is numberOfParameters * numberOfPixels.
+    //  Multiplying this with the measured spectrum gives the fitted parameters.
+    std::vector<double> solutionMatrix;
+
+    // The diagonal of inv(At*A), used to calculate the uncertainties of the fitted parameters.
+    std::vector<double> parameterVariance;
+
+    // The sum of all references with fixed column, in the fit region. This is subtracted from the measured spectrum.
+    std::vector<double> fixedReferences;
+
+    // For each reference, the index of its column in the parameters or -1 if the column is fixed.
+    std::vector<int> parameterIndex;
+
+    // For each reference, its shifted and squeezed values in the fit region (with column = 1).
+    std::vector<std::vector<double>> referenceValues;
+};
+
 // Helper class, for storing the references.
 class DoasReferenceSetup
 {
 public:
+    DoasReferenceSetup() = default;
+
+    ~DoasReferenceSetup()
+    {
+        for (MathFit::CReferenceSpectrumFunction* reference : m_ref)
+        {
+            delete reference;
+        }
+    }
+
+    // Do not copy this object as it owns the references.
+    DoasReferenceSetup(const DoasReferenceSetup&) = delete;
+    DoasReferenceSetup& operator=(const DoasReferenceSetup&) = delete;
+
     // The CReferenceSpectrumFunctions are used in the evaluation process to model
     // the reference spectra for the different species that are being fitted.
     //  The vector must hold pointers to the references, as these cannot be copied...
@@ -74,33 +133,363 @@ public:
     /// The name of each reference.
     std::vector<std::string> name;
 
+    /// How the parameters of each reference are coupled in the fit.
+    std::vector<DoasReferenceCoupling> coupling;
+
     // The scale factor for the retrieved values, can be either +1.0 or -1.0 depending on the fit-type.
     double columnScaleFactor = -1.0;
+
+    // Set if the fit only contains linear parameters, and hence can be solved without iterations.
+    std::unique_ptr<DoasLinearFitSetup> linearFit;
 };
 
-DoasFit::DoasFit()
+void CoupleReferences(const std::vector<DoasReferenceCoupling>& coupling, std::vector<MathFit::CReferenceSpectrumFunction*>& references)
 {
+    assert(coupling.size() == references.size());
+
+    for (size_t refIdx = 0; refIdx < references.size(); ++refIdx)
+    {
+        const DoasReferenceCoupling& options = coupling[refIdx];
+
+        // Check the options for the column value.
+        //  Notice the multiplication with minus one here, this is done to keep the signs of everything compatible with DOASIS.
+        switch (options.columnOption)
+        {
+        case novac::SHIFT_TYPE::SHIFT_FIX:
+            references[refIdx]->FixParameter(MathFit::CReferenceSpectrumFunction::CONCENTRATION, -1.0 * options.columnValue * references[refIdx]->GetAmplitudeScale());
+            break;
+        case novac::SHIFT_TYPE::SHIFT_LINK:
+            references[(int)options.columnValue]->LinkParameter(MathFit::CReferenceSpectrumFunction::CONCENTRATION, *references[refIdx], MathFit::CReferenceSpectrumFunction::CONCENTRATION);
+            break;
+        case novac::SHIFT_TYPE::SHIFT_FREE:
+            references[refIdx]->ReleaseParameter(MathFit::CReferenceSpectrumFunction::CONCENTRATION);
+            break;
+        default:
+            throw std::invalid_argument("Invalid type of shift set for the column option for a reference in DoasFit");
+        }
+
+        // Check the options for the shift
+        switch (options.shiftOption)
+        {
+        case novac::SHIFT_TYPE::SHIFT_FIX:
+            references[refIdx]->FixParameter(MathFit::CReferenceSpectrumFunction::SHIFT, options.shiftValue);
+            break;
+        case novac::SHIFT_TYPE::SHIFT_LINK:
+            references[(int)options.shiftValue]->LinkParameter(MathFit::CReferenceSpectrumFunction::SHIFT, *references[refIdx], MathFit::CReferenceSpectrumFunction::SHIFT);
+            break;
+        case novac::SHIFT_TYPE::SHIFT_LIMIT:
+            references[refIdx]->SetParameterLimits(MathFit::CReferenceSpectrumFunction::SHIFT, (MathFit::TFitData)options.shiftValue, (MathFit::TFitData)options.shiftMaxValue, 1);
+            break;
+        default:
+            references[refIdx]->SetDefaultParameter(MathFit::CReferenceSpectrumFunction::SHIFT, (MathFit::TFitData)0.0);
+            references[refIdx]->SetParameterLimits(MathFit::CReferenceSpectrumFunction::SHIFT, (MathFit::TFitData)-10.0, (MathFit::TFitData)10.0, (MathFit::TFitData)1e0);
+            break; // TODO: Get these limits as parameters!
+        }
+
+        // Check the options for the squeeze
+        switch (options.squeezeOption)
+        {
+        case novac::SHIFT_TYPE::SHIFT_FIX:
+            references[refIdx]->FixParameter(MathFit::CReferenceSpectrumFunction::SQUEEZE, options.squeezeValue);
+            break;
+        case novac::SHIFT_TYPE::SHIFT_LINK:
+            references[(int)options.squeezeValue]->LinkParameter(MathFit::CReferenceSpectrumFunction::SQUEEZE, *references[refIdx], MathFit::CReferenceSpectrumFunction::SQUEEZE);
+            break;
+        case novac::SHIFT_TYPE::SHIFT_LIMIT:
+            references[refIdx]->SetParameterLimits(MathFit::CReferenceSpectrumFunction::SQUEEZE, (MathFit::TFitData)options.squeezeValue, (MathFit::TFitData)options.squeezeMaxValue, 1e7);
+            break;
+        default:
+            references[refIdx]->SetDefaultParameter(MathFit::CReferenceSpectrumFunction::SQUEEZE, (MathFit::TFitData)1.0);
+            references[refIdx]->SetParameterLimits(MathFit::CReferenceSpectrumFunction::SQUEEZE, (MathFit::TFitData)0.98, (MathFit::TFitData)1.02, (MathFit::TFitData)1e0);
+            break; // TODO: Get these limits as parameters!
+        }
+    }
 }
 
-DoasFit::~DoasFit()
+// Creates a new set of references, with their own fit parameters, which shares the spectral data (splines) with the provided setup.
+//  This makes it possible to run several fits using the same references in parallel.
+std::unique_ptr<DoasReferenceSetup> CreateSharedReferenceSetup(const DoasReferenceSetup& original)
 {
-    DeallocateReferenceSetup();
+    std::unique_ptr<DoasReferenceSetup> workspace(new DoasReferenceSetup());
+    workspace->name = original.name;
+    workspace->coupling = original.coupling;
+    workspace->columnScaleFactor = original.columnScaleFactor;
+
+    for (MathFit::CReferenceSpectrumFunction* reference : original.m_ref)
+    {
+        auto newRef = DefaultReferenceSpectrumFunction();
+        newRef->ShareBasisFunction(*reference);
+        workspace->m_ref.push_back(newRef);
+    }
+
+    CoupleReferences(workspace->coupling, workspace->m_ref);
+
+    return workspace;
 }
 
-void DoasFit::DeallocateReferenceSetup()
+// Resets the (not fixed) parameters of all the references back to the values they have directly after setup.
+void ResetReferenceParameters(DoasReferenceSetup& referenceSetup)
 {
-    DoasReferenceSetup* setup = static_cast<DoasReferenceSetup*>(m_referenceSetup);
+    for (MathFit::CReferenceSpectrumFunction* reference : referenceSetup.m_ref)
+    {
+        reference->ResetLinearParameter();
+        reference->ResetNonlinearParameter();
+    }
+}
 
-    if (setup != nullptr)
+// Returns true if the DOAS fit with the given references will only contain linear parameters,
+//  i.e. the shift and squeeze of all references are fixed and the columns are either free or fixed.
+bool IsLinearFit(const DoasReferenceSetup& referenceSetup)
+{
+    for (const DoasReferenceCoupling& options : referenceSetup.coupling)
     {
-        for (MathFit::CReferenceSpectrumFunction* reference : setup->m_ref)
+        if (options.shiftOption != SHIFT_TYPE::SHIFT_FIX || options.squeezeOption != SHIFT_TYPE::SHIFT_FIX)
         {
-            delete reference;
-            reference = nullptr;
+            return false;
+        }
+        if (options.columnOption != SHIFT_TYPE::SHIFT_FIX && options.columnOption != SHIFT_TYPE::SHIFT_FREE)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sets up the precomputed solution of the linear DOAS fit.
+//  Returns nullptr if the fit cannot be solved, the error is then reported when running the (iterative) fit instead.
+std::unique_ptr<DoasLinearFitSetup> CreateLinearFitSetup(DoasReferenceSetup& referenceSetup, int fitLow, int fitHigh, int polynomialOrder)
+{
+    std::unique_ptr<DoasLinearFitSetup> linearFit(new DoasLinearFitSetup());
+    const int numberOfPixels = fitHigh - fitLow;
+    const size_t numberOfReferences = referenceSetup.m_ref.size();
+    linearFit->numberOfPixels = numberOfPixels;
+
+    MathFit::CVector vXSec = Generate(fitLow, fitHigh);
+
+    // The values of each of the references, with the fixed shift and squeeze applied.
+    linearFit->fixedReferences.resize(numberOfPixels, 0.0);
+    linearFit->parameterIndex.resize(numberOfReferences, -1);
+    linearFit->referenceValues.resize(numberOfReferences);
+    int numberOfParameters = 0;
+    for (size_t refIdx = 0; refIdx < numberOfReferences; ++refIdx)
+    {
+        MathFit::CReferenceSpectrumFunction* reference = referenceSetup.m_ref[refIdx];
+        reference->SetFitRange(vXSec);
+
+        MathFit::CVector values(numberOfPixels);
+        reference->GetLinearBasisFunctions(vXSec, values, 0, false);
+        linearFit->referenceValues[refIdx] = std::vector<double>(values.GetSafePtr(), values.GetSafePtr() + numberOfPixels);
+
+        if (referenceSetup.coupling[refIdx].columnOption == SHIFT_TYPE::SHIFT_FIX)
+        {
+            const double column = reference->GetLinearParameterVector().GetAllParameter().GetAt(0);
+            for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+            {
+                linearFit->fixedReferences[pixelIdx] += column * values.GetAt(pixelIdx);
+            }
+        }
+        else
+        {
+            linearFit->parameterIndex[refIdx] = numberOfParameters++;
+        }
+    }
+    numberOfParameters += polynomialOrder + 1;
+    linearFit->numberOfParameters = numberOfParameters;
+
+    // Build the design matrix, the references with free column followed by the polynomial
+    MathFit::CMatrix mA(numberOfParameters, numberOfPixels);
+    for (size_t refIdx = 0; refIdx < numberOfReferences; ++refIdx)
+    {
+        const int parameterIdx = linearFit->parameterIndex[refIdx];
+        if (parameterIdx >= 0)
+        {
+            for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+            {
+                mA.SetAt(pixelIdx, parameterIdx, linearFit->referenceValues[refIdx][pixelIdx]);
+            }
+        }
+    }
+    for (int order = 0; order <= polynomialOrder; ++order)
+    {
+        const int parameterIdx = numberOfParameters - polynomialOrder - 1 + order;
+        for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+        {
+            mA.SetAt(pixelIdx, parameterIdx, std::pow(vXSec.GetAt(pixelIdx), order));
+        }
+    }
+
+    linearFit->designMatrix.resize(static_cast<size_t>(numberOfPixels) * numberOfParameters);
+    for (int parameterIdx = 0; parameterIdx < numberOfParameters; ++parameterIdx)
+    {
+        for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+        {
+            linearFit->designMatrix[parameterIdx * numberOfPixels + pixelIdx] = mA.GetAt(pixelIdx, parameterIdx);
+        }
+    }
+
+    // Calculate the covariance matrix inv(At*A) from the QR decomposition of the column scaled design matrix,
+    //  in the same way as CLeastSquareFit does.
+    MathFit::CMatrix mCovariance;
+    std::vector<double> columnScale(numberOfParameters);
+    try
+    {
+        MathFit::CMatrix mQR;
+        mQR.Copy(mA);
+        for (int parameterIdx = 0; parameterIdx < numberOfParameters; ++parameterIdx)
+        {
+            double sumOfSquares = 0.0;
+            for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+            {
+                sumOfSquares += mA.GetAt(pixelIdx, parameterIdx) * mA.GetAt(pixelIdx, parameterIdx);
+            }
+            if (sumOfSquares <= 0.0)
+            {
+                return nullptr;
+            }
+            columnScale[parameterIdx] = 1.0 / std::sqrt(sumOfSquares);
+            mQR.GetCol(parameterIdx).Mul(columnScale[parameterIdx]);
+        }
+
+        MathFit::CVector vRDiagonal(numberOfParameters);
+        mQR.QRDecomposition(vRDiagonal);
+        mQR.QRInverseNormalMatrix(vRDiagonal, mCovariance);
+    }
+    catch (MathFit::CFitException&)
+    {
+        return nullptr;
+    }
+
+    for (int row = 0; row < numberOfParameters; ++row)
+    {
+        for (int column = 0; column < numberOfParameters; ++column)
+        {
+            mCovariance.SetAt(row, column, mCovariance.GetAt(row, column) * columnScale[row] * columnScale[column]);
+        }
+    }
+
+    linearFit->parameterVariance.resize(numberOfParameters);
+    linearFit->solutionMatrix.resize(static_cast<size_t>(numberOfParameters) * numberOfPixels);
+    for (int parameterIdx = 0; parameterIdx < numberOfParameters; ++parameterIdx)
+    {
+        linearFit->parameterVariance[parameterIdx] = mCovariance.GetAt(parameterIdx, parameterIdx);
+
+        for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < numberOfParameters; ++k)
+            {
+                sum += mCovariance.GetAt(parameterIdx, k) * mA.GetAt(pixelIdx, k);
+            }
+            linearFit->solutionMatrix[parameterIdx * numberOfPixels + pixelIdx] = sum;
         }
-        delete setup;
     }
 
+    return linearFit;
+}
+
+// Performs the DOAS fit using the precomputed linear solution.
+void RunLinearFit(const DoasReferenceSetup& referenceSetup, const double* measuredData, int fitLow, int fitHigh, int polynomialOrder, DoasResult& result)
+{
+    const DoasLinearFitSetup& linearFit = *referenceSetup.linearFit;
+    const int numberOfPixels = linearFit.numberOfPixels;
+    const int numberOfParameters = linearFit.numberOfParameters;
+
+    // The measured spectrum with the references with fixed columns removed.
+    std::vector<double> target(measuredData + fitLow, measuredData + fitHigh);
+    for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+    {
+        target[pixelIdx] -= linearFit.fixedReferences[pixelIdx];
+    }
+
+    std::vector<double> parameters(numberOfParameters);
+    for (int parameterIdx = 0; parameterIdx < numberOfParameters; ++parameterIdx)
+    {
+        const double* row = linearFit.solutionMatrix.data() + parameterIdx * numberOfPixels;
+        double sum = 0.0;
+        for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+        {
+            sum += row[pixelIdx] * target[pixelIdx];
+        }
+        parameters[parameterIdx] = sum;
+    }
+
+    // The residual is the difference between the measurement and the fitted model.
+    result.residual = target;
+    for (int parameterIdx = 0; parameterIdx < numberOfParameters; ++parameterIdx)
+    {
+        const double* column = linearFit.designMatrix.data() + parameterIdx * numberOfPixels;
+        for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+        {
+            result.residual[pixelIdx] -= parameters[parameterIdx] * column[pixelIdx];
+        }
+    }
+
+    result.fitLow = fitLow;
+    result.fitHigh = fitHigh;
+    result.iterations = 0;
+    result.chiSquare = 0.0;
+    for (double residual : result.residual)
+    {
+        result.chiSquare += residual * residual;
+    }
+    const auto minmax = std::minmax_element(begin(result.residual), end(result.residual));
+    result.delta = *minmax.second - *minmax.first;
+
+    // The uncertainties are normalized to the chi-square, in the same way as done by CLeastSquareFit
+    const double errorNormalization = std::sqrt(result.chiSquare / (numberOfPixels - numberOfParameters));
+
+    const int firstPolynomialParameter = numberOfParameters - polynomialOrder - 1;
+    result.polynomialCoefficients = std::vector<double>(begin(parameters) + firstPolynomialParameter, end(parameters));
+
+    MathFit::CVector coefficients;
+    coefficients.Copy(result.polynomialCoefficients.data(), polynomialOrder + 1);
+    result.polynomialValues.resize(numberOfPixels);
+    for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+    {
+        result.polynomialValues[pixelIdx] = coefficients.CalcPoly(static_cast<MathFit::TFitData>(pixelIdx + fitLow));
+    }
+
+    result.measuredSpectrum = std::vector<double>(measuredData + fitLow, measuredData + fitHigh);
+
+    result.referenceResult.resize(referenceSetup.m_ref.size());
+    for (size_t ii = 0; ii < referenceSetup.m_ref.size(); ii++)
+    {
+        MathFit::CReferenceSpectrumFunction* reference = referenceSetup.m_ref[ii];
+        const double amplitudeScale = reference->GetAmplitudeScale();
+        const int parameterIdx = linearFit.parameterIndex[ii];
+
+        const double column = (parameterIdx >= 0) ? parameters[parameterIdx] : reference->GetLinearParameterVector().GetAllParameter().GetAt(0);
+
+        result.referenceResult[ii].name = referenceSetup.name[ii];
+        result.referenceResult[ii].column = referenceSetup.columnScaleFactor * column / amplitudeScale;
+        result.referenceResult[ii].columnError = (parameterIdx >= 0) ? errorNormalization * std::sqrt(linearFit.parameterVariance[parameterIdx]) / amplitudeScale : 0.0;
+        result.referenceResult[ii].shift = reference->GetModelParameter(MathFit::CReferenceSpectrumFunction::SHIFT);
+        result.referenceResult[ii].shiftError = 0.0;
+        result.referenceResult[ii].squeeze = reference->GetModelParameter(MathFit::CReferenceSpectrumFunction::SQUEEZE);
+        result.referenceResult[ii].squeezeError = 0.0;
+
+        result.referenceResult[ii].scaledValues.resize(numberOfPixels);
+        for (int pixelIdx = 0; pixelIdx < numberOfPixels; ++pixelIdx)
+        {
+            result.referenceResult[ii].scaledValues[pixelIdx] = column * linearFit.referenceValues[ii][pixelIdx];
+        }
+    }
+}
+
+DoasFit::DoasFit()
+{
+}
+
+DoasFit::~DoasFit()
+{
+    DeallocateReferenceSetup();
+}
+
+void DoasFit::DeallocateReferenceSetup()
+{
+    DoasReferenceSetup* setup = static_cast<DoasReferenceSetup*>(m_referenceSetup);
+    delete setup;
+
     m_referenceSetup = nullptr;
 }
 
@@ -112,106 +501,64 @@ void DoasFit::Setup(const CFitWindow& setup)
     m_name = setup.name;
 
     DeallocateReferenceSetup();
-    DoasReferenceSetup* newReferenceSetup = new DoasReferenceSetup();
+    std::unique_ptr<DoasReferenceSetup> newReferenceSetup(new DoasReferenceSetup());
     newReferenceSetup->columnScaleFactor = (setup.fitType == FIT_TYPE::FIT_POLY) ? -1.0 : +1.0;
 
     // 1) Create the references
     for (int refIdx = 0; refIdx < setup.nRef; ++refIdx)
     {
-        if (setup.ref[refIdx].m_data == nullptr)
+        if (setup.ref[refIdx].Data() == nullptr)
         {
             throw std::invalid_argument("Error in setting up DOAS fit, reference is null.");
         }
-        if (setup.ref[refIdx].m_data->GetSize() == 0)
+        if (setup.ref[refIdx].Data()->GetSize() == 0)
         {
             throw std::invalid_argument("Error in setting up DOAS fit, reference does not contain any data.");
         }
 
         auto newRef = DefaultReferenceSpectrumFunction();
 
+        // Add this reference to the vector directly, such that it is deleted also if the setup fails below.
+        newReferenceSetup->m_ref.push_back(newRef);
+        newReferenceSetup->name.push_back(setup.ref[refIdx].m_specieName);
+
         // set the spectral data of the reference spectrum to the object. This also causes an internal
         // transformation of the spectral data into a B-Spline that will be used to interpolate the 
         // reference spectrum during shift and squeeze operations
         MathFit::CVector yValues;
-        yValues.Copy(setup.ref[refIdx].m_data->m_crossSection.data(), setup.ref[refIdx].m_data->GetSize());
+        yValues.Copy(setup.ref[refIdx].Data()->m_crossSection.data(), setup.ref[refIdx].Data()->GetSize());
 
-        auto tempXVec = Generate(0, setup.ref[refIdx].m_data->GetSize()); // the x-axis vector here is pixels.
+        auto tempXVec = Generate(0, setup.ref[refIdx].Data()->GetSize()); // the x-axis vector here is pixels.
         if (!newRef->SetData(tempXVec, yValues))
         {
             throw std::invalid_argument("Error in DOAS reference, failed to initialize spline object. Make sure that the reference is ok and try again.");
         }
 
-        // Finally add this reference to the vector
-        newReferenceSetup->m_ref.push_back(newRef);
-        newReferenceSetup->name.push_back(setup.ref[refIdx].m_specieName);
+        DoasReferenceCoupling coupling;
+        coupling.columnOption = setup.ref[refIdx].m_columnOption;
+        coupling.columnValue = setup.ref[refIdx].m_columnValue;
+        coupling.shiftOption = setup.ref[refIdx].m_shiftOption;
+        coupling.shiftValue = setup.ref[refIdx].m_shiftValue;
+        coupling.shiftMaxValue = setup.ref[refIdx].m_shiftMaxValue;
+        coupling.squeezeOption = setup.ref[refIdx].m_squeezeOption;
+        coupling.squeezeValue = setup.ref[refIdx].m_squeezeValue;
+        coupling.squeezeMaxValue = setup.ref[refIdx].m_squeezeMaxValue;
+        newReferenceSetup->coupling.push_back(coupling);
     }
 
     // 2) Couple the references
-    for (int refIdx = 0; refIdx < setup.nRef; ++refIdx)
-    {
-        // Check the options for the column value.
-        //  Notice the multiplication with minus one here, this is done to keep the signs of everything compatible with DOASIS.
-        switch (setup.ref[refIdx].m_columnOption)
-        {
-        case novac::SHIFT_TYPE::SHIFT_FIX:
-            newReferenceSetup->m_ref[refIdx]->FixParameter(MathFit::CReferenceSpectrumFunction::CONCENTRATION, -1.0 * setup.ref[refIdx].m_columnValue * newReferenceSetup->m_ref[refIdx]->GetAmplitudeScale());
-            break;
-        case novac::SHIFT_TYPE::SHIFT_LINK:
-            newReferenceSetup->m_ref[(int)setup.ref[refIdx].m_columnValue]->LinkParameter(MathFit::CReferenceSpectrumFunction::CONCENTRATION, *newReferenceSetup->m_ref[refIdx], MathFit::CReferenceSpectrumFunction::CONCENTRATION);
-            break;
-        case novac::SHIFT_TYPE::SHIFT_FREE:
-            newReferenceSetup->m_ref[refIdx]->ReleaseParameter(MathFit::CReferenceSpectrumFunction::CONCENTRATION);
-            break;
-        default:
-            throw std::invalid_argument("Invalid type of shift set for the column option for a reference in DoasFit");
-        }
-
-        // Check the options for the shift
-        switch (setup.ref[refIdx].m_shiftOption)
-        {
-        case novac::SHIFT_TYPE::SHIFT_FIX:
-            newReferenceSetup->m_ref[refIdx]->FixParameter(MathFit::CReferenceSpectrumFunction::SHIFT, setup.ref[refIdx].m_shiftValue);
-            break;
-        case novac::SHIFT_TYPE::SHIFT_LINK:
-            newReferenceSetup->m_ref[(int)setup.ref[refIdx].m_shiftValue]->LinkParameter(MathFit::CReferenceSpectrumFunction::SHIFT, *newReferenceSetup->m_ref[refIdx], MathFit::CReferenceSpectrumFunction::SHIFT);
-            break;
-        case novac::SHIFT_TYPE::SHIFT_LIMIT:
-            newReferenceSetup->m_ref[refIdx]->SetParameterLimits(MathFit::CReferenceSpectrumFunction::SHIFT, (MathFit::TFitData)setup.ref[refIdx].m_shiftValue, (MathFit::TFitData)setup.ref[refIdx].m_shiftMaxValue, 1);
-            break;
-        default:
-            newReferenceSetup->m_ref[refIdx]->SetDefaultParameter(MathFit::CReferenceSpectrumFunction::SHIFT, (MathFit::TFitData)0.0);
-            newReferenceSetup->m_ref[refIdx]->SetParameterLimits(MathFit::CReferenceSpectrumFunction::SHIFT, (MathFit::TFitData)-10.0, (MathFit::TFitData)10.0, (MathFit::TFitData)1e0);
-            break; // TODO: Get these limits as parameters!
-        }
+    CoupleReferences(newReferenceSetup->coupling, newReferenceSetup->m_ref);
 
-        // Check the options for the squeeze
-        switch (setup.ref[refIdx].m_squeezeOption)
-        {
-        case novac::SHIFT_TYPE::SHIFT_FIX:
-            newReferenceSetup->m_ref[refIdx]->FixParameter(MathFit::CReferenceSpectrumFunction::SQUEEZE, setup.ref[refIdx].m_squeezeValue);
-            break;
-        case novac::SHIFT_TYPE::SHIFT_LINK:
-            newReferenceSetup->m_ref[(int)setup.ref[refIdx].m_squeezeValue]->LinkParameter(MathFit::CReferenceSpectrumFunction::SQUEEZE, *newReferenceSetup->m_ref[refIdx], MathFit::CReferenceSpectrumFunction::SQUEEZE);
-            break;
-        case novac::SHIFT_TYPE::SHIFT_LIMIT:
-            newReferenceSetup->m_ref[refIdx]->SetParameterLimits(MathFit::CReferenceSpectrumFunction::SQUEEZE, (MathFit::TFitData)setup.ref[refIdx].m_squeezeValue, (MathFit::TFitData)setup.ref[refIdx].m_squeezeMaxValue, 1e7);
-            break;
-        default:
-            newReferenceSetup->m_ref[refIdx]->SetDefaultParameter(MathFit::CReferenceSpectrumFunction::SQUEEZE, (MathFit::TFitData)1.0);
-            newReferenceSetup->m_ref[refIdx]->SetParameterLimits(MathFit::CReferenceSpectrumFunction::SQUEEZE, (MathFit::TFitData)0.98, (MathFit::TFitData)1.02, (MathFit::TFitData)1e0);
-            break; // TODO: Get these limits as parameters!
-        }
+    // 3) If the fit is linear, then precompute its solution
+    if (IsLinearFit(*newReferenceSetup) && m_fitHigh - m_fitLow > (int)newReferenceSetup->m_ref.size() + m_polynomialOrder + 1)
+    {
+        newReferenceSetup->linearFit = CreateLinearFitSetup(*newReferenceSetup, m_fitLow, m_fitHigh, m_polynomialOrder);
     }
 
     assert(newReferenceSetup->name.size() == newReferenceSetup->m_ref.size());
 
     // Set the member
-    if (m_referenceSetup != nullptr)
-    {
-        auto currentSetup = static_cast<DoasReferenceSetup*>(m_referenceSetup);
-        delete currentSetup;
-    }
-    m_referenceSetup = newReferenceSetup;
+    m_referenceSetup = newReferenceSetup.release();
 }
 
 void ValidateDoasInputData(const double* measuredData, size_t measuredLength, const DoasReferenceSetup* referenceSetup)
@@ -244,14 +591,104 @@ void DoasFit::Run(const double* measuredData, size_t measuredLength, DoasResult&
 
     ValidateDoasInputData(measuredData, measuredLength, referenceSetup);
 
-    // Make a local copy of the data. TODO: Check if this actually is necessary anymore?!?
-    std::vector<double> measArray(measuredData, measuredData + measuredLength);
+    if (referenceSetup->linearFit != nullptr && m_fitLow >= 0 && static_cast<size_t>(m_fitHigh) <= measuredLength)
+    {
+        RunLinearFit(*referenceSetup, measuredData, m_fitLow, m_fitHigh, m_polynomialOrder, result);
+        return;
+    }
+
+    RunWithReferences(referenceSetup, SpectrumView(measuredData, measuredLength), result);
+}
+
+void DoasFit::Run(SpectrumView measuredData, DoasResult& result)
+{
+    Run(measuredData.data(), measuredData.size(), result);
+}
+
+void DoasFit::RunBatch(const std::vector<const double*>& measuredData, size_t measuredLength, std::vector<DoasResult>& results)
+{
+    DoasReferenceSetup* referenceSetup = static_cast<DoasReferenceSetup*>(m_referenceSetup);
+
+    for (const double* spectrum : measuredData)
+    {
+        ValidateDoasInputData(spectrum, measuredLength, referenceSetup);
+    }
+
+    const int numberOfSpectra = static_cast<int>(measuredData.size());
+    std::vector<DoasResult> batchResult(numberOfSpectra);
+
+    if (referenceSetup->linearFit != nullptr && m_fitLow >= 0 && static_cast<size_t>(m_fitHigh) <= measuredLength)
+    {
+        // The linear fit does not modify the references and can use them directly from all threads.
+#pragma omp parallel for schedule(static)
+        for (int spectrumIdx = 0; spectrumIdx < numberOfSpectra; ++spectrumIdx)
+        {
+            RunLinearFit(*referenceSetup, measuredData[spectrumIdx], m_fitLow, m_fitHigh, m_polynomialOrder, batchResult[spectrumIdx]);
+        }
+
+        results = std::move(batchResult);
+        return;
+    }
+
+    // Exceptions cannot propagate out of the parallel region, these are collected and the first one re-thrown afterwards.
+    std::vector<std::exception_ptr> errors(numberOfSpectra);
+
+#pragma omp parallel
+    {
+        // Each thread has its own set of fit parameters, but all share the (read-only) splines of the references.
+        //  If these cannot be created, then the error is reported for each of the spectra of this thread.
+        std::unique_ptr<DoasReferenceSetup> threadReferences;
+        std::exception_ptr setupError;
+        try
+        {
+            threadReferences = CreateSharedReferenceSetup(*referenceSetup);
+        }
+        catch (...)
+        {
+            setupError = std::current_exception();
+        }
+
+#pragma omp for schedule(static)
+        for (int spectrumIdx = 0; spectrumIdx < numberOfSpectra; ++spectrumIdx)
+        {
+            try
+            {
+                if (setupError)
+                {
+                    std::rethrow_exception(setupError);
+                }
+                ResetReferenceParameters(*threadReferences);
+                RunWithReferences(threadReferences.get(), SpectrumView(measuredData[spectrumIdx], measuredLength), batchResult[spectrumIdx]);
+            }
+            catch (...)
+            {
+                errors[spectrumIdx] = std::current_exception();
+            }
+        }
+    }
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    results = std::move(batchResult);
+}
+
+void DoasFit::RunWithReferences(void* referenceSetupPtr, SpectrumView measuredData, DoasResult& result) const
+{
+    DoasReferenceSetup* referenceSetup = static_cast<DoasReferenceSetup*>(referenceSetupPtr);
+    const size_t measuredLength = measuredData.size();
 
     //----------------------------------------------------------------
 
-    // Copy the measured spectrum to vMeas
+    // Let vMeas refer to the measured spectrum, the fit never modifies the measured data so this does not need to be copied.
+    //  (MathFit is not const correct, hence the cast).
     MathFit::CVector vMeas;
-    vMeas.Copy(measArray.data(), static_cast<int>(measuredLength), 1);
+    vMeas.Attach(const_cast<double*>(measuredData.data()), static_cast<int>(measuredLength), 1, false);
 
     // To perform the fit we need to extract the wavelength (or pixel)
     //  information from the vXData-vector
@@ -265,11 +702,11 @@ void DoasFit::Run(const double* measuredData, size_t measuredLength, DoasResult&
     MathFit::CDiscreteFunction dataTarget;
 
     // now set the data of the measured spectrum in regard to the wavelength information
-    {
-        // use channel base fitting.
-        auto temp = Generate(0, static_cast<int>(measuredLength));
-        dataTarget.SetData(temp, vMeas);
-    }
+    // use channel base fitting.
+    MathFit::CVector vXData = Generate(0, static_cast<int>(measuredLength));
+    MathFit::CVector vError(static_cast<int>(measuredLength));
+    vError.Wedge(1, 0);
+    dataTarget.AttachData(vXData, vMeas, vError);
 
     // since the DOAS model function consists of the sum of all reference spectra and a polynomial,
     // we first create a summation object
@@ -340,7 +777,7 @@ void DoasFit::Run(const double* measuredData, size_t measuredLength, DoasResult&
         SavePolynomial(cPoly, m_fitLow, m_fitHigh, result);
 
         // Save the filtered measured spectrum
-        result.measuredSpectrum = std::vector<double>(begin(measArray) + m_fitLow, begin(measArray) + m_fitHigh);
+        result.measuredSpectrum.assign(measuredData.begin() + m_fitLow, measuredData.begin() + m_fitHigh);
 
         // finally display the fit results for each reference spectrum including their appropriate error
         result.referenceResult.resize(referenceSetup->m_ref.size());
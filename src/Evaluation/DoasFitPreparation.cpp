@@ -3,7 +3,9 @@
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/Spectra/Scattering.h>
 #include <SpectralEvaluation/VectorUtils.h>
+#include <algorithm>
 #include <limits>
+#include <numeric>
 
 using namespace novac;
 
@@ -55,30 +57,52 @@ std::vector<double> DoasFitPreparation::PrepareMeasuredSpectrum(const CSpectrum&
         throw std::invalid_argument("Cannot prepare the measured spectrum for a DOAS fit if the measured and the sky spectra does not have equal length.");
     }
 
+    std::vector<double> filteredMeasSpectrum(static_cast<size_t>(measuredSpectrum.m_length));
+
+    PrepareMeasuredSpectrum(measuredSpectrum, skySpectrum, doasFitType, offsetRemovalRange, filteredMeasSpectrum);
+
+    return filteredMeasSpectrum;
+}
+
+void DoasFitPreparation::PrepareMeasuredSpectrum(SpectrumView measuredSpectrum, SpectrumView skySpectrum, FIT_TYPE doasFitType, const IndexRange& offsetRemovalRange, MutableSpectrumView result)
+{
+    if (measuredSpectrum.size() != skySpectrum.size())
+    {
+        throw std::invalid_argument("Cannot prepare the measured spectrum for a DOAS fit if the measured and the sky spectra does not have equal length.");
+    }
+    if (measuredSpectrum.size() != result.size())
+    {
+        throw std::invalid_argument("Cannot prepare the measured spectrum for a DOAS fit if the result does not have the same length as the measured spectrum.");
+    }
+
     CBasicMath math;
 
-    const int spectrumLength = static_cast<int>(measuredSpectrum.m_length);
+    const int spectrumLength = static_cast<int>(measuredSpectrum.size());
 
-    std::vector<double> filteredMeasSpectrum{ measuredSpectrum.m_data, measuredSpectrum.m_data + spectrumLength };
+    // The spectrum may be prepared in place, otherwise this is the only copy of the data.
+    if (result.data() != measuredSpectrum.data())
+    {
+        std::copy(measuredSpectrum.begin(), measuredSpectrum.end(), result.begin());
+    }
 
     // Always start by removing the offset.
     RemoveOffset(
-        filteredMeasSpectrum,
+        result,
         static_cast<int>(offsetRemovalRange.from),
         static_cast<int>(offsetRemovalRange.to));
 
     if (doasFitType == FIT_TYPE::FIT_HP_DIV)
     {
         // Divide the measured spectrum with the sky spectrum
-        math.Div(filteredMeasSpectrum.data(), skySpectrum.m_data, spectrumLength, 0.0);
+        math.Div(result.data(), skySpectrum.data(), spectrumLength, 0.0);
 
         // high pass filter
-        math.HighPassBinomial(filteredMeasSpectrum.data(), spectrumLength, 500);
+        math.HighPassBinomial(result.data(), spectrumLength, 500);
     }
     else if (doasFitType == FIT_TYPE::FIT_HP_SUB)
     {
         // high pass filter
-        math.HighPassBinomial(filteredMeasSpectrum.data(), spectrumLength, 500);
+        math.HighPassBinomial(result.data(), spectrumLength, 500);
     }
     else if (doasFitType == FIT_TYPE::FIT_POLY)
     {
@@ -90,19 +114,22 @@ std::vector<double> DoasFitPreparation::PrepareMeasuredSpectrum(const CSpectrum&
     }
 
     // Always end with taking the log of the spectrum, such that we end up in Optical Density space.
-    math.Log(filteredMeasSpectrum.data(), spectrumLength);
-
-    return filteredMeasSpectrum;
+    math.Log(result.data(), spectrumLength);
 }
 
 void DoasFitPreparation::RemoveOffset(std::vector<double>& spectrum, int startIndex, int endIndex)
+{
+    RemoveOffset(MutableSpectrumView(spectrum), startIndex, endIndex);
+}
+
+void DoasFitPreparation::RemoveOffset(MutableSpectrumView spectrum, int startIndex, int endIndex)
 {
     if (startIndex == endIndex)
     {
         return;
     }
 
-    const double spectrumOffset = Average(begin(spectrum) + startIndex, begin(spectrum) + endIndex);
+    const double spectrumOffset = std::accumulate(spectrum.begin() + startIndex, spectrum.begin() + endIndex, 0.0) / (endIndex - startIndex);
 
     CBasicMath math;
     math.Sub(spectrum.data(), static_cast<int>(spectrum.size()), spectrumOffset);
@@ -1,5 +1,6 @@
 #include <SpectralEvaluation/Evaluation/EvaluationBase.h>
 #include <SpectralEvaluation/Evaluation/CrossSectionData.h>
+#include <SpectralEvaluation/Evaluation/FitWorkspace.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/Spectra/Scattering.h>
 
@@ -50,6 +51,15 @@ void CEvaluationBase::SetFitWindow(const CFitWindow& window)
     CreateReferenceSpectra();
 }
 
+FitWorkspace& CEvaluationBase::GetWorkspace()
+{
+    if (m_workspace == nullptr || !m_workspace->IsValidFor(m_window, m_ref))
+    {
+        m_workspace = std::make_unique<FitWorkspace>(m_window, m_ref);
+    }
+    return *m_workspace;
+}
+
 void CEvaluationBase::CreateXDataVector(int numberOfChannels)
 {
     vXData.SetSize(numberOfChannels);
@@ -83,9 +93,9 @@ int CEvaluationBase::CreateReferenceSpectra()
         // transformation of the spectral data into a B-Spline that will be used to interpolate the 
         // reference spectrum during shift and squeeze operations
         CVector yValues;
-        yValues.Copy(m_window.ref[i].m_data->m_crossSection.data(), m_window.ref[i].m_data->GetSize());
+        yValues.Copy(m_window.ref[i].Data()->m_crossSection.data(), m_window.ref[i].Data()->GetSize());
 
-        auto tempXVec = vXData.SubVector(0, m_window.ref[i].m_data->GetSize());
+        auto tempXVec = vXData.SubVector(0, m_window.ref[i].Data()->GetSize());
         if (!newRef->SetData(tempXVec, yValues))
         {
             Error0("Error initializing spline object!");
@@ -323,9 +333,9 @@ int CEvaluationBase::SetSkySpectrum(const CCrossSectionData& spec, bool removeOf
         {
             skySpectrum = CSpectrum(m_sky.m_waveLength, m_sky.m_crossSection);
         }
-        else if (m_window.fraunhoferRef.m_data != nullptr)
+        else if (m_window.fraunhoferRef.Data() != nullptr)
         {
-            skySpectrum = CSpectrum(m_window.fraunhoferRef.m_data->m_waveLength, m_sky.m_crossSection);
+            skySpectrum = CSpectrum(m_window.fraunhoferRef.Data()->m_waveLength, m_sky.m_crossSection);
         }
         else
         {
@@ -506,9 +516,7 @@ void CEvaluationBase::SaveResidual(CStandardFit& cFirstFit)
     //// display some statistical stuff about the residual data
     CDOASVector vResiduum;
     vResiduum.Attach(cFirstFit.GetResiduum(), false);
-    m_residual.SetSize(vResiduum.GetSize());
-    m_residual.Zero();
-    m_residual.Add(vResiduum);
+    m_residual.Copy(vResiduum);
 
     m_result.m_delta = (double)vResiduum.Delta();
 }
@@ -520,7 +528,11 @@ int CEvaluationBase::Evaluate(const CSpectrum& measured, int numSteps)
 
 int CEvaluationBase::Evaluate(const double* measured, size_t measuredLength, int measuredStartChannel, int numSteps)
 {
-    assert(static_cast<size_t>(vXData.GetSize()) >= measuredLength);
+    if (static_cast<size_t>(vXData.GetSize()) < measuredStartChannel + measuredLength)
+    {
+        // spectra longer than MAX_SPECTRUM_LENGTH
+        CreateXDataVector(measuredStartChannel + static_cast<int>(measuredLength));
+    }
 
     m_lastError = "";
 
@@ -550,76 +562,28 @@ int CEvaluationBase::Evaluate(const double* measured, size_t measuredLength, int
         fitHigh = m_window.fitHigh;
     }
 
-    // Make a local copy of the data (since we're going to change the contents)
-    std::vector<double> measArray(measured, measured + measuredLength);
+    // All buffers and fit objects are kept in the workspace, such that repeated evaluations does not allocate any memory.
+    FitWorkspace& workspace = GetWorkspace();
+
+    // Make a local copy of the data (since we're going to change the contents).
+    //  This is the only copy of the measured spectrum, the fit refers directly to m_measuredData.
+    m_measuredData.assign(measured, measured + measuredLength);
 
     //----------------------------------------------------------------
     // --------- prepare the spectrum for evaluation -----------------
     //----------------------------------------------------------------
 
-    PrepareSpectra(m_sky.m_crossSection.data(), measArray.data(), m_window);
-    m_measuredData = std::vector<double>(begin(measArray), end(measArray));
+    PrepareSpectra(m_sky.m_crossSection.data(), m_measuredData.data(), m_window);
 
     //----------------------------------------------------------------
 
-    // Copy the measured spectrum to vMeas
-    CVector vMeas;
-    vMeas.Copy(measArray.data(), m_window.specLength, 1);
-
-    // To perform the fit we need to extract the wavelength (or pixel)
-    //  information from the vXData-vector
-    CVector vXSec(fitHigh - fitLow);
-    vXSec.Copy(vXData.SubVector(fitLow, fitHigh - fitLow));
-
-    ////////////////////////////////////////////////////////////////////////////
-    // now we start building the model function needed for fitting.
-    //
-    // First we create a function object that represents our measured spectrum. Since we do not
-    // need any interpolation on the measured data its enough to use a CDiscreteFunction object.
-    CDiscreteFunction dataTarget;
-
-    // now set the data of the measured spectrum in regard to the wavelength information
-    {
-        auto temp = vXData.SubVector(measuredStartChannel, m_window.specLength);
-        dataTarget.SetData(temp, vMeas);
-    }
-
-    // since the DOAS model function consists of the sum of all reference spectra and a polynomial,
-    // we first create a summation object
-    CSimpleDOASFunction cRefSum;
-
-    // now we add the required CReferenceSpectrumFunction objects that actually represent the 
-    // reference spectra used in the DOAS model function
-    for (CReferenceSpectrumFunction* reference : this->m_ref)
-    {
-        cRefSum.AddReference(*reference); // <-- at last add the reference to the summation object
-    }
-
-    // create the additional polynomial with the correct order
-    //	and add it to the summation object, too
-    CPolynomialFunction cPoly(m_window.polyOrder);
-    cRefSum.AddReference(cPoly);
-
-    // the last step in the model function will be to define how the difference between the measured data and the modeled
-    // data will be determined. In this case we will use the CStandardMetricFunction which actually just calculate the difference
-    // between the measured data and the modeled data channel by channel. The fit will try to minimize these differences.
-    // So we create the metric object and set the measured spectrum function object and the DOAS model function object as parameters
-    CStandardMetricFunction cDiff(dataTarget, cRefSum);
-
-    /////////////////////////////////////////////////////////////////
-    // Now its time to create the fit object. The CStandardFit object will 
-    // provide a combination of a linear Least Square Fit and a nonlinear Levenberg-Marquardt Fit, which
-    // should be sufficient for most needs.
-    CStandardFit cFirstFit(cDiff);
-
-    // don't forget to the the already extracted fit range to the fit object!
-    // without a valid fit range you'll get an exception.
-    cFirstFit.SetFitRange(vXSec);
-
-    // limit the number of fit iteration to 5000. This can still take a long time! More convinient values are
-    // between 100 and 1000
-    cFirstFit.GetNonlinearMinimizer().SetMaxFitSteps(numSteps);
-    cFirstFit.GetNonlinearMinimizer().SetMinChiSquare(0.0001);
+    // The model function is the sum of all references and a polynomial (CSimpleDOASFunction) and the fit
+    // minimizes the difference between the measured spectrum and this model (CStandardMetricFunction).
+    // The CStandardFit combines a linear Least Square Fit and a nonlinear Levenberg-Marquardt Fit.
+    // All these are set up in the workspace, here we only provide the data and the fit range.
+    workspace.PrepareFit(m_measuredData, vXData, measuredStartChannel, fitLow, fitHigh, numSteps);
+    CStandardFit& cFirstFit = workspace.fit;
+    CPolynomialFunction& cPoly = workspace.polynomial;
 
     try
     {
@@ -651,8 +615,7 @@ int CEvaluationBase::Evaluate(const double* measured, size_t measuredLength, int
         SaveResidual(cFirstFit);
 
         // get the fitResult for the polynomial
-        CVector tmpVector;
-        tmpVector.SetSize(fitHigh - fitLow);
+        CVector& tmpVector = workspace.fittedValues;
         auto tempXVec = vXData.SubVector(fitLow, fitHigh - fitLow);
         cPoly.GetValues(tempXVec, tmpVector);
         m_fitResult[0].Set(tmpVector, fitHigh - fitLow);
@@ -704,7 +667,11 @@ int CEvaluationBase::Evaluate(const double* measured, size_t measuredLength, int
 
 int CEvaluationBase::EvaluateShift(novac::LogContext context, const CSpectrum& measured, ShiftEvaluationResult& shiftResult)
 {
-    assert(vXData.GetSize() >= measured.m_length);
+    if (vXData.GetSize() < measured.m_info.m_startChannel + measured.m_length)
+    {
+        // spectra longer than MAX_SPECTRUM_LENGTH
+        CreateXDataVector(measured.m_info.m_startChannel + measured.m_length);
+    }
 
     m_lastError = "";
 
@@ -769,11 +736,12 @@ int CEvaluationBase::EvaluateShift(novac::LogContext context, const CSpectrum& m
     }
 
     // --------- also prepare the solar-spectrum for evaluation -----------------
+    const auto solarSpectrum = m_window.fraunhoferRef.Data();
     CVector localSolarSpectrumData;
-    localSolarSpectrumData.SetSize(m_window.fraunhoferRef.m_data->GetSize());
+    localSolarSpectrumData.SetSize(solarSpectrum->GetSize());
     for (int j = 0; j < m_window.specLength; ++j)
     {
-        localSolarSpectrumData.SetAt(j, m_window.fraunhoferRef.m_data->GetAt(j));
+        localSolarSpectrumData.SetAt(j, solarSpectrum->GetAt(j));
     }
 
     //----------------------------------------------------------------
@@ -924,33 +892,40 @@ int CEvaluationBase::EvaluateShift(novac::LogContext context, const CSpectrum& m
     }
 }
 
-std::string CEvaluationBase::GetReferenceName(size_t referenceIndex) const
+const std::string& CEvaluationBase::GetReferenceName(size_t referenceIndex) const
 {
+    // Returned by reference, such that the name can be assigned to the result without allocating memory.
+    static const std::string notAvailable = "N/A";
+    static const std::string sky = "Sky";
+    static const std::string intensitySpacePolynomial = "IntensitySpacePolynomial";
+    static const std::string ring = "Ring";
+    static const std::string ringLambda4 = "Ring * lambda^4";
+
     if (referenceIndex < (size_t)m_window.nRef)
     {
         return m_window.ref[referenceIndex].m_specieName; // user supplied reference
     }
     else if (referenceIndex >= this->m_ref.size())
     {
-        return "N/A";
+        return notAvailable;
     }
     else if (m_ref[referenceIndex] == this->m_skyReference)
     {
-        return "Sky";
+        return sky;
     }
     else if (m_ref[referenceIndex] == this->m_intensitySpacePolynomial)
     {
-        return "IntensitySpacePolynomial";
+        return intensitySpacePolynomial;
     }
     else if (m_ref[referenceIndex] == this->m_ringSpectrum)
     {
-        return "Ring";
+        return ring;
     }
     else if (m_ref[referenceIndex] == this->m_ringSpectrumLambda4)
     {
-        return "Ring * lambda^4";
+        return ringLambda4;
     }
 
-    return "N/A"; // unknown.
+    return notAvailable; // unknown.
+}
 }
-}
\ No newline at end of file
@@ -202,11 +202,11 @@ void HighPassFilterReferences(CFitWindow& window)
         {
             if (EqualsIgnoringCase(thisReference.m_specieName, "ring"))
             {
-                HighPassFilter_Ring(*thisReference.m_data);
+                HighPassFilter_Ring(thisReference.MutableData());
             }
             else
             {
-                HighPassFilter(*thisReference.m_data);
+                HighPassFilter(thisReference.MutableData());
             }
         }
     }
@@ -228,14 +228,14 @@ void ScaleReferencesToMolecCm2(CFitWindow& window)
         if (thisReference.m_isFiltered)
         {
             // Convert from ppmm to moleculues / cm2
-            Multiply(*thisReference.m_data, (1.0 / 2.5e15));
+            Multiply(thisReference.MutableData(), (1.0 / 2.5e15));
         }
     }
 }
 
 void AddAsReference(CFitWindow& window, const std::vector<double>& referenceData, const std::string& name, int linkShiftToIdx)
 {
-    window.ref[window.nRef].m_data = std::make_unique<CCrossSectionData>(referenceData);
+    window.ref[window.nRef].SetData(referenceData);
     window.ref[window.nRef].m_specieName = name;
     window.ref[window.nRef].m_columnOption = novac::SHIFT_TYPE::SHIFT_FREE;
     window.ref[window.nRef].m_columnValue = 1.0;
@@ -260,7 +260,7 @@ int AddAsSky(CFitWindow& window, const std::vector<double>& referenceData, SHIFT
 {
     int indexOfSkySpectrum = window.nRef;
 
-    window.ref[window.nRef].m_data = std::make_unique<novac::CCrossSectionData>(referenceData);
+    window.ref[window.nRef].SetData(referenceData);
     window.ref[window.nRef].m_specieName = "sky";
     window.ref[window.nRef].m_columnOption = novac::SHIFT_TYPE::SHIFT_FIX;
     window.ref[window.nRef].m_columnValue = -1.0;
@@ -0,0 +1,62 @@
+#include <SpectralEvaluation/Evaluation/FitWorkspace.h>
+#include <SpectralEvaluation/Evaluation/FitWindow.h>
+
+using namespace MathFit;
+
+namespace novac
+{
+
+FitWorkspace::FitWorkspace(const CFitWindow& window, const std::vector<CReferenceSpectrumFunction*>& references)
+    : polynomial(window.polyOrder),
+    metric(target, model),
+    fit(metric),
+    m_references(references),
+    m_specLength(window.specLength),
+    m_polyOrder(window.polyOrder)
+{
+    for (CReferenceSpectrumFunction* reference : references)
+    {
+        model.AddReference(*reference);
+    }
+    model.AddReference(polynomial);
+
+    measuredError.SetSize(window.specLength);
+    measuredError.Wedge(1, 0);
+    fitRange.SetSize(window.fitHigh - window.fitLow);
+    fittedValues.SetSize(window.fitHigh - window.fitLow);
+}
+
+bool FitWorkspace::IsValidFor(const CFitWindow& window, const std::vector<CReferenceSpectrumFunction*>& references) const
+{
+    return window.specLength == m_specLength &&
+        window.polyOrder == m_polyOrder &&
+        references == m_references;
+}
+
+void FitWorkspace::PrepareFit(SpectrumView measuredData, CVector& xData, int measuredStartChannel, int fitLow, int fitHigh, int numSteps)
+{
+    const int length = static_cast<int>(measuredData.size());
+
+    // MathFit is not const correct, but the target never modifies its data.
+    measured.Attach(const_cast<double*>(measuredData.data()), length, 1, false);
+    fitRange.Copy(xData.SubVector(fitLow, fitHigh - fitLow));
+    fittedValues.SetSize(fitHigh - fitLow);
+
+    // set the data of the measured spectrum in regard to the wavelength information
+    if (measuredError.GetSize() != length)
+    {
+        measuredError.SetSize(length);
+        measuredError.Wedge(1, 0);
+    }
+    auto measuredX = xData.SubVector(measuredStartChannel, length);
+    target.AttachData(measuredX, measured, measuredError);
+
+    // the polynomial is solved for in the linear fit, restart from zero each time
+    polynomial.ResetLinearParameter();
+
+    fit.SetFitRange(fitRange);
+    fit.GetNonlinearMinimizer().SetMaxFitSteps(numSteps);
+    fit.GetNonlinearMinimizer().SetMinChiSquare(0.0001);
+}
+
+}
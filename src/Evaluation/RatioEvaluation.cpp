@@ -149,7 +149,7 @@ DoasResult RunEvaluation(const CFitWindow& window, PreparedInputSpectraForDoasEv
     doas.Setup(localCopyOfWindow);
 
     DoasResult doasResult;
-    doas.Run(spectra.filteredInPlumeSpectrum.data(), spectra.filteredInPlumeSpectrum.size(), doasResult);
+    doas.Run(spectra.filteredInPlumeSpectrum, doasResult);
 
     return doasResult;
 }
@@ -228,13 +228,13 @@ std::vector<Ratio> RatioEvaluation::Run(novac::LogContext context, IScanSpectrum
 
         // Get the pixel-to-wavelength calibration of the out-of-plume-spectrum.
         // TODO: Decide on a better input for this.
-        if (m_masterFitWindow.fraunhoferRef.m_data != nullptr && static_cast<long>(m_masterFitWindow.fraunhoferRef.m_data->m_waveLength.size()) == debugInfo.outOfPlumeSpectrum.m_length)
+        if (m_masterFitWindow.fraunhoferRef.Data() != nullptr && static_cast<long>(m_masterFitWindow.fraunhoferRef.Data()->m_waveLength.size()) == debugInfo.outOfPlumeSpectrum.m_length)
         {
-            debugInfo.outOfPlumeSpectrum.m_wavelength = m_masterFitWindow.fraunhoferRef.m_data->m_waveLength;
+            debugInfo.outOfPlumeSpectrum.m_wavelength = m_masterFitWindow.fraunhoferRef.Data()->m_waveLength;
         }
-        else if (m_masterFitWindow.ref[0].m_data->m_waveLength.size() == m_masterFitWindow.ref[0].m_data->m_crossSection.size())
+        else if (m_masterFitWindow.ref[0].Data()->m_waveLength.size() == m_masterFitWindow.ref[0].Data()->m_crossSection.size())
         {
-            debugInfo.outOfPlumeSpectrum.m_wavelength = m_masterFitWindow.ref[0].m_data->m_waveLength;
+            debugInfo.outOfPlumeSpectrum.m_wavelength = m_masterFitWindow.ref[0].Data()->m_waveLength;
         }
         else
         {
@@ -29,7 +29,7 @@ CReferenceFile& CReferenceFile::operator=(const CReferenceFile& other)
 
     if (other.m_data != nullptr)
     {
-        this->m_data.reset(new CCrossSectionData(*other.m_data));
+        this->m_data = other.m_data;
     }
 
     return *this;
@@ -83,7 +83,7 @@ CReferenceFile::CReferenceFile(const CReferenceFile& other)
 {
     if (other.m_data != nullptr)
     {
-        this->m_data.reset(new CCrossSectionData(*other.m_data));
+        this->m_data = other.m_data;
     }
 }
 
@@ -113,10 +113,30 @@ CReferenceFile::CReferenceFile(CReferenceFile&& other)
 }
 
 CReferenceFile::CReferenceFile(const CCrossSectionData& contents)
-    : m_data(new CCrossSectionData(contents))
+    : m_data(std::make_shared<CCrossSectionData>(contents))
 {
 }
 
+void CReferenceFile::SetData(const CCrossSectionData& data)
+{
+    m_data = std::make_shared<CCrossSectionData>(data);
+}
+
+void CReferenceFile::SetData(std::unique_ptr<CCrossSectionData> data)
+{
+    m_data = std::move(data);
+}
+
+CCrossSectionData& CReferenceFile::MutableData()
+{
+    if (m_data.use_count() != 1)
+    {
+        m_data = std::make_shared<CCrossSectionData>(*m_data);
+    }
+
+    return *m_data;
+}
+
 void CReferenceFile::SetColumn(SHIFT_TYPE option, double value, double value2)
 {
     this->m_columnOption = option;
@@ -157,26 +177,28 @@ int CReferenceFile::ReadCrossSectionDataFromFile()
         return 1;
     }
 
-    m_data.reset(new CCrossSectionData());
-    if (m_data->ReadCrossSectionFile(m_path))
+    auto data = std::make_shared<CCrossSectionData>();
+    if (data->ReadCrossSectionFile(m_path))
     {
         m_data.reset();
         return 1;
     }
 
+    m_data = std::move(data);
     return 0;
 }
 
 int CReferenceFile::ConvolveReference()
 {
-    m_data.reset(new CCrossSectionData());
+    auto data = std::make_shared<CCrossSectionData>();
 
-    if (!::novac::ConvolveReference(m_wavelengthCalibrationFile, m_slitFunctionFile, m_crossSectionFile, *m_data))
+    if (!::novac::ConvolveReference(m_wavelengthCalibrationFile, m_slitFunctionFile, m_crossSectionFile, *data))
     {
         m_data.reset();
         return 1;
     }
 
+    m_data = std::move(data);
     return 0;
 }
 
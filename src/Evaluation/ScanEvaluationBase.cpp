@@ -3,6 +3,7 @@
 #include <SpectralEvaluation/Evaluation/FitWindow.h>
 #include <SpectralEvaluation/Evaluation/EvaluationBase.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <SpectralEvaluation/Spectra/ScanSpectrumReduction.h>
 #include <SpectralEvaluation/Spectra/SpectrometerModel.h>
 #include <SpectralEvaluation/File/ScanFileHandler.h>
 #include <SpectralEvaluation/File/SpectrumIO.h>
@@ -117,39 +118,20 @@ bool ScanEvaluationBase::GetSkySpectrumFromAverageOfGoodSpectra(CScanFileHandler
 {
     const int interlaceSteps = scan.GetInterlaceSteps();
     const int startChannel = scan.GetStartChannel();
-    const int fitLow = m_fitLow / interlaceSteps - startChannel;
-    const int fitHigh = m_fitHigh / interlaceSteps - startChannel;
-    int nofSpectraAveraged = 0;
 
     novac::LogContext context; // TODO: Get from input
 
     CSpectrum tmp;
     scan.GetSky(tmp);
-    scan.ResetCounter();
 
     // Get the maximum intensity of this spectrometer model (with a little bit of margin)
-    const double spectrometerDynamicRange = (CSpectrometerDatabase::GetInstance().GetModel(tmp.m_info.m_specModelName).maximumIntensityForSingleReadout - 20);
+    GoodSpectrumCriteria criteria;
+    criteria.fromPixel = m_fitLow / interlaceSteps - startChannel;
+    criteria.toPixel = m_fitHigh / interlaceSteps - startChannel;
+    criteria.maximumIntensityForSingleReadout = (CSpectrometerDatabase::GetInstance().GetModel(tmp.m_info.m_specModelName).maximumIntensityForSingleReadout - 20);
+    criteria.excludeDarkSpectra = true;
 
-    double spectrumIntensityInFitRegion = tmp.MaxValue(fitLow, fitHigh);
-    if (spectrumIntensityInFitRegion < spectrometerDynamicRange * tmp.NumSpectra() && !tmp.IsDark())
-    {
-        sky = tmp;
-        nofSpectraAveraged = 1;
-    }
-    else
-    {
-        sky.Clear();
-    }
-
-    while (scan.GetNextSpectrum(context, tmp))
-    {
-        spectrumIntensityInFitRegion = tmp.MaxValue(fitLow, fitHigh);
-        if (spectrumIntensityInFitRegion < spectrometerDynamicRange * tmp.NumSpectra() && !tmp.IsDark())
-        {
-            sky.Add(tmp);
-            ++nofSpectraAveraged;
-        }
-    }
+    const int nofSpectraAveraged = SumGoodSpectra(context, scan, criteria, sky);
     scan.ResetCounter();
 
     if (sky.m_info.m_interlaceStep > 1)
@@ -257,7 +239,7 @@ CEvaluationBase* ScanEvaluationBase::FindOptimumShiftAndSqueezeFromFraunhoferRef
     CScanFileHandler& scan)
 {
     // Check that the Fraunhofer reference has been read in
-    if (fitWindow.fraunhoferRef.m_data == nullptr || fitWindow.fraunhoferRef.m_data->m_crossSection.size() == 0)
+    if (fitWindow.fraunhoferRef.Data() == nullptr || fitWindow.fraunhoferRef.Data()->m_crossSection.size() == 0)
     {
         m_log.Information(context, "Cannot determine shift and squeeze from Fraunhofer reference. Reference has no values.");
         return nullptr;
@@ -0,0 +1,497 @@
+#include <SpectralEvaluation/File/EvaluationLogCache.h>
+#include <SpectralEvaluation/File/ScanEvaluationLogFileHandler.h>
+#include <SpectralEvaluation/Evaluation/EvaluationResult.h>
+#include <SpectralEvaluation/StringUtils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdio.h>
+#include <sys/stat.h>
+
+namespace novac
+{
+
+namespace
+{
+    // The first bytes of every cache file, followed by the version of the format.
+    const char cacheFileIdentifier[8] = { 'N', 'O', 'V', 'A', 'C', 'E', 'V', 'C' };
+    const std::uint64_t cacheFileVersion = 1;
+
+    struct CacheFileHeader
+    {
+        char identifier[8];
+        std::uint64_t version;
+        std::uint64_t sourceFileSize;
+        std::int64_t sourceModificationTime;
+        std::uint64_t numberOfScans;
+        std::uint64_t numberOfSpectra;
+        std::uint64_t numberOfSpecies;
+
+        // The length of the specie names, which are stored null-terminated after the header, padded to a multiple of eight bytes.
+        std::uint64_t specieNamesLength;
+    };
+
+    // The columns stored for each spectrum, these are followed by the fit results of each specie.
+    enum SpectrumColumn
+    {
+        SCAN_ANGLE,
+        SCAN_ANGLE2,
+        DELTA,
+        CHI_SQUARE,
+        EVALUATION_STATUS,
+        START_TIME,
+        STOP_TIME,
+        NUMBER_OF_SPECTRUM_COLUMNS
+    };
+
+    // The columns stored for each specie and spectrum.
+    enum SpecieColumn
+    {
+        COLUMN,
+        COLUMN_ERROR,
+        SHIFT,
+        SHIFT_ERROR,
+        SQUEEZE,
+        SQUEEZE_ERROR,
+        NUMBER_OF_SPECIE_COLUMNS
+    };
+
+    size_t NumberOfColumns(size_t numberOfSpecies)
+    {
+        return NUMBER_OF_SPECTRUM_COLUMNS + NUMBER_OF_SPECIE_COLUMNS * numberOfSpecies;
+    }
+
+    size_t SpecieColumnIndex(size_t specieIndex, SpecieColumn column)
+    {
+        return NUMBER_OF_SPECTRUM_COLUMNS + NUMBER_OF_SPECIE_COLUMNS * specieIndex + column;
+    }
+
+    std::int64_t PackTime(const CDateTime& time)
+    {
+        std::int64_t packed = time.year;
+        packed = packed * 100 + time.month;
+        packed = packed * 100 + time.day;
+        packed = packed * 100 + time.hour;
+        packed = packed * 100 + time.minute;
+        packed = packed * 100 + time.second;
+        return packed;
+    }
+
+    CDateTime UnpackTime(std::int64_t packed)
+    {
+        CDateTime time;
+        time.second = static_cast<unsigned char>(packed % 100);
+        packed /= 100;
+        time.minute = static_cast<unsigned char>(packed % 100);
+        packed /= 100;
+        time.hour = static_cast<unsigned char>(packed % 100);
+        packed /= 100;
+        time.day = static_cast<unsigned char>(packed % 100);
+        packed /= 100;
+        time.month = static_cast<unsigned char>(packed % 100);
+        time.year = static_cast<unsigned short>(packed / 100);
+        return time;
+    }
+
+    bool GetFileSizeAndModificationTime(const std::string& fileName, std::uint64_t& size, std::int64_t& modificationTime)
+    {
+        struct stat fileStatus;
+        if (stat(fileName.c_str(), &fileStatus) != 0)
+        {
+            return false;
+        }
+        size = static_cast<std::uint64_t>(fileStatus.st_size);
+        modificationTime = static_cast<std::int64_t>(fileStatus.st_mtime);
+        return true;
+    }
+
+    // The results of the evaluation log, column by column, in the order of the file.
+    struct EvaluationLogColumns
+    {
+        struct Scan
+        {
+            CDateTime skyStartTime;
+            size_t firstSpectrum = 0;
+            size_t numberOfSpectra = 0;
+        };
+
+        std::vector<Scan> scans;
+
+        std::vector<std::string> species;
+
+        // One vector for each of the columns, the integer columns are stored as their bit pattern.
+        std::vector<std::vector<std::uint64_t>> columns;
+
+        void Append(size_t columnIndex, double value)
+        {
+            std::uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            columns[columnIndex].push_back(bits);
+        }
+
+        void Append(size_t columnIndex, std::int64_t value)
+        {
+            columns[columnIndex].push_back(static_cast<std::uint64_t>(value));
+        }
+    };
+
+    // Parses the evaluation log into columns.
+    // @return false if the file could not be parsed or if not all spectra have been evaluated for the same species.
+    //  Species without a name in the evaluation log are taken to be the specie at the same position in the other scans.
+    bool ReadEvaluationLogColumns(const std::string& evaluationLogFile, EvaluationLogColumns& result)
+    {
+        bool allSpeciesAreEqual = true;
+        CScanEvaluationLogFileHandler reader;
+        const bool fileIsOk = reader.ReadEvaluationLog(evaluationLogFile, [&](BasicScanEvaluationResult&& scan)
+            {
+                if (result.columns.empty() && scan.m_spec.size() > 0)
+                {
+                    for (const CReferenceFitResult& reference : scan.m_spec.front().m_referenceResult)
+                    {
+                        result.species.push_back(reference.m_specieName);
+                    }
+                    result.columns.resize(NumberOfColumns(result.species.size()));
+                }
+
+                EvaluationLogColumns::Scan scanLocation;
+                scanLocation.skyStartTime = scan.m_skySpecInfo.m_startTime;
+                scanLocation.firstSpectrum = result.columns.empty() ? 0 : result.columns.front().size();
+                scanLocation.numberOfSpectra = scan.m_spec.size();
+                result.scans.push_back(scanLocation);
+
+                for (size_t spectrumIdx = 0; spectrumIdx < scan.m_spec.size(); ++spectrumIdx)
+                {
+                    const CEvaluationResult& evaluation = scan.m_spec[spectrumIdx];
+                    const CSpectrumInfo& info = scan.m_specInfo[spectrumIdx];
+
+                    if (evaluation.m_referenceResult.size() != result.species.size())
+                    {
+                        allSpeciesAreEqual = false;
+                        return;
+                    }
+                    for (size_t specieIdx = 0; specieIdx < result.species.size(); ++specieIdx)
+                    {
+                        // Some evaluation logs lack the name of the specie for some of the scans, these are matched by position.
+                        const std::string& specieName = evaluation.m_referenceResult[specieIdx].m_specieName;
+                        if (result.species[specieIdx].empty())
+                        {
+                            result.species[specieIdx] = specieName;
+                        }
+                        else if (!specieName.empty() && specieName != result.species[specieIdx])
+                        {
+                            allSpeciesAreEqual = false;
+                            return;
+                        }
+                    }
+
+                    result.Append(SCAN_ANGLE, static_cast<double>(info.m_scanAngle));
+                    result.Append(SCAN_ANGLE2, static_cast<double>(info.m_scanAngle2));
+                    result.Append(DELTA, evaluation.m_delta);
+                    result.Append(CHI_SQUARE, evaluation.m_chiSquare);
+                    result.Append(EVALUATION_STATUS, static_cast<std::int64_t>(evaluation.m_evaluationStatus));
+                    result.Append(START_TIME, PackTime(info.m_startTime));
+                    result.Append(STOP_TIME, PackTime(info.m_stopTime));
+
+                    for (size_t specieIdx = 0; specieIdx < result.species.size(); ++specieIdx)
+                    {
+                        const CReferenceFitResult& reference = evaluation.m_referenceResult[specieIdx];
+                        result.Append(SpecieColumnIndex(specieIdx, COLUMN), reference.m_column);
+                        result.Append(SpecieColumnIndex(specieIdx, COLUMN_ERROR), reference.m_columnError);
+                        result.Append(SpecieColumnIndex(specieIdx, SHIFT), reference.m_shift);
+                        result.Append(SpecieColumnIndex(specieIdx, SHIFT_ERROR), reference.m_shiftError);
+                        result.Append(SpecieColumnIndex(specieIdx, SQUEEZE), reference.m_squeeze);
+                        result.Append(SpecieColumnIndex(specieIdx, SQUEEZE_ERROR), reference.m_squeezeError);
+                    }
+                }
+            });
+
+        return fileIsOk && allSpeciesAreEqual;
+    }
+
+    // Creates the contents of the cache file from the columns of the evaluation log.
+    //  The scans are sorted by the start time of the sky spectrum, in the same way as CScanEvaluationLogFileHandler does.
+    void CreateCacheContents(const EvaluationLogColumns& evaluationLog, std::uint64_t sourceFileSize, std::int64_t sourceModificationTime, std::vector<std::uint64_t>& contents)
+    {
+        std::vector<size_t> scanOrder(evaluationLog.scans.size());
+        std::iota(begin(scanOrder), end(scanOrder), size_t(0));
+        std::stable_sort(begin(scanOrder), end(scanOrder), [&](size_t first, size_t second)
+            {
+                return evaluationLog.scans[first].skyStartTime < evaluationLog.scans[second].skyStartTime;
+            });
+
+        std::string specieNames;
+        for (const std::string& specie : evaluationLog.species)
+        {
+            specieNames.append(specie);
+            specieNames.push_back('\0');
+        }
+        specieNames.resize(8 * ((specieNames.size() + 7) / 8), '\0');
+
+        CacheFileHeader header;
+        memcpy(header.identifier, cacheFileIdentifier, sizeof(header.identifier));
+        header.version = cacheFileVersion;
+        header.sourceFileSize = sourceFileSize;
+        header.sourceModificationTime = sourceModificationTime;
+        header.numberOfScans = evaluationLog.scans.size();
+        header.numberOfSpectra = evaluationLog.columns.empty() ? 0 : evaluationLog.columns.front().size();
+        header.numberOfSpecies = evaluationLog.species.size();
+        header.specieNamesLength = specieNames.size();
+
+        contents.clear();
+        contents.resize(sizeof(header) / 8 + specieNames.size() / 8);
+        memcpy(contents.data(), &header, sizeof(header));
+        memcpy(contents.data() + sizeof(header) / 8, specieNames.data(), specieNames.size());
+
+        // The offset of the first spectrum of each scan, with one extra element at the end.
+        std::uint64_t offset = 0;
+        for (size_t scanIdx : scanOrder)
+        {
+            contents.push_back(offset);
+            offset += evaluationLog.scans[scanIdx].numberOfSpectra;
+        }
+        contents.push_back(offset);
+
+        for (size_t scanIdx : scanOrder)
+        {
+            contents.push_back(static_cast<std::uint64_t>(PackTime(evaluationLog.scans[scanIdx].skyStartTime)));
+        }
+
+        for (const std::vector<std::uint64_t>& column : evaluationLog.columns)
+        {
+            for (size_t scanIdx : scanOrder)
+            {
+                const auto first = column.begin() + evaluationLog.scans[scanIdx].firstSpectrum;
+                contents.insert(contents.end(), first, first + evaluationLog.scans[scanIdx].numberOfSpectra);
+            }
+        }
+    }
+
+    // Writes the contents to the given file. The contents are first written to a temporary file
+    //  such that a partially written cache file is never read.
+    bool WriteCacheFile(const std::string& cacheFile, const std::vector<std::uint64_t>& contents)
+    {
+        const std::string temporaryFile = cacheFile + ".tmp";
+        FILE* f = fopen(temporaryFile.c_str(), "wb");
+        if (f == nullptr)
+        {
+            return false;
+        }
+        const size_t written = fwrite(contents.data(), sizeof(std::uint64_t), contents.size(), f);
+        const bool closedOk = (fclose(f) == 0);
+        if (written != contents.size() || !closedOk)
+        {
+            remove(temporaryFile.c_str());
+            return false;
+        }
+
+        remove(cacheFile.c_str());
+        if (rename(temporaryFile.c_str(), cacheFile.c_str()) != 0)
+        {
+            remove(temporaryFile.c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+bool CachedScanResult::IsBad(size_t spectrumIndex) const
+{
+    return (evaluationStatus[spectrumIndex] & MARK_BAD_EVALUATION) != 0;
+}
+
+CDateTime CachedScanResult::StartTime(size_t spectrumIndex) const
+{
+    return UnpackTime(startTime[spectrumIndex]);
+}
+
+CDateTime CachedScanResult::StopTime(size_t spectrumIndex) const
+{
+    return UnpackTime(stopTime[spectrumIndex]);
+}
+
+std::string EvaluationLogCache::GetCacheFileName(const std::string& evaluationLogFile)
+{
+    return evaluationLogFile + ".evcache";
+}
+
+bool EvaluationLogCache::Open(const std::string& evaluationLogFile)
+{
+    return Open(evaluationLogFile, GetCacheFileName(evaluationLogFile));
+}
+
+bool EvaluationLogCache::Open(const std::string& evaluationLogFile, const std::string& cacheFile)
+{
+    Close();
+
+    std::uint64_t sourceFileSize = 0;
+    std::int64_t sourceModificationTime = 0;
+    if (!GetFileSizeAndModificationTime(evaluationLogFile, sourceFileSize, sourceModificationTime))
+    {
+        return false;
+    }
+
+    // Use the existing cache file, if it is up to date.
+    if (m_file.Open(cacheFile))
+    {
+        m_data = m_file.Data();
+        m_size = m_file.Size();
+        if (ReadContents(sourceFileSize, sourceModificationTime))
+        {
+            m_isReadFromCacheFile = true;
+            return true;
+        }
+        Close();
+    }
+
+    // Parse the evaluation log and (re-)create the cache file.
+    EvaluationLogColumns evaluationLog;
+    if (!ReadEvaluationLogColumns(evaluationLogFile, evaluationLog))
+    {
+        return false;
+    }
+    CreateCacheContents(evaluationLog, sourceFileSize, sourceModificationTime, m_contents);
+
+    // The results are used from memory, also when the cache file could not be written.
+    (void)WriteCacheFile(cacheFile, m_contents);
+
+    m_data = reinterpret_cast<const std::uint8_t*>(m_contents.data());
+    m_size = m_contents.size() * sizeof(std::uint64_t);
+    if (!ReadContents(sourceFileSize, sourceModificationTime))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void EvaluationLogCache::Close()
+{
+    m_file.Close();
+    m_contents.clear();
+    m_contents.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+    m_isReadFromCacheFile = false;
+    m_numberOfScans = 0;
+    m_numberOfSpectra = 0;
+    m_species.clear();
+}
+
+bool EvaluationLogCache::ReadContents(std::uint64_t sourceFileSize, std::int64_t sourceModificationTime)
+{
+    CacheFileHeader header;
+    if (m_data == nullptr || m_size < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, m_data, sizeof(header));
+
+    if (memcmp(header.identifier, cacheFileIdentifier, sizeof(header.identifier)) != 0 ||
+        header.version != cacheFileVersion ||
+        header.sourceFileSize != sourceFileSize ||
+        header.sourceModificationTime != sourceModificationTime ||
+        header.specieNamesLength % 8 != 0)
+    {
+        return false;
+    }
+
+    const std::uint64_t expectedSize = sizeof(header) + header.specieNamesLength +
+        8 * (2 * header.numberOfScans + 1) +
+        8 * header.numberOfSpectra * NumberOfColumns(header.numberOfSpecies);
+    if (m_size != expectedSize)
+    {
+        return false;
+    }
+
+    m_species.clear();
+    const char* specieName = reinterpret_cast<const char*>(m_data + sizeof(header));
+    const char* specieNamesEnd = specieName + header.specieNamesLength;
+    for (std::uint64_t specieIdx = 0; specieIdx < header.numberOfSpecies; ++specieIdx)
+    {
+        const char* nameEnd = static_cast<const char*>(memchr(specieName, '\0', specieNamesEnd - specieName));
+        if (nameEnd == nullptr)
+        {
+            return false;
+        }
+        m_species.push_back(std::string(specieName, nameEnd));
+        specieName = nameEnd + 1;
+    }
+
+    m_numberOfScans = static_cast<size_t>(header.numberOfScans);
+    m_numberOfSpectra = static_cast<size_t>(header.numberOfSpectra);
+
+    return ScanOffsets()[m_numberOfScans] == m_numberOfSpectra;
+}
+
+const std::uint64_t* EvaluationLogCache::ScanOffsets() const
+{
+    CacheFileHeader header;
+    memcpy(&header, m_data, sizeof(header));
+    return reinterpret_cast<const std::uint64_t*>(m_data + sizeof(header) + header.specieNamesLength);
+}
+
+const std::uint8_t* EvaluationLogCache::Column(size_t columnIndex) const
+{
+    // The columns follow the offsets and sky start times of the scans.
+    const std::uint8_t* firstColumn = reinterpret_cast<const std::uint8_t*>(ScanOffsets() + 2 * m_numberOfScans + 1);
+    return firstColumn + 8 * m_numberOfSpectra * columnIndex;
+}
+
+int EvaluationLogCache::GetSpecieIndex(const std::string& specieName) const
+{
+    for (size_t specieIdx = 0; specieIdx < m_species.size(); ++specieIdx)
+    {
+        if (EqualsIgnoringCase(m_species[specieIdx], specieName))
+        {
+            return static_cast<int>(specieIdx);
+        }
+    }
+    return -1;
+}
+
+CachedScanResult EvaluationLogCache::GetScan(size_t scanIndex) const
+{
+    const std::uint64_t* scanOffsets = ScanOffsets();
+    const size_t firstSpectrum = static_cast<size_t>(scanOffsets[scanIndex]);
+    const std::int64_t* skyStartTimes = reinterpret_cast<const std::int64_t*>(scanOffsets + m_numberOfScans + 1);
+
+    auto doubleColumn = [&](size_t columnIndex) { return reinterpret_cast<const double*>(Column(columnIndex)) + firstSpectrum; };
+    auto integerColumn = [&](size_t columnIndex) { return reinterpret_cast<const std::int64_t*>(Column(columnIndex)) + firstSpectrum; };
+
+    CachedScanResult result;
+    result.numberOfSpectra = static_cast<size_t>(scanOffsets[scanIndex + 1]) - firstSpectrum;
+    result.skyStartTime = UnpackTime(skyStartTimes[scanIndex]);
+    result.scanAngle = doubleColumn(SCAN_ANGLE);
+    result.scanAngle2 = doubleColumn(SCAN_ANGLE2);
+    result.delta = doubleColumn(DELTA);
+    result.chiSquare = doubleColumn(CHI_SQUARE);
+    result.evaluationStatus = integerColumn(EVALUATION_STATUS);
+    result.startTime = integerColumn(START_TIME);
+    result.stopTime = integerColumn(STOP_TIME);
+
+    for (size_t specieIdx = 0; specieIdx < m_species.size(); ++specieIdx)
+    {
+        result.column.push_back(doubleColumn(SpecieColumnIndex(specieIdx, COLUMN)));
+        result.columnError.push_back(doubleColumn(SpecieColumnIndex(specieIdx, COLUMN_ERROR)));
+        result.shift.push_back(doubleColumn(SpecieColumnIndex(specieIdx, SHIFT)));
+        result.shiftError.push_back(doubleColumn(SpecieColumnIndex(specieIdx, SHIFT_ERROR)));
+        result.squeeze.push_back(doubleColumn(SpecieColumnIndex(specieIdx, SQUEEZE)));
+        result.squeezeError.push_back(doubleColumn(SpecieColumnIndex(specieIdx, SQUEEZE_ERROR)));
+    }
+
+    return result;
+}
+
+std::vector<double> GetColumns(const CachedScanResult& result, int specieIndex)
+{
+    if (specieIndex < 0 || result.numberOfSpectra == 0 || result.column.size() <= (size_t)specieIndex)
+    {
+        return std::vector<double>();
+    }
+
+    const double* columns = result.column[specieIndex];
+    return std::vector<double>(columns, columns + result.numberOfSpectra);
+}
+
+}
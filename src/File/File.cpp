@@ -3,6 +3,7 @@
 #include <SpectralEvaluation/File/File.h>
 #include <SpectralEvaluation/File/STDFile.h>
 #include <SpectralEvaluation/File/TXTFile.h>
+#include <SpectralEvaluation/File/TextFileReader.h>
 #include <SpectralEvaluation/Evaluation/CrossSectionData.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/Calibration/InstrumentCalibration.h>
@@ -55,15 +56,32 @@ std::string ReadEntireFile(const std::string& filename)
     return buffer;
 }
 
-// @return the number of columns read.
-int ReadFromFile(FILE* f, const char* formatStr, double& col1, double& col2)
+// Reads the next row of values from the file, in the same way as fscanf(f, formatStr, &col1, &col2)
+//  where the format is one of the formats returned from GetFileFormat.
+// @return the number of columns read, or EOF if the end of the file was reached before reading any value.
+int ReadFromFile(TextFileReader& file, const char* formatStr, double& col1, double& col2)
 {
-    int nCols = fscanf(f, formatStr, &col1, &col2);
-    if (nCols != 0)
+    file.SkipWhitespace();
+    if (file.IsAtEnd())
     {
-        return nCols;
+        return EOF;
     }
-    return 0;
+    if (!file.ReadDouble(col1))
+    {
+        return 0;
+    }
+    if (0 == strcmp(formatStr, "%lf"))
+    {
+        return 1;
+    }
+
+    // The character separating the two columns, i.e. ' ', ',' or ';'
+    const char separator = formatStr[3];
+    if (separator != ' ' && !file.ReadCharacter(separator))
+    {
+        return 1;
+    }
+    return file.ReadDouble(col2) ? 2 : 1;
 }
 
 int GetFileFormat(const char* string, char* format)
@@ -135,8 +153,8 @@ bool ReadCrossSectionFile(const std::string& fullFilePath, CCrossSectionData& re
         return ReadCrossSectionFromStdFile(fullFilePath, result, saveAsWavelength);
     }
 
-    FILE* f = fopen(fullFilePath.c_str(), "r");
-    if (nullptr == f)
+    TextFileReader file;
+    if (!file.Open(fullFilePath))
     {
         return false;
     }
@@ -144,25 +162,28 @@ bool ReadCrossSectionFile(const std::string& fullFilePath, CCrossSectionData& re
     // Get the file-format and number of columns from the file.
     char tempBuffer[8192];
     char format[256];
-    if (nullptr == fgets(tempBuffer, 8191, f))
+    if (!file.ReadLine(tempBuffer, 8191))
     {
-        fclose(f);
         return false;
     }
 
     const int numColumns = GetFileFormat(tempBuffer, format);
+    if (numColumns == 0)
+    {
+        return true; // the file does not start with a row of values, there is nothing we can read.
+    }
 
-    fseek(f, 0, SEEK_SET);
+    file.Rewind();
 
     // Make some space
     result.m_crossSection.reserve(2050);
     result.m_waveLength.reserve(2050);
 
-    while (!feof(f))
+    while (!file.IsAtEnd())
     {
         double col1 = 0.0;
         double col2 = 0.0;
-        int nCols = ReadFromFile(f, format, col1, col2);
+        int nCols = ReadFromFile(file, format, col1, col2);
 
         if (nCols != numColumns)
         {
@@ -183,8 +204,6 @@ bool ReadCrossSectionFile(const std::string& fullFilePath, CCrossSectionData& re
         }
     }
 
-    fclose(f);
-
     return true;
 }
 
@@ -1,5 +1,7 @@
 #include <SpectralEvaluation/File/MKPack.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <algorithm>
+#include <array>
 
 namespace novac
 {
@@ -206,5 +208,193 @@ namespace novac
 
         return(lentofile);
     }
-}
 
+    // ---------------------------------------------------------------------------------
+    // -------------- The word based decoder of the compressed spectra -----------------
+    // ---------------------------------------------------------------------------------
+
+    // The compressed spectrum consists of segments, each starting with a header of 'headsiz' (12) bits
+    //  where the first 7 bits are the number of values in the segment and the last 5 bits are the number of bits per value.
+    //  The values are the (sign extended) differences between consecutive pixels, stored with the most significant bit first.
+    namespace
+    {
+        struct SegmentHeader
+        {
+            std::uint8_t length;        // the number of values in the segment
+            std::uint8_t bitsPerValue;  // the number of bits in each value
+            std::uint8_t valuesPerRead; // the number of values which can be read from one refill of the bit reader
+            std::uint16_t payloadBits;  // the total number of bits in the values of the segment
+        };
+
+        std::array<SegmentHeader, (1 << headsiz)> CreateSegmentHeaderTable()
+        {
+            std::array<SegmentHeader, (1 << headsiz)> table;
+            for (size_t header = 0; header < table.size(); ++header)
+            {
+                const std::uint8_t bitsPerValue = (std::uint8_t)(header & 0x1f);
+                table[header].length = (std::uint8_t)(header >> 5);
+                table[header].bitsPerValue = bitsPerValue;
+                table[header].valuesPerRead = (std::uint8_t)((bitsPerValue == 0) ? 0 : 56 / bitsPerValue);
+                table[header].payloadBits = (std::uint16_t)(table[header].length * bitsPerValue);
+            }
+            return table;
+        }
+
+        const std::array<SegmentHeader, (1 << headsiz)>& SegmentHeaderTable()
+        {
+            static const std::array<SegmentHeader, (1 << headsiz)> table = CreateSegmentHeaderTable();
+            return table;
+        }
+
+        /** Reads bits, most significant bit first, from a buffer of bytes.
+            The bits are kept in a 64 bit word, aligned to the most significant bit, which is refilled
+            a whole word at a time except at the very end of the buffer. */
+        class BitReader
+        {
+        public:
+            BitReader(const std::uint8_t* data, size_t size)
+                : m_position(data), m_end(data + size), m_bitsRemaining((std::uint64_t)size * 8)
+            {
+            }
+
+            /** Fills up the word such that at least 56 bits can be read before the next refill. */
+            inline void Refill()
+            {
+                if (m_end - m_position >= 8)
+                {
+                    const std::uint64_t word =
+                        ((std::uint64_t)m_position[0] << 56) | ((std::uint64_t)m_position[1] << 48) |
+                        ((std::uint64_t)m_position[2] << 40) | ((std::uint64_t)m_position[3] << 32) |
+                        ((std::uint64_t)m_position[4] << 24) | ((std::uint64_t)m_position[5] << 16) |
+                        ((std::uint64_t)m_position[6] << 8) | ((std::uint64_t)m_position[7]);
+                    m_word |= word >> m_bitsInWord;
+                    m_position += (63 - m_bitsInWord) >> 3;
+                    m_bitsInWord |= 56;
+                }
+                else
+                {
+                    // The end of the buffer, continue with zeros once the data runs out.
+                    while (m_bitsInWord <= 56)
+                    {
+                        const std::uint64_t byte = (m_position < m_end) ? *m_position++ : 0;
+                        m_word |= byte << (56 - m_bitsInWord);
+                        m_bitsInWord += 8;
+                    }
+                }
+            }
+
+            /** @return true if there are at least 'bits' more bits to read in the buffer. */
+            inline bool HasBits(std::uint64_t bits) const
+            {
+                return bits <= m_bitsRemaining;
+            }
+
+            /** Reads an unsigned value of 'bits' (1 to 32) bits. */
+            inline std::uint32_t ReadUnsigned(int bits)
+            {
+                const std::uint32_t value = (std::uint32_t)(m_word >> (64 - bits));
+                Consume(bits);
+                return value;
+            }
+
+            /** Reads a two's complement value of 'bits' (1 to 32) bits. */
+            inline std::int64_t ReadSigned(int bits)
+            {
+                const std::int64_t value = (std::int64_t)m_word >> (64 - bits);
+                Consume(bits);
+                return value;
+            }
+
+        private:
+            inline void Consume(int bits)
+            {
+                m_word <<= bits;
+                m_bitsInWord -= bits;
+                m_bitsRemaining -= bits;
+            }
+
+            const std::uint8_t* m_position;
+            const std::uint8_t* m_end;
+            std::uint64_t m_bitsRemaining;
+            std::uint64_t m_word = 0;
+            int m_bitsInWord = 0;
+        };
+
+        template<class T>
+        long UnPackWords(const std::uint8_t* compressed, size_t compressedSize, long pixels, T* result)
+        {
+            if (compressed == nullptr || result == nullptr || pixels < 0)
+            {
+                return -1;
+            }
+
+            const SegmentHeader* headerTable = SegmentHeaderTable().data();
+            BitReader reader(compressed, compressedSize);
+
+            // The values are the differences between consecutive pixels, this is the sum of all values so far.
+            std::int64_t value = 0;
+            long pixelsWritten = 0;
+
+            while (pixelsWritten < pixels)
+            {
+                reader.Refill();
+                if (!reader.HasBits(headsiz))
+                {
+                    return -1;
+                }
+                const SegmentHeader segment = headerTable[reader.ReadUnsigned(headsiz)];
+
+                // Validate the entire segment at once, such that the values can be read without any further checks.
+                if (pixelsWritten + segment.length > pixels || !reader.HasBits(segment.payloadBits))
+                {
+                    return -1;
+                }
+
+                T* output = result + pixelsWritten;
+                pixelsWritten += segment.length;
+
+                if (segment.bitsPerValue == 0)
+                {
+                    // All differences are zero
+                    std::fill(output, output + segment.length, (T)value);
+                    continue;
+                }
+
+                int remaining = segment.length;
+                while (remaining > 0)
+                {
+                    reader.Refill();
+                    const int count = std::min(remaining, (int)segment.valuesPerRead);
+                    for (int ii = 0; ii < count; ++ii)
+                    {
+                        value += reader.ReadSigned(segment.bitsPerValue);
+                        *output++ = (T)value;
+                    }
+                    remaining -= count;
+                }
+            }
+
+            return pixelsWritten;
+        }
+    }
+
+    long MKPack::UnPack(const std::uint8_t* compressed, size_t compressedSize, long pixels, std::int32_t* result)
+    {
+        return UnPackWords(compressed, compressedSize, pixels, result);
+    }
+
+    long MKPack::UnPack(const std::uint8_t* compressed, size_t compressedSize, long pixels, double* result)
+    {
+        return UnPackWords(compressed, compressedSize, pixels, result);
+    }
+
+    std::uint16_t MKPack::Checksum(const double* values, long length)
+    {
+        std::uint32_t chk = 0;
+        for (long j = 0; j < length; j++)
+        {
+            chk += (std::uint32_t)(std::int64_t)values[j];
+        }
+        return (std::uint16_t)((chk & 0xFFFF) + (chk >> 16));
+    }
+}
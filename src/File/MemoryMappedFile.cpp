@@ -0,0 +1,146 @@
+#include <SpectralEvaluation/File/MemoryMappedFile.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#undef min
+#undef max
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace novac
+{
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MemoryMappedFile::Open(const std::string& fileName)
+{
+    Close();
+
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_isOpen = true;
+
+    if (m_size == 0)
+    {
+        // Empty files cannot be mapped, but are still valid to open.
+        return true;
+    }
+
+    m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MemoryMappedFile::Close()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle != nullptr)
+    {
+        CloseHandle(m_mappingHandle);
+    }
+    if (m_fileHandle != nullptr)
+    {
+        CloseHandle(m_fileHandle);
+    }
+
+    m_data = nullptr;
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+}
+
+#else
+
+bool MemoryMappedFile::Open(const std::string& fileName)
+{
+    Close();
+
+    const int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        close(fileDescriptor);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(fileStatus.st_size);
+
+    if (m_size > 0)
+    {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fileDescriptor);
+            m_size = 0;
+            return false;
+        }
+
+        m_data = static_cast<const std::uint8_t*>(data);
+    }
+
+    // The mapping stays valid after the file is closed.
+    close(fileDescriptor);
+    m_isOpen = true;
+
+    return true;
+}
+
+void MemoryMappedFile::Close()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<std::uint8_t*>(m_data), m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+}
+
+#endif // _WIN32
+
+}
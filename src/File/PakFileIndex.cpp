@@ -0,0 +1,142 @@
+#include <SpectralEvaluation/File/PakFileIndex.h>
+#include <SpectralEvaluation/File/SpectrumIO.h>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <cstring>
+#include <algorithm>
+
+#undef min
+#undef max
+
+namespace novac
+{
+
+PakFileIndex::PakFileIndex()
+{
+    m_lastError = CSpectrumIO::ERROR_NO_ERROR;
+}
+
+bool PakFileIndex::Open(const std::string& fileName)
+{
+    Close();
+
+    if (!m_file.Open(fileName))
+    {
+        m_lastError = CSpectrumIO::ERROR_COULD_NOT_OPEN_FILE;
+        return false;
+    }
+    m_fileName = fileName;
+
+    const std::uint8_t* data = m_file.Data();
+    const size_t fileSize = m_file.Size();
+    const size_t skipLimit = 4 * MAX_SPECTRUM_LENGTH;
+
+    // Walk through the file in the same way as CSpectrumIO does, such that the spectra are numbered identically.
+    size_t position = 0;
+    while (position + 8 <= fileSize)
+    {
+        // check that we are actually at the beginning of a header, otherwise continue with the next eight bytes.
+        if (0 != memcmp(data + position, "MKZY", 4))
+        {
+            position += 8;
+            continue;
+        }
+
+        SpectrumLocation location;
+        memset(&location.header, 0, sizeof(location.header));
+        location.header.measureidx = -1; // this is for compatibility reasons, if the file does not contain spectrum number, we'll know about it
+
+        std::uint16_t headerSize = 0;
+        memcpy(&headerSize, data + position + 4, sizeof(headerSize));
+
+        // Only read as much of the header as this version of the header can understand.
+        const size_t readableHeaderSize = std::min((size_t)headerSize, sizeof(MKZYhdr));
+        if (readableHeaderSize < 8 || position + readableHeaderSize > fileSize)
+        {
+            break;
+        }
+        memcpy(&location.header, data + position, readableHeaderSize);
+        position += std::max((size_t)headerSize, readableHeaderSize);
+
+        location.dataOffset = position;
+        m_spectra.push_back(location);
+
+        // Jump to the next spectrum, but only if there is a header there.
+        //  Otherwise search for the next header starting from the beginning of the compressed data.
+        const size_t nextPosition = position + std::min((size_t)location.header.size, skipLimit);
+        if (nextPosition + 4 <= fileSize && 0 == memcmp(data + nextPosition, "MKZY", 4))
+        {
+            position = nextPosition;
+        }
+    }
+
+    m_lastError = CSpectrumIO::ERROR_NO_ERROR;
+    return true;
+}
+
+void PakFileIndex::Close()
+{
+    m_file.Close();
+    m_spectra.clear();
+    m_fileName.clear();
+}
+
+const std::uint8_t* PakFileIndex::GetCompressedData(size_t index) const
+{
+    return m_file.Data() + m_spectra[index].dataOffset;
+}
+
+std::string PakFileIndex::GetSpectrumName(size_t index) const
+{
+    const MKZYhdr& header = m_spectra[index].header;
+    return std::string(header.name, strnlen(header.name, sizeof(header.name)));
+}
+
+bool PakFileIndex::GetSpectrum(size_t index, CSpectrum& spec)
+{
+    m_lastError = ReadSpectrum(index, spec);
+    return (m_lastError == CSpectrumIO::ERROR_NO_ERROR);
+}
+
+int PakFileIndex::ReadSpectrum(size_t index, CSpectrum& spec) const
+{
+    if (index >= m_spectra.size())
+    {
+        return CSpectrumIO::ERROR_SPECTRUM_NOT_FOUND;
+    }
+
+    const SpectrumLocation& location = m_spectra[index];
+    const MKZYhdr& header = location.header;
+
+    if (location.dataOffset + header.size > m_file.Size())
+    {
+        return CSpectrumIO::ERROR_EOF;
+    }
+
+    // This sizes the spectrum to hold all the pixels
+    CSpectrumIO::ParseSpectrumHeader(header, spec);
+
+    // Decompress the spectrum directly from the mapped file into the spectrum data.
+    const long outlen = MKPack::UnPack(GetCompressedData(index), header.size, header.pixels, spec.m_data);
+    if (outlen < 0)
+    {
+        return CSpectrumIO::ERROR_DECOMPRESS;
+    }
+
+    // calculate the checksum
+    const std::uint16_t checksum = MKPack::Checksum(spec.m_data, outlen);
+    if (checksum != header.checksum)
+    {
+        return CSpectrumIO::ERROR_CHECKSUM_MISMATCH;
+    }
+
+    // Get the maximum intensity
+    if (header.pixels > 0)
+    {
+        spec.m_info.m_peakIntensity = (float)spec.MaxValue();
+        spec.m_info.m_offset = (float)spec.GetOffset();
+    }
+
+    return CSpectrumIO::ERROR_NO_ERROR;
+}
+
+}
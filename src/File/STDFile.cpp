@@ -1,9 +1,11 @@
 #include <SpectralEvaluation/File/STDFile.h>
+#include <SpectralEvaluation/File/TextFileReader.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/StringUtils.h>
 #include <algorithm>
 #include <cstring>
 #include <cmath>
+#include <stdlib.h>
 
 #include <iostream>
 
@@ -60,13 +62,15 @@ namespace novac
                 pt = strstr(pt, "])") + strlen("])");
             }
             // read array of space separated values
+            //  (using strtod rather than sscanf, since sscanf takes the length of the entire remaining string for each value)
             const char* nextSeparator = pt;
-            double temporaryDouble = 0.0;
             while (nextSeparator != nullptr)
             {
-                if (sscanf(nextSeparator, "%lf", &temporaryDouble) == 1)
+                char* valueEnd = nullptr;
+                const double value = strtod(nextSeparator, &valueEnd);
+                if (valueEnd != nextSeparator)
                 {
-                    values.push_back(temporaryDouble);
+                    values.push_back(value);
                 }
                 nextSeparator = strstr(nextSeparator + 1, " ");
             }
@@ -100,8 +104,8 @@ namespace novac
             extendedInformation.Clear();
             spec.m_wavelength.clear();
 
-            FILE* f = fopen(fileName.c_str(), "r");
-            if (f == nullptr)
+            TextFileReader f;
+            if (!f.Open(fileName))
             {
                 throw std::invalid_argument("failed to open file.");
             }
@@ -114,82 +118,77 @@ namespace novac
             spec.Clear();
 
             // 1. the "GDBGMNUP" string that identifies a STD-file
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read mandatory header.");
             }
             if (0 != strncmp("GDBGMNUP", buffer, strlen("GDBGMNUP")))
             {
-                fclose(f);
                 throw std::invalid_argument("File does not contain mandatory header.");
             }
 
             // 2. The version number (always 1)
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("File does not contain mandatory version.");
             }
 
             // 3. The spectrum length
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("File does not contain mandatory length.");
             }
             if (1 > sscanf(buffer, "%d", &tmpInt))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read first value.");
             }
-            spec.m_length = std::min((long)tmpInt, (long)MAX_SPECTRUM_LENGTH);
+            if (tmpInt > MAX_SPECTRUM_LENGTH)
+            {
+                throw std::invalid_argument("The spectrum length is larger than the maximum supported length.");
+            }
+            spec.Resize(std::max(tmpInt, 0));
 
             // 4. The spectrum data
             for (int i = 0; i < spec.m_length; ++i)
             {
-                if (nullptr == fgets(buffer, bufSize, f))
+                if (!f.ReadLine(buffer, bufSize))
                 {
-                    fclose(f);
                     throw std::invalid_argument("File does not contain enough values.");
                 }
-                if (1 > sscanf(buffer, "%lf", &tmpDbl))
+                char* valueEnd = nullptr;
+                tmpDbl = strtod(buffer, &valueEnd);
+                if (valueEnd == buffer)
                 {
-                    fclose(f);
                     throw std::invalid_argument("Failed to parse data.");
                 }
                 spec.m_data[i] = tmpDbl;
             }
 
             // 5. The fileName (ignore)
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to parse filename.");
             }
 
             // 6. The detector (ignore)
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to parse spectrometer model.");
             }
             spec.m_info.m_specModelName = std::string(buffer);
             Trim(spec.m_info.m_specModelName, " \t\r\n"); // remove initial and trailing spaces and newline characters
 
             // 7. The spectrometer
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to parse spectrometer name.");
             }
             spec.m_info.m_device = std::string(buffer);
             Trim(spec.m_info.m_device, " \t\r\n"); // remove initial and trailing spaces and newline characters
 
             // 8. The date
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read date.");
             }
             if (strstr(buffer, "/"))
@@ -197,14 +196,12 @@ namespace novac
                 // DOASIS sometimes writes the date as MM/DD/YYYY
                 if (3 > sscanf(buffer, "%d/%d/%d", &tmpInt2, &tmpInt3, &tmpInt))
                 {
-                    fclose(f);
                     throw std::invalid_argument("Failed to parse date.");
                 }
             }
             else {
                 if (3 > sscanf(buffer, "%d.%d.%d", &tmpInt3, &tmpInt2, &tmpInt))
                 {
-                    fclose(f);
                     throw std::invalid_argument("Failed to parse date.");
                 }
             }
@@ -224,9 +221,8 @@ namespace novac
             spec.m_info.m_stopTime.day = spec.m_info.m_startTime.day;
 
             // 9. The starttime
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read starttime.");
             }
             if (3 > sscanf(buffer, "%d:%d:%d", &tmpInt, &tmpInt2, &tmpInt3))
@@ -239,14 +235,12 @@ namespace novac
             }
 
             // 10. The stoptime
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read stop time.");
             }
             if (3 > sscanf(buffer, "%d:%d:%d", &tmpInt, &tmpInt2, &tmpInt3))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to parse stop time.");
             }
             spec.m_info.m_stopTime.hour = (unsigned char)tmpInt;
@@ -254,76 +248,69 @@ namespace novac
             spec.m_info.m_stopTime.second = (unsigned char)tmpInt3;
 
             // 11. The start wavelength (ignore)
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read first wavelength.");
             }
 
             // 12. The stop wavelength (ignore)
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read last wavelength.");
             }
 
             // 13. The number of scans
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read number of scans.");
             }
             if (1 > sscanf(buffer, "SCANS %d", &tmpInt))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to parse number of scans.");
             }
             spec.m_info.m_numSpec = tmpInt;
 
             // 14. The integration time
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read integration time.");
             }
             if (1 > sscanf(buffer, "INT_TIME %lf", &tmpDbl))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to parse integration time.");
             }
             spec.m_info.m_exposureTime = (int)tmpDbl;
 
             // 15. The site
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read site.");
             }
             buffer[strlen(buffer) - 1] = 0; // <-- Remove the trailing newline character
+            if (strlen(buffer) > 0 && buffer[strlen(buffer) - 1] == '\r')
+            {
+                buffer[strlen(buffer) - 1] = 0; // <-- and the carriage return, the file is not read in text mode.
+            }
             spec.m_info.m_name = std::string(buffer + 5);
 
             // 15. The longitude
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read longitude.");
             }
             if (1 > sscanf(buffer, "LONGITUDE %lf", &tmpDbl))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to parse longitude.");
             }
             spec.m_info.m_gps.m_longitude = tmpDbl;
 
             // 15. The latitude
-            if (nullptr == fgets(buffer, bufSize, f))
+            if (!f.ReadLine(buffer, bufSize))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to read latitude.");
             }
             if (1 > sscanf(buffer, "LATITUDE %lf", &tmpDbl))
             {
-                fclose(f);
                 throw std::invalid_argument("Failed to parse latitude.");
             }
             spec.m_info.m_gps.m_latitude = tmpDbl;
@@ -332,7 +319,7 @@ namespace novac
             // - if the file is in the extended STD-format then we can continue here... -
 
             std::vector<char> szLine(65535);
-            while (fgets(szLine.data(), (int)szLine.size(), f))
+            while (f.ReadLine(szLine.data(), (int)szLine.size()))
             {
                 // Read in scanAngle
                 if (AttemptParseDouble(szLine, elevationAngleStr, tmpDbl))
@@ -425,7 +412,6 @@ namespace novac
                 spec.m_info.m_gps.m_longitude = CGPSData::DoubleToAngle(spec.m_info.m_gps.m_longitude);
             }
 
-            fclose(f);
             return true;
         }
         catch (std::exception& e)
@@ -1,10 +1,11 @@
 #include <SpectralEvaluation/File/ScanEvaluationLogFileHandler.h>
+#include <SpectralEvaluation/File/MemoryMappedFile.h>
 #include <SpectralEvaluation/Spectra/SpectrometerModel.h>
 #include <SpectralEvaluation/StringUtils.h>
 
 #include <algorithm>
-#include <numeric> // std::iota
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 using namespace novac;
@@ -28,22 +29,23 @@ CScanEvaluationLogFileHandler::~CScanEvaluationLogFileHandler(void)
     m_scan.clear();
 }
 
-void CScanEvaluationLogFileHandler::ParseScanHeader(const char szLine[8192])
+void CScanEvaluationLogFileHandler::ParseScanHeader(const char* szLine, size_t length)
 {
     // reset some old information
     ResetColumns();
 
-    char str[8192];
-    if (szLine[0] == '#')
+    // The header is tokenized in place, hence copy it. There is no limit on the length of the line.
+    std::string str;
+    if (length > 0 && szLine[0] == '#')
     {
-        strncpy(str, szLine + 1, 8191 * sizeof(char));
+        str.assign(szLine + 1, length - 1);
     }
     else
     {
-        strncpy(str, szLine, 8192 * sizeof(char));
+        str.assign(szLine, length);
     }
 
-    char* szToken = str;
+    char* szToken = &str[0];
     int curCol = -1;
     char elevation[] = "elevation";
     char scanAngle[] = "scanangle";
@@ -275,18 +277,155 @@ void CScanEvaluationLogFileHandler::ParseScanHeader(const char szLine[8192])
     return;
 }
 
+namespace
+{
+    // Splits the line into tokens separated by spaces or tabs in the same way as strtok(line, " \t") does,
+    //  i.e. the tokens are null-terminated in place and 'position' is advanced past the returned token.
+    // @return the next token or nullptr if there are no more tokens in the line.
+    char* NextToken(char*& position)
+    {
+        position += strspn(position, " \t");
+        if (*position == '\0')
+        {
+            return nullptr;
+        }
+
+        char* token = position;
+        position += strcspn(position, " \t");
+        if (*position != '\0')
+        {
+            *position = '\0';
+            ++position;
+        }
+        return token;
+    }
+
+    // Parses the three integers of a time written as 'hh:mm:ss' (or 'hh.mm.ss'),
+    //  accepting the same input as sscanf(token, "%d:%d:%d").
+    bool ParseTime(const char* token, char separator, int& hour, int& minute, int& second)
+    {
+        int* values[3] = { &hour, &minute, &second };
+        const char* position = token;
+        for (int k = 0; k < 3; ++k)
+        {
+            if (k > 0)
+            {
+                if (*position != separator)
+                {
+                    return false;
+                }
+                ++position;
+            }
+
+            char* end = nullptr;
+            const long value = strtol(position, &end, 10);
+            if (end == position)
+            {
+                return false;
+            }
+            *values[k] = static_cast<int>(value);
+            position = end;
+        }
+        return true;
+    }
+
+    // Parses the time in the provided token into the hour, minute and second of the given time.
+    // @return false if the token could not be parsed.
+    bool ParseTime(const char* token, CDateTime& time)
+    {
+        int hour, minute, second;
+        const char separator = (strchr(token, ':') != nullptr) ? ':' : '.';
+        if (!ParseTime(token, separator, hour, minute, second))
+        {
+            return false;
+        }
+        time.hour = (unsigned char)hour;
+        time.minute = (unsigned char)minute;
+        time.second = (unsigned char)second;
+        return true;
+    }
+}
+
+/** Splits the memory mapped contents of an evaluation log file into lines, which are converted to lower case. */
+class CScanEvaluationLogFileHandler::LogFileLines
+{
+public:
+    explicit LogFileLines(const MemoryMappedFile& file)
+        : m_position(reinterpret_cast<const char*>(file.Data())),
+        m_end(reinterpret_cast<const char*>(file.Data()) + file.Size())
+    {
+    }
+
+    /** Reads the next line of the file. As with fgets, the line includes the terminating newline character (if any).
+        @return the null-terminated line in lower case or nullptr at the end of the file.
+            The returned line is valid until the next call to Next(). */
+    char* Next()
+    {
+        if (m_position >= m_end)
+        {
+            return nullptr;
+        }
+
+        const char* newline = static_cast<const char*>(memchr(m_position, '\n', m_end - m_position));
+        const char* lineEnd = (newline == nullptr) ? m_end : newline + 1;
+        const size_t length = static_cast<size_t>(lineEnd - m_position);
+
+        m_line.resize(length + 1);
+        for (size_t it = 0; it < length; ++it)
+        {
+            const char c = m_position[it];
+            m_line[it] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+        m_line[length] = '\0';
+        m_length = length;
+
+        m_position = lineEnd;
+        return m_line.data();
+    }
+
+    /** @return the length of the most recently read line, including the newline character. */
+    size_t Length() const { return m_length; }
+
+private:
+    const char* m_position = nullptr;
+    const char* m_end = nullptr;
+
+    std::vector<char> m_line;
+    size_t m_length = 0;
+};
+
 bool CScanEvaluationLogFileHandler::ReadEvaluationLog(const std::string& evaluationLogFile)
 {
-    char  expTimeStr[] = "exposuretime";         // this string only exists in the header line.
-    char  scanInformation[] = "<scaninformation>";    // this string only exists in the scan-information section before the scan-data
-    char  fluxInformation[] = "<fluxinfo>";           // this string only exists in the flux-information section before the scan-data
-    char  spectralData[] = "<spectraldata>";
-    char  endofSpectralData[] = "</spectraldata>";
-    char szLine[8192];
+    m_scan.clear();
+
+    const bool fileIsOk = ReadEvaluationLog(evaluationLogFile, [&](BasicScanEvaluationResult&& scan)
+        {
+            m_scan.push_back(std::move(scan));
+        });
+
+    if (!fileIsOk)
+    {
+        return false;
+    }
+
+    // Sort the scans in order of collection
+    SortScans();
+
+    return true;
+}
+
+bool CScanEvaluationLogFileHandler::ReadEvaluationLog(const std::string& evaluationLogFile, const std::function<void(BasicScanEvaluationResult&&)>& onScan)
+{
+    const char expTimeStr[] = "exposuretime";         // this string only exists in the header line.
+    const char scanInformation[] = "<scaninformation>";    // this string only exists in the scan-information section before the scan-data
+    const char fluxInformation[] = "<fluxinfo>";           // this string only exists in the flux-information section before the scan-data
+    const char spectralData[] = "<spectraldata>";
+    const char endofSpectralData[] = "</spectraldata>";
     int measNr = 0;
-    double fValue;
     bool fReadingScan = false;
     double flux = 0.0;
+    size_t numberOfScans = 0;
+    size_t previousScanLength = 0;
 
     // If no evaluation log selected, quit
     if (evaluationLogFile.size() <= 1)
@@ -296,68 +435,68 @@ bool CScanEvaluationLogFileHandler::ReadEvaluationLog(const std::string& evaluat
 
     this->m_evaluationLog = evaluationLogFile;
 
-    // First count the number of scans in the file.
-    // This to speed up the initialization of the arrays
-    std::vector<CDateTime> allStartTimes;
-    GetScanStartTimes(allStartTimes);
-    if (allStartTimes.size() == 0)
+    // Map the evaluation log into memory. (Notice that the NovacProgram did use a CriticalSection here for locking..)
+    MemoryMappedFile file;
+    if (!file.Open(m_evaluationLog))
     {
         return false;
     }
+    LogFileLines lines(file);
 
-    m_scan.resize(allStartTimes.size());
-    // m_windField.SetSize(nScans + 1);
-
-    std::vector<unsigned int> sortOrder;
-    SortScanStartTimes(allStartTimes, sortOrder);
+    // The scan currently being read.
+    BasicScanEvaluationResult scan;
 
-    int m_scanNum = 0; // TODO: Rename
-
-    // Open the evaluation log. (Notice that the NovacProgram did use a CriticalSection here for locking..)
+    // Before the next scan is started, or the file ends, calculate some information about the current one and pass it on.
+    auto completeScan = [&]()
     {
-        FILE* f = fopen(m_evaluationLog.c_str(), "r");
-        if (nullptr == f)
+        // If the sky and dark were specified, remove them from the measurement
+        if (scan.m_specInfo.size() > 1 && fabs(scan.m_specInfo[1].m_scanAngle - 180.0) < 1)
         {
-            return false;
+            scan.RemoveResult(0); // remove sky
+            scan.RemoveResult(0); // remove dark
         }
 
-        // Reset the column- and spectrum info
-        ResetColumns();
-        ResetScanInformation();
+        previousScanLength = scan.m_spec.size();
+        onScan(std::move(scan));
+        scan = BasicScanEvaluationResult();
+    };
 
-        // Read the file, one line at a time
-        while (fgets(szLine, 8192, f))
-        {
-            // ignore empty lines
-            if (strlen(szLine) < 2)
-            {
-                if (fReadingScan)
-                {
-                    fReadingScan = false;
-                    // Reset the column- and spectrum-information
-                    ResetColumns();
-                    ResetScanInformation();
-                }
-                continue;
-            }
+    // Reset the column- and spectrum info
+    ResetColumns();
+    ResetScanInformation();
 
-            // convert the string to all lower-case letters
-            for (unsigned int it = 0; it < strlen(szLine); ++it)
+    // Read the file, one line at a time
+    while (char* szLine = lines.Next())
+    {
+        // ignore empty lines
+        if (lines.Length() < 2)
+        {
+            if (fReadingScan)
             {
-                szLine[it] = (char)tolower(szLine[it]);
+                fReadingScan = false;
+                // Reset the column- and spectrum-information
+                ResetColumns();
+                ResetScanInformation();
             }
+            continue;
+        }
 
+        // The xml-shaped tags can only be found in lines containing a '<', which the spectral data does not.
+        if (nullptr != memchr(szLine, '<', lines.Length()))
+        {
             // find the next scan-information section
             if (nullptr != strstr(szLine, scanInformation))
             {
-                ParseScanInformation(m_specInfo, flux, f);
+                if (ParseScanInformation(m_specInfo, flux, lines))
+                {
+                    ++numberOfScans;
+                }
                 continue;
             }
 
             // find the next flux-information section
             if (nullptr != strstr(szLine, fluxInformation))
             {
-                // ParseFluxInformation(m_windField[sortOrder[m_scanNum + 1]], flux, f);
                 continue;
             }
 
@@ -371,319 +510,222 @@ bool CScanEvaluationLogFileHandler::ReadEvaluationLog(const std::string& evaluat
                 fReadingScan = false;
                 continue;
             }
+        }
 
-            // find the next start of a scan 
-            if (nullptr != strstr(szLine, expTimeStr))
+        // find the next start of a scan 
+        if (nullptr != strstr(szLine, expTimeStr))
+        {
+            // check so that there was some information in the last scan read
+            //	if not the re-use the memory space
+            if (measNr > 0)
             {
-                // check so that there was some information in the last scan read
-                //	if not the re-use the memory space
-                if ((measNr > 0) || (measNr == 0 && m_scanNum < 0))
-                {
-
-                    // The current measurement position inside the scan
-                    measNr = 0;
-
-                    // before we start the next scan, calculate some information about
-                    // the old one
-
-                    // 1. If the sky and dark were specified, remove them from the measurement
-                    if (m_scanNum >= 0 && fabs(m_scan[sortOrder[m_scanNum]].m_specInfo[1].m_scanAngle - 180.0) < 1)
-                    {
-                        m_scan[sortOrder[m_scanNum]].RemoveResult(0); // remove sky
-                        m_scan[sortOrder[m_scanNum]].RemoveResult(0); // remove dark
-                    }
-
-                    // 2. Calculate the offset
-                    if (m_scanNum >= 0 && m_scan[sortOrder[m_scanNum]].m_spec.size() > 0)
-                    {
-                        // const CEvaluationResult& evResult = m_scan[sortOrder[m_scanNum]].m_spec.front();
-                        // if (evResult.m_referenceResult.size() > 0) {
-                        //     m_scan[sortOrder[m_scanNum]].CalculateOffset(evResult.m_referenceResult.front().m_specieName);
-                        // }
-                    }
-
-                    // start the next scan.
-                    ++m_scanNum;
-                }
-
-                // This line is the header line which says what each column represents.
-                //  Read it and parse it to find out how to interpret the rest of the 
-                //  file. 
-                ParseScanHeader(szLine);
+                // The current measurement position inside the scan
+                measNr = 0;
 
-                // start parsing the lines
-                fReadingScan = true;
-
-                // read the next line, which is the first line in the scan
-                continue;
+                completeScan();
             }
 
-            // ignore comment lines
-            if (szLine[0] == '#')
-                continue;
+            // This line is the header line which says what each column represents.
+            //  Read it and parse it to find out how to interpret the rest of the 
+            //  file. 
+            ParseScanHeader(szLine, lines.Length());
 
-            // if we're not reading a scan, let's read the next line
-            if (!fReadingScan)
-                continue;
-
-            // Split the scan information up into tokens and parse them. 
-            char* szToken = (char*)szLine;
-            int curCol = -1;
-            while (true)
-            {
-                szToken = strtok(szToken, " \t");
-                if (szToken == nullptr)
-                {
-                    break;
-                }
+            // start parsing the lines
+            fReadingScan = true;
 
-                ++curCol;
-
-                // First check the starttime
-                if (curCol == m_tableColumnMapping.starttime)
-                {
-                    int fValue1, fValue2, fValue3, ret;
-                    if (strstr(szToken, ":"))
-                    {
-                        ret = sscanf(szToken, "%d:%d:%d", &fValue1, &fValue2, &fValue3);
-                    }
-                    else
-                    {
-                        ret = sscanf(szToken, "%d.%d.%d", &fValue1, &fValue2, &fValue3);
-                    }
-                    if (ret == 3)
-                    {
-                        m_specInfo.m_startTime.hour = (unsigned char)fValue1;
-                        m_specInfo.m_startTime.minute = (unsigned char)fValue2;
-                        m_specInfo.m_startTime.second = (unsigned char)fValue3;
-                        szToken = nullptr;
-                    }
-                    continue;
-                }
-
-                // Then check the stoptime
-                if (curCol == m_tableColumnMapping.stoptime)
-                {
-                    int fValue1, fValue2, fValue3, ret;
-                    if (strstr(szToken, ":"))
-                    {
-                        ret = sscanf(szToken, "%d:%d:%d", &fValue1, &fValue2, &fValue3);
-                    }
-                    else
-                    {
-                        ret = sscanf(szToken, "%d.%d.%d", &fValue1, &fValue2, &fValue3);
-                    }
-                    if (ret == 3)
-                    {
-                        m_specInfo.m_stopTime.hour = (unsigned char)fValue1;
-                        m_specInfo.m_stopTime.minute = (unsigned char)fValue2;
-                        m_specInfo.m_stopTime.second = (unsigned char)fValue3;
-                        szToken = nullptr;
-                    }
-                    continue;
-                }
-
-                // Also check the name...
-                if (curCol == m_tableColumnMapping.name)
-                {
-                    m_specInfo.m_name = std::string(szToken);
-                    szToken = nullptr;
-                    continue;
-                }
+            // read the next line, which is the first line in the scan
+            continue;
+        }
 
-                // ignore columns whose value cannot be parsed into a float
-                if (1 != sscanf(szToken, "%lf", &fValue))
-                {
-                    szToken = nullptr;
-                    continue;
-                }
+        // ignore comment lines
+        if (szLine[0] == '#')
+            continue;
 
-                if (curCol == m_tableColumnMapping.position)
-                {
-                    m_specInfo.m_scanAngle = (float)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+        // if we're not reading a scan, let's read the next line
+        if (!fReadingScan)
+            continue;
 
-                if (curCol == m_tableColumnMapping.position2)
-                {
-                    m_specInfo.m_scanAngle2 = (float)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+        // Split the scan information up into tokens and parse them. 
+        char* position = szLine;
+        int curCol = -1;
+        while (char* szToken = NextToken(position))
+        {
+            ++curCol;
 
-                if (curCol == m_tableColumnMapping.intensity)
+            if (!ParseColumn(szToken, curCol))
+            {
+                // A start or stop time which could not be parsed. The strtok based parser used previously did then
+                //  read the same token again as the next column and thereafter stopped reading the line, this is kept.
+                while (!ParseColumn(szToken, ++curCol))
                 {
-                    m_specInfo.m_peakIntensity = (float)fValue;
-                    szToken = nullptr;
-                    continue;
                 }
+                break;
+            }
+        }
 
-                if (curCol == m_tableColumnMapping.fitIntensity)
-                {
-                    m_specInfo.m_fitIntensity = (float)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+        // start reading the next line in the evaluation log (i.e. the next
+        //  spectrum in the scan). Insert the data from this spectrum into the 
+        //  CScanResult structure
 
-                if (curCol == m_tableColumnMapping.fitSaturation)
-                {
-                    m_specInfo.m_fitIntensity = (float)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+        // If this is the first spectrum in the new scan, then make
+        //	an initial guess for how large the arrays are going to be...
+        if (measNr == 0 && previousScanLength > 0)
+        {
+            // If this is the first spectrum in a new scan, then initialize the 
+            //	size of the arrays, to save some time on re-allocating memory
+            scan.InitializeArrays((long)previousScanLength);
+        }
 
-                if (curCol == m_tableColumnMapping.peakSaturation)
-                {
-                    m_specInfo.m_peakIntensity = (float)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+        m_specInfo.m_scanIndex = (short)measNr;
+        if (EqualsIgnoringCase(m_specInfo.m_name, "sky"))
+        {
+            scan.m_skySpecInfo = m_specInfo;
+        }
+        else if (EqualsIgnoringCase(m_specInfo.m_name, "dark"))
+        {
+            scan.m_darkSpecInfo = m_specInfo;
+        }
+        else if (EqualsIgnoringCase(m_specInfo.m_name, "offset"))
+        {
+            scan.m_offsetSpecInfo = m_specInfo;
+        }
+        else if (EqualsIgnoringCase(m_specInfo.m_name, "dark_cur"))
+        {
+            scan.m_darkCurSpecInfo = m_specInfo;
+        }
+        else
+        {
+            scan.AppendResult(m_evResult, m_specInfo);
+        }
 
-                if (curCol == m_tableColumnMapping.offset)
-                {
-                    m_specInfo.m_offset = (float)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+        // Update the quality of the DOAS fit
+        if (scan.m_spec.size() > 0)
+        {
+            scan.m_spec.back().CheckGoodnessOfFit(m_specInfo);
+        }
 
-                if (curCol == m_tableColumnMapping.delta)
-                {
-                    m_evResult.m_delta = (float)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+        ++measNr;
+    }
 
-                if (curCol == m_tableColumnMapping.chiSquare)
-                {
-                    m_evResult.m_chiSquare = (float)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+    // The last scan in the file
+    if (measNr > 0)
+    {
+        completeScan();
+    }
 
-                if (curCol == m_tableColumnMapping.nSpec)
-                {
-                    m_specInfo.m_numSpec = (long)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+    return numberOfScans > 0;
+}
 
-                if (curCol == m_tableColumnMapping.expTime)
-                {
-                    m_specInfo.m_exposureTime = (long)fValue;
-                    szToken = nullptr;
-                    continue;
-                }
+bool CScanEvaluationLogFileHandler::ParseColumn(const char* szToken, int curCol)
+{
+    // First check the starttime
+    if (curCol == m_tableColumnMapping.starttime)
+    {
+        return ParseTime(szToken, m_specInfo.m_startTime);
+    }
 
-                for (int k = 0; k < m_tableColumnMapping.nSpecies; ++k)
-                {
-                    if (curCol == m_tableColumnMapping.column[k])
-                    {
-                        m_evResult.m_referenceResult[k].m_column = (float)fValue;
-                        break;
-                    }
-                    if (curCol == m_tableColumnMapping.columnError[k])
-                    {
-                        m_evResult.m_referenceResult[k].m_columnError = (float)fValue;
-                        break;
-                    }
-                    if (curCol == m_tableColumnMapping.shift[k])
-                    {
-                        m_evResult.m_referenceResult[k].m_shift = (float)fValue;
-                        break;
-                    }
-                    if (curCol == m_tableColumnMapping.shiftError[k])
-                    {
-                        m_evResult.m_referenceResult[k].m_shiftError = (float)fValue;
-                        break;
-                    }
-                    if (curCol == m_tableColumnMapping.squeeze[k])
-                    {
-                        m_evResult.m_referenceResult[k].m_squeeze = (float)fValue;
-                        break;
-                    }
-                    if (curCol == m_tableColumnMapping.squeezeError[k])
-                    {
-                        m_evResult.m_referenceResult[k].m_squeezeError = (float)fValue;
-                        break;
-                    }
-                }
-                szToken = nullptr;
-            }
+    // Then check the stoptime
+    if (curCol == m_tableColumnMapping.stoptime)
+    {
+        return ParseTime(szToken, m_specInfo.m_stopTime);
+    }
 
-            // start reading the next line in the evaluation log (i.e. the next
-            //  spectrum in the scan). Insert the data from this spectrum into the 
-            //  CScanResult structure
+    // Also check the name...
+    if (curCol == m_tableColumnMapping.name)
+    {
+        m_specInfo.m_name = std::string(szToken);
+        return true;
+    }
 
-            // If this is the first spectrum in the new scan, then make
-            //	an initial guess for how large the arrays are going to be...
-            if (measNr == 0 && m_scanNum > 1)
-            {
-                // If this is the first spectrum in a new scan, then initialize the 
-                //	size of the arrays, to save some time on re-allocating memory
-                m_scan[sortOrder[m_scanNum]].InitializeArrays((long)m_scan[m_scanNum - 1].m_spec.size());
-            }
+    // ignore columns whose value cannot be parsed into a float
+    char* end = nullptr;
+    const double fValue = strtod(szToken, &end);
+    if (end == szToken)
+    {
+        return true;
+    }
 
-            m_specInfo.m_scanIndex = (short)measNr;
-            if (EqualsIgnoringCase(m_specInfo.m_name, "sky"))
+    if (curCol == m_tableColumnMapping.position)
+    {
+        m_specInfo.m_scanAngle = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.position2)
+    {
+        m_specInfo.m_scanAngle2 = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.intensity)
+    {
+        m_specInfo.m_peakIntensity = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.fitIntensity)
+    {
+        m_specInfo.m_fitIntensity = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.fitSaturation)
+    {
+        m_specInfo.m_fitIntensity = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.peakSaturation)
+    {
+        m_specInfo.m_peakIntensity = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.offset)
+    {
+        m_specInfo.m_offset = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.delta)
+    {
+        m_evResult.m_delta = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.chiSquare)
+    {
+        m_evResult.m_chiSquare = (float)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.nSpec)
+    {
+        m_specInfo.m_numSpec = (long)fValue;
+    }
+    else if (curCol == m_tableColumnMapping.expTime)
+    {
+        m_specInfo.m_exposureTime = (long)fValue;
+    }
+    else
+    {
+        for (int k = 0; k < m_tableColumnMapping.nSpecies; ++k)
+        {
+            if (curCol == m_tableColumnMapping.column[k])
             {
-                m_scan[sortOrder[m_scanNum]].m_skySpecInfo = m_specInfo;
+                m_evResult.m_referenceResult[k].m_column = (float)fValue;
+                break;
             }
-            else if (EqualsIgnoringCase(m_specInfo.m_name, "dark"))
+            if (curCol == m_tableColumnMapping.columnError[k])
             {
-                m_scan[sortOrder[m_scanNum]].m_darkSpecInfo = m_specInfo;
+                m_evResult.m_referenceResult[k].m_columnError = (float)fValue;
+                break;
             }
-            else if (EqualsIgnoringCase(m_specInfo.m_name, "offset"))
+            if (curCol == m_tableColumnMapping.shift[k])
             {
-                m_scan[sortOrder[m_scanNum]].m_offsetSpecInfo = m_specInfo;
+                m_evResult.m_referenceResult[k].m_shift = (float)fValue;
+                break;
             }
-            else if (EqualsIgnoringCase(m_specInfo.m_name, "dark_cur"))
+            if (curCol == m_tableColumnMapping.shiftError[k])
             {
-                m_scan[sortOrder[m_scanNum]].m_darkCurSpecInfo = m_specInfo;
+                m_evResult.m_referenceResult[k].m_shiftError = (float)fValue;
+                break;
             }
-            else
+            if (curCol == m_tableColumnMapping.squeeze[k])
             {
-                m_scan[sortOrder[m_scanNum]].AppendResult(m_evResult, m_specInfo);
-                // m_scan[sortOrder[m_scanNum]].SetFlux(flux);
+                m_evResult.m_referenceResult[k].m_squeeze = (float)fValue;
+                break;
             }
-
-            // double dynamicRange = 1.0; // <-- unknown
-            // if (m_tableColumnMapping.peakSaturation != -1) { // If the intensity is specified as a saturation ratio...
-            //     dynamicRange = CSpectrometerDatabase::GetInstance().GetModel(m_specInfo.m_specModelName).maximumIntensityForSingleReadout;
-            // }
-
-            // Update the quality of the DOAS fit
-            if (m_scan[sortOrder[m_scanNum]].m_spec.size() > 0)
+            if (curCol == m_tableColumnMapping.squeezeError[k])
             {
-                m_scan[sortOrder[m_scanNum]].m_spec.back().CheckGoodnessOfFit(m_specInfo);
+                m_evResult.m_referenceResult[k].m_squeezeError = (float)fValue;
+                break;
             }
-
-            ++measNr;
         }
-
-        // close the evaluation log
-        fclose(f);
-    }
-
-    // If the sky and dark were specified, remove them from the measurement
-    if (m_scanNum >= 0 && fabs(m_scan[sortOrder[m_scanNum]].m_specInfo[1].m_scanAngle - 180.0) < 1)
-    {
-        m_scan[sortOrder[m_scanNum]].RemoveResult(0); // remove sky
-        m_scan[sortOrder[m_scanNum]].RemoveResult(0); // remove dark
     }
 
-    // Calculate the offset
-    if (m_scanNum >= 0)
-    {
-        // m_scan[sortOrder[m_scanNum]].CalculateOffset(m_evResult.m_referenceResult[0].m_specieName);
-    }
-
-    // make sure that scan num is correct
-    ++m_scanNum;
-
-    // Sort the scans in order of collection
-    SortScans();
-
     return true;
 }
 
@@ -735,117 +777,25 @@ long CScanEvaluationLogFileHandler::CountScansInFile()
     return nScans;
 }
 
-void CScanEvaluationLogFileHandler::GetScanStartTimes(std::vector<CDateTime>& startTimes)
-{
-    char  scanInfoStart[] = "<scaninformation>"; // this string indicates the beginning of a 'scanInformation' section
-    char  scanInfoStop[] = "</scaninformation>"; // this string indicates the beginning of a 'scanInformation' section
-    char szLine[8192];
-    long  nScans = 0;
-    bool inScanInfoSection = false;
-    CDateTime scanStartTime;
-    int tmpInt[3];
-    bool foundDate = false, foundTime = false;
-
-    startTimes.clear();
-
-    // If no evaluation log selected, quit
-    if (m_evaluationLog.size() <= 1)
-    {
-        return;
-    }
-
-    {
-        // Open the evaluation log
-        FILE* f = fopen(m_evaluationLog.c_str(), "r");
-        if (nullptr == f)
-        {
-            return;
-        }
-
-        // Read the file, one line at a time
-        while (fgets(szLine, 8192, f))
-        {
-            // convert the string to all lower-case letters
-            for (unsigned int it = 0; it < strlen(szLine); ++it)
-            {
-                szLine[it] = (char)tolower(szLine[it]);
-            }
-
-            // find the next start of a scan 
-            if (nullptr != strstr(szLine, scanInfoStart))
-            {
-                inScanInfoSection = true;
-            }
-
-            if (nullptr != strstr(szLine, scanInfoStop))
-            {
-                if (foundDate && foundTime)
-                {
-                    startTimes.push_back(CDateTime(scanStartTime));
-                }
-                inScanInfoSection = false;
-                foundDate = false;
-                foundTime = false;
-                ++nScans;
-            }
-
-            if (inScanInfoSection)
-            {
-                const char* pt = strstr(szLine, "date=");
-                if (pt != nullptr)
-                {
-                    if (3 == sscanf(pt + 5, "%d.%d.%d", &tmpInt[0], &tmpInt[1], &tmpInt[2]))
-                    {
-                        scanStartTime.day = (unsigned char)tmpInt[0];
-                        scanStartTime.month = (unsigned char)tmpInt[1];
-                        scanStartTime.year = (unsigned short)tmpInt[2];
-                        foundDate = true;
-                        continue;
-                    }
-                }
-                pt = strstr(szLine, "starttime=");
-                if (pt != nullptr)
-                {
-                    if (3 == sscanf(pt + 10, "%d:%d:%d", &tmpInt[0], &tmpInt[1], &tmpInt[2]))
-                    {
-                        scanStartTime.hour = (unsigned char)tmpInt[0];
-                        scanStartTime.minute = (unsigned char)tmpInt[1];
-                        scanStartTime.second = (unsigned char)tmpInt[2];
-                        foundTime = true;
-                    }
-                    continue;
-                }
-            }
-        }
-        fclose(f);
-    }
-}
-
 /** Reads and parses the 'scanInfo' header before the scan */
-void CScanEvaluationLogFileHandler::ParseScanInformation(CSpectrumInfo& scanInfo, double& flux, FILE* f)
+bool CScanEvaluationLogFileHandler::ParseScanInformation(CSpectrumInfo& scanInfo, double& flux, LogFileLines& lines)
 {
-    char szLine[8192];
     int tmpInt[3];
     double tmpDouble;
+    bool foundDate = false;
+    bool foundTime = false;
 
     // Reset the column- and spectrum info
     // ResetColumns();
     ResetScanInformation();
 
-    // read the additional scan-information, line by line
-    while (fgets(szLine, 8192, f))
+    // read the additional scan-information, line by line (these are already converted to lower-case)
+    while (const char* szLine = lines.Next())
     {
-
-        // convert to lower-case
-        for (unsigned int it = 0; it < strlen(szLine); ++it)
-        {
-            szLine[it] = (char)tolower(szLine[it]);
-        }
-
         const char* pt = strstr(szLine, "</scaninformation>");
         if (pt != nullptr)
         {
-            break;
+            return foundDate && foundTime;
         }
 
         pt = strstr(szLine, "compiledate=");
@@ -874,6 +824,7 @@ void CScanEvaluationLogFileHandler::ParseScanInformation(CSpectrumInfo& scanInfo
                 scanInfo.m_stopTime.year = scanInfo.m_startTime.year;
                 scanInfo.m_stopTime.month = scanInfo.m_startTime.month;
                 scanInfo.m_stopTime.day = scanInfo.m_startTime.day;
+                foundDate = true;
             }
             continue;
         }
@@ -886,6 +837,7 @@ void CScanEvaluationLogFileHandler::ParseScanInformation(CSpectrumInfo& scanInfo
                 scanInfo.m_startTime.hour = (unsigned char)tmpInt[0];
                 scanInfo.m_startTime.minute = (unsigned char)tmpInt[1];
                 scanInfo.m_startTime.second = (unsigned char)tmpInt[2];
+                foundTime = true;
             }
             continue;
         }
@@ -1028,6 +980,8 @@ void CScanEvaluationLogFileHandler::ParseScanInformation(CSpectrumInfo& scanInfo
             (void)sscanf(pt + 12, "%f", &scanInfo.m_temperature);
         }
     }
+
+    return false;
 }
 
 /* void CScanEvaluationLogFileHandler::ParseFluxInformation(CWindField& windField, double& flux, FILE* f) {
@@ -1177,23 +1131,12 @@ bool CScanEvaluationLogFileHandler::IsWindSpeedMeasurement(int /*scanNo*/)
 
 void CScanEvaluationLogFileHandler::SortScans()
 {
-    std::sort(begin(m_scan), end(m_scan), [](const BasicScanEvaluationResult& result1, const BasicScanEvaluationResult& result2)
+    std::stable_sort(begin(m_scan), end(m_scan), [](const BasicScanEvaluationResult& result1, const BasicScanEvaluationResult& result2)
         {
             return result1.m_skySpecInfo.m_startTime < result2.m_skySpecInfo.m_startTime;
         });
 }
 
-void CScanEvaluationLogFileHandler::SortScanStartTimes(std::vector<CDateTime>& timestamps, std::vector<unsigned int>& sortOrder)
-{
-    sortOrder.resize(timestamps.size());
-    std::iota(begin(sortOrder), end(sortOrder), 0);
-
-    std::sort(begin(sortOrder), end(sortOrder), [&](unsigned int idx1, unsigned int idx2)
-        {
-            return timestamps[idx1] < timestamps[idx2];
-        });
-}
-
 bool CScanEvaluationLogFileHandler::WriteEvaluationLog(const std::string fileName)
 {
     std::string string, specieName;
@@ -1,6 +1,7 @@
 #include <SpectralEvaluation/File/ScanFileHandler.h>
 #include <SpectralEvaluation/File/SpectrumIO.h>
 #include <SpectralEvaluation/Spectra/SpectrometerModel.h>
+#include <SpectralEvaluation/StringUtils.h>
 
 #include <sstream>
 
@@ -16,55 +17,48 @@ CScanFileHandler::CScanFileHandler(ILogger& log)
 {
 }
 
+// The names of the special spectra in the scan, in the order in which they are searched for in CheckScanFile.
+static const std::string specialSpectrumNames[] = { "sky", "zenith", "dark", "offset", "dark_cur", "darkcur" };
+
 bool CScanFileHandler::CheckScanFile(novac::LogContext context, const std::string& fileName)
 {
-    CSpectrumIO reader;
-    const std::string strings[] = { std::string("sky"), std::string("zenith"), std::string("dark"), std::string("offset"), std::string("dark_cur"), std::string("darkcur") };
     int indices[] = { -1, -1, -1, -1, -1, -1 };
-    bool error = false;
 
     m_fileName = fileName;
+    m_spectrumBuffer.clear();
+    m_spectrumError.clear();
+    m_spectraNotYetRead = 0;
 
-    // Count the number of spectra in the .pak-file
-    m_specNum = reader.ScanSpectrumFile(m_fileName, strings, 6, indices);
+    // Locate all the spectra in the .pak-file. The spectra are only decompressed when they are first requested
+    //  and the file is kept open until all of them have been read.
+    if (!m_pakFileIndex.Open(m_fileName))
+    {
+        this->m_lastError = m_pakFileIndex.m_lastError;
+        m_specNum = 0;
+        return false;
+    }
+    m_specNum = static_cast<std::uint32_t>(m_pakFileIndex.SpectrumCount());
     if (m_specNum == 0)
     {
         return false;
     }
+    m_spectrumBuffer.resize(m_specNum);
+    m_spectrumError.resize(m_specNum, -1);
+    m_spectraNotYetRead = m_specNum;
 
-    // Read in the spectra into the buffer, if the file is not too long
-    if (m_specNum < 200)
+    // Find the special spectra from their names. If there are several spectra with the same name, then the last one is used.
+    for (std::uint32_t spectrumIdx = 0; spectrumIdx < m_specNum; ++spectrumIdx)
     {
-        m_spectrumBuffer.resize(m_specNum);
-        FILE* f = fopen(m_fileName.c_str(), "rb");
-        if (f != NULL)
+        std::string specName = m_pakFileIndex.GetSpectrumName(spectrumIdx);
+        Trim(specName, " \t");
+
+        for (int nameIndex = 0; nameIndex < 6; ++nameIndex)
         {
-            CSpectrum tempSpec;
-            for (unsigned int k = 0; k < m_specNum; ++k)
+            if (EqualsIgnoringCase(specialSpectrumNames[nameIndex], specName))
             {
-                if (true == reader.ReadNextSpectrum(f, tempSpec))
-                {
-                    m_spectrumBuffer[k] = tempSpec;
-                }
-                else
-                {
-                    this->m_lastError = reader.m_lastError;
-                    std::stringstream msg;
-                    msg << "Could not read spectrum " << k << " from file. " << reader.FormatLastError();
-                    m_log.Error(context, msg.str());
-                    fclose(f);
-                    return false;
-                }
+                indices[nameIndex] = static_cast<int>(spectrumIdx);
             }
-            fclose(f);
         }
-        m_spectrumBufferNum = m_specNum;
-    }
-    else
-    {
-        // The file's too large, don't store it in memory!
-        m_spectrumBufferNum = 0;
-        m_spectrumBuffer.clear();
     }
 
     // --------------- read the sky spectrum ----------------------
@@ -85,22 +79,10 @@ bool CScanFileHandler::CheckScanFile(novac::LogContext context, const std::strin
         indexOfSkySpectrum = 0;
     }
 
+    this->m_sky = ReadSpectrum(indexOfSkySpectrum);
+    if (this->m_sky == nullptr)
     {
-        std::unique_ptr<CSpectrum> spectrum = std::make_unique<CSpectrum>();
-        if (true != reader.ReadSpectrum(m_fileName, indexOfSkySpectrum, *spectrum))
-        {
-            error = true;
-        }
-        else
-        {
-            this->m_sky = std::move(spectrum);
-        }
-    }
-
-    if (error)
-    {
-        this->m_lastError = reader.m_lastError;
-        m_log.Error(context, "Could not read sky spectrum from file. " + reader.FormatLastError());
+        m_log.Error(context, "Could not read sky spectrum from file. " + CSpectrumIO::FormatError(m_lastError));
         return false;
     }
 
@@ -119,76 +101,57 @@ bool CScanFileHandler::CheckScanFile(novac::LogContext context, const std::strin
         indexOfDarkSpectrum = 1;
     }
 
+    this->m_dark = ReadSpectrum(indexOfDarkSpectrum);
+    if (this->m_dark == nullptr)
     {
-        std::unique_ptr<CSpectrum> spectrum = std::make_unique<CSpectrum>();
-        if (true != reader.ReadSpectrum(m_fileName, indexOfDarkSpectrum, *spectrum))
-        {
-            error = true;
-        }
-        else
-        {
-            this->m_dark = std::move(spectrum);
-        }
-    }
-
-    if (error)
-    {
-        this->m_lastError = reader.m_lastError;
-        m_log.Error(context, "Could not read dark spectrum from file." + reader.FormatLastError());
+        m_log.Error(context, "Could not read dark spectrum from file." + CSpectrumIO::FormatError(m_lastError));
         return false;
     }
 
     // --------------- read the offset spectrum (if any) ----------------------
     if (indices[3] != -1)
     {
-        std::unique_ptr<CSpectrum> spectrum = std::make_unique<CSpectrum>();
-        if (true != reader.ReadSpectrum(m_fileName, indices[3], *spectrum))
+        this->m_offset = ReadSpectrum(indices[3]);
+        if (this->m_offset == nullptr)
         {
-            this->m_lastError = reader.m_lastError;
-            m_log.Error(context, "Could not read offset spectrum from file." + reader.FormatLastError());
+            m_log.Error(context, "Could not read offset spectrum from file." + CSpectrumIO::FormatError(m_lastError));
             return false;
         }
-
-        this->m_offset = std::move(spectrum);
     }
 
     // --------------- read the dark-current spectrum (if any) ----------------------
     if (indices[4] != -1)
     {
-        std::unique_ptr<CSpectrum> spectrum = std::make_unique<CSpectrum>();
-        if (true != reader.ReadSpectrum(m_fileName, indices[4], *spectrum))
+        this->m_darkCurrent = ReadSpectrum(indices[4]);
+        if (this->m_darkCurrent == nullptr)
         {
-            this->m_lastError = reader.m_lastError;
-            m_log.Error(context, "Could not read dark current spectrum from file." + reader.FormatLastError());
+            m_log.Error(context, "Could not read dark current spectrum from file." + CSpectrumIO::FormatError(m_lastError));
             return false;
         }
-        this->m_darkCurrent = std::move(spectrum);
     }
     if (indices[5] != -1)
     {
-        std::unique_ptr<CSpectrum> spectrum = std::make_unique<CSpectrum>();
-        if (true != reader.ReadSpectrum(m_fileName, indices[5], *spectrum))
+        this->m_offset = ReadSpectrum(indices[5]);
+        if (this->m_offset == nullptr)
         {
-            m_log.Error(context, "Could not read offset spectrum spectrum from file." + reader.FormatLastError());
-            this->m_lastError = reader.m_lastError;
+            m_log.Error(context, "Could not read offset spectrum spectrum from file." + CSpectrumIO::FormatError(m_lastError));
             return false;
         }
-        this->m_offset = std::move(spectrum);
     }
 
     // set the start and stop time of the measurement
     {
-        std::unique_ptr<CSpectrum> spectrum = std::make_unique<CSpectrum>();
-        if (true == reader.ReadSpectrum(m_fileName, 0, *spectrum))
+        std::unique_ptr<CSpectrum> firstSpectrum = (indexOfSkySpectrum == 0) ? std::make_unique<CSpectrum>(*m_sky) : ReadSpectrum(0);
+        if (firstSpectrum != nullptr)
         {
-            this->m_startTime = spectrum->m_info.m_startTime;
-            this->m_stopTime = spectrum->m_info.m_stopTime;
+            this->m_startTime = firstSpectrum->m_info.m_startTime;
+            this->m_stopTime = firstSpectrum->m_info.m_stopTime;
 
             // get the serial number of the spectrometer
-            m_device = std::string(spectrum->m_info.m_device.c_str());
+            m_device = std::string(firstSpectrum->m_info.m_device.c_str());
 
             // get the channel of the spectrometer
-            m_channel = spectrum->m_info.m_channel;
+            m_channel = firstSpectrum->m_info.m_channel;
         }
     }
 
@@ -208,37 +171,71 @@ bool CScanFileHandler::CheckScanFile(novac::LogContext context, const std::strin
     return true;
 }
 
-int CScanFileHandler::GetNextSpectrum(novac::LogContext context, CSpectrum& spec)
+const CSpectrum* CScanFileHandler::GetBufferedSpectrum(int index)
 {
-    CSpectrumIO reader;
+    if (index < 0 || (size_t)index >= m_spectrumBuffer.size())
+    {
+        this->m_lastError = CSpectrumIO::ERROR_SPECTRUM_NOT_FOUND;
+        return nullptr;
+    }
 
-    if (m_spectrumBufferNum == (unsigned int)m_specNum)
+    if (m_spectrumError[index] == -1)
     {
-        // We've read in the spectra into the buffer, just read it from there
-        // instead of reading from the file itself.
-        if (m_specReadSoFarNum >= m_spectrumBufferNum)
+        // First time this spectrum is requested, decompress it from the file.
+        std::unique_ptr<CSpectrum> spectrum = std::make_unique<CSpectrum>();
+        m_spectrumError[index] = m_pakFileIndex.ReadSpectrum((size_t)index, *spectrum);
+        if (m_spectrumError[index] == CSpectrumIO::ERROR_NO_ERROR)
         {
-            this->m_lastError = CSpectrumIO::ERROR_SPECTRUM_NOT_FOUND;
-            ++m_specReadSoFarNum; // <-- go to the next spectum
-            return 0;
+            m_spectrumBuffer[index] = std::move(spectrum);
         }
-        else
+
+        if (--m_spectraNotYetRead == 0)
         {
-            spec = m_spectrumBuffer.at(m_specReadSoFarNum);
+            // All the spectra are now in memory, the file is no longer needed.
+            m_pakFileIndex.Close();
         }
     }
-    else
+
+    if (m_spectrumBuffer[index] == nullptr)
     {
-        // read the next spectrum in the file
-        if (true != reader.ReadSpectrum(m_fileName, m_specReadSoFarNum, spec))
-        {
-            // if there was an error reading the spectrum, set the error-flag
-            this->m_lastError = reader.m_lastError;
-            m_log.Error(context, "Error reading spectrum." + reader.FormatLastError());
-            ++m_specReadSoFarNum; // <-- go to the next spectum
-            return 0;
-        }
+        this->m_lastError = m_spectrumError[index];
+        return nullptr;
+    }
+    return m_spectrumBuffer[index].get();
+}
+
+std::unique_ptr<CSpectrum> CScanFileHandler::ReadSpectrum(int index)
+{
+    const CSpectrum* spectrum = GetBufferedSpectrum(index);
+    if (spectrum == nullptr)
+    {
+        return nullptr;
+    }
+    return std::make_unique<CSpectrum>(*spectrum);
+}
+
+int CScanFileHandler::GetNextSpectrum(novac::LogContext context, CSpectrum& spec)
+{
+    if (m_specReadSoFarNum >= m_specNum)
+    {
+        // We've reached the end of the scan.
+        this->m_lastError = CSpectrumIO::ERROR_SPECTRUM_NOT_FOUND;
+        ++m_specReadSoFarNum; // <-- go to the next spectum
+        return 0;
+    }
+
+    // get the next spectrum in the file
+    const CSpectrum* spectrum = GetBufferedSpectrum((int)m_specReadSoFarNum);
+    if (spectrum == nullptr)
+    {
+        // if there was an error reading the spectrum, set the error-flag
+        std::stringstream msg;
+        msg << "Error reading spectrum number " << m_specReadSoFarNum << " in scan. " << CSpectrumIO::FormatError(m_lastError);
+        m_log.Error(context, msg.str());
+        ++m_specReadSoFarNum; // <-- go to the next spectum
+        return 0;
     }
+    spec = *spectrum;
 
     ++m_specReadSoFarNum;
 
@@ -255,30 +252,22 @@ int CScanFileHandler::GetNextSpectrum(novac::LogContext context, CSpectrum& spec
 
 int CScanFileHandler::GetSpectrum(novac::LogContext context, CSpectrum& spec, long specNo)
 {
-    if ((unsigned int)specNo < m_spectrumBufferNum)
+    if (specNo < 0 || (uint32_t)specNo >= m_specNum)
     {
-        // We've read in the spectra into the buffer, just read it from there
-        // instead of reading from the file itself.
-        spec = m_spectrumBuffer.at(specNo);
-    }
-    else if ((uint32_t)specNo >= m_specNum)
-    {
-        // Attempt to read past the end of the file
+        // Attempt to read outside of the file
         return 0;
     }
-    else
+
+    // get the desired spectrum, this is decompressed from the file the first time it is requested
+    const CSpectrum* spectrum = GetBufferedSpectrum((int)specNo);
+    if (spectrum == nullptr)
     {
-        // read the desired spectrum from file
-        CSpectrumIO reader;
-        if (true != reader.ReadSpectrum(m_fileName, specNo, spec))
-        {
-            this->m_lastError = reader.m_lastError;
-            std::stringstream msg;
-            msg << "Error reading spectrum number " << specNo << "in scan. Error code : " << reader.m_lastError;
-            m_log.Information(context, msg.str());
-            return 0;
-        }
+        std::stringstream msg;
+        msg << "Error reading spectrum number " << specNo << " in scan. " << CSpectrumIO::FormatError(m_lastError);
+        m_log.Information(context, msg.str());
+        return 0;
     }
+    spec = *spectrum;
 
     UpdateStartAndStopTimeOfScan(spec);
 
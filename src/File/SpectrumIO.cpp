@@ -20,13 +20,18 @@ namespace novac
 CSpectrumIO::CSpectrumIO()
 {
     this->m_lastError = ERROR_NO_ERROR;
-    this->m_buffer.resize(16384);
-    this->m_outbuf.resize(16384);
+    // the size of the compressed data is stored as a 16-bit value, this fits any spectrum
+    this->m_buffer.resize(65536);
 }
 
 std::string CSpectrumIO::FormatLastError() const
 {
-    switch (this->m_lastError)
+    return FormatError(this->m_lastError);
+}
+
+std::string CSpectrumIO::FormatError(int errorCode)
+{
+    switch (errorCode)
     {
     case ERROR_NO_ERROR: return "No error";
     case ERROR_EOF: return "End of File";
@@ -280,18 +285,8 @@ bool CSpectrumIO::ReadSpectrum(const std::string& fileName, const int spectrumNu
                 return false;
             }
 
-            if (MKZY.pixels > m_buffer.size())
-            {
-                // The spectrum is longer than what the buffer can handle. Trying to
-                // uncompress the whole spectrum will result in a buffer overflow.
-                // this spectrum cannot be read - return.
-                m_lastError = ERROR_SPECTRUM_TOO_LARGE;
-                fclose(f);
-                return false;
-            }
-
-            MKPack mkPack;
-            const long outlen = mkPack.UnPack(m_buffer.data(), MKZY.pixels, m_outbuf.data()); //uncompress info(compressed buffer,num of sampling points, uncompressedinfo)
+            // uncompress the spectrum directly into the spectrum data, which has been sized when reading the header
+            const long outlen = MKPack::UnPack(m_buffer.data(), MKZY.size, MKZY.pixels, spec.m_data);
 
             // validate that the decompression was ok - Added 2006.02.13 by MJ
             if (outlen < 0)
@@ -301,23 +296,8 @@ bool CSpectrumIO::ReadSpectrum(const std::string& fileName, const int spectrumNu
                 return false;
             }
 
-            // validate that the spectrum is not too large - Added 2006.02.13 by MJ
-            if (outlen > MAX_SPECTRUM_LENGTH)
-            {
-                m_lastError = ERROR_SPECTRUM_TOO_LARGE;
-                fclose(f);
-                return false;
-            }
-
             // calculate the checksum
-            std::uint32_t chk = 0;
-            for (long j = 0; j < outlen && j < MAX_SPECTRUM_LENGTH; j++)
-            {
-                chk += m_outbuf[j];
-                spec.m_data[j] = m_outbuf[j];
-            }
-            const std::uint16_t* p = (std::uint16_t*)&chk;
-            const std::uint16_t checksum = p[0] + p[1];
+            const std::uint16_t checksum = MKPack::Checksum(spec.m_data, outlen);
 
             if (checksum != MKZY.checksum)
             {
@@ -404,8 +384,6 @@ bool CSpectrumIO::ReadNextSpectrum(FILE* f, CSpectrum& spec)
 
 bool CSpectrumIO::ReadNextSpectrum(FILE* f, CSpectrum& spec, int& headerSize, char* headerBuffer, int headerBufferSize)
 {
-    std::uint16_t* p = nullptr;
-
     struct MKZYhdr MKZY;
     int ret = ReadNextSpectrumHeader(f, MKZY, headerSize, &spec, headerBuffer, headerBufferSize);
     if (ret != 0)
@@ -429,15 +407,6 @@ bool CSpectrumIO::ReadNextSpectrum(FILE* f, CSpectrum& spec, int& headerSize, ch
         return false;
     }
 
-    if (MKZY.pixels > m_outbuf.size())
-    {
-        // The spectrum is longer than what the buffer can handle. Trying to
-        // uncompress the whole spectrum will result in a buffer overflow.
-        // this spectrum cannot be read - return.
-        m_lastError = ERROR_SPECTRUM_TOO_LARGE;
-        return false;
-    }
-
     // We've managed to read the spectrum header, write that information
     //	to the supplied spectrum data-structure
     spec.m_info.m_device = std::string(MKZY.instrumentname);
@@ -445,8 +414,7 @@ bool CSpectrumIO::ReadNextSpectrum(FILE* f, CSpectrum& spec, int& headerSize, ch
     spec.m_info.m_name = std::string(MKZY.name);
 
     // Decompress the spectrum itself
-    MKPack mkPack;
-    const long outlen = mkPack.UnPack(m_buffer.data(), MKZY.pixels, m_outbuf.data()); //uncompress info(compressed buffer,num of sampling points, uncompressedinfo)
+    const long outlen = MKPack::UnPack(m_buffer.data(), MKZY.size, MKZY.pixels, spec.m_data);
 
     // validate that the decompression was ok - Added 2006.02.13 by MJ
     if (outlen < 0)
@@ -454,22 +422,9 @@ bool CSpectrumIO::ReadNextSpectrum(FILE* f, CSpectrum& spec, int& headerSize, ch
         this->m_lastError = ERROR_DECOMPRESS;
         return false;
     }
-    // validate that the spectrum is not too large - Added 2006.02.13 by MJ
-    if (outlen > MAX_SPECTRUM_LENGTH)
-    {
-        this->m_lastError = ERROR_SPECTRUM_TOO_LARGE;
-        return false;
-    }
 
     // calculate the checksum
-    std::uint32_t chk = 0;
-    for (long j = 0; j < outlen && j < MAX_SPECTRUM_LENGTH; j++)
-    {
-        chk += m_outbuf[j];
-    }
-    p = (std::uint16_t*)&chk;
-
-    const std::uint16_t checksum = p[0] + p[1];
+    const std::uint16_t checksum = MKPack::Checksum(spec.m_data, outlen);
     if (checksum != MKZY.checksum)
     {
         printf("Checksum mismatch %04x!=x%04x\n", checksum, MKZY.checksum);
@@ -478,12 +433,6 @@ bool CSpectrumIO::ReadNextSpectrum(FILE* f, CSpectrum& spec, int& headerSize, ch
         return false;
     }
 
-    // copy the spectrum
-    for (long j = 0; j < outlen && j < MAX_SPECTRUM_LENGTH; j++)
-    {
-        spec.m_data[j] = m_outbuf[j];
-    }
-
     // Get the maximum intensity
     if (MKZY.pixels > 0)
     {
@@ -494,7 +443,52 @@ bool CSpectrumIO::ReadNextSpectrum(FILE* f, CSpectrum& spec, int& headerSize, ch
     return true;
 }
 
-void CSpectrumIO::ParseTime(const std::uint32_t t, CDateTime& time) const
+void CSpectrumIO::ParseSpectrumHeader(const MKZYhdr& header, CSpectrum& spec)
+{
+    // clear the spectrum and make room for all the pixels
+    spec.m_length = 0;
+    spec.Resize(header.pixels);
+
+    CSpectrumInfo* info = &spec.m_info;
+    // save the spectrum information in the CSpectrum data structure
+    info->m_startChannel = header.startc;
+    info->m_numSpec = header.scans;
+    info->m_exposureTime = (header.exptime > 0) ? header.exptime : -header.exptime;
+    info->m_gps.m_longitude = header.lon;
+    info->m_gps.m_latitude = header.lat;
+    info->m_gps.m_altitude = header.altitude;
+    info->m_channel = header.channel;
+    CSpectrum::GetInterlaceSteps(info->m_channel, info->m_interlaceStep);
+    info->m_scanAngle = header.viewangle;
+    if (info->m_scanAngle > 180.0)
+    {
+        info->m_scanAngle -= 360.0; // map 270 -> -90
+    }
+    info->m_scanAngle2 = (float)header.viewangle2;
+    info->m_coneAngle = header.coneangle;
+    info->m_compass = (float)header.compassdir / 10.0f;
+    if (info->m_compass > 360.0 || info->m_compass < 0)
+    {
+        printf("Spectrum has compass angle outside of the expected [0, 360] degree range.\n");
+    }
+    info->m_batteryVoltage = (float)header.ADC[0] / 100.0f;
+    info->m_temperature = header.temperature;
+
+    info->m_scanIndex = header.measureidx;
+    info->m_scanSpecNum = header.measurecnt;
+    info->m_flag = header.flag;
+
+    ParseTime(header.starttime, info->m_startTime);
+    ParseTime(header.stoptime, info->m_stopTime);
+    ParseDate(header.date, info->m_startTime);
+    ParseDate(header.date, info->m_stopTime);
+
+    info->m_device = std::string(header.instrumentname);
+    Trim(info->m_device, " "); // remove spaces in the beginning or the end
+    info->m_name = std::string(header.name);
+}
+
+void CSpectrumIO::ParseTime(const std::uint32_t t, CDateTime& time)
 {
     time.hour = (unsigned char)(t / 1000000);
     time.minute = (unsigned char)((t - time.hour * 1000000) / 10000);
@@ -506,7 +500,7 @@ void CSpectrumIO::WriteTime(std::uint32_t& t, const CDateTime& time) const {
     t = time.hour * 1000000 + time.minute * 10000 + time.second * 100 + time.millisecond / 10;
 }
 
-void CSpectrumIO::ParseDate(const std::uint32_t d, CDateTime& day) const {
+void CSpectrumIO::ParseDate(const std::uint32_t d, CDateTime& day) {
     day.day = (unsigned char)(d / 10000);                  // the day
     day.month = (unsigned char)((d - day.day * 10000) / 100);  // the month
     day.year = (std::uint16_t)(d % 100);                  // the year
@@ -562,8 +556,8 @@ int CSpectrumIO::AddSpectrumToFile(const std::string& fileName, const CSpectrum&
     }
 
     // Compress the spectrum..
-    std::vector<std::uint16_t> sbuf(16384);
-    memset(sbuf.data(), 0, 16384);
+    // each pixel takes at most 31 bits plus the 12 bits of the segment header
+    std::vector<std::uint16_t> sbuf(std::max(16384L, 3 * spectrum.m_length));
     MKPack mkPack;
     const std::uint16_t outsiz = mkPack.mk_compress(spec.data(), (unsigned char*)sbuf.data(), (std::uint16_t)spectrum.m_length);
     const CSpectrumInfo& info = spectrum.m_info;
@@ -698,47 +692,7 @@ int CSpectrumIO::ReadNextSpectrumHeader(FILE* f, struct MKZYhdr& MKZYHeader, int
 
     if (spec != nullptr)
     {
-        // clear the spectrum
-        memset(spec->m_data, 0, MAX_SPECTRUM_LENGTH * sizeof(double));
-
-        CSpectrumInfo* info = &spec->m_info;
-        // save the spectrum information in the CSpectrum data structure
-        spec->m_length = std::max(std::min(MKZYHeader.pixels, (std::uint16_t)(MAX_SPECTRUM_LENGTH)), (std::uint16_t)(0));
-        info->m_startChannel = MKZYHeader.startc;
-        info->m_numSpec = MKZYHeader.scans;
-        info->m_exposureTime = (MKZYHeader.exptime > 0) ? MKZYHeader.exptime : -MKZYHeader.exptime;
-        info->m_gps.m_longitude = MKZYHeader.lon;
-        info->m_gps.m_latitude = MKZYHeader.lat;
-        info->m_gps.m_altitude = MKZYHeader.altitude;
-        info->m_channel = MKZYHeader.channel;
-        CSpectrum::GetInterlaceSteps(info->m_channel, info->m_interlaceStep);
-        info->m_scanAngle = MKZYHeader.viewangle;
-        if (info->m_scanAngle > 180.0)
-        {
-            info->m_scanAngle -= 360.0; // map 270 -> -90
-        }
-        info->m_scanAngle2 = (float)MKZYHeader.viewangle2;
-        info->m_coneAngle = MKZYHeader.coneangle;
-        info->m_compass = (float)MKZYHeader.compassdir / 10.0f;
-        if (info->m_compass > 360.0 || info->m_compass < 0)
-        {
-            printf("Spectrum has compass angle outside of the expected [0, 360] degree range.\n");
-        }
-        info->m_batteryVoltage = (float)MKZYHeader.ADC[0] / 100.0f;
-        info->m_temperature = MKZYHeader.temperature;
-
-        info->m_scanIndex = MKZYHeader.measureidx;
-        info->m_scanSpecNum = MKZYHeader.measurecnt;
-        info->m_flag = MKZYHeader.flag;
-
-        ParseTime(MKZYHeader.starttime, info->m_startTime);
-        ParseTime(MKZYHeader.stoptime, info->m_stopTime);
-        ParseDate(MKZYHeader.date, info->m_startTime);
-        ParseDate(MKZYHeader.date, info->m_stopTime);
-
-        info->m_device = std::string(MKZYHeader.instrumentname);
-        Trim(info->m_device, " "); // remove spaces in the beginning or the end
-        info->m_name = std::string(MKZYHeader.name);
+        ParseSpectrumHeader(MKZYHeader, *spec);
     }
 
     return 0;
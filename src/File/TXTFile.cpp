@@ -1,17 +1,19 @@
 #include <SpectralEvaluation/File/TXTFile.h>
+#include <SpectralEvaluation/File/TextFileReader.h>
 #include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <algorithm>
 
 namespace novac
 {
 // TODO: move these functions to a common helper
-int ReadFromFile(FILE* f, const char* formatStr, double& col1, double& col2);
+int ReadFromFile(TextFileReader& file, const char* formatStr, double& col1, double& col2);
 int GetFileFormat(const char* string, char* format);
 
 bool CTXTFile::ReadSpectrum(CSpectrum& spec, const std::string& fileName)
 {
     // Open the file
-    FILE* f = fopen(fileName.c_str(), "r");
-    if (f == nullptr)
+    TextFileReader file;
+    if (!file.Open(fileName))
     {
         return false;
     }
@@ -19,28 +21,27 @@ bool CTXTFile::ReadSpectrum(CSpectrum& spec, const std::string& fileName)
     // Clear all the information in the spectrum
     spec.Clear();
 
-    // allocate some space for the wavlength data (if there is any)
-    std::vector<double> wavelengths(MAX_SPECTRUM_LENGTH);
+    // the wavelength data (if there is any) and the spectral data
+    std::vector<double> wavelengths;
+    std::vector<double> values;
     bool containsWavelengthData = false;
 
     // Get the file-format and number of columns from the file.
     char tempBuffer[8192];
     char format[256];
-    if (nullptr == fgets(tempBuffer, 8191, f))
+    if (!file.ReadLine(tempBuffer, 8191))
     {
-        fclose(f);
         return false;
     }
     const int numColumns = novac::GetFileFormat(tempBuffer, format);
-    fseek(f, 0, SEEK_SET);
+    file.Rewind();
 
     // Simply read the spectrum, one pixel at a time
-    int length = 0;
-    while (length < MAX_SPECTRUM_LENGTH)
+    while (numColumns > 0)
     {
         double col1 = 0.0;
         double col2 = 0.0;
-        int nCols = novac::ReadFromFile(f, format, col1, col2);
+        int nCols = novac::ReadFromFile(file, format, col1, col2);
 
         if (nCols != numColumns)
         {
@@ -49,34 +50,31 @@ bool CTXTFile::ReadSpectrum(CSpectrum& spec, const std::string& fileName)
 
         if (nCols == 1)
         {
-            spec.m_data[length] = col1;
+            values.push_back(col1);
         }
         else if (nCols == 2)
         {
             containsWavelengthData = true;
-            wavelengths[length] = col1;
-            spec.m_data[length] = col2;
+            wavelengths.push_back(col1);
+            values.push_back(col2);
         }
         else
         {
             break;
         }
-
-        ++length;
     }
-    spec.m_length = length;
+    spec.Resize((long)values.size());
+    std::copy(begin(values), end(values), spec.m_data);
 
     if (containsWavelengthData)
     {
-        spec.m_wavelength = std::vector<double>(begin(wavelengths), begin(wavelengths) + length);
+        spec.m_wavelength = std::move(wavelengths);
     }
     else
     {
         spec.m_wavelength.clear();
     }
 
-    // close the file before we return
-    fclose(f);
     return true;
 }
 
@@ -0,0 +1,271 @@
+#include <SpectralEvaluation/File/TextFileReader.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdlib.h>
+
+namespace novac
+{
+
+namespace
+{
+    // The characters which strtod and scanf consider to be whitespace (in the "C" locale).
+    inline bool IsWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
+
+    inline bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // Parses decimal numbers, such as "-123.456e7", whose significant digits and power of ten are both exactly representable
+    //  as doubles. These can be converted using one floating point multiplication or division, which is correctly rounded,
+    //  hence giving the same result as strtod (this is known as Clinger's fast path).
+    // @return false if the number is not on this form, it must then be parsed using strtod.
+    bool TryParseSimpleDecimal(const char* start, const char* end, double& value, const char*& numberEnd)
+    {
+        static const double powersOfTen[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        const std::uint64_t maximumExactMantissa = std::uint64_t(1) << 53;
+
+        const char* pt = start;
+        const bool isNegative = (pt < end && *pt == '-');
+        if (pt < end && (*pt == '-' || *pt == '+'))
+        {
+            ++pt;
+        }
+
+        std::uint64_t mantissa = 0;
+        int numberOfSignificantDigits = 0;
+        int exponent = 0;
+        bool hasDigits = false;
+
+        while (pt < end && IsDigit(*pt))
+        {
+            if (mantissa != 0 || *pt != '0')
+            {
+                if (++numberOfSignificantDigits > 19)
+                {
+                    return false;
+                }
+                mantissa = 10 * mantissa + static_cast<std::uint64_t>(*pt - '0');
+            }
+            hasDigits = true;
+            ++pt;
+        }
+
+        if (pt < end && (*pt == 'x' || *pt == 'X'))
+        {
+            return false; // hexadecimal number
+        }
+
+        if (pt < end && *pt == '.')
+        {
+            ++pt;
+            while (pt < end && IsDigit(*pt))
+            {
+                if (mantissa != 0 || *pt != '0')
+                {
+                    if (++numberOfSignificantDigits > 19)
+                    {
+                        return false;
+                    }
+                    mantissa = 10 * mantissa + static_cast<std::uint64_t>(*pt - '0');
+                }
+                --exponent;
+                hasDigits = true;
+                ++pt;
+            }
+        }
+
+        if (!hasDigits)
+        {
+            return false; // not a number, or infinity or nan
+        }
+
+        // The exponent is only part of the number if it contains at least one digit.
+        if (pt < end && (*pt == 'e' || *pt == 'E'))
+        {
+            const char* exponentPt = pt + 1;
+            const bool isNegativeExponent = (exponentPt < end && *exponentPt == '-');
+            if (exponentPt < end && (*exponentPt == '-' || *exponentPt == '+'))
+            {
+                ++exponentPt;
+            }
+            if (exponentPt < end && IsDigit(*exponentPt))
+            {
+                int exponentValue = 0;
+                while (exponentPt < end && IsDigit(*exponentPt))
+                {
+                    exponentValue = std::min(10 * exponentValue + (*exponentPt - '0'), 100000);
+                    ++exponentPt;
+                }
+                exponent += isNegativeExponent ? -exponentValue : exponentValue;
+                pt = exponentPt;
+            }
+        }
+
+        double result = 0.0;
+        if (mantissa != 0)
+        {
+            if (mantissa > maximumExactMantissa || exponent < -22 || exponent > 22)
+            {
+                return false;
+            }
+            result = (exponent < 0) ? (double)mantissa / powersOfTen[-exponent] : (double)mantissa * powersOfTen[exponent];
+        }
+
+        value = isNegative ? -result : result;
+        numberEnd = pt;
+        return true;
+    }
+}
+
+bool ParseDouble(const char*& position, const char* end, double& value)
+{
+    const char* start = position;
+    while (start < end && IsWhitespace(*start))
+    {
+        ++start;
+    }
+    if (start == end)
+    {
+        return false;
+    }
+
+    if (TryParseSimpleDecimal(start, end, value, position))
+    {
+        return true;
+    }
+
+    // Whitespace is never part of a number, hence strtod will not read beyond the first whitespace character after the number.
+    //  If there is no such character before 'end' then the number is copied to a null terminated buffer before it is parsed.
+    const char* tokenEnd = start;
+    while (tokenEnd < end && !IsWhitespace(*tokenEnd))
+    {
+        ++tokenEnd;
+    }
+
+    char* parseEnd = nullptr;
+    if (tokenEnd < end)
+    {
+        value = strtod(start, &parseEnd);
+        if (parseEnd == start)
+        {
+            return false;
+        }
+        position = parseEnd;
+        return true;
+    }
+
+    const size_t tokenLength = static_cast<size_t>(tokenEnd - start);
+    char smallBuffer[64];
+    std::string largeBuffer;
+    char* token = smallBuffer;
+    if (tokenLength < sizeof(smallBuffer))
+    {
+        memcpy(smallBuffer, start, tokenLength);
+        smallBuffer[tokenLength] = '\0';
+    }
+    else
+    {
+        largeBuffer.assign(start, tokenEnd);
+        token = &largeBuffer[0];
+    }
+
+    value = strtod(token, &parseEnd);
+    if (parseEnd == token)
+    {
+        return false;
+    }
+    position = start + (parseEnd - token);
+    return true;
+}
+
+bool TextFileReader::Open(const std::string& fileName)
+{
+    Close();
+
+    if (!m_file.Open(fileName))
+    {
+        return false;
+    }
+
+    Rewind();
+    return true;
+}
+
+void TextFileReader::Close()
+{
+    m_file.Close();
+    m_position = nullptr;
+    m_end = nullptr;
+}
+
+void TextFileReader::Rewind()
+{
+    m_position = reinterpret_cast<const char*>(m_file.Data());
+    m_end = (m_position == nullptr) ? nullptr : m_position + m_file.Size();
+}
+
+bool TextFileReader::ReadLine(char* buffer, int bufferSize)
+{
+    if (m_position == m_end || bufferSize <= 0)
+    {
+        return false;
+    }
+
+    const size_t maximumLength = std::min(static_cast<size_t>(bufferSize - 1), static_cast<size_t>(m_end - m_position));
+    const char* newline = static_cast<const char*>(memchr(m_position, '\n', maximumLength));
+    const size_t length = (newline == nullptr) ? maximumLength : static_cast<size_t>(newline - m_position) + 1;
+
+    memcpy(buffer, m_position, length);
+    buffer[length] = '\0';
+    m_position += length;
+
+    return true;
+}
+
+bool TextFileReader::ReadLine(const char*& lineBegin, const char*& lineEnd)
+{
+    if (m_position == m_end)
+    {
+        return false;
+    }
+
+    const char* newline = static_cast<const char*>(memchr(m_position, '\n', static_cast<size_t>(m_end - m_position)));
+    lineBegin = m_position;
+    lineEnd = (newline == nullptr) ? m_end : newline;
+    m_position = (newline == nullptr) ? m_end : newline + 1;
+
+    return true;
+}
+
+bool TextFileReader::ReadDouble(double& value)
+{
+    SkipWhitespace();
+    return ParseDouble(m_position, m_end, value);
+}
+
+bool TextFileReader::ReadCharacter(char character)
+{
+    if (m_position != m_end && *m_position == character)
+    {
+        ++m_position;
+        return true;
+    }
+    return false;
+}
+
+void TextFileReader::SkipWhitespace()
+{
+    while (m_position != m_end && IsWhitespace(*m_position))
+    {
+        ++m_position;
+    }
+}
+
+}
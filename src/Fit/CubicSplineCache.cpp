@@ -0,0 +1,124 @@
+/**
+ * Contains the implementation of the process wide cache of cubic splines.
+ */
+#include <SpectralEvaluation/Fit/CubicSplineCache.h>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace MathFit
+{
+namespace
+{
+    struct SplineCache
+    {
+        std::mutex guard;
+
+        // The splines, identified by the hash of their data points. Different data may give the same hash,
+        //  hence the data points are compared as well when searching for a spline.
+        std::unordered_multimap<std::uint64_t, std::weak_ptr<const CCubicSplineCoefficients>> splines;
+    };
+
+    SplineCache& GetCache()
+    {
+        static SplineCache cache;
+        return cache;
+    }
+
+    // 64-bit FNV-1a hash of the values in the vector.
+    std::uint64_t Hash(const CVector& vValues, std::uint64_t hash)
+    {
+        const int iSize = vValues.GetSize();
+        for (int i = 0; i < iSize; ++i)
+        {
+            const TFitData value = vValues.GetAt(i);
+            unsigned char bytes[sizeof(TFitData)];
+            memcpy(bytes, &value, sizeof(TFitData));
+
+            for (unsigned char byte : bytes)
+            {
+                hash ^= byte;
+                hash *= 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+
+    void RemoveExpiredSplines(SplineCache& cache)
+    {
+        for (auto it = cache.splines.begin(); it != cache.splines.end();)
+        {
+            if (it->second.expired())
+            {
+                it = cache.splines.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+std::shared_ptr<const CCubicSplineCoefficients> CCubicSplineCache::GetCoefficients(CVector& vXValues, CVector& vYValues)
+{
+    const std::uint64_t key = Hash(vYValues, Hash(vXValues, 14695981039346656037ULL ^ static_cast<std::uint64_t>(vXValues.GetSize())));
+
+    SplineCache& cache = GetCache();
+    {
+        std::lock_guard<std::mutex> lock(cache.guard);
+
+        const auto range = cache.splines.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            std::shared_ptr<const CCubicSplineCoefficients> spline = it->second.lock();
+            if (spline && spline->IsCalculatedFrom(vXValues, vYValues))
+            {
+                return spline;
+            }
+        }
+    }
+
+    // Calculate the spline without holding the lock, this is the expensive part.
+    std::shared_ptr<CCubicSplineCoefficients> spline = std::make_shared<CCubicSplineCoefficients>();
+    if (!spline->Initialize(vXValues, vYValues))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(cache.guard);
+
+    // Another thread may have added the same spline in the meantime, if so then use that one.
+    const auto range = cache.splines.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        std::shared_ptr<const CCubicSplineCoefficients> existingSpline = it->second.lock();
+        if (existingSpline && existingSpline->IsCalculatedFrom(vXValues, vYValues))
+        {
+            return existingSpline;
+        }
+    }
+
+    RemoveExpiredSplines(cache);
+    cache.splines.emplace(key, spline);
+
+    return spline;
+}
+
+int CCubicSplineCache::GetSize()
+{
+    SplineCache& cache = GetCache();
+    std::lock_guard<std::mutex> lock(cache.guard);
+
+    int numberOfSplines = 0;
+    for (const auto& entry : cache.splines)
+    {
+        if (!entry.second.expired())
+        {
+            ++numberOfSplines;
+        }
+    }
+    return numberOfSplines;
+}
+}
@@ -0,0 +1,520 @@
+/**
+ * Contains the implementation of the CVector and CMatrix kernels, with one version for each supported instruction set.
+ */
+#include <SpectralEvaluation/Fit/VectorKernels.h>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MATHFIT_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define MATHFIT_TARGET_SSE2 __attribute__((target("sse2")))
+#define MATHFIT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MATHFIT_TARGET_SSE2
+#define MATHFIT_TARGET_AVX2
+#endif
+
+namespace MathFit
+{
+namespace Kernels
+{
+namespace
+{
+    /** The set of kernels implemented with one instruction set. */
+    struct KernelTable
+    {
+        EInstructionSet instructionSet;
+        void(*add)(double*, const double*, int);
+        void(*sub)(double*, const double*, int);
+        void(*addScaled)(double*, const double*, double, int);
+        void(*mul)(double*, const double*, int);
+        void(*div)(double*, const double*, int);
+        void(*addScalar)(double*, double, int);
+        void(*mulScalar)(double*, double, int);
+        void(*divScalar)(double*, double, int);
+        double(*dot)(const double*, const double*, int);
+        void(*polynomialValues)(double*, const double*, int, const double*, int);
+    };
+
+    // ---------------------------------- Scalar ----------------------------------
+
+    void AddScalarImpl(double* fData, const double* fOperand, int iLength)
+    {
+        for (int i = 0; i < iLength; i++)
+            fData[i] += fOperand[i];
+    }
+
+    void SubScalarImpl(double* fData, const double* fOperand, int iLength)
+    {
+        for (int i = 0; i < iLength; i++)
+            fData[i] -= fOperand[i];
+    }
+
+    void AddScaledScalarImpl(double* fData, const double* fOperand, double fFactor, int iLength)
+    {
+        for (int i = 0; i < iLength; i++)
+            fData[i] += fFactor * fOperand[i];
+    }
+
+    void MulScalarImpl(double* fData, const double* fOperand, int iLength)
+    {
+        for (int i = 0; i < iLength; i++)
+            fData[i] *= fOperand[i];
+    }
+
+    void DivScalarImpl(double* fData, const double* fOperand, int iLength)
+    {
+        for (int i = 0; i < iLength; i++)
+            fData[i] /= fOperand[i];
+    }
+
+    void AddScalarScalarImpl(double* fData, double fScalar, int iLength)
+    {
+        for (int i = 0; i < iLength; i++)
+            fData[i] += fScalar;
+    }
+
+    void MulScalarScalarImpl(double* fData, double fScalar, int iLength)
+    {
+        for (int i = 0; i < iLength; i++)
+            fData[i] *= fScalar;
+    }
+
+    void DivScalarScalarImpl(double* fData, double fScalar, int iLength)
+    {
+        for (int i = 0; i < iLength; i++)
+            fData[i] /= fScalar;
+    }
+
+    double DotScalarImpl(const double* fFirst, const double* fSecond, int iLength)
+    {
+        double fSum = 0;
+        for (int i = 0; i < iLength; i++)
+            fSum += fFirst[i] * fSecond[i];
+        return fSum;
+    }
+
+    void PolynomialValuesScalarImpl(double* fResult, const double* fX, int iLength, const double* fCoefficients, int iNumberOfCoefficients)
+    {
+        for (int i = 0; i < iLength; i++)
+        {
+            double fValue = fCoefficients[iNumberOfCoefficients - 1];
+            for (int k = iNumberOfCoefficients - 2; k >= 0; k--)
+                fValue = fX[i] * fValue + fCoefficients[k];
+            fResult[i] = fValue;
+        }
+    }
+
+    const KernelTable scalarKernels =
+    {
+        SCALAR,
+        AddScalarImpl, SubScalarImpl, AddScaledScalarImpl, MulScalarImpl, DivScalarImpl,
+        AddScalarScalarImpl, MulScalarScalarImpl, DivScalarScalarImpl,
+        DotScalarImpl,
+        PolynomialValuesScalarImpl
+    };
+
+#if defined(MATHFIT_KERNELS_X86)
+
+    // ---------------------------------- SSE2 ----------------------------------
+
+    MATHFIT_TARGET_SSE2 void AddSse2Impl(double* fData, const double* fOperand, int iLength)
+    {
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+            _mm_storeu_pd(fData + i, _mm_add_pd(_mm_loadu_pd(fData + i), _mm_loadu_pd(fOperand + i)));
+        for (; i < iLength; i++)
+            fData[i] += fOperand[i];
+    }
+
+    MATHFIT_TARGET_SSE2 void SubSse2Impl(double* fData, const double* fOperand, int iLength)
+    {
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+            _mm_storeu_pd(fData + i, _mm_sub_pd(_mm_loadu_pd(fData + i), _mm_loadu_pd(fOperand + i)));
+        for (; i < iLength; i++)
+            fData[i] -= fOperand[i];
+    }
+
+    MATHFIT_TARGET_SSE2 void AddScaledSse2Impl(double* fData, const double* fOperand, double fFactor, int iLength)
+    {
+        const __m128d factor = _mm_set1_pd(fFactor);
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+            _mm_storeu_pd(fData + i, _mm_add_pd(_mm_loadu_pd(fData + i), _mm_mul_pd(factor, _mm_loadu_pd(fOperand + i))));
+        for (; i < iLength; i++)
+            fData[i] += fFactor * fOperand[i];
+    }
+
+    MATHFIT_TARGET_SSE2 void MulSse2Impl(double* fData, const double* fOperand, int iLength)
+    {
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+            _mm_storeu_pd(fData + i, _mm_mul_pd(_mm_loadu_pd(fData + i), _mm_loadu_pd(fOperand + i)));
+        for (; i < iLength; i++)
+            fData[i] *= fOperand[i];
+    }
+
+    MATHFIT_TARGET_SSE2 void DivSse2Impl(double* fData, const double* fOperand, int iLength)
+    {
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+            _mm_storeu_pd(fData + i, _mm_div_pd(_mm_loadu_pd(fData + i), _mm_loadu_pd(fOperand + i)));
+        for (; i < iLength; i++)
+            fData[i] /= fOperand[i];
+    }
+
+    MATHFIT_TARGET_SSE2 void AddScalarSse2Impl(double* fData, double fScalar, int iLength)
+    {
+        const __m128d scalar = _mm_set1_pd(fScalar);
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+            _mm_storeu_pd(fData + i, _mm_add_pd(_mm_loadu_pd(fData + i), scalar));
+        for (; i < iLength; i++)
+            fData[i] += fScalar;
+    }
+
+    MATHFIT_TARGET_SSE2 void MulScalarSse2Impl(double* fData, double fScalar, int iLength)
+    {
+        const __m128d scalar = _mm_set1_pd(fScalar);
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+            _mm_storeu_pd(fData + i, _mm_mul_pd(_mm_loadu_pd(fData + i), scalar));
+        for (; i < iLength; i++)
+            fData[i] *= fScalar;
+    }
+
+    MATHFIT_TARGET_SSE2 void DivScalarSse2Impl(double* fData, double fScalar, int iLength)
+    {
+        const __m128d scalar = _mm_set1_pd(fScalar);
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+            _mm_storeu_pd(fData + i, _mm_div_pd(_mm_loadu_pd(fData + i), scalar));
+        for (; i < iLength; i++)
+            fData[i] /= fScalar;
+    }
+
+    MATHFIT_TARGET_SSE2 double DotSse2Impl(const double* fFirst, const double* fSecond, int iLength)
+    {
+        // two independent accumulators to hide the latency of the additions
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+        {
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(fFirst + i), _mm_loadu_pd(fSecond + i)));
+            sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(fFirst + i + 2), _mm_loadu_pd(fSecond + i + 2)));
+        }
+        sum0 = _mm_add_pd(sum0, sum1);
+
+        double partial[2];
+        _mm_storeu_pd(partial, sum0);
+        double fSum = partial[0] + partial[1];
+        for (; i < iLength; i++)
+            fSum += fFirst[i] * fSecond[i];
+        return fSum;
+    }
+
+    MATHFIT_TARGET_SSE2 void PolynomialValuesSse2Impl(double* fResult, const double* fX, int iLength, const double* fCoefficients, int iNumberOfCoefficients)
+    {
+        const __m128d highestCoefficient = _mm_set1_pd(fCoefficients[iNumberOfCoefficients - 1]);
+        int i = 0;
+        for (; i + 2 <= iLength; i += 2)
+        {
+            const __m128d x = _mm_loadu_pd(fX + i);
+            __m128d value = highestCoefficient;
+            for (int k = iNumberOfCoefficients - 2; k >= 0; k--)
+                value = _mm_add_pd(_mm_mul_pd(x, value), _mm_set1_pd(fCoefficients[k]));
+            _mm_storeu_pd(fResult + i, value);
+        }
+        PolynomialValuesScalarImpl(fResult + i, fX + i, iLength - i, fCoefficients, iNumberOfCoefficients);
+    }
+
+    const KernelTable sse2Kernels =
+    {
+        SSE2,
+        AddSse2Impl, SubSse2Impl, AddScaledSse2Impl, MulSse2Impl, DivSse2Impl,
+        AddScalarSse2Impl, MulScalarSse2Impl, DivScalarSse2Impl,
+        DotSse2Impl,
+        PolynomialValuesSse2Impl
+    };
+
+    // ---------------------------------- AVX2 ----------------------------------
+    // Notice that fused multiply-add is deliberately not used, such that the element-wise kernels
+    //  give exactly the same result as the scalar versions.
+
+    MATHFIT_TARGET_AVX2 void AddAvx2Impl(double* fData, const double* fOperand, int iLength)
+    {
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+            _mm256_storeu_pd(fData + i, _mm256_add_pd(_mm256_loadu_pd(fData + i), _mm256_loadu_pd(fOperand + i)));
+        for (; i < iLength; i++)
+            fData[i] += fOperand[i];
+    }
+
+    MATHFIT_TARGET_AVX2 void SubAvx2Impl(double* fData, const double* fOperand, int iLength)
+    {
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+            _mm256_storeu_pd(fData + i, _mm256_sub_pd(_mm256_loadu_pd(fData + i), _mm256_loadu_pd(fOperand + i)));
+        for (; i < iLength; i++)
+            fData[i] -= fOperand[i];
+    }
+
+    MATHFIT_TARGET_AVX2 void AddScaledAvx2Impl(double* fData, const double* fOperand, double fFactor, int iLength)
+    {
+        const __m256d factor = _mm256_set1_pd(fFactor);
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+            _mm256_storeu_pd(fData + i, _mm256_add_pd(_mm256_loadu_pd(fData + i), _mm256_mul_pd(factor, _mm256_loadu_pd(fOperand + i))));
+        for (; i < iLength; i++)
+            fData[i] += fFactor * fOperand[i];
+    }
+
+    MATHFIT_TARGET_AVX2 void MulAvx2Impl(double* fData, const double* fOperand, int iLength)
+    {
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+            _mm256_storeu_pd(fData + i, _mm256_mul_pd(_mm256_loadu_pd(fData + i), _mm256_loadu_pd(fOperand + i)));
+        for (; i < iLength; i++)
+            fData[i] *= fOperand[i];
+    }
+
+    MATHFIT_TARGET_AVX2 void DivAvx2Impl(double* fData, const double* fOperand, int iLength)
+    {
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+            _mm256_storeu_pd(fData + i, _mm256_div_pd(_mm256_loadu_pd(fData + i), _mm256_loadu_pd(fOperand + i)));
+        for (; i < iLength; i++)
+            fData[i] /= fOperand[i];
+    }
+
+    MATHFIT_TARGET_AVX2 void AddScalarAvx2Impl(double* fData, double fScalar, int iLength)
+    {
+        const __m256d scalar = _mm256_set1_pd(fScalar);
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+            _mm256_storeu_pd(fData + i, _mm256_add_pd(_mm256_loadu_pd(fData + i), scalar));
+        for (; i < iLength; i++)
+            fData[i] += fScalar;
+    }
+
+    MATHFIT_TARGET_AVX2 void MulScalarAvx2Impl(double* fData, double fScalar, int iLength)
+    {
+        const __m256d scalar = _mm256_set1_pd(fScalar);
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+            _mm256_storeu_pd(fData + i, _mm256_mul_pd(_mm256_loadu_pd(fData + i), scalar));
+        for (; i < iLength; i++)
+            fData[i] *= fScalar;
+    }
+
+    MATHFIT_TARGET_AVX2 void DivScalarAvx2Impl(double* fData, double fScalar, int iLength)
+    {
+        const __m256d scalar = _mm256_set1_pd(fScalar);
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+            _mm256_storeu_pd(fData + i, _mm256_div_pd(_mm256_loadu_pd(fData + i), scalar));
+        for (; i < iLength; i++)
+            fData[i] /= fScalar;
+    }
+
+    MATHFIT_TARGET_AVX2 double DotAvx2Impl(const double* fFirst, const double* fSecond, int iLength)
+    {
+        // two independent accumulators to hide the latency of the additions
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= iLength; i += 8)
+        {
+            sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(fFirst + i), _mm256_loadu_pd(fSecond + i)));
+            sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_loadu_pd(fFirst + i + 4), _mm256_loadu_pd(fSecond + i + 4)));
+        }
+        sum0 = _mm256_add_pd(sum0, sum1);
+
+        double partial[4];
+        _mm256_storeu_pd(partial, sum0);
+        double fSum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+        for (; i < iLength; i++)
+            fSum += fFirst[i] * fSecond[i];
+        return fSum;
+    }
+
+    MATHFIT_TARGET_AVX2 void PolynomialValuesAvx2Impl(double* fResult, const double* fX, int iLength, const double* fCoefficients, int iNumberOfCoefficients)
+    {
+        const __m256d highestCoefficient = _mm256_set1_pd(fCoefficients[iNumberOfCoefficients - 1]);
+        int i = 0;
+        for (; i + 4 <= iLength; i += 4)
+        {
+            const __m256d x = _mm256_loadu_pd(fX + i);
+            __m256d value = highestCoefficient;
+            for (int k = iNumberOfCoefficients - 2; k >= 0; k--)
+                value = _mm256_add_pd(_mm256_mul_pd(x, value), _mm256_set1_pd(fCoefficients[k]));
+            _mm256_storeu_pd(fResult + i, value);
+        }
+        PolynomialValuesScalarImpl(fResult + i, fX + i, iLength - i, fCoefficients, iNumberOfCoefficients);
+    }
+
+    const KernelTable avx2Kernels =
+    {
+        AVX2,
+        AddAvx2Impl, SubAvx2Impl, AddScaledAvx2Impl, MulAvx2Impl, DivAvx2Impl,
+        AddScalarAvx2Impl, MulScalarAvx2Impl, DivScalarAvx2Impl,
+        DotAvx2Impl,
+        PolynomialValuesAvx2Impl
+    };
+
+#endif // MATHFIT_KERNELS_X86
+
+    EInstructionSet DetectInstructionSet()
+    {
+#if defined(MATHFIT_KERNELS_X86) && defined(__GNUC__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return AVX2;
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return SSE2;
+        }
+        return SCALAR;
+#elif defined(MATHFIT_KERNELS_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int highestLeaf = info[0];
+
+        __cpuid(info, 1);
+        const bool hasSse2 = (info[3] & (1 << 26)) != 0;
+        const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+        const bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+        // the operating system must also save the ymm registers on context switches
+        const bool osSupportsAvx = hasOsxsave && hasAvx && ((_xgetbv(0) & 0x6) == 0x6);
+
+        if (osSupportsAvx && highestLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            if ((info[1] & (1 << 5)) != 0)
+            {
+                return AVX2;
+            }
+        }
+        return hasSse2 ? SSE2 : SCALAR;
+#else
+        return SCALAR;
+#endif
+    }
+
+    const KernelTable* GetKernelTable(EInstructionSet eInstructionSet)
+    {
+#if defined(MATHFIT_KERNELS_X86)
+        switch (eInstructionSet)
+        {
+        case AVX2: return &avx2Kernels;
+        case SSE2: return &sse2Kernels;
+        default: return &scalarKernels;
+        }
+#else
+        (void)eInstructionSet;
+        return &scalarKernels;
+#endif
+    }
+
+    std::atomic<const KernelTable*>& ActiveKernels()
+    {
+        static std::atomic<const KernelTable*> activeKernels(GetKernelTable(GetSupportedInstructionSet()));
+        return activeKernels;
+    }
+
+    inline const KernelTable& Active()
+    {
+        return *ActiveKernels().load(std::memory_order_relaxed);
+    }
+}
+
+EInstructionSet GetSupportedInstructionSet()
+{
+    static const EInstructionSet supportedInstructionSet = DetectInstructionSet();
+    return supportedInstructionSet;
+}
+
+EInstructionSet GetInstructionSet()
+{
+    return Active().instructionSet;
+}
+
+EInstructionSet SetInstructionSet(EInstructionSet eInstructionSet)
+{
+    if (eInstructionSet > GetSupportedInstructionSet())
+    {
+        eInstructionSet = GetSupportedInstructionSet();
+    }
+    ActiveKernels().store(GetKernelTable(eInstructionSet));
+    return eInstructionSet;
+}
+
+void Add(double* fData, const double* fOperand, int iLength)
+{
+    Active().add(fData, fOperand, iLength);
+}
+
+void Sub(double* fData, const double* fOperand, int iLength)
+{
+    Active().sub(fData, fOperand, iLength);
+}
+
+void AddScaled(double* fData, const double* fOperand, double fFactor, int iLength)
+{
+    Active().addScaled(fData, fOperand, fFactor, iLength);
+}
+
+void Mul(double* fData, const double* fOperand, int iLength)
+{
+    Active().mul(fData, fOperand, iLength);
+}
+
+void Div(double* fData, const double* fOperand, int iLength)
+{
+    Active().div(fData, fOperand, iLength);
+}
+
+void AddScalar(double* fData, double fScalar, int iLength)
+{
+    Active().addScalar(fData, fScalar, iLength);
+}
+
+void MulScalar(double* fData, double fScalar, int iLength)
+{
+    Active().mulScalar(fData, fScalar, iLength);
+}
+
+void DivScalar(double* fData, double fScalar, int iLength)
+{
+    Active().divScalar(fData, fScalar, iLength);
+}
+
+double Dot(const double* fFirst, const double* fSecond, int iLength)
+{
+    return Active().dot(fFirst, fSecond, iLength);
+}
+
+void PolynomialValues(double* fResult, const double* fX, int iLength, const double* fCoefficients, int iNumberOfCoefficients)
+{
+    if (iNumberOfCoefficients <= 0)
+    {
+        for (int i = 0; i < iLength; i++)
+            fResult[i] = 0.0;
+        return;
+    }
+    Active().polynomialValues(fResult, fX, iLength, fCoefficients, iNumberOfCoefficients);
+}
+
+}
+}
@@ -1,6 +1,7 @@
 #include <SpectralEvaluation/Flux/PlumeInScanProperty.h>
 #include <SpectralEvaluation/VectorUtils.h>
 #include <SpectralEvaluation/Evaluation/BasicScanEvaluationResult.h>
+#include <SpectralEvaluation/File/EvaluationLogCache.h>
 #include <SpectralEvaluation/VectorUtils.h>
 #include <algorithm>
 #include <cassert>
@@ -158,6 +159,24 @@ double CalculatePlumeOffset(const BasicScanEvaluationResult& evaluatedScan, int
     return plumeProperties.offset;
 }
 
+double CalculatePlumeOffset(const CachedScanResult& evaluatedScan, int specieIdx, CPlumeInScanProperty& plumeProperties)
+{
+    assert(static_cast<int>(evaluatedScan.column.size()) >= specieIdx + 1);
+
+    std::vector<double> columns;
+    for (size_t idx = 0; idx < evaluatedScan.numberOfSpectra; ++idx)
+    {
+        if (!evaluatedScan.IsBad(idx))
+        {
+            columns.push_back(evaluatedScan.column[specieIdx][idx]);
+        }
+    }
+
+    plumeProperties.offset = CalculatePlumeOffsetFromGoodColumnValues(columns);
+
+    return plumeProperties.offset;
+}
+
 double CalculatePlumeOffset(const std::vector<double>& columns, const std::vector<bool>& badEvaluation, long numPoints)
 {
     // calculate the offset as the average of the three lowest offsetCorrectedColumn values 
@@ -356,6 +375,32 @@ bool FindPlume(const BasicScanEvaluationResult& evaluatedScan, int specieIdx, do
     return FindPlume(evaluation, plumeProperties, message);
 }
 
+bool FindPlume(const CachedScanResult& evaluatedScan, int specieIdx, double plumeOffset, CPlumeInScanProperty& plumeProperties, std::string* message)
+{
+    assert(static_cast<int>(evaluatedScan.column.size()) >= specieIdx + 1);
+
+    std::vector< ScanEvaluationData> evaluation;
+    evaluation.reserve(evaluatedScan.numberOfSpectra);
+
+    for (size_t idx = 0; idx < evaluatedScan.numberOfSpectra; ++idx)
+    {
+        if (evaluatedScan.IsBad(idx))
+        {
+            continue;
+        }
+
+        ScanEvaluationData data;
+        data.scanAngle = evaluatedScan.scanAngle[idx];
+        data.scanAngle2 = evaluatedScan.scanAngle2[idx];
+        data.offsetCorrectedColumn = evaluatedScan.column[specieIdx][idx] - plumeOffset;
+        data.columnError = evaluatedScan.columnError[specieIdx][idx];
+
+        evaluation.push_back(data);
+    }
+
+    return FindPlume(evaluation, plumeProperties, message);
+}
+
 
 // VERSION 1: FROM NOVACPROGRAM
 bool FindPlume(
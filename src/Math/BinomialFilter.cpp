@@ -0,0 +1,202 @@
+#include <SpectralEvaluation/Math/BinomialFilter.h>
+#include <SpectralEvaluation/Math/FFT.h>
+#include <algorithm>
+#include <cstring>
+
+namespace novac
+{
+
+// The kernel is truncated where its values are smaller than this, relative to the central value.
+static const double negligibleKernelValue = 1e-20;
+
+// The shortest fft used, very short transforms are not worth optimizing for.
+static const size_t minimumFftLength = 64;
+
+BinomialFilter::BinomialFilter(size_t length, int iterations)
+    : m_length(length), m_iterations(std::max(iterations, 0))
+{
+    if (m_length < 2 || m_iterations == 0)
+    {
+        // Nothing to filter.
+        return;
+    }
+
+    // The kernel C(2N, N + k) / 4^N, calculated relative to the central value using the
+    //  ratio between consecutive binomial coefficients and then normalized to unit sum.
+    const size_t iterationCount = static_cast<size_t>(m_iterations);
+    std::vector<double> kernel{ 1.0 };
+    double kernelSum = 1.0;
+    for (size_t k = 1; k <= iterationCount; ++k)
+    {
+        const double value = kernel.back() * (double)(iterationCount - k + 1) / (double)(iterationCount + k);
+        if (value < negligibleKernelValue)
+        {
+            break;
+        }
+        kernel.push_back(value);
+        kernelSum += 2.0 * value;
+    }
+    m_radius = kernel.size() - 1;
+
+    m_fftLength = minimumFftLength;
+    while (m_fftLength < m_length + 2 * m_radius)
+    {
+        m_fftLength *= 2;
+    }
+
+    m_workspace.reset(new Workspace());
+    SetupWorkspace(*m_workspace);
+
+    // The kernel is symmetric, hence its Fourier transform is real valued.
+    std::vector<double>& circularKernel = m_workspace->extendedData;
+    std::fill(circularKernel.begin(), circularKernel.end(), 0.0);
+    circularKernel[0] = kernel[0] / kernelSum;
+    for (size_t k = 1; k <= m_radius; ++k)
+    {
+        circularKernel[k] = kernel[k] / kernelSum;
+        circularKernel[m_fftLength - k] = kernel[k] / kernelSum;
+    }
+    m_workspace->plan->Forward(circularKernel.data(), m_workspace->spectrum.data());
+
+    // Include the scaling of the inverse transform
+    const double scale = 1.0 / (double)m_fftLength;
+    m_kernelSpectrum.resize(m_workspace->spectrum.size());
+    for (size_t ii = 0; ii < m_kernelSpectrum.size(); ++ii)
+    {
+        m_kernelSpectrum[ii] = m_workspace->spectrum[ii].real() * scale;
+    }
+}
+
+BinomialFilter::~BinomialFilter()
+{
+}
+
+void BinomialFilter::SetupWorkspace(Workspace& workspace) const
+{
+    workspace.plan.reset(new RealFftPlan(m_fftLength));
+    workspace.extendedData.resize(m_fftLength);
+    workspace.spectrum.resize(workspace.plan->SpectrumLength());
+}
+
+const double* BinomialFilter::CalculateLowPass(Workspace& workspace, const double* data) const
+{
+    // Extend the data by mirroring it around its edges, which is what repeating the first and last value in every iteration corresponds to.
+    //  The data is mirrored back and forth if it is shorter than the kernel.
+    const long long length = static_cast<long long>(m_length);
+    const long long radius = static_cast<long long>(m_radius);
+    double* extendedData = workspace.extendedData.data();
+    for (long long ii = 0; ii < radius; ++ii)
+    {
+        long long index = (ii - radius) % (2 * length);
+        index = (index < 0) ? index + 2 * length : index;
+        extendedData[ii] = data[(index < length) ? index : 2 * length - 1 - index];
+
+        index = (length + ii) % (2 * length);
+        extendedData[radius + length + ii] = data[(index < length) ? index : 2 * length - 1 - index];
+    }
+    memcpy(extendedData + radius, data, m_length * sizeof(double));
+    std::fill(workspace.extendedData.begin() + (m_length + 2 * m_radius), workspace.extendedData.end(), 0.0);
+
+    workspace.plan->Forward(extendedData, workspace.spectrum.data());
+    for (size_t ii = 0; ii < m_kernelSpectrum.size(); ++ii)
+    {
+        workspace.spectrum[ii] *= m_kernelSpectrum[ii];
+    }
+    workspace.plan->Inverse(workspace.spectrum.data(), extendedData);
+
+    return extendedData + radius;
+}
+
+void BinomialFilter::HighPass(Workspace& workspace, double* data) const
+{
+    const double* lowPass = CalculateLowPass(workspace, data);
+
+    for (size_t ii = 0; ii < m_length; ++ii)
+    {
+        if (lowPass[ii] != 0.0)
+        {
+            data[ii] /= lowPass[ii];
+        }
+        else
+        {
+            data[ii] = 0;
+        }
+    }
+}
+
+void BinomialFilter::LowPass(double* data)
+{
+    if (m_workspace == nullptr)
+    {
+        return;
+    }
+
+    const double* lowPass = CalculateLowPass(*m_workspace, data);
+    memcpy(data, lowPass, m_length * sizeof(double));
+}
+
+void BinomialFilter::HighPass(double* data)
+{
+    if (m_workspace == nullptr)
+    {
+        // The low pass filtered data equals the data
+        for (size_t ii = 0; ii < m_length; ++ii)
+        {
+            data[ii] = (data[ii] != 0.0) ? 1.0 : 0.0;
+        }
+        return;
+    }
+
+    HighPass(*m_workspace, data);
+}
+
+void BinomialFilter::LowPass(const std::vector<double*>& spectra)
+{
+    if (m_workspace == nullptr)
+    {
+        return;
+    }
+
+    const int numberOfSpectra = static_cast<int>(spectra.size());
+
+#pragma omp parallel if(numberOfSpectra > 1)
+    {
+        Workspace workspace;
+        SetupWorkspace(workspace);
+
+#pragma omp for schedule(static)
+        for (int spectrumIdx = 0; spectrumIdx < numberOfSpectra; ++spectrumIdx)
+        {
+            const double* lowPass = CalculateLowPass(workspace, spectra[spectrumIdx]);
+            memcpy(spectra[spectrumIdx], lowPass, m_length * sizeof(double));
+        }
+    }
+}
+
+void BinomialFilter::HighPass(const std::vector<double*>& spectra)
+{
+    if (m_workspace == nullptr)
+    {
+        for (double* data : spectra)
+        {
+            HighPass(data);
+        }
+        return;
+    }
+
+    const int numberOfSpectra = static_cast<int>(spectra.size());
+
+#pragma omp parallel if(numberOfSpectra > 1)
+    {
+        Workspace workspace;
+        SetupWorkspace(workspace);
+
+#pragma omp for schedule(static)
+        for (int spectrumIdx = 0; spectrumIdx < numberOfSpectra; ++spectrumIdx)
+        {
+            HighPass(workspace, spectra[spectrumIdx]);
+        }
+    }
+}
+
+}
@@ -1,4 +1,6 @@
 #include <SpectralEvaluation/Math/FFT.h>
+#include <new>
+#include <stdexcept>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -148,6 +150,43 @@ void Fft_Real(const std::vector<double>& input, std::vector<std::complex<double>
     }
 }
 
+// kiss_fft_cpx and std::complex<double> have the same layout, which lets the plan transform the callers buffers directly.
+static_assert(sizeof(kiss_fft_cpx) == sizeof(std::complex<double>), "kiss_fft_cpx must have the same layout as std::complex<double>");
+
+RealFftPlan::RealFftPlan(size_t length)
+    : m_length(length)
+{
+    if (length == 0 || length % 2 != 0)
+    {
+        throw std::invalid_argument("The length of a real valued FFT must be an even number");
+    }
+
+    m_forwardConfiguration = kiss_fftr_alloc(static_cast<int>(length), 0, nullptr, nullptr);
+    m_inverseConfiguration = kiss_fftr_alloc(static_cast<int>(length), 1, nullptr, nullptr);
+    if (m_forwardConfiguration == nullptr || m_inverseConfiguration == nullptr)
+    {
+        kiss_fftr_free(m_forwardConfiguration);
+        kiss_fftr_free(m_inverseConfiguration);
+        throw std::bad_alloc();
+    }
+}
+
+RealFftPlan::~RealFftPlan()
+{
+    kiss_fftr_free(m_forwardConfiguration);
+    kiss_fftr_free(m_inverseConfiguration);
+}
+
+void RealFftPlan::Forward(const double* input, std::complex<double>* spectrum) const
+{
+    kiss_fftr(static_cast<kiss_fftr_cfg>(m_forwardConfiguration), input, reinterpret_cast<kiss_fft_cpx*>(spectrum));
+}
+
+void RealFftPlan::Inverse(const std::complex<double>* spectrum, double* output) const
+{
+    kiss_fftri(static_cast<kiss_fftr_cfg>(m_inverseConfiguration), reinterpret_cast<const kiss_fft_cpx*>(spectrum), output);
+}
+
 }
 
 #ifdef _MSC_VER
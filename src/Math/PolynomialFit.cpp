@@ -3,6 +3,7 @@
 #include <SpectralEvaluation/Fit/StandardMetricFunction.h>
 #include <SpectralEvaluation/Fit/CubicSplineFunction.h>
 #include <SpectralEvaluation/Fit/PolynomialFunction.h>
+#include <SpectralEvaluation/Fit/VectorKernels.h>
 #include <numeric>
 
 namespace novac
@@ -251,6 +252,12 @@ double PolynomialValueAt(const std::vector<double>& coefficients, double x)
     return value;
 }
 
+void PolynomialValuesAt(const std::vector<double>& coefficients, const std::vector<double>& x, std::vector<double>& result)
+{
+    result.resize(x.size());
+    MathFit::Kernels::PolynomialValues(result.data(), x.data(), static_cast<int>(x.size()), coefficients.data(), static_cast<int>(coefficients.size()));
+}
+
 
 bool FindRoots(const std::vector<double>& polynomial, std::vector<std::complex<double>>& roots)
 {
@@ -0,0 +1,169 @@
+#include <SpectralEvaluation/Spectra/ScanSpectrumReduction.h>
+#include <SpectralEvaluation/Spectra/IScanSpectrumSource.h>
+#include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <SpectralEvaluation/Fit/VectorKernels.h>
+#include <algorithm>
+
+namespace novac
+{
+
+// The number of values (spectra times pixels) to add before it is worth starting more threads.
+static const long minimumValuesForParallelSum = 64 * 2048;
+
+bool IsGoodSpectrum(const CSpectrum& spectrum, const GoodSpectrumCriteria& criteria)
+{
+    if (spectrum.m_length <= 0)
+    {
+        return false;
+    }
+
+    if (criteria.maximumIntensityForSingleReadout > 0.0)
+    {
+        const double intensityInRange = spectrum.MaxValue(criteria.fromPixel, criteria.toPixel);
+        if (intensityInRange >= criteria.maximumIntensityForSingleReadout * spectrum.NumSpectra())
+        {
+            return false;
+        }
+    }
+
+    return !(criteria.excludeDarkSpectra && spectrum.IsDark());
+}
+
+int SumGoodSpectra(const std::vector<CSpectrum>& spectra, const GoodSpectrumCriteria& criteria, CSpectrum& result)
+{
+    const int numberOfSpectra = static_cast<int>(spectra.size());
+
+    std::vector<char> isGood(spectra.size(), 0);
+
+#pragma omp parallel for schedule(static) if(numberOfSpectra > 8)
+    for (int spectrumIdx = 0; spectrumIdx < numberOfSpectra; ++spectrumIdx)
+    {
+        isGood[spectrumIdx] = IsGoodSpectrum(spectra[spectrumIdx], criteria) ? 1 : 0;
+    }
+
+    // The first good spectrum determines the length and the meta data of the result.
+    int firstGoodSpectrum = 0;
+    while (firstGoodSpectrum < numberOfSpectra && !isGood[firstGoodSpectrum])
+    {
+        ++firstGoodSpectrum;
+    }
+    if (firstGoodSpectrum == numberOfSpectra)
+    {
+        result.Clear();
+        return 0;
+    }
+
+    result = spectra[firstGoodSpectrum];
+    const long length = result.m_length;
+
+    int numberOfGoodSpectra = 1;
+    for (int spectrumIdx = firstGoodSpectrum + 1; spectrumIdx < numberOfSpectra; ++spectrumIdx)
+    {
+        const CSpectrum& spectrum = spectra[spectrumIdx];
+        if (!isGood[spectrumIdx] || spectrum.m_length != length)
+        {
+            isGood[spectrumIdx] = 0;
+            continue;
+        }
+
+        // Combine the meta data in the same way as CSpectrum::Add
+        result.m_info.m_numSpec += spectrum.m_info.m_numSpec;
+        if (spectrum.m_info.m_startTime < result.m_info.m_startTime)
+        {
+            result.m_info.m_startTime = spectrum.m_info.m_startTime;
+        }
+        if (result.m_info.m_stopTime < spectrum.m_info.m_stopTime)
+        {
+            result.m_info.m_stopTime = spectrum.m_info.m_stopTime;
+        }
+        ++numberOfGoodSpectra;
+    }
+
+    if (numberOfGoodSpectra == 1)
+    {
+        return 1;
+    }
+
+    // Each thread sums its share of the spectra into its own buffer, these are then added to the result.
+    const bool runInParallel = (numberOfGoodSpectra * length >= minimumValuesForParallelSum);
+
+#pragma omp parallel if(runInParallel)
+    {
+        std::vector<double> partialSum(length, 0.0);
+        bool hasPartialSum = false;
+
+#pragma omp for schedule(static) nowait
+        for (int spectrumIdx = firstGoodSpectrum + 1; spectrumIdx < numberOfSpectra; ++spectrumIdx)
+        {
+            if (isGood[spectrumIdx])
+            {
+                MathFit::Kernels::Add(partialSum.data(), spectra[spectrumIdx].m_data, static_cast<int>(length));
+                hasPartialSum = true;
+            }
+        }
+
+        if (hasPartialSum)
+        {
+#pragma omp critical
+            MathFit::Kernels::Add(result.m_data, partialSum.data(), static_cast<int>(length));
+        }
+    }
+
+    return numberOfGoodSpectra;
+}
+
+// Returns the index of the first measured spectrum in the scan, i.e. the first spectrum after the sky, dark, offset and dark-current
+//  spectra at the beginning of the scan. These are the same spectra as are skipped by CScanFileHandler::ResetCounter.
+static int IndexOfFirstMeasuredSpectrum(const IScanSpectrumSource& scan)
+{
+    int index = 0;
+    CSpectrum specialSpectrum;
+
+    if (0 == scan.GetSky(specialSpectrum) && specialSpectrum.ScanIndex() == index)
+    {
+        ++index;
+    }
+    if (0 == scan.GetDark(specialSpectrum) && specialSpectrum.ScanIndex() == index)
+    {
+        ++index;
+    }
+    if (0 == scan.GetOffset(specialSpectrum) && specialSpectrum.ScanIndex() == index)
+    {
+        ++index;
+    }
+    if (0 == scan.GetDarkCurrent(specialSpectrum) && specialSpectrum.ScanIndex() == index)
+    {
+        ++index;
+    }
+
+    return index;
+}
+
+int SumGoodSpectra(novac::LogContext context, IScanSpectrumSource& scan, const GoodSpectrumCriteria& criteria, CSpectrum& result)
+{
+    const int numberOfSpectra = scan.GetSpectrumNumInFile();
+    const int firstMeasuredSpectrum = IndexOfFirstMeasuredSpectrum(scan);
+
+    std::vector<CSpectrum> spectra;
+    spectra.reserve(static_cast<size_t>(std::max(numberOfSpectra - firstMeasuredSpectrum + 1, 1)));
+
+    // The sky spectrum is included first, followed by the measured spectra.
+    CSpectrum sky;
+    if (0 == scan.GetSky(sky))
+    {
+        spectra.push_back(std::move(sky));
+    }
+
+    for (int spectrumIdx = firstMeasuredSpectrum; spectrumIdx < numberOfSpectra; ++spectrumIdx)
+    {
+        CSpectrum spectrum;
+        if (0 == scan.GetSpectrum(context, spectrumIdx, spectrum))
+        {
+            spectra.push_back(std::move(spectrum));
+        }
+    }
+
+    return SumGoodSpectra(spectra, criteria, result);
+}
+
+}
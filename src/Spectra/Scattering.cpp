@@ -2,6 +2,10 @@
 #include <SpectralEvaluation/Spectra/Spectrum.h>
 #include <SpectralEvaluation/Fit/CubicSplineFunction.h>
 #include <SpectralEvaluation/Fit/Vector.h>
+#include <SpectralEvaluation/Fit/VectorKernels.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
 
 /*******************************************************************************
 * DOASIS - DOAS Intelligent System
@@ -333,6 +337,29 @@ CVector Scattering::CalcRamanSpectrum(CVector& vWavelength, CVector& vOrigSpec,
     return vRamanSpec;
 }
 
+// Retrieves a Ring spectrum calculator for the given wavelength grid and parameters. The calculators are kept per thread,
+//  such that calculating the Ring spectrum of many spectra with the same wavelength calibration only sets up the calculator once.
+static RingSpectrumCalculator& GetRingSpectrumCalculator(const std::vector<double>& wavelength, double fTemp, int iJMax, double fMixing)
+{
+    static thread_local std::vector<std::unique_ptr<RingSpectrumCalculator>> calculators;
+
+    for (auto& calculator : calculators)
+    {
+        if (calculator->IsSetupFor(wavelength, fTemp, iJMax, fMixing))
+        {
+            return *calculator;
+        }
+    }
+
+    const size_t maximumNumberOfCalculators = 4;
+    if (calculators.size() == maximumNumberOfCalculators)
+    {
+        calculators.erase(calculators.begin());
+    }
+    calculators.emplace_back(new RingSpectrumCalculator(wavelength, fTemp, iJMax, fMixing));
+    return *calculators.back();
+}
+
 CVector Scattering::CalcRingSpectrum(CVector& vWavelength, CVector& vOrigSpec, double fTemp, int iJMax, double fMixing, double fSZA)
 {
     if (vWavelength.GetSize() <= 0 || vWavelength.GetSize() != vOrigSpec.GetSize())
@@ -340,16 +367,16 @@ CVector Scattering::CalcRingSpectrum(CVector& vWavelength, CVector& vOrigSpec, d
         return CVector();
     }
 
-    // zunchst das Originalspektrum in eine Energie umrechnen (durch lambda teilen)
-    CVector vEnergy(vWavelength.GetSize());
-    vEnergy.Copy(vOrigSpec);
-    vEnergy.DivSimpleSafe(vWavelength);
-
-    // Ramanspektrum berechnen
-    CVector vRingSpec = CalcRamanSpectrum(vWavelength, vEnergy, fTemp, iJMax, fMixing, fSZA);
+    std::vector<double> wavelength(vWavelength.GetSize());
+    std::vector<double> origSpec(vOrigSpec.GetSize());
+    for (int i = 0; i < vWavelength.GetSize(); i++)
+    {
+        wavelength[i] = vWavelength.GetAt(i);
+        origSpec[i] = vOrigSpec.GetAt(i);
+    }
 
-    // Spektren dividieren
-    vRingSpec.DivSimpleSafe(vEnergy);
+    CVector vRingSpec(vWavelength.GetSize());
+    GetRingSpectrumCalculator(wavelength, fTemp, iJMax, fMixing).CalcRingSpectrum(origSpec.data(), vRingSpec.GetSafePtr(), fSZA);
 
     return vRingSpec;
 }
@@ -368,11 +395,179 @@ novac::CSpectrum Scattering::CalcRingSpectrum(novac::CSpectrum& specOrig, double
     CVector vRing = CalcRingSpectrum(wavelength, intensity, fTemp, iJMax, fMixing, fSZA);
 
     novac::CSpectrum specRing;
-    specRing.m_length = vRing.GetSize();
+    specRing.Resize(vRing.GetSize());
     memcpy(specRing.m_data, vRing.GetSafePtr(), vRing.GetSize() * sizeof(double));
     specRing.m_wavelength = std::vector<double>(begin(specOrig.m_wavelength), end(specOrig.m_wavelength));
 
     return specRing;
 }
+
+// The ratio of the phase functions of Raman and Rayleigh scattering at the given SZA, this scales the whole Raman spectrum.
+static double RamanPhaseFunctionRatio(double fSZA)
+{
+    double fTmpC = std::cos(fSZA * RAD_DEG);
+    double fTmpC2 = fTmpC * fTmpC;
+    double fPhiRam = ((1.0 + DEPOL_RAM + (1.0 - DEPOL_RAM) * fTmpC2) / (1.0 + 0.5 * DEPOL_RAM));
+    double fPhiRay = ((1.0 + DEPOL_RAY + (1.0 - DEPOL_RAY) * fTmpC2) / (1.0 + 0.5 * DEPOL_RAY));
+    return fPhiRam / fPhiRay;
+}
+
+RingSpectrumCalculator::RingSpectrumCalculator(const std::vector<double>& vWavelength, double fTemp, int iJMax, double fMixing)
+    : m_wavelength(vWavelength), m_temperature(fTemp), m_jMax(iJMax), m_mixing(fMixing)
+{
+    const int iNChannels = static_cast<int>(m_wavelength.size());
+    m_firstColumn.resize(iNChannels, 0);
+    m_rowStart.resize(iNChannels + 1, 0);
+    m_energy.resize(iNChannels);
+    if (iNChannels == 0)
+    {
+        return;
+    }
+
+    // This follows Scattering::CalcRamanSpectrum, but instead of scattering the intensity of each pixel this
+    //  calculates the weight with which each pixel contributes to the pixels its scattered light falls on.
+    double fGamma2[] = { 0.518, 1.35 };
+    double fB0[] = { 198.96, 143.77 };
+    int iGj[2][2] = { {6, 3},{0, 1} };
+    int iSpin[2] = { 1, 0 };
+
+    CVector vWave(m_wavelength.data(), iNChannels, 1, false);
+    CVector vIndex(iNChannels);
+    vIndex.Wedge(0, 1);
+    CCubicSplineFunction csfInverseWave;
+    csfInverseWave.SetData(vWave, vIndex);
+
+    double fMixRatio[GASE];
+    fMixRatio[0] = fMixing;
+    fMixRatio[1] = 1 - fMixRatio[0];
+
+    double fSpinFactor[GASE][2];
+    for (int i = 0; i < GASE; i++)
+    {
+        double fZ = (((2.0 * iSpin[i] + 1) * (2.0 * iSpin[i] + 1) * fTemp) / (2.0 * fB0[i]));
+        double fTmp = (fGamma2[i] * fMixRatio[i]) / fZ;
+        fSpinFactor[i][0] = fTmp * iGj[i][0];
+        fSpinFactor[i][1] = fTmp * (iGj[i][0] + iGj[i][1]);
+    }
+
+    // The scattered lines, the pixel 'fromPixel' scatters 'weight' times its intensity to the pixels 'toPixel' and 'toPixel + 1'.
+    struct ScatteredLine
+    {
+        int fromPixel;
+        int toPixel;
+        double fraction;
+        double weight;
+    };
+    std::vector<ScatteredLine> lines;
+    lines.reserve((size_t)std::max(iJMax, 0) * 2 * GASE * iNChannels);
+
+    double fDeltaNu[2 * GASE];
+    double fSigma[2 * GASE];
+    for (int j = 0; j < iJMax; j++)
+    {
+        double fStokes = ((9.0 / 8.0) + (3.0 / 4.0) * j - (3.0 / 8.0) / (2 * j + 3));
+        double fAntiStokes = ((-3.0 / 8.0) + (3.0 / 4.0) * j - (3.0 / 8.0) / (2 * j - 1));
+        double fTmpE = ((-HC_K) * (j * (j + 1.0)) / fTemp);
+        int iNuIndex = 0;
+        int iSigmaIndex = 0;
+
+        for (int g = 0; g < GASE; g++)
+        {
+            fDeltaNu[iNuIndex++] = (-fB0[g] * (4.0 * j + 6.0) * 1.0e-9);
+            fDeltaNu[iNuIndex++] = (fB0[g] * (4.0 * j - 2.0) * 1.0e-9);
+            double fTmpS = (fSpinFactor[g][0] * std::exp(fTmpE * fB0[g]));
+            fSigma[iSigmaIndex++] = fTmpS * fStokes;
+            fSigma[iSigmaIndex++] = fTmpS * fAntiStokes;
+            fSpinFactor[g][0] = fSpinFactor[g][1] - fSpinFactor[g][0];
+        }
+
+        for (int l = 0; l < iNChannels; l++)
+        {
+            double fLambda = m_wavelength[l];
+
+            for (int k = 0; k < 2 * GASE; k++)
+            {
+                double fLambdaScat = (fLambda / (1.0 + fLambda * fDeltaNu[k]));
+                double fLambdaScat2 = fLambdaScat * fLambdaScat;
+
+                double fIndex = csfInverseWave.GetValue(fLambdaScat);
+                int iIndex = (int)fIndex;
+                if ((iIndex >= 0) && (iIndex < iNChannels - 1))
+                {
+                    ScatteredLine line;
+                    line.fromPixel = l;
+                    line.toPixel = iIndex;
+                    line.fraction = fIndex - iIndex;
+                    line.weight = CALIBRATE_SIGMA * fSigma[k] / (fLambdaScat2 * fLambdaScat2);
+                    lines.push_back(line);
+                }
+            }
+        }
+    }
+
+    // The range of pixels contributing to each pixel of the Raman spectrum gives the layout of the banded matrix
+    std::vector<int> lastColumn(iNChannels, -1);
+    std::fill(m_firstColumn.begin(), m_firstColumn.end(), iNChannels);
+    for (const ScatteredLine& line : lines)
+    {
+        for (int toPixel = line.toPixel; toPixel <= line.toPixel + 1; toPixel++)
+        {
+            m_firstColumn[toPixel] = std::min(m_firstColumn[toPixel], line.fromPixel);
+            lastColumn[toPixel] = std::max(lastColumn[toPixel], line.fromPixel);
+        }
+    }
+    for (int i = 0; i < iNChannels; i++)
+    {
+        if (lastColumn[i] < m_firstColumn[i])
+        {
+            m_firstColumn[i] = 0;
+            lastColumn[i] = -1;
+        }
+        m_rowStart[i + 1] = m_rowStart[i] + (size_t)(lastColumn[i] - m_firstColumn[i] + 1);
+    }
+
+    m_weights.resize(m_rowStart[iNChannels], 0.0);
+    for (const ScatteredLine& line : lines)
+    {
+        m_weights[m_rowStart[line.toPixel] + (line.fromPixel - m_firstColumn[line.toPixel])] += line.weight * (1.0 - line.fraction);
+        m_weights[m_rowStart[line.toPixel + 1] + (line.fromPixel - m_firstColumn[line.toPixel + 1])] += line.weight * line.fraction;
+    }
+}
+
+bool RingSpectrumCalculator::IsSetupFor(const std::vector<double>& vWavelength, double fTemp, int iJMax, double fMixing) const
+{
+    return vWavelength.size() == m_wavelength.size() &&
+        fTemp == m_temperature &&
+        iJMax == m_jMax &&
+        fMixing == m_mixing &&
+        std::equal(m_wavelength.begin(), m_wavelength.end(), vWavelength.begin());
 }
 
+void RingSpectrumCalculator::CalcRamanSpectrum(const double* fOrigSpec, double* fRamanSpec, double fSZA) const
+{
+    const double fPhi = RamanPhaseFunctionRatio(fSZA);
+    const int iNChannels = static_cast<int>(m_wavelength.size());
+    for (int i = 0; i < iNChannels; i++)
+    {
+        const int iRowLength = static_cast<int>(m_rowStart[i + 1] - m_rowStart[i]);
+        fRamanSpec[i] = fPhi * Kernels::Dot(m_weights.data() + m_rowStart[i], fOrigSpec + m_firstColumn[i], iRowLength);
+    }
+}
+
+void RingSpectrumCalculator::CalcRingSpectrum(const double* fOrigSpec, double* fRingSpec, double fSZA)
+{
+    // The spectrum converted into energy (divided by the wavelength)
+    const size_t iNChannels = m_wavelength.size();
+    for (size_t i = 0; i < iNChannels; i++)
+    {
+        m_energy[i] = (m_wavelength[i] != 0) ? fOrigSpec[i] / m_wavelength[i] : 0.0;
+    }
+
+    CalcRamanSpectrum(m_energy.data(), fRingSpec, fSZA);
+
+    for (size_t i = 0; i < iNChannels; i++)
+    {
+        fRingSpec[i] = (m_energy[i] != 0) ? fRingSpec[i] / m_energy[i] : 0.0;
+    }
+}
+}
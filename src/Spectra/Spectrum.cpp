@@ -1,10 +1,12 @@
 #include <SpectralEvaluation/Spectra/Spectrum.h>
+#include <SpectralEvaluation/Spectra/SpectrumDataPool.h>
 #include <SpectralEvaluation/Spectra/SpectrometerModel.h>
 #include <SpectralEvaluation/Evaluation/CrossSectionData.h>
 #include <SpectralEvaluation/Evaluation/BasicMath.h>
 #include <SpectralEvaluation/Fit/Vector.h>
 
 #include <algorithm>
+#include <utility>
 
 #include <cstdarg>
 #include <cassert>
@@ -21,47 +23,65 @@ MathFit::CVector Generate(int first, int last); // from DoasFit.cpp
 CSpectrum::CSpectrum()
     : m_length(0)
 {
-    memset(m_data, 0, sizeof(double) * MAX_SPECTRUM_LENGTH);
+    Reserve(MAX_SPECTRUM_LENGTH);
+    memset(m_data, 0, sizeof(double) * m_capacity);
 }
 
 CSpectrum::CSpectrum(const std::vector<double>& spectralData)
-    : m_length((long)spectralData.size())
+    : m_length(0)
 {
-    memcpy(this->m_data, spectralData.data(), sizeof(double) * std::min(spectralData.size(), (size_t)MAX_SPECTRUM_LENGTH));
+    Reserve(MAX_SPECTRUM_LENGTH);
+    Resize((long)spectralData.size());
+    memcpy(this->m_data, spectralData.data(), sizeof(double) * spectralData.size());
 }
 
 CSpectrum::CSpectrum(const std::vector<double>& wavelength, const std::vector<double>& spectralData)
-    : m_length((long)spectralData.size()),
+    : m_length(0),
     m_wavelength{ begin(wavelength), end(wavelength) }
 {
-    memcpy(this->m_data, spectralData.data(), sizeof(double) * std::min(spectralData.size(), (size_t)MAX_SPECTRUM_LENGTH));
+    Reserve(MAX_SPECTRUM_LENGTH);
+    Resize((long)spectralData.size());
+    memcpy(this->m_data, spectralData.data(), sizeof(double) * spectralData.size());
 }
 
 CSpectrum::CSpectrum(const double* spectralData, size_t length)
-    : m_length((long)length)
+    : m_length(0)
 {
-    memcpy(this->m_data, spectralData, sizeof(double) * std::min(length, (size_t)MAX_SPECTRUM_LENGTH));
+    Reserve(MAX_SPECTRUM_LENGTH);
+    Resize((long)length);
+    memcpy(this->m_data, spectralData, sizeof(double) * length);
 }
 
 CSpectrum::CSpectrum(const double* wavelength, const double* spectralData, size_t length)
-    : m_length((long)length),
+    : m_length(0),
     m_wavelength(wavelength, wavelength + length)
 {
-    memcpy(this->m_data, spectralData, sizeof(double) * std::min(length, (size_t)MAX_SPECTRUM_LENGTH));
+    Reserve(MAX_SPECTRUM_LENGTH);
+    Resize((long)length);
+    memcpy(this->m_data, spectralData, sizeof(double) * length);
 }
 
 CSpectrum::CSpectrum(const CCrossSectionData& crossSection)
-    : m_length((long)crossSection.m_crossSection.size()),
+    : m_length(0),
     m_wavelength{ begin(crossSection.m_waveLength), end(crossSection.m_waveLength) }
 {
-    memcpy(this->m_data, crossSection.m_crossSection.data(), sizeof(double) * std::min(crossSection.m_crossSection.size(), (size_t)MAX_SPECTRUM_LENGTH));
+    Reserve(MAX_SPECTRUM_LENGTH);
+    Resize((long)crossSection.m_crossSection.size());
+    memcpy(this->m_data, crossSection.m_crossSection.data(), sizeof(double) * crossSection.m_crossSection.size());
 }
 
 CSpectrum::CSpectrum(const CSpectrum& other)
-    : m_length(other.m_length),
+    : m_length(0),
     m_info(other.m_info)
 {
-    memcpy(this->m_data, &other.m_data, sizeof(double) * MAX_SPECTRUM_LENGTH);
+    // Only the values of the spectrum are copied, the rest of the storage is cleared.
+    m_data = SpectrumDataPool::Allocate((size_t)std::max(other.m_length, MAX_SPECTRUM_LENGTH), m_capacity);
+    if (other.m_length > 0)
+    {
+        memcpy(this->m_data, other.m_data, sizeof(double) * other.m_length);
+        m_length = other.m_length;
+    }
+    memset(this->m_data + m_length, 0, sizeof(double) * (m_capacity - m_length));
 
     if (other.m_wavelength.size() > 0)
     {
@@ -70,11 +90,16 @@ CSpectrum::CSpectrum(const CSpectrum& other)
 }
 
 CSpectrum::CSpectrum(CSpectrum&& other)
-    : m_length(other.m_length),
-    m_info(std::move(other.m_info))
+    : m_data(other.m_data),
+    m_length(other.m_length),
+    m_info(std::move(other.m_info)),
+    m_capacity(other.m_capacity)
 {
-    // this still has to be copied
-    memcpy(this->m_data, &other.m_data, sizeof(double) * MAX_SPECTRUM_LENGTH);
+    // The other spectrum gets new storage, such that it still has room for MAX_SPECTRUM_LENGTH values.
+    other.m_data = nullptr;
+    other.m_length = 0;
+    other.m_capacity = 0;
+    other.Reserve(MAX_SPECTRUM_LENGTH);
 
     if (other.m_wavelength.size() > 0)
     {
@@ -82,11 +107,25 @@ CSpectrum::CSpectrum(CSpectrum&& other)
     }
 }
 
+CSpectrum::~CSpectrum()
+{
+    SpectrumDataPool::Release(m_data, m_capacity);
+}
+
 CSpectrum& CSpectrum::operator=(const CSpectrum& other)
 {
+    if (this == &other)
+    {
+        return *this;
+    }
+
     this->m_info = other.m_info;
+    Reserve(other.m_length);
     this->m_length = other.m_length;
-    memcpy(this->m_data, &other.m_data, sizeof(double) * MAX_SPECTRUM_LENGTH);
+    if (other.m_length > 0)
+    {
+        memcpy(this->m_data, other.m_data, sizeof(double) * other.m_length);
+    }
 
     if (other.m_wavelength.size() > 0)
     {
@@ -98,11 +137,19 @@ CSpectrum& CSpectrum::operator=(const CSpectrum& other)
 
 CSpectrum& CSpectrum::operator=(CSpectrum&& other)
 {
+    if (this == &other)
+    {
+        return *this;
+    }
+
     this->m_info = std::move(other.m_info);
-    this->m_length = other.m_length;
 
-    // This still has to be copied..
-    memcpy(this->m_data, &other.m_data, sizeof(double) * MAX_SPECTRUM_LENGTH);
+    // Swap the storage with the other spectrum, leaving it empty but with room for MAX_SPECTRUM_LENGTH values.
+    std::swap(this->m_data, other.m_data);
+    std::swap(this->m_capacity, other.m_capacity);
+    this->m_length = other.m_length;
+    other.m_length = 0;
+    other.Reserve(MAX_SPECTRUM_LENGTH);
 
     if (other.m_wavelength.size() > 0)
     {
@@ -112,6 +159,40 @@ CSpectrum& CSpectrum::operator=(CSpectrum&& other)
     return *this;
 }
 
+void CSpectrum::Reserve(long capacity)
+{
+    if (capacity <= 0 || (size_t)capacity <= m_capacity)
+    {
+        return;
+    }
+
+    size_t newCapacity = 0;
+    double* newData = SpectrumDataPool::Allocate((size_t)capacity, newCapacity);
+
+    // Keep all the values of the old storage, since values may have been written to it before setting m_length.
+    if (m_capacity > 0)
+    {
+        memcpy(newData, m_data, sizeof(double) * m_capacity);
+    }
+    memset(newData + m_capacity, 0, sizeof(double) * (newCapacity - m_capacity));
+
+    SpectrumDataPool::Release(m_data, m_capacity);
+    m_data = newData;
+    m_capacity = newCapacity;
+}
+
+void CSpectrum::Resize(long length)
+{
+    length = std::max(length, 0L);
+    Reserve(length);
+
+    if (length > m_length)
+    {
+        memset(m_data + std::max(m_length, 0L), 0, sizeof(double) * (length - std::max(m_length, 0L)));
+    }
+    m_length = length;
+}
+
 int CSpectrum::AssertRange(long& fromPixel, long& toPixel) const
 {
     /* Check the input */
@@ -322,7 +403,10 @@ bool CSpectrum::IsDark() const
 
 void CSpectrum::Clear()
 {
-    memset(m_data, 0, MAX_SPECTRUM_LENGTH * sizeof(double));
+    if (m_capacity > 0)
+    {
+        memset(m_data, 0, m_capacity * sizeof(double));
+    }
     m_length = 0;
     // uchar
     m_info.m_channel = m_info.m_flag = 0;
@@ -371,6 +455,7 @@ int	CSpectrum::Split(CSpectrum* spec[MAX_CHANNEL_NUM]) const
         spec[i]->m_info.m_interlaceStep = NSpectra;
         spec[i]->m_info.m_channel = (unsigned char)(i + 16 * (spec[i]->m_info.m_interlaceStep - 1));
         spec[i]->m_length = 0;
+        spec[i]->Reserve(m_length / NSpectra + 1);
     }
 
     // Which spectrum to start with, the master or the slave channel
@@ -429,8 +514,6 @@ int CSpectrum::GetInterlaceSteps(int channel, int& interlaceSteps)
 /** Interpolate the spectrum originating from the channel number 'channel' */
 bool CSpectrum::InterpolateSpectrum()
 {
-    double	data[MAX_SPECTRUM_LENGTH];
-    memset(data, 0, MAX_SPECTRUM_LENGTH * sizeof(double));
     int step = 2, start = 0;	// start is the first data-point we know in the spectrum
 
     // If this is not an partial spectrum, then return false
@@ -449,6 +532,7 @@ bool CSpectrum::InterpolateSpectrum()
 
     // Get the length of this spectrum
     int newLength = m_length * step;
+    std::vector<double> data(newLength, 0.0);
 
     // Copy the data we have
     for (int k = 0; k < m_length; ++k)
@@ -466,8 +550,8 @@ bool CSpectrum::InterpolateSpectrum()
         data[newLength - 1] = data[newLength - 2];
 
     // Get the data back
-    memcpy(m_data, data, newLength * sizeof(double));
-    m_length = m_length * step;
+    Resize(newLength);
+    memcpy(m_data, data.data(), newLength * sizeof(double));
 
     // Correct the channel number
     switch (m_info.m_channel) {
@@ -482,8 +566,6 @@ bool CSpectrum::InterpolateSpectrum()
 /** Interpolate the spectrum originating from the channel number 'channel' */
 bool CSpectrum::InterpolateSpectrum(CSpectrum& spec) const
 {
-    double	data[MAX_SPECTRUM_LENGTH];
-    memset(data, 0, MAX_SPECTRUM_LENGTH * sizeof(double));
     int step = 2, start = 0;	// start is the first data-point we know in the spectrum
 
     // If this is not an partial spectrum, then return false
@@ -499,6 +581,7 @@ bool CSpectrum::InterpolateSpectrum(CSpectrum& spec) const
 
     // Get the 'new' length of this spectrum
     int newLength = m_length * step;
+    std::vector<double> data(newLength, 0.0);
 
     // Copy the data we have
     for (int k = 0; k < m_length; ++k) {
@@ -516,8 +599,8 @@ bool CSpectrum::InterpolateSpectrum(CSpectrum& spec) const
 
     // Get the data back
     spec = *this;
-    spec.m_length = m_length * step;
-    memcpy(spec.m_data, data, newLength * sizeof(double));
+    spec.Resize(newLength);
+    memcpy(spec.m_data, data.data(), newLength * sizeof(double));
 
     // Correct the channel number
     switch (m_info.m_channel) {
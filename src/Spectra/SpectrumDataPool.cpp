@@ -0,0 +1,128 @@
+#include <SpectralEvaluation/Spectra/SpectrumDataPool.h>
+#include <vector>
+
+namespace novac
+{
+
+namespace
+{
+// The smallest buffer handed out is 2^smallestSizeClass values.
+const int smallestSizeClass = 6;
+
+// The largest buffer which is kept in the pool is 2^largestSizeClass values, larger buffers are allocated and deleted directly.
+const int largestSizeClass = 16;
+
+// The maximum number of released buffers kept by each thread, for each size class.
+const size_t maximumBuffersPerSizeClass = 32;
+
+int GetSizeClass(size_t length)
+{
+    int sizeClass = smallestSizeClass;
+    while (((size_t)1 << sizeClass) < length)
+    {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+// Set when the pool of the current thread has been destroyed (at thread exit).
+// Buffers released after this are deleted directly.
+thread_local bool threadPoolDestroyed = false;
+
+struct ThreadPool
+{
+    ThreadPool()
+    {
+        for (auto& buffers : released)
+        {
+            buffers.reserve(maximumBuffersPerSizeClass);
+        }
+    }
+
+    ~ThreadPool()
+    {
+        for (auto& buffers : released)
+        {
+            for (double* buffer : buffers)
+            {
+                delete[] buffer;
+            }
+        }
+        threadPoolDestroyed = true;
+    }
+
+    std::vector<double*> released[largestSizeClass - smallestSizeClass + 1];
+};
+
+std::vector<double*>* GetReleasedBuffers(int sizeClass)
+{
+    if (threadPoolDestroyed || sizeClass > largestSizeClass)
+    {
+        return nullptr;
+    }
+
+    static thread_local ThreadPool pool;
+    return &pool.released[sizeClass - smallestSizeClass];
+}
+}
+
+double* SpectrumDataPool::Allocate(size_t length, size_t& capacity)
+{
+    if (length == 0)
+    {
+        capacity = 0;
+        return nullptr;
+    }
+
+    const int sizeClass = GetSizeClass(length);
+    std::vector<double*>* releasedBuffers = GetReleasedBuffers(sizeClass);
+    if (releasedBuffers == nullptr)
+    {
+        capacity = (sizeClass > largestSizeClass) ? length : ((size_t)1 << sizeClass);
+        return new double[capacity];
+    }
+
+    capacity = (size_t)1 << sizeClass;
+    if (releasedBuffers->empty())
+    {
+        return new double[capacity];
+    }
+
+    double* buffer = releasedBuffers->back();
+    releasedBuffers->pop_back();
+    return buffer;
+}
+
+void SpectrumDataPool::Release(double* buffer, size_t capacity)
+{
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    const int sizeClass = GetSizeClass(capacity);
+    if (((size_t)1 << sizeClass) == capacity)
+    {
+        std::vector<double*>* releasedBuffers = GetReleasedBuffers(sizeClass);
+        if (releasedBuffers != nullptr && releasedBuffers->size() < maximumBuffersPerSizeClass)
+        {
+            releasedBuffers->push_back(buffer);
+            return;
+        }
+    }
+
+    delete[] buffer;
+}
+
+size_t SpectrumDataPool::CachedBufferCount()
+{
+    size_t count = 0;
+    for (int sizeClass = smallestSizeClass; sizeClass <= largestSizeClass; ++sizeClass)
+    {
+        const std::vector<double*>* releasedBuffers = GetReleasedBuffers(sizeClass);
+        count += (releasedBuffers == nullptr) ? 0 : releasedBuffers->size();
+    }
+    return count;
+}
+
+}